@@ -76,6 +76,11 @@ public:
   /// This `enqueue` variant allows to define forwarding chains.
   virtual void enqueue(mailbox_element_ptr what, execution_unit* host) = 0;
 
+  /// Enqueues all elements of `what` to the actor, preserving their order.
+  /// The default implementation calls `enqueue` for each element. Actors with
+  /// a lock-free mailbox override this function to add all messages at once.
+  virtual void enqueue_batch(mailbox_element_chain what, execution_unit* host);
+
   /// Attaches `ptr` to this actor. The actor will call `ptr->detach(...)` on
   /// exit, or immediately if it already finished execution.
   virtual void attach(attachable_ptr ptr) = 0;
@@ -106,6 +111,20 @@ public:
   /// Returns the system that created this actor (or proxy).
   actor_system& home_system() const noexcept;
 
+  /// Returns an approximation of the number of messages in the mailbox of
+  /// this actor. Safe to call from any thread. The default implementation
+  /// always returns 0.
+  virtual size_t mailbox_size_hint() const noexcept;
+
+  /// Starts tracking the values for `mailbox_size_hint`. Actor pools call this
+  /// function for each worker. The default implementation does nothing.
+  virtual void enable_mailbox_size_hint() noexcept;
+
+  /// Reverts a previous call to `enable_mailbox_size_hint`. Actor pools call
+  /// this function when removing a worker. The default implementation does
+  /// nothing.
+  virtual void disable_mailbox_size_hint() noexcept;
+
   /****************************************************************************
    *                 here be dragons: end of public interface                 *
    ****************************************************************************/
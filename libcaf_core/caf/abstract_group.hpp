@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "caf/abstract_channel.hpp"
 #include "caf/actor_addr.hpp"
@@ -62,6 +63,13 @@ public:
   /// Stops any background actors or threads and IO handles.
   virtual void stop() = 0;
 
+  // -- virtual member functions -----------------------------------------------
+
+  /// Enqueues each element of `xs` as a separate message with ID `mid` to all
+  /// subscribers. The default implementation calls `enqueue` once per message.
+  virtual void enqueue_batch(strong_actor_ptr sender, message_id mid,
+                             std::vector<message> xs, execution_unit* host);
+
   // -- observers --------------------------------------------------------------
 
   /// Returns the parent module.
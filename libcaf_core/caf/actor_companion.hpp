@@ -82,6 +82,8 @@ public:
   void enqueue(strong_actor_ptr src, message_id mid, message content,
                execution_unit* eu) override;
 
+  void enqueue_batch(mailbox_element_chain xs, execution_unit* host) override;
+
   void launch(execution_unit* eu, bool lazy, bool hide) override;
 
   void on_exit() override;
@@ -18,15 +18,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "caf/actor.hpp"
+#include "caf/config.hpp"
 #include "caf/detail/core_export.hpp"
-#include "caf/detail/shared_spinlock.hpp"
 #include "caf/detail/split_join.hpp"
 #include "caf/execution_unit.hpp"
-#include "caf/locks.hpp"
 #include "caf/mailbox_element.hpp"
 #include "caf/monitorable_actor.hpp"
 
@@ -56,12 +58,14 @@ namespace caf {
 /// @experimental
 class CAF_CORE_EXPORT actor_pool : public monitorable_actor {
 public:
-  using uplock = upgrade_lock<detail::shared_spinlock>;
   using actor_vec = std::vector<actor>;
   using factory = std::function<actor()>;
-  using policy = std::function<void(actor_system&, uplock&, const actor_vec&,
+  using policy = std::function<void(actor_system&, const actor_vec&,
                                     mailbox_element_ptr&, execution_unit*)>;
 
+  /// Maps a message to a key for the consistent hashing policy.
+  using key_function = std::function<size_t(const message&)>;
+
   /// Returns a simple round robin dispatching policy.
   static policy round_robin();
 
@@ -71,6 +75,20 @@ public:
   /// Returns a random dispatching policy.
   static policy random();
 
+  /// Returns a dispatching policy that picks the worker with the fewest
+  /// messages in its mailbox. Scans all workers for each message.
+  static policy least_loaded();
+
+  /// Returns a dispatching policy that picks two workers at random and
+  /// forwards to the one with fewer messages in its mailbox. Balances almost
+  /// as well as `least_loaded` in constant time.
+  static policy power_of_two_choices();
+
+  /// Returns a dispatching policy that always forwards messages with the same
+  /// key to the same worker, as long as that worker stays in the pool.
+  /// Adding or removing workers only remaps the keys of the affected worker.
+  static policy consistent_hash(key_function f);
+
   /// Returns a split/join dispatching policy. The function object `sf`
   /// distributes a work item to all workers (split step) and the function
   /// object `jf` joins individual results into a single one with `init`
@@ -109,15 +127,81 @@ protected:
   void on_cleanup(const error& reason) override;
 
 private:
-  bool filter(upgrade_lock<detail::shared_spinlock>&,
-              const strong_actor_ptr& sender, message_id mid, message& msg,
+  /// Grants access to the current set of workers without locking. Writers
+  /// keep replaced worker sets alive until all readers of older epochs left.
+  class reader_guard {
+  public:
+    explicit reader_guard(actor_pool& pool);
+
+    reader_guard(const reader_guard&) = delete;
+
+    reader_guard& operator=(const reader_guard&) = delete;
+
+    ~reader_guard();
+
+    const actor_vec& workers() const noexcept {
+      return *workers_;
+    }
+
+  private:
+    actor_pool& pool_;
+    std::atomic<size_t>* slot_;
+    const actor_vec* workers_;
+  };
+
+  // Number of reader counters per epoch. Readers pick a counter based on their
+  // thread to avoid contention on a single cache line.
+  static constexpr size_t reader_slots = 8;
+
+  struct reader_slot {
+    std::atomic<size_t> value;
+    char pad[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+  };
+
+  bool filter(const strong_actor_ptr& sender, message_id mid, message& msg,
               execution_unit* eu);
 
+  // Replaces the current set of workers with a modified copy. Returns the size
+  // of the new set.
+  template <class F>
+  size_t update_workers(F f);
+
+  // Decrements the reader counter `slot` and frees retired worker sets if
+  // this was the last reader that blocked them.
+  void leave(std::atomic<size_t>& slot);
+
+  // Moves all retired worker sets that no reader can access anymore to
+  // `garbage` and starts a new epoch if necessary. Requires `workers_mtx_`.
+  void reclaim(std::vector<std::unique_ptr<const actor_vec>>& garbage);
+
   // call without workers_mtx_ held
   void quit(execution_unit* host);
 
-  detail::shared_spinlock workers_mtx_;
-  std::vector<actor> workers_;
+  // Points to the current, immutable set of workers.
+  std::atomic<const actor_vec*> workers_;
+
+  // Counts threads that currently access `workers_`, grouped by the parity of
+  // the epoch they entered in.
+  reader_slot readers_[2][reader_slots];
+
+  // Advances whenever writers retire worker sets. Only changes while holding
+  // `workers_mtx_`.
+  std::atomic<size_t> epoch_;
+
+  // Signals readers that retired worker sets wait for them to leave.
+  std::atomic<bool> reclaim_pending_;
+
+  // Serializes all writes to `workers_`.
+  std::mutex workers_mtx_;
+
+  // Stores worker sets retired in the current epoch. Guarded by
+  // `workers_mtx_`.
+  std::vector<std::unique_ptr<const actor_vec>> retired_;
+
+  // Stores worker sets retired in the previous epoch, which we free once all
+  // readers of that epoch left. Guarded by `workers_mtx_`.
+  std::vector<std::unique_ptr<const actor_vec>> draining_;
+
   policy policy_;
   exit_reason planned_reason_;
 };
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -30,6 +31,8 @@
 #include "caf/actor.hpp"
 #include "caf/actor_cast.hpp"
 #include "caf/actor_control_block.hpp"
+#include "caf/config.hpp"
+#include "caf/detail/actor_id_map.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/shared_spinlock.hpp"
 #include "caf/fwd.hpp"
@@ -42,6 +45,10 @@ namespace caf {
 /// independent from their ID at runtime. Note that the registry does *not*
 /// contain all actors of an actor system. The middleman registers actors as
 /// needed.
+///
+/// The registry distributes actors over several shards by their ID. Each shard
+/// has its own reader-writer lock. Hence, lookups never block each other and
+/// spawning or terminating actors only blocks lookups for the same shard.
 class CAF_CORE_EXPORT actor_registry {
 public:
   friend class actor_system;
@@ -117,7 +124,22 @@ private:
   /// Associates given actor to `key`.
   void put_impl(const std::string& key, strong_actor_ptr value);
 
-  using entries = std::unordered_map<actor_id, strong_actor_ptr>;
+  /// Configures the number of shards for the ID table.
+  static constexpr size_t num_shards = 16;
+
+  /// Stores all actors with an ID that maps to this shard.
+  struct alignas(CAF_CACHE_LINE_SIZE) shard {
+    mutable detail::shared_spinlock mtx;
+    detail::actor_id_map entries;
+  };
+
+  shard& shard_for(actor_id key) noexcept {
+    return shards_[key % num_shards];
+  }
+
+  const shard& shard_for(actor_id key) const noexcept {
+    return shards_[key % num_shards];
+  }
 
   actor_registry(actor_system& sys);
 
@@ -125,8 +147,7 @@ private:
   mutable std::mutex running_mtx_;
   mutable std::condition_variable running_cv_;
 
-  mutable detail::shared_spinlock instances_mtx_;
-  entries entries_;
+  std::array<shard, num_shards> shards_;
 
   name_map named_entries_;
   mutable detail::shared_spinlock named_entries_mtx_;
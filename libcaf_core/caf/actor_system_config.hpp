@@ -243,6 +243,11 @@ public:
   /// @private
   timespan stream_tick_duration() const noexcept;
 
+  // -- request parameters -----------------------------------------------------
+
+  /// @private
+  timespan request_timeout_slack;
+
   // -- OpenSSL parameters -----------------------------------------------------
 
   std::string openssl_certificate;
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+#include "caf/default_downstream_manager.hpp"
+#include "caf/detail/parallel_stream_stage.hpp"
+#include "caf/detail/type_traits.hpp"
+#include "caf/fwd.hpp"
+#include "caf/make_counted.hpp"
+#include "caf/make_stage_result.hpp"
+#include "caf/policy/arg.hpp"
+#include "caf/stream.hpp"
+#include "caf/stream_stage_trait.hpp"
+#include "caf/unit.hpp"
+
+namespace caf {
+
+/// Selects whether a parallel stream stage emits results in the order of its
+/// input.
+enum class parallel_stage_ordering {
+  /// Emits the results of a batch only after emitting the results of all
+  /// previous batches.
+  preserved,
+  /// Emits the results of a batch as soon as its worker finishes.
+  relaxed,
+};
+
+/// Attaches a new stream stage to `self` that distributes the processing of
+/// incoming batches to `num_workers` worker actors. Each worker initializes
+/// its own state with `init` and calls `fun` for each batch it receives. The
+/// stage only grants credit for elements that neither wait at a worker nor in
+/// its output buffer, i.e., the workers remain subject to back-pressure.
+/// @param self Points to the hosting actor.
+/// @param in Stream handshake from upstream path.
+/// @param xs User-defined arguments for the downstream handshake.
+/// @param num_workers Number of worker actors.
+/// @param ordering Selects whether the stage preserves the order of the input.
+/// @param init Function object for initializing the state of a worker.
+/// @param fun Processing function.
+/// @param fin Optional cleanup handler that each worker calls for its state.
+/// @param token Policy token for selecting a downstream manager
+///              implementation.
+/// @returns The new `stream_manager`, an inbound slot, and an outbound slot.
+template <class In, class... Ts, class Init, class Fun, class Finalize = unit_t,
+          class DownstreamManager = default_downstream_manager_t<Fun>,
+          class Trait = stream_stage_trait_t<Fun>>
+make_stage_result_t<In, DownstreamManager, Ts...>
+attach_parallel_stream_stage(scheduled_actor* self, const stream<In>& in,
+                             std::tuple<Ts...> xs, size_t num_workers,
+                             parallel_stage_ordering ordering, Init init,
+                             Fun fun, Finalize fin = {},
+                             policy::arg<DownstreamManager> token = {}) {
+  CAF_IGNORE_UNUSED(token);
+  using output_type = typename Trait::output;
+  using state_type = typename Trait::state;
+  static_assert(
+    std::is_same<void(state_type&),
+                 typename detail::get_callable_trait<Init>::fun_sig>::value,
+    "Expected signature `void (State&)` for init function");
+  using consume_one = void(state_type&, downstream<output_type>&, In);
+  using consume_all
+    = void(state_type&, downstream<output_type>&, std::vector<In>&);
+  using fun_sig = typename detail::get_callable_trait<Fun>::fun_sig;
+  static_assert(std::is_same<fun_sig, consume_one>::value
+                  || std::is_same<fun_sig, consume_all>::value,
+                "Expected signature `void (State&, downstream<Out>&, In)` "
+                "or `void (State&, downstream<Out>&, std::vector<In>&)` "
+                "for consume function");
+  using impl = detail::parallel_stream_stage<typename Trait::input,
+                                             DownstreamManager, Fun, Finalize>;
+  auto mgr = make_counted<impl>(self, num_workers,
+                                ordering == parallel_stage_ordering::preserved,
+                                std::move(init), std::move(fun),
+                                std::move(fin));
+  auto islot = mgr->add_inbound_path(in);
+  auto oslot = mgr->add_outbound_path(std::move(xs));
+  return {islot, oslot, std::move(mgr)};
+}
+
+/// Attaches a new stream stage to `self` that distributes the processing of
+/// incoming batches to `num_workers` worker actors.
+/// @param self Points to the hosting actor.
+/// @param in Stream handshake from upstream path.
+/// @param num_workers Number of worker actors.
+/// @param ordering Selects whether the stage preserves the order of the input.
+/// @param init Function object for initializing the state of a worker.
+/// @param fun Processing function.
+/// @param fin Optional cleanup handler that each worker calls for its state.
+/// @param token Policy token for selecting a downstream manager
+///              implementation.
+/// @returns The new `stream_manager`, an inbound slot, and an outbound slot.
+template <class In, class Init, class Fun, class Finalize = unit_t,
+          class DownstreamManager = default_downstream_manager_t<Fun>,
+          class Trait = stream_stage_trait_t<Fun>>
+make_stage_result_t<In, DownstreamManager>
+attach_parallel_stream_stage(scheduled_actor* self, const stream<In>& in,
+                             size_t num_workers,
+                             parallel_stage_ordering ordering, Init init,
+                             Fun fun, Finalize fin = {},
+                             policy::arg<DownstreamManager> token = {}) {
+  return attach_parallel_stream_stage(self, in, std::make_tuple(), num_workers,
+                                      ordering, std::move(init), std::move(fun),
+                                      std::move(fin), token);
+}
+
+} // namespace caf
@@ -21,8 +21,11 @@
 #include <cstddef>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "caf/blob_serializable.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/error_code.hpp"
 #include "caf/fwd.hpp"
@@ -85,6 +88,17 @@ public:
     return context_;
   }
 
+  /// Returns the cache for known message shapes or `nullptr`.
+  detail::message_shape_cache* shape_cache() const noexcept {
+    return shape_cache_;
+  }
+
+  /// Sets a cache for known message shapes that speeds up deserializing
+  /// messages with recurring element types.
+  void shape_cache(detail::message_shape_cache* ptr) noexcept {
+    shape_cache_ = ptr;
+  }
+
   /// Jumps `num_bytes` forward.
   /// @pre `num_bytes <= remaining()`
   void skip(size_t num_bytes) noexcept;
@@ -153,6 +167,22 @@ public:
 
   result_type apply(std::vector<bool>& xs);
 
+  /// Reads a sequence that was written as a single block of raw bytes.
+  template <class T>
+  std::enable_if_t<is_blob_serializable_v<T>, result_type>
+  apply(std::vector<T>& xs) {
+    static_assert(std::is_default_constructible<T>::value);
+    size_t size = 0;
+    if (auto err = begin_sequence(size))
+      return err;
+    if (size > remaining() / sizeof(T))
+      return sec::end_of_stream;
+    xs.resize(size);
+    if (auto err = apply(as_writable_bytes(make_span(xs))))
+      return err;
+    return end_sequence();
+  }
+
 private:
   explicit binary_deserializer(actor_system& sys) noexcept;
 
@@ -169,6 +199,9 @@ private:
 
   /// Provides access to the ::proxy_registry and to the ::actor_system.
   execution_unit* context_;
+
+  /// Optionally remembers type ID lists of previously deserialized messages.
+  detail::message_shape_cache* shape_cache_ = nullptr;
 };
 
 } // namespace caf
@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "caf/blob_serializable.hpp"
 #include "caf/byte.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/core_export.hpp"
@@ -142,6 +143,16 @@ public:
 
   void apply(const std::vector<bool>& x);
 
+  /// Writes the size of `xs` followed by the raw bytes of all elements.
+  template <class T>
+  std::enable_if_t<is_blob_serializable_v<T>, error_code<sec>>
+  apply(const std::vector<T>& xs) {
+    if (auto err = begin_sequence(xs.size()))
+      return err;
+    apply(as_bytes(make_span(xs)));
+    return end_sequence();
+  }
+
 private:
   /// Stores the serialized output.
   byte_buffer& buf_;
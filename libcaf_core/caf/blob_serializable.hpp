@@ -0,0 +1,52 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <type_traits>
+
+#include "caf/byte.hpp"
+
+namespace caf {
+
+/// Template specializations can allow the binary serializers to write
+/// sequences of a trivially copyable type as a single block of raw bytes. The
+/// bytes use the host representation of `T`, i.e., the specialization must
+/// only be provided if all communicating nodes agree on size, alignment and
+/// byte order of `T`. Single-byte integers are enabled by default, since their
+/// raw representation is identical to their regular encoding.
+template <class T>
+struct blob_serializable
+  : std::bool_constant<std::is_integral<T>::value && sizeof(T) == 1
+                       && !std::is_same<T, bool>::value> {};
+
+template <>
+struct blob_serializable<byte> : std::true_type {};
+
+template <class T>
+constexpr bool is_blob_serializable_v = blob_serializable<T>::value;
+
+} // namespace caf
+
+#define CAF_ALLOW_BLOB_SERIALIZATION(type_name)                                \
+  namespace caf {                                                              \
+  template <>                                                                  \
+  struct blob_serializable<type_name> : std::true_type {};                     \
+  static_assert(std::is_trivially_copyable<type_name>::value,                  \
+                "blob serialization requires a trivially copyable type");      \
+  }
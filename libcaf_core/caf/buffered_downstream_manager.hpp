@@ -18,11 +18,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
-#include <deque>
-#include <iterator>
 #include <vector>
 
+#include "caf/detail/circular_buffer.hpp"
 #include "caf/downstream_manager_base.hpp"
 #include "caf/logger.hpp"
 
@@ -39,7 +39,7 @@ public:
 
   using output_type = T;
 
-  using buffer_type = std::deque<output_type>;
+  using buffer_type = detail::circular_buffer<output_type>;
 
   using chunk_type = std::vector<output_type>;
 
@@ -60,19 +60,12 @@ public:
 
   /// @pre `n <= buf_.size()`
   static chunk_type get_chunk(buffer_type& buf, size_t n) {
-    CAF_LOG_TRACE(CAF_ARG(buf) << CAF_ARG(n));
+    CAF_LOG_TRACE(CAF_ARG2("buffered", buf.size()) << CAF_ARG(n));
     chunk_type xs;
     if (!buf.empty() && n > 0) {
-      xs.reserve(std::min(n, buf.size()));
-      if (n < buf.size()) {
-        auto first = buf.begin();
-        auto last = first + static_cast<ptrdiff_t>(n);
-        std::move(first, last, std::back_inserter(xs));
-        buf.erase(first, last);
-      } else {
-        std::move(buf.begin(), buf.end(), std::back_inserter(xs));
-        buf.clear();
-      }
+      n = std::min(n, buf.size());
+      xs.reserve(n);
+      buf.move_front_to(n, xs);
     }
     return xs;
   }
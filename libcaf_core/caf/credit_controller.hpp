@@ -88,6 +88,12 @@ public:
   ///          generate additional credit.
   virtual int32_t threshold() const noexcept;
 
+  /// Called whenever the inbound path sends new credit to the source.
+  /// @param outstanding Credit the source received previously but did not use
+  ///                    up yet.
+  /// @param granted Newly assigned credit.
+  virtual void credit_granted(int32_t outstanding, int32_t granted);
+
 private:
   // -- member variables -------------------------------------------------------
 
@@ -54,6 +54,9 @@ extern CAF_CORE_EXPORT string_view profiling_output_file;
 extern CAF_CORE_EXPORT const size_t max_threads;
 extern CAF_CORE_EXPORT const size_t max_throughput;
 extern CAF_CORE_EXPORT const timespan profiling_resolution;
+extern CAF_CORE_EXPORT const string_view clock;
+extern CAF_CORE_EXPORT const timespan clock_resolution;
+extern CAF_CORE_EXPORT const timespan request_timeout_slack;
 
 } // namespace scheduler
 
@@ -66,6 +69,7 @@ extern CAF_CORE_EXPORT const size_t moderate_steal_interval;
 extern CAF_CORE_EXPORT const timespan moderate_sleep_duration;
 extern CAF_CORE_EXPORT const size_t relaxed_steal_interval;
 extern CAF_CORE_EXPORT const timespan relaxed_sleep_duration;
+extern CAF_CORE_EXPORT const bool topology_aware;
 
 } // namespace work_stealing
 
@@ -89,7 +93,12 @@ extern CAF_CORE_EXPORT const size_t max_consecutive_reads;
 extern CAF_CORE_EXPORT const size_t heartbeat_interval;
 extern CAF_CORE_EXPORT const size_t cached_udp_buffers;
 extern CAF_CORE_EXPORT const size_t max_pending_msgs;
+extern CAF_CORE_EXPORT const size_t multiplexers;
 extern CAF_CORE_EXPORT const size_t workers;
+extern CAF_CORE_EXPORT const size_t compression_threshold;
+extern CAF_CORE_EXPORT const size_t max_batch_size;
+extern CAF_CORE_EXPORT const timespan max_batch_delay;
+extern CAF_CORE_EXPORT const size_t zerocopy_threshold;
 
 } // namespace middleman
 
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "caf/actor_control_block.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/fwd.hpp"
+
+namespace caf::detail {
+
+/// A hash map from actor IDs to actor handles that stores all entries in a
+/// single array. The map resolves collisions via linear probing and removes
+/// entries by shifting subsequent entries backwards, i.e., lookups never
+/// need to skip over deleted entries.
+/// @note This class is not thread-safe.
+class CAF_CORE_EXPORT actor_id_map {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Configures the number of slots when allocating memory on first insert.
+  static constexpr size_t min_capacity = 8;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  actor_id_map() noexcept;
+
+  actor_id_map(actor_id_map&& other) noexcept;
+
+  actor_id_map& operator=(actor_id_map&& other) noexcept;
+
+  actor_id_map(const actor_id_map&) = delete;
+
+  actor_id_map& operator=(const actor_id_map&) = delete;
+
+  ~actor_id_map();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of stored entries.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns whether the map has no entries.
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// Returns the number of slots.
+  size_t capacity() const noexcept {
+    return slots_ != nullptr ? mask_ + 1 : 0;
+  }
+
+  // -- lookup and modifiers ---------------------------------------------------
+
+  /// Returns the actor handle for `key` or `nullptr`.
+  strong_actor_ptr get(actor_id key) const noexcept;
+
+  /// Stores `value` for `key`, replacing any previous value.
+  /// @pre `value != nullptr`
+  void put(actor_id key, strong_actor_ptr value);
+
+  /// Removes the entry for `key` and returns its value or `nullptr` if the map
+  /// contains no such entry.
+  strong_actor_ptr take(actor_id key) noexcept;
+
+  /// Removes all entries.
+  void clear() noexcept;
+
+  /// Calls `f(key, value)` for each entry.
+  template <class F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < capacity(); ++i)
+      if (slots_[i].value != nullptr)
+        f(slots_[i].key, slots_[i].value);
+  }
+
+private:
+  struct slot {
+    actor_id key = 0;
+    strong_actor_ptr value;
+  };
+
+  size_t home_of(actor_id key) const noexcept {
+    // Fibonacci hashing spreads consecutive IDs across the table.
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+  }
+
+  /// Returns the slot index for `key` or `capacity()` if `key` is missing.
+  size_t find(actor_id key) const noexcept;
+
+  /// Doubles the capacity and re-inserts all entries.
+  void grow();
+
+  std::unique_ptr<slot[]> slots_;
+
+  size_t mask_;
+
+  size_t size_;
+};
+
+} // namespace caf::detail
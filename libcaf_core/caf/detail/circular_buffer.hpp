@@ -0,0 +1,465 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "caf/config.hpp"
+#include "caf/span.hpp"
+
+namespace caf::detail {
+
+/// A growable FIFO buffer that stores its elements in a single contiguous
+/// array with power-of-two capacity, using the array as a ring. Unlike
+/// `std::deque`, appending and removing elements never allocates or frees
+/// individual nodes, and bulk operations work on at most two contiguous
+/// segments. Only supports inserting at the back and erasing at the front.
+template <class T>
+class circular_buffer {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using value_type = T;
+
+  using size_type = size_t;
+
+  using difference_type = ptrdiff_t;
+
+  using reference = value_type&;
+
+  using const_reference = const value_type&;
+
+  using pointer = value_type*;
+
+  using const_pointer = const value_type*;
+
+  /// Random access iterator over the logical positions of the buffer.
+  template <class Buffer, class Value>
+  class iterator_base {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+
+    using value_type = std::remove_const_t<Value>;
+
+    using difference_type = ptrdiff_t;
+
+    using pointer = Value*;
+
+    using reference = Value&;
+
+    iterator_base() noexcept : buf_(nullptr), pos_(0) {
+      // nop
+    }
+
+    iterator_base(Buffer* buf, size_t pos) noexcept : buf_(buf), pos_(pos) {
+      // nop
+    }
+
+    template <class OtherBuffer, class OtherValue>
+    iterator_base(const iterator_base<OtherBuffer, OtherValue>& other) noexcept
+      : buf_(other.buf_), pos_(other.pos_) {
+      // nop
+    }
+
+    reference operator*() const noexcept {
+      return (*buf_)[pos_];
+    }
+
+    pointer operator->() const noexcept {
+      return &(*buf_)[pos_];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+      return (*buf_)[static_cast<size_t>(static_cast<difference_type>(pos_)
+                                         + n)];
+    }
+
+    iterator_base& operator++() noexcept {
+      ++pos_;
+      return *this;
+    }
+
+    iterator_base operator++(int) noexcept {
+      auto result = *this;
+      ++pos_;
+      return result;
+    }
+
+    iterator_base& operator--() noexcept {
+      --pos_;
+      return *this;
+    }
+
+    iterator_base operator--(int) noexcept {
+      auto result = *this;
+      --pos_;
+      return result;
+    }
+
+    iterator_base& operator+=(difference_type n) noexcept {
+      pos_ = static_cast<size_t>(static_cast<difference_type>(pos_) + n);
+      return *this;
+    }
+
+    iterator_base& operator-=(difference_type n) noexcept {
+      return *this += -n;
+    }
+
+    friend iterator_base operator+(iterator_base x, difference_type n) {
+      return x += n;
+    }
+
+    friend iterator_base operator+(difference_type n, iterator_base x) {
+      return x += n;
+    }
+
+    friend iterator_base operator-(iterator_base x, difference_type n) {
+      return x -= n;
+    }
+
+    friend difference_type operator-(const iterator_base& x,
+                                     const iterator_base& y) noexcept {
+      return static_cast<difference_type>(x.pos_)
+             - static_cast<difference_type>(y.pos_);
+    }
+
+    friend bool operator==(const iterator_base& x,
+                           const iterator_base& y) noexcept {
+      return x.pos_ == y.pos_;
+    }
+
+    friend bool operator!=(const iterator_base& x,
+                           const iterator_base& y) noexcept {
+      return x.pos_ != y.pos_;
+    }
+
+    friend bool operator<(const iterator_base& x,
+                          const iterator_base& y) noexcept {
+      return x.pos_ < y.pos_;
+    }
+
+    friend bool operator<=(const iterator_base& x,
+                           const iterator_base& y) noexcept {
+      return x.pos_ <= y.pos_;
+    }
+
+    friend bool operator>(const iterator_base& x,
+                          const iterator_base& y) noexcept {
+      return x.pos_ > y.pos_;
+    }
+
+    friend bool operator>=(const iterator_base& x,
+                           const iterator_base& y) noexcept {
+      return x.pos_ >= y.pos_;
+    }
+
+    size_t position() const noexcept {
+      return pos_;
+    }
+
+  private:
+    template <class, class>
+    friend class iterator_base;
+
+    Buffer* buf_;
+    size_t pos_;
+  };
+
+  using iterator = iterator_base<circular_buffer, value_type>;
+
+  using const_iterator = iterator_base<const circular_buffer, const value_type>;
+
+  /// Smallest capacity after the first allocation.
+  static constexpr size_t min_capacity = 16;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  circular_buffer() noexcept
+    : data_(nullptr), capacity_(0), head_(0), size_(0) {
+    // nop
+  }
+
+  circular_buffer(const circular_buffer& other) : circular_buffer() {
+    reserve(other.size_);
+    for (auto& x : other)
+      emplace_back(x);
+  }
+
+  circular_buffer(circular_buffer&& other) noexcept
+    : data_(other.data_),
+      capacity_(other.capacity_),
+      head_(other.head_),
+      size_(other.size_) {
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+
+  circular_buffer& operator=(const circular_buffer& other) {
+    if (this != &other) {
+      circular_buffer tmp{other};
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  circular_buffer& operator=(circular_buffer&& other) noexcept {
+    circular_buffer tmp{std::move(other)};
+    swap(tmp);
+    return *this;
+  }
+
+  ~circular_buffer() {
+    clear();
+    deallocate(data_);
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_t capacity() const noexcept {
+    return capacity_;
+  }
+
+  // -- element access ---------------------------------------------------------
+
+  reference operator[](size_t pos) noexcept {
+    CAF_ASSERT(pos < size_);
+    return data_[index(pos)];
+  }
+
+  const_reference operator[](size_t pos) const noexcept {
+    CAF_ASSERT(pos < size_);
+    return data_[index(pos)];
+  }
+
+  reference front() noexcept {
+    return (*this)[0];
+  }
+
+  const_reference front() const noexcept {
+    return (*this)[0];
+  }
+
+  reference back() noexcept {
+    return (*this)[size_ - 1];
+  }
+
+  const_reference back() const noexcept {
+    return (*this)[size_ - 1];
+  }
+
+  // -- iterators --------------------------------------------------------------
+
+  iterator begin() noexcept {
+    return {this, 0};
+  }
+
+  const_iterator begin() const noexcept {
+    return {this, 0};
+  }
+
+  const_iterator cbegin() const noexcept {
+    return begin();
+  }
+
+  iterator end() noexcept {
+    return {this, size_};
+  }
+
+  const_iterator end() const noexcept {
+    return {this, size_};
+  }
+
+  const_iterator cend() const noexcept {
+    return end();
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Makes sure the buffer can store `n` elements without reallocating.
+  void reserve(size_t n) {
+    if (n > capacity_)
+      relocate(n);
+  }
+
+  template <class... Ts>
+  reference emplace_back(Ts&&... xs) {
+    if (size_ == capacity_)
+      relocate(size_ + 1);
+    auto ptr = data_ + index(size_);
+    new (ptr) value_type(std::forward<Ts>(xs)...);
+    ++size_;
+    return *ptr;
+  }
+
+  void push_back(const value_type& x) {
+    emplace_back(x);
+  }
+
+  void push_back(value_type&& x) {
+    emplace_back(std::move(x));
+  }
+
+  /// Appends all elements in the range `[first, last)`.
+  /// @pre `pos == end()`
+  template <class Iterator, class Sentinel>
+  iterator insert(const_iterator pos, Iterator first, Sentinel last) {
+    CAF_ASSERT(pos == end());
+    CAF_IGNORE_UNUSED(pos);
+    auto offset = size_;
+    if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                  typename std::iterator_traits<
+                                    Iterator>::iterator_category>::value)
+      reserve(size_ + static_cast<size_t>(std::distance(first, last)));
+    for (; first != last; ++first)
+      emplace_back(*first);
+    return {this, offset};
+  }
+
+  /// Appends `n` default-constructed elements and returns them as contiguous
+  /// storage, which allows callers to write elements in place.
+  span<value_type> extend(size_t n) {
+    if (n == 0)
+      return {};
+    // Make sure the new elements do not wrap around the end of the array.
+    auto tail = index(size_);
+    if (size_ + n > capacity_ || (tail >= head_ && capacity_ - tail < n)
+        || (tail < head_ && head_ - tail < n))
+      relocate(size_ + n);
+    auto first = data_ + index(size_);
+    std::uninitialized_value_construct(first, first + n);
+    size_ += n;
+    return {first, n};
+  }
+
+  /// Erases all elements in the range `[first, last)`.
+  /// @pre `first == begin()`
+  iterator erase(const_iterator first, const_iterator last) {
+    CAF_ASSERT(first == begin());
+    CAF_IGNORE_UNUSED(first);
+    pop_front(last.position());
+    return begin();
+  }
+
+  /// Erases the first `n` elements.
+  void pop_front(size_t n = 1) {
+    CAF_ASSERT(n <= size_);
+    for_each_segment(n, [](pointer first, pointer last) {
+      std::destroy(first, last);
+    });
+    drop_front(n);
+  }
+
+  /// Moves the first `n` elements to the end of `out` and erases them from
+  /// the buffer. Moves the elements in at most two contiguous blocks.
+  template <class Container>
+  void move_front_to(size_t n, Container& out) {
+    CAF_ASSERT(n <= size_);
+    for_each_segment(n, [&](pointer first, pointer last) {
+      out.insert(out.end(), std::make_move_iterator(first),
+                 std::make_move_iterator(last));
+      std::destroy(first, last);
+    });
+    drop_front(n);
+  }
+
+  void clear() noexcept {
+    pop_front(size_);
+    head_ = 0;
+  }
+
+  void swap(circular_buffer& other) noexcept {
+    using std::swap;
+    swap(data_, other.data_);
+    swap(capacity_, other.capacity_);
+    swap(head_, other.head_);
+    swap(size_, other.size_);
+  }
+
+private:
+  size_t index(size_t pos) const noexcept {
+    return (head_ + pos) & (capacity_ - 1);
+  }
+
+  static pointer allocate(size_t n) {
+    return std::allocator<value_type>{}.allocate(n);
+  }
+
+  void deallocate(pointer ptr) noexcept {
+    if (ptr != nullptr)
+      std::allocator<value_type>{}.deallocate(ptr, capacity_);
+  }
+
+  // Calls `f(first, last)` for the contiguous blocks of the first `n` elements.
+  template <class F>
+  void for_each_segment(size_t n, F f) {
+    if (n == 0)
+      return;
+    auto first = data_ + head_;
+    auto n1 = std::min(n, capacity_ - head_);
+    f(first, first + n1);
+    if (n1 < n)
+      f(data_, data_ + (n - n1));
+  }
+
+  void drop_front(size_t n) noexcept {
+    size_ -= n;
+    head_ = size_ == 0 ? 0 : index(n);
+  }
+
+  // Moves all elements to a new array with room for at least `n` elements,
+  // starting at index 0.
+  void relocate(size_t n) {
+    auto new_capacity = std::max(capacity_, min_capacity);
+    while (new_capacity < n)
+      new_capacity *= 2;
+    auto new_data = allocate(new_capacity);
+    auto pos = new_data;
+    for_each_segment(size_, [&](pointer first, pointer last) {
+      pos = std::uninitialized_move(first, last, pos);
+      std::destroy(first, last);
+    });
+    deallocate(data_);
+    data_ = new_data;
+    capacity_ = new_capacity;
+    head_ = 0;
+  }
+
+  pointer data_;
+  size_t capacity_;
+  size_t head_;
+  size_t size_;
+};
+
+} // namespace caf::detail
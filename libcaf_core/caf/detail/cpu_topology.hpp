@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::detail {
+
+/// Describes the CPUs available to this process along with their position in
+/// the cache and memory hierarchy.
+class CAF_CORE_EXPORT cpu_topology {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Describes a single logical CPU.
+  struct cpu {
+    /// Logical CPU number as used by the operating system.
+    size_t id;
+
+    /// Identifies the group of CPUs sharing the last-level cache.
+    size_t cache;
+
+    /// Identifies the NUMA node of this CPU.
+    size_t node;
+  };
+
+  /// Classifies how far apart two CPUs are.
+  enum distance_level : size_t {
+    /// Both CPUs share their last-level cache.
+    same_cache,
+    /// Both CPUs belong to the same NUMA node.
+    same_node,
+    /// Both CPUs belong to different NUMA nodes.
+    remote_node,
+  };
+
+  /// Number of values in `distance_level`.
+  static constexpr size_t num_distance_levels = 3;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a topology from `cpus` and sorts the CPUs by NUMA node, cache and
+  /// ID. This ordering places nearby CPUs next to each other.
+  explicit cpu_topology(std::vector<cpu> cpus = {});
+
+  /// Reads the topology of all CPUs the calling thread may run on. Returns an
+  /// empty topology if the platform provides no information.
+  static cpu_topology query();
+
+  // -- properties -------------------------------------------------------------
+
+  const std::vector<cpu>& cpus() const noexcept {
+    return cpus_;
+  }
+
+  bool empty() const noexcept {
+    return cpus_.empty();
+  }
+
+  size_t size() const noexcept {
+    return cpus_.size();
+  }
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Returns how far apart `x` and `y` are.
+  static distance_level distance(const cpu& x, const cpu& y) noexcept;
+
+  /// Parses a CPU list in the Linux sysfs format, e.g., `0-3,8,10-11`. Returns
+  /// an empty list on parser errors.
+  static std::vector<size_t> parse_cpu_list(string_view str);
+
+  /// Restricts the calling thread to run only on the CPU with given ID.
+  /// @returns `true` on success, `false` if the platform does not support
+  ///          pinning threads or if the operating system rejected the request.
+  static bool pin_this_thread(size_t cpu_id);
+
+private:
+  std::vector<cpu> cpus_;
+};
+
+} // namespace caf::detail
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "caf/config.hpp"
+#include "caf/detail/memory_pool.hpp"
 
 #include <atomic>
 #include <cassert>
@@ -89,6 +90,14 @@ public:
       // nop
     }
 
+    static void* operator new(size_t size) {
+      return memory_pool::allocate(size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+      memory_pool::deallocate(ptr);
+    }
+
   private:
     static constexpr size_type payload_size
       = sizeof(pointer) + sizeof(std::atomic<node*>);
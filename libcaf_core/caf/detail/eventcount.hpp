@@ -0,0 +1,111 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf::detail {
+
+/// Allows threads to park until some condition becomes true without requiring
+/// notifiers to acquire a lock when nobody waits. A waiter announces itself
+/// with `prepare_wait`, re-checks its condition and then either calls
+/// `cancel_wait` or blocks via `commit_wait`. Notifiers first make the
+/// condition true and then call `notify_one` or `notify_all`, which only fall
+/// back to the mutex if at least one thread has announced itself.
+class CAF_CORE_EXPORT eventcount {
+public:
+  /// Identifies the epoch a waiter has observed in `prepare_wait`.
+  using key_type = uint32_t;
+
+  eventcount();
+
+  eventcount(const eventcount&) = delete;
+
+  eventcount& operator=(const eventcount&) = delete;
+
+  /// Registers the calling thread as waiter and returns the current epoch.
+  key_type prepare_wait() noexcept {
+    auto prev = state_.fetch_add(1, std::memory_order_seq_cst);
+    // Orders the increment before re-checking the wait condition.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return static_cast<key_type>(prev >> epoch_shift);
+  }
+
+  /// Unregisters the calling thread after `prepare_wait` in case the wait
+  /// condition became false in the meantime.
+  void cancel_wait() noexcept {
+    state_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Blocks until a notification arrives after `prepare_wait` returned `key`
+  /// or until `timeout` expires.
+  /// @returns `true` if the thread got notified, `false` on timeout.
+  bool commit_wait(key_type key, timespan timeout);
+
+  /// Wakes up at most one waiting thread.
+  void notify_one() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((state_.load(std::memory_order_relaxed) & waiter_mask) != 0)
+      notify_impl(false);
+  }
+
+  /// Wakes up all waiting threads.
+  void notify_all() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((state_.load(std::memory_order_relaxed) & waiter_mask) != 0)
+      notify_impl(true);
+  }
+
+  /// Returns the number of threads between `prepare_wait` and the return from
+  /// `cancel_wait` or `commit_wait`.
+  size_t waiters() const noexcept {
+    return static_cast<size_t>(state_.load(std::memory_order_relaxed)
+                               & waiter_mask);
+  }
+
+private:
+  static constexpr uint64_t epoch_shift = 32;
+
+  static constexpr uint64_t waiter_mask = (uint64_t{1} << epoch_shift) - 1;
+
+  key_type epoch() const noexcept {
+    return static_cast<key_type>(state_.load(std::memory_order_acquire)
+                                 >> epoch_shift);
+  }
+
+  void notify_impl(bool all);
+
+  // Stores the epoch in the upper 32 bits and the number of waiters in the
+  // lower 32 bits.
+  std::atomic<uint64_t> state_;
+
+  // Guards changes to the epoch for the benefit of blocked threads.
+  std::mutex mtx_;
+
+  // Signals epoch changes.
+  std::condition_variable cv_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,161 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+/// Base type for elements of an `injection_queue`. Stores the link to the next
+/// element, which allows the queue to push elements without allocating nodes.
+/// Hence, an element can only be in one `injection_queue` at a time.
+class injection_queue_node {
+public:
+  template <class>
+  friend class injection_queue;
+
+  injection_queue_node() noexcept : inbox_next_(nullptr) {
+    // nop
+  }
+
+  injection_queue_node(const injection_queue_node&) noexcept
+    : inbox_next_(nullptr) {
+    // nop
+  }
+
+  injection_queue_node& operator=(const injection_queue_node&) noexcept {
+    // The link belongs to the queue, not to the value of an element.
+    return *this;
+  }
+
+private:
+  std::atomic<injection_queue_node*> inbox_next_;
+};
+
+/// An unbounded FIFO queue for injecting jobs into a worker from other
+/// threads, based on Dmitry Vyukov's intrusive MPSC queue. Pushing is
+/// wait-free, never blocks and never allocates. Consumers serialize via a
+/// try-lock instead of blocking, which allows thieves to take jobs from the
+/// queue of a busy worker while the owner keeps the fast path.
+template <class T>
+class injection_queue {
+public:
+  static_assert(std::is_base_of<injection_queue_node, T>::value,
+                "T must inherit from injection_queue_node");
+
+  using value_type = T;
+
+  using pointer = value_type*;
+
+  using node_type = injection_queue_node;
+
+  injection_queue() : head_(&stub_), tail_(&stub_) {
+    consumer_lock_.clear();
+  }
+
+  injection_queue(const injection_queue&) = delete;
+
+  injection_queue& operator=(const injection_queue&) = delete;
+
+  /// Appends `value` to the queue.
+  /// @note Safe to call from any thread.
+  void push(pointer value) {
+    CAF_ASSERT(value != nullptr);
+    push_node(value);
+  }
+
+  /// Removes the oldest element from the queue. Returns `nullptr` if the queue
+  /// is empty, if a producer has not finished linking its element yet, or if
+  /// another consumer currently accesses the queue.
+  /// @note Safe to call from any thread.
+  pointer try_take() {
+    if (consumer_lock_.test_and_set(std::memory_order_acquire))
+      return nullptr;
+    auto result = take_node();
+    consumer_lock_.clear(std::memory_order_release);
+    return static_cast<pointer>(result);
+  }
+
+  /// Returns whether the queue is empty. Never returns `true` while a
+  /// producer is still linking its element, but may return `false` for an
+  /// empty queue while a consumer is still taking the last element.
+  bool empty() const noexcept {
+    // Producers first swap the tail and then link their node to the previous
+    // tail. Hence, the queue is only empty if the stub is the only node.
+    return head_.load(std::memory_order_acquire) == &stub_
+           && stub_.inbox_next_.load(std::memory_order_acquire) == nullptr
+           && tail_.load(std::memory_order_acquire) == &stub_;
+  }
+
+private:
+  void push_node(node_type* x) {
+    x->inbox_next_.store(nullptr, std::memory_order_relaxed);
+    auto prev = tail_.exchange(x, std::memory_order_acq_rel);
+    prev->inbox_next_.store(x, std::memory_order_release);
+  }
+
+  // Requires the consumer lock.
+  node_type* take_node() {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto next = head->inbox_next_.load(std::memory_order_acquire);
+    if (head == &stub_) {
+      // Skip the stub.
+      if (next == nullptr)
+        return nullptr;
+      head_.store(next, std::memory_order_relaxed);
+      head = next;
+      next = next->inbox_next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      head_.store(next, std::memory_order_relaxed);
+      return head;
+    }
+    // A producer is still linking its element after `head`.
+    if (tail_.load(std::memory_order_acquire) != head)
+      return nullptr;
+    // `head` is the last element: put the stub behind it before taking it.
+    push_node(&stub_);
+    next = head->inbox_next_.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      head_.store(next, std::memory_order_relaxed);
+      return head;
+    }
+    return nullptr;
+  }
+
+  // Written only while holding consumer_lock_.
+  std::atomic<node_type*> head_;
+  char pad1_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<node_type*>)];
+
+  // Points to the most recently pushed node.
+  std::atomic<node_type*> tail_;
+  char pad2_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<node_type*>)];
+
+  // Serializes consumers.
+  std::atomic_flag consumer_lock_;
+
+  // Separates the last element from the head once consumers took all others.
+  node_type stub_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// Allocates small memory blocks from per-thread pools with a fixed set of
+/// size classes. Releasing a block on any other thread than its owner pushes
+/// the block to a lock-free list of the owning pool, from which the owner
+/// reclaims it on its next allocation. Pools of terminated threads get adopted
+/// by new threads. Allocations that exceed the largest size class or happen
+/// while the pool is disabled fall back to `malloc`.
+class CAF_CORE_EXPORT memory_pool {
+public:
+  /// Largest block size in bytes served from a pool.
+  static constexpr size_t max_block_size = 1024;
+
+  /// Allocates `size` bytes of memory aligned to `max_align_t`.
+  /// @throws std::bad_alloc
+  static void* allocate(size_t size);
+
+  /// Releases memory obtained by `allocate`. Safe to call from any thread,
+  /// even after disabling the pool.
+  static void deallocate(void* ptr) noexcept;
+
+  /// Enables or disables pooling for all subsequent calls to `allocate`.
+  static void enable(bool flag) noexcept;
+
+  /// Queries whether `allocate` serves memory from per-thread pools.
+  static bool enabled() noexcept;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,104 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "caf/detail/core_export.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/ref_counted.hpp"
+#include "caf/type_id.hpp"
+#include "caf/type_id_list.hpp"
+
+namespace caf::detail {
+
+/// Remembers the type ID lists of deserialized messages, i.e., their shapes.
+/// Deserializing a message with a known shape skips validating each type ID
+/// against the global meta objects as well as interning the list in the
+/// global (mutex-protected) registry of type ID lists. The cache only grows
+/// and has a fixed capacity, which allows concurrent lookups without locking.
+/// Shapes that do not fit into the cache take the regular path.
+class CAF_CORE_EXPORT message_shape_cache : public ref_counted {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Configures how many shapes the cache stores at most.
+  static constexpr size_t capacity = 64;
+
+  /// Configures how many slots `find` and `add` probe before giving up.
+  static constexpr size_t max_probes = 8;
+
+  /// Configures the maximum number of elements in a cached shape. Messages
+  /// with more elements bypass the cache.
+  static constexpr size_t max_shape_size = 16;
+
+  // -- member types -----------------------------------------------------------
+
+  /// A validated list of type IDs.
+  struct shape {
+    /// Interned list of type IDs.
+    type_id_list types;
+
+    /// Stores the sum of the padded sizes of all elements.
+    size_t data_size;
+
+    /// Stores the hash value of `types`.
+    size_t hash;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  message_shape_cache();
+
+  message_shape_cache(const message_shape_cache&) = delete;
+
+  message_shape_cache& operator=(const message_shape_cache&) = delete;
+
+  ~message_shape_cache() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Computes the hash value for the size-prefixed list `ids`.
+  static size_t hash(const type_id_t* ids) noexcept;
+
+  /// Returns the number of stored shapes.
+  size_t size() const noexcept;
+
+  // -- lookup and modifiers ---------------------------------------------------
+
+  /// Returns the shape for the size-prefixed list `ids` with hash value `hash`
+  /// or `nullptr` if the cache does not contain such a shape.
+  /// @note Safe to call from any thread.
+  const shape* find(const type_id_t* ids, size_t hash) const noexcept;
+
+  /// Stores a new shape unless the cache already contains `types` or has no
+  /// free slot left.
+  /// @pre `types` is an interned list with a hash value of `hash`.
+  /// @note Safe to call from any thread.
+  void add(type_id_list types, size_t data_size, size_t hash);
+
+private:
+  std::atomic<const shape*> slots_[capacity];
+};
+
+/// @relates message_shape_cache
+using message_shape_cache_ptr = intrusive_ptr<message_shape_cache>;
+
+} // namespace caf::detail
@@ -0,0 +1,284 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "caf/actor.hpp"
+#include "caf/behavior.hpp"
+#include "caf/downstream.hpp"
+#include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/message_priority.hpp"
+#include "caf/scheduled_actor.hpp"
+#include "caf/spawn_options.hpp"
+#include "caf/stateful_actor.hpp"
+#include "caf/stream_finalize_trait.hpp"
+#include "caf/stream_stage.hpp"
+#include "caf/stream_stage_trait.hpp"
+#include "caf/typed_message_view.hpp"
+
+namespace caf::detail {
+
+/// A stream stage that distributes incoming batches to a fixed set of worker
+/// actors. Each worker owns a copy of the stage state and runs the processing
+/// function on whole batches. The stage emits the results either in the order
+/// of the input batches or as soon as they arrive.
+template <class In, class DownstreamManager, class Process, class Finalize>
+class parallel_stream_stage : public stream_stage<In, DownstreamManager> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = stream_stage<In, DownstreamManager>;
+
+  using input_type = In;
+
+  using output_type = typename DownstreamManager::output_type;
+
+  using trait = stream_stage_trait_t<Process>;
+
+  using state_type = typename trait::state;
+
+  /// Bookkeeping for a single worker.
+  struct worker {
+    /// Handle to the worker actor.
+    actor hdl;
+
+    /// Number of batches the worker did not respond to yet.
+    size_t pending;
+  };
+
+  /// Result of a batch that waits for its predecessors.
+  struct result {
+    /// Number of input elements in the batch.
+    int32_t num_inputs;
+
+    /// Stores whether the worker already responded.
+    bool ready;
+
+    /// Output of the worker.
+    std::vector<output_type> ys;
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// Configures how many batches we assign to each worker at most before
+  /// considering the stage congested. Assigning more than one batch makes sure
+  /// that workers never wait for their next batch.
+  static constexpr size_t batches_per_worker = 2;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  template <class Init>
+  parallel_stream_stage(scheduled_actor* self, size_t num_workers,
+                        bool preserve_order, Init init, Process fun,
+                        Finalize fin)
+    : stream_manager(self), super(self), preserve_order_(preserve_order) {
+    num_workers = std::max(num_workers, size_t{1});
+    workers_.reserve(num_workers);
+    // Linking makes sure that workers never outlive the stage and that the
+    // stage fails if one of its workers fails.
+    for (size_t i = 0; i < num_workers; ++i) {
+      auto hdl = self->spawn<linked>(worker_impl<Init>, init, fun, fin);
+      workers_.emplace_back(worker{std::move(hdl), 0});
+    }
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of batches that wait for a worker to finish.
+  size_t pending_batches() const noexcept {
+    return pending_batches_;
+  }
+
+  // -- overrides --------------------------------------------------------------
+
+  using super::handle;
+
+  void handle(inbound_path*, downstream_msg::batch& x) override {
+    CAF_LOG_TRACE(CAF_ARG(x));
+    using vec_type = std::vector<input_type>;
+    if (auto view = make_typed_message_view<vec_type>(x.xs)) {
+      dispatch(std::move(get<0>(view)));
+      return;
+    }
+    CAF_LOG_ERROR("received unexpected batch type (dropped)");
+  }
+
+  bool done() const override {
+    return pending_batches_ == 0 && super::done();
+  }
+
+  bool congested() const noexcept override {
+    return this->out_.capacity() == 0
+           || pending_batches_ >= workers_.size() * batches_per_worker;
+  }
+
+  int32_t acquire_credit(inbound_path*, int32_t desired) override {
+    // Elements at the workers count as buffered, since their results still
+    // have to pass through our output buffer.
+    auto result = static_cast<int64_t>(desired) - pending_elements_;
+    return result > 0 ? static_cast<int32_t>(result) : 0;
+  }
+
+protected:
+  void finalize(const error& reason) override {
+    // Unlink first to keep the workers from taking down the actor.
+    for (auto& w : workers_) {
+      this->self()->unlink_from(w.hdl);
+      this->self()->send_exit(w.hdl, reason);
+    }
+    workers_.clear();
+    results_.clear();
+  }
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  template <class Init>
+  static behavior worker_impl(stateful_actor<state_type>* self, Init init,
+                              Process fun, Finalize fin) {
+    init(self->state);
+    self->set_exit_handler([self, fin](exit_msg& x) {
+      // The handler must be const-callable, but `invoke` takes a mutable ref.
+      auto f = fin;
+      stream_finalize_trait<Finalize, state_type>::invoke(f, self->state,
+                                                          x.reason);
+      self->quit(std::move(x.reason));
+    });
+    return {
+      [self, fun](std::vector<input_type>& xs) mutable {
+        typename downstream<output_type>::queue_type buf;
+        downstream<output_type> out{buf};
+        trait::process::invoke(fun, self->state, out, xs);
+        std::vector<output_type> ys;
+        ys.reserve(buf.size());
+        std::move(buf.begin(), buf.end(), std::back_inserter(ys));
+        return ys;
+      },
+    };
+  }
+
+  void dispatch(std::vector<input_type> xs) {
+    // Pick the worker with the fewest pending batches.
+    auto less = [](const worker& x, const worker& y) {
+      return x.pending < y.pending;
+    };
+    auto i = std::min_element(workers_.begin(), workers_.end(), less);
+    if (i == workers_.end()) {
+      CAF_LOG_ERROR("received a batch after finalizing the stage (dropped)");
+      return;
+    }
+    auto index = static_cast<size_t>(std::distance(workers_.begin(), i));
+    auto num_inputs = static_cast<int32_t>(xs.size());
+    auto seq = first_seq_ + results_.size();
+    if (preserve_order_)
+      results_.emplace_back(result{num_inputs, false, {}});
+    ++i->pending;
+    ++pending_batches_;
+    pending_elements_ += num_inputs;
+    auto self = this->self();
+    auto req_id = self->new_request_id(message_priority::normal);
+    i->hdl->enqueue(make_mailbox_element(self->ctrl(), req_id, {},
+                                         std::move(xs)),
+                    self->context());
+    intrusive_ptr<parallel_stream_stage> strong_this{this};
+    self->add_multiplexed_response_handler(
+      req_id.response_id(),
+      behavior{
+        [strong_this, index, seq, num_inputs](std::vector<output_type>& ys) {
+          strong_this->deliver(index, seq, num_inputs, ys);
+        },
+        [strong_this](error& err) { strong_this->fail(std::move(err)); },
+      });
+  }
+
+  void deliver(size_t index, uint64_t seq, int32_t num_inputs,
+               std::vector<output_type>& ys) {
+    // Drop late responses after the stage stopped.
+    if (workers_.empty())
+      return;
+    --workers_[index].pending;
+    if (preserve_order_) {
+      auto& entry = results_[seq - first_seq_];
+      entry.ready = true;
+      entry.ys = std::move(ys);
+      while (!results_.empty() && results_.front().ready) {
+        auto& front = results_.front();
+        emit(front.num_inputs, front.ys);
+        results_.pop_front();
+        ++first_seq_;
+      }
+    } else {
+      emit(num_inputs, ys);
+    }
+    this->push();
+    if (done()) {
+      CAF_LOG_DEBUG("parallel stage is done and closes its manager");
+      stream_manager_ptr strong_this{this};
+      this->self()->erase_stream_manager(strong_this);
+      this->stop();
+    }
+  }
+
+  void emit(int32_t num_inputs, std::vector<output_type>& ys) {
+    auto& buf = this->out_.buf();
+    buf.insert(buf.end(), std::make_move_iterator(ys.begin()),
+               std::make_move_iterator(ys.end()));
+    pending_elements_ -= num_inputs;
+    --pending_batches_;
+  }
+
+  void fail(error reason) {
+    if (workers_.empty())
+      return;
+    CAF_LOG_ERROR("worker of a parallel stage failed:" << reason);
+    stream_manager_ptr strong_this{this};
+    this->self()->erase_stream_manager(strong_this);
+    this->stop(std::move(reason));
+  }
+
+  // -- member variables -------------------------------------------------------
+
+  /// Stores whether we emit results in the order of the input batches.
+  bool preserve_order_;
+
+  /// Stores all worker actors of this stage.
+  std::vector<worker> workers_;
+
+  /// Number of batches that wait for a worker to finish.
+  size_t pending_batches_ = 0;
+
+  /// Number of input elements in all pending batches.
+  int64_t pending_elements_ = 0;
+
+  /// Sequence number of the first element in `results_`.
+  uint64_t first_seq_ = 0;
+
+  /// Results in the order of the input batches. Only used when preserving the
+  /// order of the input.
+  std::deque<result> results_;
+};
+
+} // namespace caf::detail
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <type_traits>
 #include <vector>
 
 #include "caf/actor_cast.hpp"
@@ -64,4 +65,26 @@ void profiled_send(Self* self, SelfHandle&& src, const Handle& dst,
   }
 }
 
+template <class Self, class SelfHandle, class Handle, class Range>
+void profiled_send_batch(Self* self, SelfHandle&& src, const Handle& dst,
+                         message_id msg_id, execution_unit* context,
+                         Range&& xs) {
+  CAF_IGNORE_UNUSED(self);
+  if (dst) {
+    strong_actor_ptr sender{std::forward<SelfHandle>(src)};
+    mailbox_element_chain chain;
+    for (auto&& x : xs) {
+      mailbox_element_ptr element;
+      if constexpr (std::is_lvalue_reference<Range>::value)
+        element = make_mailbox_element(sender, msg_id, no_stages, x);
+      else
+        element = make_mailbox_element(sender, msg_id, no_stages,
+                                       std::move(x));
+      CAF_BEFORE_SENDING(self, *element);
+      chain.push_back(std::move(element));
+    }
+    dst->enqueue_batch(std::move(chain), context);
+  }
+}
+
 } // namespace caf::detail
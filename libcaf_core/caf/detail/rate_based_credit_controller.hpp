@@ -0,0 +1,168 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/actor_clock.hpp"
+#include "caf/credit_controller.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf::detail {
+
+/// Computes credit for an attached source by estimating the bottleneck
+/// throughput and the minimum round-trip time (RTT) of the stream, similar to
+/// the BBR congestion control algorithm. The controller assigns enough credit
+/// to cover the bandwidth-delay product plus one credit round, which keeps the
+/// pipe full without letting batches pile up at the consumer.
+class rate_based_credit_controller : public credit_controller {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = credit_controller;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Configures how many credit rounds the bottleneck rate estimate covers.
+  static constexpr size_t rate_window = 10;
+
+  /// Configures how long a minimum RTT sample remains valid.
+  static constexpr timespan min_rtt_window = timespan{10'000'000'000};
+
+  /// Configures how much credit we assign relative to the bandwidth-delay
+  /// product. A gain of 2 leaves room for the throughput to grow.
+  static constexpr int64_t credit_gain = 2;
+
+  /// Configures after how many rounds without significant throughput growth
+  /// we leave the startup phase.
+  static constexpr int32_t startup_rounds = 3;
+
+  /// Stores how many elements we buffer at most after the handshake.
+  int32_t initial_buffer_size = 50;
+
+  /// Stores how many elements we allow per batch after the handshake.
+  int32_t initial_batch_size = 10;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit rate_based_credit_controller(scheduled_actor* self);
+
+  ~rate_based_credit_controller() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the estimated bottleneck throughput in elements per second.
+  int64_t bottleneck_rate() const noexcept;
+
+  /// Returns the minimum RTT or `timespan::max()` if the controller did not
+  /// measure the RTT yet.
+  timespan min_rtt() const noexcept {
+    return min_rtt_;
+  }
+
+  /// Returns whether the controller still doubles credit each round to
+  /// discover the available throughput.
+  bool in_startup() const noexcept {
+    return startup_;
+  }
+
+  // -- overrides --------------------------------------------------------------
+
+  void before_processing(downstream_msg::batch& x) override;
+
+  void after_processing(downstream_msg::batch& x) override;
+
+  assignment compute_initial() override;
+
+  assignment compute(timespan cycle, int32_t downstream_capacity) override;
+
+  assignment compute_bridge() override;
+
+  int32_t threshold() const noexcept override;
+
+  void credit_granted(int32_t outstanding, int32_t granted) override;
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  actor_clock::time_point now() noexcept;
+
+  void add_rtt_sample(timespan rtt, actor_clock::time_point t);
+
+  // -- member variables -------------------------------------------------------
+
+  /// Number of elements received in the current round.
+  int64_t received_ = 0;
+
+  /// Number of elements received since the handshake.
+  int64_t total_received_ = 0;
+
+  /// Elapsed time for processing all elements of the current round.
+  timespan processing_time_{0};
+
+  /// Timestamp of the last call to `before_processing`.
+  actor_clock::time_point processing_begin_;
+
+  /// Timestamp of the last credit round.
+  actor_clock::time_point last_round_;
+
+  /// Stores delivery rate samples of the last rounds in elements per second.
+  std::array<int64_t, rate_window> rate_samples_{};
+
+  /// Position of the next rate sample.
+  size_t rate_sample_pos_ = 0;
+
+  /// Stores the minimum RTT in the current window.
+  timespan min_rtt_ = timespan::max();
+
+  /// Stores when we took the `min_rtt_` sample.
+  actor_clock::time_point min_rtt_stamp_;
+
+  /// Value of `total_received_` after which a batch must have used the credit
+  /// of the pending RTT probe or -1 if no probe is pending.
+  int64_t probe_marker_ = -1;
+
+  /// Stores when we granted the credit for the pending RTT probe.
+  actor_clock::time_point probe_start_;
+
+  /// Stores whether we still probe for the available throughput.
+  bool startup_ = true;
+
+  /// Stores the highest rate we have seen during startup.
+  int64_t startup_rate_ = 0;
+
+  /// Counts consecutive startup rounds without significant rate growth.
+  int32_t startup_stalls_ = 0;
+
+  /// Stores the desired per-batch complexity.
+  timespan complexity_;
+
+  /// Stores how much credit the source should have at most.
+  int32_t credit_ = initial_buffer_size;
+
+  /// Stores how many elements each batch should contain.
+  int32_t batch_size_ = initial_batch_size;
+
+  /// Stores the credit level for granting bridge credit.
+  int32_t threshold_ = -1;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,209 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "caf/detail/core_export.hpp"
+
+namespace caf::detail {
+
+/// A hierarchical timing wheel as described by Varghese and Lauck in "Hashed
+/// and Hierarchical Timing Wheels". Inserting and removing a timer are
+/// constant-time operations that never allocate memory, since the wheel links
+/// nodes intrusively. Each level has 64 slots and covers 64 times the range of
+/// the level below. Timers beyond the range of the top level wait in its last
+/// slot and get re-inserted whenever the top level cascades.
+///
+/// The wheel counts time in abstract ticks. Users convert time points to ticks
+/// and must round deadlines up to never fire a timer early.
+/// @note This class is not thread-safe.
+class CAF_CORE_EXPORT timing_wheel {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using tick_type = uint64_t;
+
+  /// Base type for all timers in the wheel.
+  struct node {
+    /// Links to the siblings in the same slot.
+    node* prev = nullptr;
+
+    /// Links to the siblings in the same slot.
+    node* next = nullptr;
+
+    /// Expiry time of this timer.
+    tick_type due = 0;
+
+    /// Position of this node in the wheel, set by `insert`.
+    uint8_t level = 0;
+
+    /// Position of this node in the wheel, set by `insert`.
+    uint8_t slot = 0;
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  static constexpr size_t slot_bits = 6;
+
+  static constexpr size_t num_slots = size_t{1} << slot_bits;
+
+  static constexpr size_t num_levels = 6;
+
+  /// Denotes an unknown or infinite point in time.
+  static constexpr tick_type infinite = std::numeric_limits<tick_type>::max();
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit timing_wheel(tick_type start = 0);
+
+  timing_wheel(const timing_wheel&) = delete;
+
+  timing_wheel& operator=(const timing_wheel&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the current time of the wheel.
+  tick_type now() const noexcept {
+    return now_;
+  }
+
+  /// Returns the number of timers in the wheel.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns whether the wheel contains no timers.
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// Returns the next tick at which `advance` has work to do, i.e., either
+  /// fires a timer or moves timers to a lower level. Returns `now()` if timers
+  /// have already expired and `infinite` if the wheel is empty.
+  tick_type next_event() const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds `x` to the wheel. Timers that are already due fire on the next call
+  /// to `advance`.
+  /// @pre `x` is not part of any wheel
+  void insert(node* x) noexcept;
+
+  /// Removes `x` from the wheel.
+  /// @pre `x` is part of this wheel
+  void erase(node* x) noexcept;
+
+  /// Advances the time of the wheel to `t` and calls `f` for each timer that
+  /// expires in the process. Timers that expire at an earlier tick fire first.
+  /// The wheel drops all references to a timer before passing it to `f`.
+  template <class F>
+  void advance(tick_type t, F f) {
+    fire_ready(f);
+    for (;;) {
+      auto next = next_event();
+      if (next > t) {
+        if (t > now_)
+          now_ = t;
+        return;
+      }
+      now_ = next;
+      cascade();
+      fire_ready(f);
+    }
+  }
+
+  /// Removes all timers and calls `f` for each one of them.
+  template <class F>
+  void clear(F f) {
+    for (auto& level : slots_)
+      for (auto& xs : level)
+        drain(xs, f);
+    drain(ready_, f);
+    occupied_.fill(0);
+    size_ = 0;
+  }
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  /// A doubly linked list of timers.
+  struct list {
+    node* head = nullptr;
+    node* tail = nullptr;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Moves timers from higher levels down and moves expired timers from the
+  /// current slot of level 0 to the ready list.
+  void cascade() noexcept;
+
+  /// Appends `x` to `xs`.
+  static void link(list& xs, node* x) noexcept;
+
+  /// Removes `x` from `xs`.
+  static void unlink(list& xs, node* x) noexcept;
+
+  template <class F>
+  void fire_ready(F& f) {
+    while (ready_.head != nullptr) {
+      auto x = ready_.head;
+      unlink(ready_, x);
+      --size_;
+      f(x);
+    }
+  }
+
+  template <class F>
+  static void drain(list& xs, F& f) {
+    auto x = xs.head;
+    xs.head = nullptr;
+    xs.tail = nullptr;
+    while (x != nullptr) {
+      auto next = x->next;
+      x->prev = nullptr;
+      x->next = nullptr;
+      f(x);
+      x = next;
+    }
+  }
+
+  // -- member variables -------------------------------------------------------
+
+  /// Current time of the wheel.
+  tick_type now_;
+
+  /// Number of timers in the wheel.
+  size_t size_;
+
+  /// Stores one bit per slot to quickly find the next non-empty slot.
+  std::array<uint64_t, num_levels> occupied_;
+
+  /// Stores the timers for each slot.
+  std::array<std::array<list, num_slots>, num_levels> slots_;
+
+  /// Lists expired timers.
+  list ready_;
+};
+
+} // namespace caf::detail
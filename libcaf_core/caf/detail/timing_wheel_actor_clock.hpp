@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "caf/actor_clock.hpp"
+#include "caf/detail/core_export.hpp"
+#include "caf/detail/timing_wheel.hpp"
+#include "caf/fwd.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf::detail {
+
+/// A thread-safe actor clock that stores timeouts and delayed messages in
+/// hierarchical timing wheels. Setting or cancelling a timeout takes constant
+/// time and does not allocate additional memory for bookkeeping. The clock
+/// spreads its entries over multiple shards by actor ID, each with its own
+/// mutex, so that actors running on different worker threads rarely contend
+/// for the same lock. A dedicated thread calls `run_dispatch_loop` to ship
+/// expired entries.
+class CAF_CORE_EXPORT timing_wheel_actor_clock : public actor_clock {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = actor_clock;
+
+  struct shard;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// @param num_shards Number of independent timing wheels.
+  /// @param resolution Length of a single tick. The clock never ships an entry
+  ///                   early, but may ship it up to one tick late.
+  timing_wheel_actor_clock(size_t num_shards, timespan resolution);
+
+  timing_wheel_actor_clock(const timing_wheel_actor_clock&) = delete;
+
+  timing_wheel_actor_clock& operator=(const timing_wheel_actor_clock&) = delete;
+
+  ~timing_wheel_actor_clock() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of shards.
+  size_t num_shards() const noexcept {
+    return shards_.size();
+  }
+
+  /// Returns the number of pending timeouts and delayed messages.
+  size_t pending() const;
+
+  // -- overridden member functions --------------------------------------------
+
+  void set_ordinary_timeout(time_point t, abstract_actor* self,
+                            std::string type, uint64_t id) override;
+
+  void set_multi_timeout(time_point t, abstract_actor* self, std::string type,
+                         uint64_t id) override;
+
+  void set_request_timeout(time_point t, abstract_actor* self,
+                           message_id id) override;
+
+  void cancel_ordinary_timeout(abstract_actor* self, std::string type) override;
+
+  void cancel_request_timeout(abstract_actor* self, message_id id) override;
+
+  void cancel_timeouts(abstract_actor* self) override;
+
+  void schedule_message(time_point t, strong_actor_ptr receiver,
+                        mailbox_element_ptr content) override;
+
+  void schedule_message(time_point t, group target, strong_actor_ptr sender,
+                        message content) override;
+
+  void cancel_all() override;
+
+  // -- dispatching ------------------------------------------------------------
+
+  /// Ships all entries that expired until now.
+  /// @returns The number of shipped entries.
+  size_t trigger_expired_timeouts();
+
+  void run_dispatch_loop();
+
+  void cancel_dispatch_loop();
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  shard& shard_for(actor_id id);
+
+  timing_wheel::tick_type to_tick(time_point t) const noexcept;
+
+  time_point to_time_point(timing_wheel::tick_type t) const noexcept;
+
+  /// Wakes up the dispatcher if it sleeps past `due`.
+  void notify_dispatcher(timing_wheel::tick_type due);
+
+  // -- member variables -------------------------------------------------------
+
+  /// Reference point for converting time points to ticks.
+  time_point epoch_;
+
+  /// Length of a single tick.
+  duration_type resolution_;
+
+  /// Independent timing wheels.
+  std::vector<std::unique_ptr<shard>> shards_;
+
+  /// Stores the tick until which the dispatcher sleeps. Set to 0 while the
+  /// dispatcher is running.
+  std::atomic<timing_wheel::tick_type> wakeup_tick_;
+
+  /// Protects `dirty_` and `shutdown_`.
+  std::mutex mtx_;
+
+  /// Signals the dispatcher.
+  std::condition_variable cv_;
+
+  /// Signals the dispatcher to recompute its wakeup time.
+  bool dirty_;
+
+  /// Signals the dispatcher to stop.
+  bool shutdown_;
+};
+
+} // namespace caf::detail
@@ -0,0 +1,192 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "caf/config.hpp"
+
+namespace caf::detail {
+
+/// A lock-free work-stealing deque as described by Chase and Lev in "Dynamic
+/// Circular Work-Stealing Deque", using the memory orderings from Lê et al. in
+/// "Correct and Efficient Work-Stealing for Weak Memory Models".
+///
+/// Only the owning thread may call `push` and `take`, which operate on the
+/// bottom of the deque in LIFO order. Any thread may call `steal`, which
+/// removes the oldest element at the top. The deque starts with a fixed
+/// capacity and grows on demand. Retired buffers stay alive until the deque
+/// gets destroyed, because concurrent thieves may still read from them.
+template <class T>
+class work_stealing_deque {
+public:
+  using value_type = T;
+
+  using pointer = value_type*;
+
+  static constexpr size_t default_capacity = 64;
+
+  /// @pre `initial_capacity` is a power of two
+  explicit work_stealing_deque(size_t initial_capacity = default_capacity)
+    : top_(0), bottom_(0) {
+    CAF_ASSERT(initial_capacity > 0);
+    CAF_ASSERT((initial_capacity & (initial_capacity - 1)) == 0);
+    buffers_.emplace_back(new buffer(initial_capacity));
+    buf_ = buffers_.back().get();
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  /// Inserts `value` at the bottom of the deque.
+  /// @warning Must only be called from the owning thread.
+  void push(pointer value) {
+    CAF_ASSERT(value != nullptr);
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_acquire);
+    auto buf = buf_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(buf->capacity()) - 1)
+      buf = grow(buf, t, b);
+    buf->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Removes the most recently pushed element, returns `nullptr` if the deque
+  /// is empty.
+  /// @warning Must only be called from the owning thread.
+  pointer take() {
+    auto b = bottom_.load(std::memory_order_relaxed) - 1;
+    auto buf = buf_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Deque is empty.
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto result = buf->get(b);
+    if (t == b) {
+      // Last element, race against thieves for it.
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+        result = nullptr;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// Removes the oldest element, returns `nullptr` if the deque is empty or if
+  /// this thread lost a race against the owner or another thief.
+  /// @note Safe to call from any thread.
+  pointer steal() {
+    auto t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+    auto buf = buf_.load(std::memory_order_acquire);
+    auto result = buf->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return result;
+  }
+
+  /// Returns whether the deque is empty. The result is only a snapshot when
+  /// called concurrently to `push`, `take` or `steal`.
+  bool empty() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  /// Returns the number of elements in the deque. The result is only a
+  /// snapshot when called concurrently to `push`, `take` or `steal`.
+  size_t size() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0u;
+  }
+
+  /// Returns the capacity of the current buffer.
+  size_t capacity() const noexcept {
+    return buf_.load(std::memory_order_relaxed)->capacity();
+  }
+
+private:
+  class buffer {
+  public:
+    explicit buffer(size_t capacity)
+      : mask_(capacity - 1), slots_(new std::atomic<pointer>[capacity]) {
+      // nop
+    }
+
+    size_t capacity() const noexcept {
+      return mask_ + 1;
+    }
+
+    pointer get(int64_t index) const noexcept {
+      return slots_[static_cast<size_t>(index) & mask_].load(
+        std::memory_order_relaxed);
+    }
+
+    void put(int64_t index, pointer value) noexcept {
+      slots_[static_cast<size_t>(index) & mask_].store(
+        value, std::memory_order_relaxed);
+    }
+
+  private:
+    size_t mask_;
+    std::unique_ptr<std::atomic<pointer>[]> slots_;
+  };
+
+  // Called by the owner only.
+  buffer* grow(buffer* old_buf, int64_t t, int64_t b) {
+    buffers_.emplace_back(new buffer(old_buf->capacity() * 2));
+    auto new_buf = buffers_.back().get();
+    for (auto i = t; i != b; ++i)
+      new_buf->put(i, old_buf->get(i));
+    buf_.store(new_buf, std::memory_order_release);
+    return new_buf;
+  }
+
+  // Read and written by thieves and the owner.
+  std::atomic<int64_t> top_;
+  char pad1_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+  // Written by the owner only.
+  std::atomic<int64_t> bottom_;
+  char pad2_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+
+  // Points to the active buffer, i.e., the last element of `buffers_`.
+  std::atomic<buffer*> buf_;
+
+  // Stores the active buffer plus all retired buffers. Accessed by the owner
+  // only.
+  std::vector<std::unique_ptr<buffer>> buffers_;
+};
+
+} // namespace caf::detail
@@ -18,10 +18,11 @@
 
 #pragma once
 
-#include <deque>
 #include <vector>
 
+#include "caf/detail/circular_buffer.hpp"
 #include "caf/message.hpp"
+#include "caf/span.hpp"
 
 namespace caf {
 
@@ -32,7 +33,7 @@ public:
   // -- member types -----------------------------------------------------------
 
   /// A queue of items for temporary storage before moving them into chunks.
-  using queue_type = std::deque<T>;
+  using queue_type = detail::circular_buffer<T>;
 
   // -- constructors, destructors, and assignment operators --------------------
 
@@ -52,6 +53,12 @@ public:
     buf_.insert(buf_.end(), first, last);
   }
 
+  /// Appends `n` default-constructed elements and returns them as contiguous
+  /// storage, which allows sources to generate elements in place.
+  span<T> extend(size_t n) {
+    return buf_.extend(n);
+  }
+
   // @private
   queue_type& buf() {
     return buf_;
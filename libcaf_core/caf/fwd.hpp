@@ -39,6 +39,7 @@ template <class> class intrusive_cow_ptr;
 template <class> class intrusive_ptr;
 template <class> class optional;
 template <class> class param;
+template <class> class shared_broadcast_downstream_manager;
 template <class> class span;
 template <class> class stream;
 template <class> class stream_sink;
@@ -121,6 +122,7 @@ class ipv6_endpoint;
 class ipv6_subnet;
 class local_actor;
 class mailbox_element;
+class mailbox_element_chain;
 class message;
 class message_builder;
 class message_handler;
@@ -283,6 +285,7 @@ class disposer;
 class dynamic_message_data;
 class group_manager;
 class message_data;
+class message_shape_cache;
 class private_thread;
 class uri_impl;
 
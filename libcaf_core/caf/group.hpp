@@ -21,6 +21,7 @@
 #include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "caf/abstract_group.hpp"
 #include "caf/detail/comparable.hpp"
@@ -107,6 +108,9 @@ public:
                     make_message(std::forward<Ts>(xs)...), ctx);
   }
 
+  void eq_batch_impl(message_id mid, strong_actor_ptr sender,
+                     execution_unit* ctx, std::vector<message> xs) const;
+
   bool subscribe(strong_actor_ptr who) const {
     if (!ptr_)
       return false;
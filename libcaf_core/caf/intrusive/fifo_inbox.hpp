@@ -108,6 +108,13 @@ public:
     return push_back(new value_type(std::forward<Ts>(xs)...));
   }
 
+  /// Appends the pre-linked elements from `first` to `last` (in LIFO order)
+  /// to the inbox at once. Leaves ownership with the caller if the inbox has
+  /// been closed.
+  inbox_result splice_back(pointer first, pointer last) noexcept {
+    return inbox_.splice_front(first, last);
+  }
+
   // -- backwards compatibility ------------------------------------------------
 
   /// @cond PRIVATE
@@ -86,6 +86,30 @@ public:
     return push_front(x.release());
   }
 
+  /// Tries to enqueue a list of elements to the inbox with a single CAS
+  /// operation. The elements from `first` to `last` must already be linked
+  /// via their `next` pointer in LIFO order, i.e., `first` is the newest
+  /// element. Unlike `push_front`, this function leaves ownership of the list
+  /// with the caller if the inbox has been closed.
+  /// @threadsafe
+  inbox_result splice_front(pointer first, pointer last) noexcept {
+    CAF_ASSERT(first != nullptr);
+    CAF_ASSERT(last != nullptr);
+    pointer e = stack_.load();
+    auto eof = stack_closed_tag();
+    auto blk = reader_blocked_tag();
+    while (e != eof) {
+      // A tag is never part of a non-empty list.
+      last->next = e != blk ? e : nullptr;
+      if (stack_.compare_exchange_strong(e, first))
+        return e == reader_blocked_tag() ? inbox_result::unblocked_reader
+                                         : inbox_result::success;
+      // Continue with new value of `e`.
+    }
+    last->next = nullptr;
+    return inbox_result::queue_closed;
+  }
+
   /// Tries to enqueue a new element to the mailbox.
   /// @threadsafe
   template <class... Ts>
@@ -23,6 +23,7 @@
 
 #include "caf/actor_control_block.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/memory_pool.hpp"
 #include "caf/intrusive/singly_linked.hpp"
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
@@ -71,6 +72,16 @@ public:
   mailbox_element& operator=(mailbox_element&&) = delete;
   mailbox_element& operator=(const mailbox_element&) = delete;
 
+  // -- memory management ------------------------------------------------------
+
+  static void* operator new(size_t size) {
+    return detail::memory_pool::allocate(size);
+  }
+
+  static void operator delete(void* ptr) noexcept {
+    detail::memory_pool::deallocate(ptr);
+  }
+
   // -- backward compatibility -------------------------------------------------
 
   message& content() noexcept {
@@ -114,4 +125,83 @@ make_mailbox_element(strong_actor_ptr sender, message_id id,
                                            std::forward<Ts>(xs)...));
 }
 
+/// Owns a list of mailbox elements for the same receiver, which allows senders
+/// to hand over many messages at once via `abstract_actor::enqueue_batch`.
+/// The chain links its elements in reverse order, i.e., `head()` points to the
+/// most recently added element. This is the layout of the receiver's inbox,
+/// which can therefore adopt the whole chain with a single CAS operation.
+/// @relates mailbox_element
+class CAF_CORE_EXPORT mailbox_element_chain {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  mailbox_element_chain() noexcept;
+
+  mailbox_element_chain(mailbox_element_chain&& other) noexcept;
+
+  mailbox_element_chain& operator=(mailbox_element_chain&& other) noexcept;
+
+  mailbox_element_chain(const mailbox_element_chain&) = delete;
+
+  mailbox_element_chain& operator=(const mailbox_element_chain&) = delete;
+
+  ~mailbox_element_chain();
+
+  // -- properties -------------------------------------------------------------
+
+  bool empty() const noexcept {
+    return head_ == nullptr;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns the most recently added element.
+  mailbox_element* head() const noexcept {
+    return head_;
+  }
+
+  /// Returns the least recently added element.
+  mailbox_element* tail() const noexcept {
+    return tail_;
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Adds `ptr` as the newest element to the chain.
+  void push_back(mailbox_element_ptr ptr) noexcept;
+
+  /// Drops ownership of all elements without destroying them. Call after
+  /// transferring the elements to an inbox.
+  void release() noexcept;
+
+  /// Removes all elements from the chain and passes them to `f` in the order
+  /// they were added.
+  template <class F>
+  void drain(F f) {
+    // Reverse the links first to visit elements in FIFO order.
+    intrusive::singly_linked<mailbox_element>* prev = nullptr;
+    auto ptr = head_;
+    while (ptr != nullptr) {
+      auto next = ptr->next;
+      ptr->next = prev;
+      prev = ptr;
+      ptr = static_cast<mailbox_element*>(next);
+    }
+    release();
+    while (prev != nullptr) {
+      auto next = prev->next;
+      prev->next = nullptr;
+      f(mailbox_element_ptr{static_cast<mailbox_element*>(prev)});
+      prev = next;
+    }
+  }
+
+private:
+  mailbox_element* head_;
+  mailbox_element* tail_;
+  size_t size_;
+};
+
 } // namespace caf
@@ -25,6 +25,7 @@
 #include "caf/detail/comparable.hpp"
 #include "caf/detail/core_export.hpp"
 #include "caf/detail/implicit_conversions.hpp"
+#include "caf/detail/memory_pool.hpp"
 #include "caf/detail/message_data.hpp"
 #include "caf/detail/padded_size.hpp"
 #include "caf/fwd.hpp"
@@ -186,9 +187,7 @@ message make_message(Ts&&... xs) {
   static constexpr size_t data_size
     = sizeof(message_data) + (padded_size_v<strip_and_convert_t<Ts>> + ...);
   auto types = make_type_id_list<strip_and_convert_t<Ts>...>();
-  auto vptr = malloc(data_size);
-  if (vptr == nullptr)
-    throw std::bad_alloc();
+  auto vptr = memory_pool::allocate(data_size);
   auto raw_ptr = new (vptr) message_data(types);
   intrusive_cow_ptr<message_data> ptr{raw_ptr, false};
   message_data_init(raw_ptr->storage(), std::forward<Ts>(xs)...);
@@ -19,7 +19,10 @@
 #pragma once
 
 #include <chrono>
+#include <iterator>
 #include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include "caf/actor.hpp"
 #include "caf/actor_cast.hpp"
@@ -92,6 +95,51 @@ public:
                           self->context(), std::forward<Ts>(xs)...);
   }
 
+  /// Sends each element of `xs` as a separate asynchronous message to `dest`
+  /// with priority `P`. Hands all messages over to the receiver at once, which
+  /// schedules the receiver at most once for the entire batch.
+  template <message_priority P = message_priority::normal, class Dest,
+            class Range>
+  detail::enable_if_t<!std::is_same<group, Dest>::value>
+  send_batch(const Dest& dest, Range&& xs) {
+    using value_type = detail::strip_and_convert_t<decltype(*std::begin(xs))>;
+    static_assert(detail::sendable<value_type>,
+                  "at least one type has no ID, "
+                  "did you forgot to announce it via CAF_ADD_TYPE_ID?");
+    detail::type_list<value_type> args_token;
+    type_check(dest, args_token);
+    auto self = dptr();
+    detail::profiled_send_batch(self, self->ctrl(), dest, make_message_id(P),
+                                self->context(), std::forward<Range>(xs));
+  }
+
+  /// Sends each element of `xs` as a separate asynchronous message to all
+  /// subscribers of `dest` with priority `P`. Each subscriber receives the
+  /// entire batch at once.
+  template <message_priority P = message_priority::normal, class Range>
+  void send_batch(const group& dest, Range&& xs) {
+    using value_type = detail::strip_and_convert_t<decltype(*std::begin(xs))>;
+    static_assert(detail::sendable<value_type>,
+                  "at least one type has no ID, "
+                  "did you forgot to announce it via CAF_ADD_TYPE_ID?");
+    static_assert(!statically_typed<Subtype>(),
+                  "statically typed actors can only send() to other "
+                  "statically typed actors; use anon_send() when "
+                  "communicating to groups");
+    if (dest) {
+      std::vector<message> msgs;
+      for (auto&& x : xs) {
+        if constexpr (std::is_lvalue_reference<Range>::value)
+          msgs.emplace_back(make_message(x));
+        else
+          msgs.emplace_back(make_message(std::move(x)));
+      }
+      auto self = dptr();
+      dest->eq_batch_impl(make_message_id(P), self->ctrl(), self->context(),
+                          std::move(msgs));
+    }
+  }
+
   template <message_priority P = message_priority::normal, class Dest = actor,
             class... Ts>
   void anon_send(const Dest& dest, Ts&&... xs) {
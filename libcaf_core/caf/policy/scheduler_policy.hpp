@@ -61,6 +61,11 @@ public:
   template <class Worker>
   resumable* dequeue(Worker* self);
 
+  /// Performs initialization on the worker thread before the worker starts
+  /// dequeueing jobs.
+  template <class Worker>
+  void init_worker(Worker* self);
+
   /// Performs cleanup action before a shutdown takes place.
   template <class Worker>
   void before_shutdown(Worker* self);
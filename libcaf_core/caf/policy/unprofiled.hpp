@@ -32,6 +32,13 @@ class CAF_CORE_EXPORT unprofiled {
 public:
   virtual ~unprofiled();
 
+  /// Performs initialization on the worker thread before the worker starts
+  /// dequeueing jobs.
+  template <class Worker>
+  void init_worker(Worker*) {
+    // nop
+  }
+
   /// Performs cleanup action before a shutdown takes place.
   template <class Worker>
   void before_shutdown(Worker*) {
@@ -19,17 +19,18 @@
 #pragma once
 
 #include <array>
-#include <chrono>
-#include <condition_variable>
+#include <atomic>
 #include <cstddef>
-#include <deque>
-#include <mutex>
+#include <memory>
 #include <random>
-#include <thread>
+#include <vector>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/detail/core_export.hpp"
-#include "caf/detail/double_ended_queue.hpp"
+#include "caf/detail/cpu_topology.hpp"
+#include "caf/detail/eventcount.hpp"
+#include "caf/detail/injection_queue.hpp"
+#include "caf/detail/work_stealing_deque.hpp"
 #include "caf/policy/unprofiled.hpp"
 #include "caf/resumable.hpp"
 #include "caf/timespan.hpp"
@@ -42,8 +43,11 @@ class CAF_CORE_EXPORT work_stealing : public unprofiled {
 public:
   ~work_stealing() override;
 
-  // A thread-safe queue implementation.
-  using queue_type = detail::double_ended_queue<resumable>;
+  // A lock-free deque that only the owning worker pushes to.
+  using queue_type = detail::work_stealing_deque<resumable>;
+
+  // A lock-free queue for jobs enqueued by other threads.
+  using inbox_type = detail::injection_queue<resumable>;
 
   // configuration for aggressive/moderate/relaxed poll strategies.
   struct poll_strategy {
@@ -53,14 +57,8 @@ public:
     timespan sleep_duration;
   };
 
-  // what is needed to implement the waiting strategy.
-  struct wait_strategy {
-    std::mutex lock;
-    std::condition_variable cv;
-    bool sleeping{false};
-  };
-
-  // The coordinator has only a counter for round-robin enqueue to its workers.
+  // The coordinator has a counter for round-robin enqueue to its workers and
+  // parks idle workers.
   struct coordinator_data {
     inline explicit coordinator_data(scheduler::abstract_coordinator*)
       : next_worker(0) {
@@ -68,6 +66,10 @@ public:
     }
 
     std::atomic<size_t> next_worker;
+
+    // Idle workers wait on this eventcount. Its waiter count doubles as the
+    // number of idle workers.
+    detail::eventcount idle;
   };
 
   // Holds job job queue of a worker and a random number generator.
@@ -76,15 +78,52 @@ public:
     worker_data(const worker_data& other);
 
     // This queue is exposed to other workers that may attempt to steal jobs
-    // from it and the central scheduling unit can push new jobs to the queue.
+    // from it, but only the worker itself pushes new jobs to the queue.
     queue_type queue;
+    // Receives jobs from the central scheduling unit and from other threads.
+    // Other workers may steal from this queue as well.
+    inbox_type inbox;
     // needed to generate pseudo random numbers
     std::default_random_engine rengine;
     std::uniform_int_distribution<size_t> uniform;
     std::array<poll_strategy, 3> strategies;
-    wait_strategy waitdata;
+    // stores the CPU layout if running in topology-aware mode, shared by all
+    // workers of the coordinator
+    std::shared_ptr<const detail::cpu_topology> topology;
+    // IDs of other workers grouped by distance with the nearest ones first,
+    // empty unless running in topology-aware mode
+    std::vector<std::vector<size_t>> victims;
   };
 
+  // Pins the worker to a CPU and computes its victims in topology-aware mode.
+  template <class Worker>
+  void init_worker(Worker* self) {
+    auto& topology = d(self).topology;
+    if (!topology)
+      return;
+    auto& cpus = topology->cpus();
+    auto& this_cpu = cpus[self->id() % cpus.size()];
+    detail::cpu_topology::pin_this_thread(this_cpu.id);
+    auto& victims = d(self).victims;
+    victims.resize(detail::cpu_topology::num_distance_levels);
+    auto num = self->parent()->num_workers();
+    for (size_t id = 0; id < num; ++id) {
+      if (id == self->id())
+        continue;
+      auto dist = detail::cpu_topology::distance(this_cpu,
+                                                 cpus[id % cpus.size()]);
+      victims[dist].emplace_back(id);
+    }
+  }
+
+  // Steals the oldest element from the queues of `victim`.
+  template <class Coordinator>
+  resumable* steal_from(Coordinator* p, size_t victim) {
+    auto& vd = d(p->worker_by_id(victim));
+    auto job = vd.queue.steal();
+    return job != nullptr ? job : vd.inbox.try_take();
+  }
+
   // Goes on a raid in quest for a shiny new job.
   template <class Worker>
   resumable* try_steal(Worker* self) {
@@ -93,12 +132,88 @@ public:
       // you can't steal from yourself, can you?
       return nullptr;
     }
+    // in topology-aware mode, pick a random victim from each distance level,
+    // starting with workers that share our cache
+    auto& victims = d(self).victims;
+    if (!victims.empty()) {
+      for (auto& level : victims) {
+        if (level.empty())
+          continue;
+        auto victim = level[d(self).rengine() % level.size()];
+        if (auto job = steal_from(p, victim))
+          return job;
+      }
+      return nullptr;
+    }
     // roll the dice to pick a victim other than ourselves
     auto victim = d(self).uniform(d(self).rengine);
     if (victim == self->id())
       victim = p->num_workers() - 1;
-    // steal oldest element from the victim's queue
-    return d(p->worker_by_id(victim)).queue.take_tail();
+    return steal_from(p, victim);
+  }
+
+  // Takes the next job from the worker's own queues.
+  template <class Worker>
+  resumable* take_head(Worker* self) {
+    auto job = d(self).queue.take();
+    return job != nullptr ? job : d(self).inbox.try_take();
+  }
+
+  // Visits all other workers, starting at a random victim or with the
+  // nearest victims in topology-aware mode.
+  template <class Worker>
+  resumable* steal_any(Worker* self) {
+    auto p = self->parent();
+    auto num = p->num_workers();
+    if (num < 2)
+      return nullptr;
+    auto& victims = d(self).victims;
+    if (!victims.empty()) {
+      for (auto& level : victims)
+        for (auto victim : level)
+          if (auto job = steal_from(p, victim))
+            return job;
+      return nullptr;
+    }
+    auto first = d(self).uniform(d(self).rengine);
+    for (size_t i = 0; i < num; ++i) {
+      auto victim = (first + i) % num;
+      if (victim == self->id())
+        continue;
+      if (auto job = steal_from(p, victim))
+        return job;
+    }
+    return nullptr;
+  }
+
+  // Parks the worker for at most `timeout` or until a producer signals new
+  // work. The `i`-th call steals on timeout if `i` is a multiple of
+  // `steal_interval`.
+  template <class Worker>
+  resumable* park(Worker* self, const poll_strategy& strategy, size_t i) {
+    auto& idle = d(self->parent()).idle;
+    auto key = idle.prepare_wait();
+    // re-check our own queues after announcing ourselves; jobs in other
+    // queues show up as an epoch change in commit_wait
+    if (auto job = take_head(self)) {
+      idle.cancel_wait();
+      return job;
+    }
+    // try_take fails while a producer is still linking its job or while a
+    // thief accesses our inbox; poll again instead of sleeping in this case
+    if (!d(self).inbox.empty()) {
+      idle.cancel_wait();
+      return nullptr;
+    }
+    if (idle.commit_wait(key, strategy.sleep_duration)) {
+      // a producer made a new job available but may have pushed it into the
+      // queue of any worker
+      auto job = take_head(self);
+      return job != nullptr ? job : steal_any(self);
+    }
+    if ((i % strategy.steal_interval) == 0)
+      return try_steal(self);
+    return nullptr;
   }
 
   template <class Coordinator>
@@ -109,97 +224,66 @@ public:
 
   template <class Worker>
   void external_enqueue(Worker* self, resumable* job) {
-    d(self).queue.append(job);
-    auto& lock = d(self).waitdata.lock;
-    auto& cv = d(self).waitdata.cv;
-    { // guard scope
-      std::unique_lock<std::mutex> guard(lock);
-      // check if the worker is sleeping
-      if (d(self).waitdata.sleeping && !d(self).queue.empty())
-        cv.notify_one();
-    }
+    d(self).inbox.push(job);
+    // wake up one idle worker (if any) without acquiring a lock otherwise
+    d(self->parent()).idle.notify_one();
   }
 
   template <class Worker>
   void internal_enqueue(Worker* self, resumable* job) {
-    d(self).queue.prepend(job);
+    auto& queue = d(self).queue;
+    queue.push(job);
+    // wake up an idle worker for stealing if we have a backlog
+    if (queue.size() > 1)
+      d(self->parent()).idle.notify_one();
   }
 
   template <class Worker>
   void resume_job_later(Worker* self, resumable* job) {
     // job has voluntarily released the CPU to let others run instead
-    // this means we are going to put this job to the very end of our queue
-    d(self).queue.append(job);
+    // this means we are going to put this job to the very end of our queue,
+    // i.e., behind all jobs in the deque
+    d(self).inbox.push(job);
   }
 
   template <class Worker>
   resumable* dequeue(Worker* self) {
-    // we wait for new jobs by polling our external queue: first, we
-    // assume an active work load on the machine and perform aggressive
-    // polling, then we relax our polling a bit and wait 50 us between
-    // dequeue attempts
+    // we wait for new jobs by polling our own queues: first, we assume an
+    // active work load on the machine and perform aggressive polling, then we
+    // park the worker with a short timeout and finally relax our polling by
+    // parking with a long timeout; producers wake up parked workers early
     auto& strategies = d(self).strategies;
+    auto& aggressive = strategies[0];
     resumable* job = nullptr;
-    for (size_t k = 0; k < 2; ++k) { // iterate over the first two strategies
-      for (size_t i = 0; i < strategies[k].attempts;
-           i += strategies[k].step_size) {
-        job = d(self).queue.take_head();
+    for (size_t i = 0; i < aggressive.attempts; i += aggressive.step_size) {
+      job = take_head(self);
+      if (job)
+        return job;
+      // try to steal every X poll attempts
+      if ((i % aggressive.steal_interval) == 0) {
+        job = try_steal(self);
         if (job)
           return job;
-        // try to steal every X poll attempts
-        if ((i % strategies[k].steal_interval) == 0) {
-          job = try_steal(self);
-          if (job)
-            return job;
-        }
-        if (strategies[k].sleep_duration.count() > 0) {
-#ifdef CAF_MSVC
-          // Windows cannot sleep less than 1000 us, so timeout is converted to
-          // 0 inside sleep_for(), but Sleep(0) is dangerous so replace it with
-          // yield()
-          if (strategies[k].sleep_duration.count() < 1000)
-            std::this_thread::yield();
-          else
-            std::this_thread::sleep_for(strategies[k].sleep_duration);
-#else
-          std::this_thread::sleep_for(strategies[k].sleep_duration);
-#endif
-        }
       }
     }
+    auto& moderate = strategies[1];
+    for (size_t i = 0; i < moderate.attempts; i += moderate.step_size) {
+      job = park(self, moderate, i);
+      if (job)
+        return job;
+    }
     // we assume pretty much nothing is going on so we can relax polling
-    // and falling to sleep on a condition variable whose timeout is the one
-    // of the relaxed polling strategy
     auto& relaxed = strategies[2];
-    auto& sleeping = d(self).waitdata.sleeping;
-    auto& lock = d(self).waitdata.lock;
-    auto& cv = d(self).waitdata.cv;
-    bool notimeout = true;
     size_t i = 1;
     do {
-      { // guard scope
-        std::unique_lock<std::mutex> guard(lock);
-        sleeping = true;
-        if (!cv.wait_for(guard, relaxed.sleep_duration,
-                         [&] { return !d(self).queue.empty(); }))
-          notimeout = false;
-        sleeping = false;
-      }
-      if (notimeout) {
-        job = d(self).queue.take_head();
-      } else {
-        notimeout = true;
-        if ((i % relaxed.steal_interval) == 0)
-          job = try_steal(self);
-      }
-      ++i;
+      job = park(self, relaxed, i++);
     } while (job == nullptr);
     return job;
   }
 
   template <class Worker, class UnaryFunction>
   void foreach_resumable(Worker* self, UnaryFunction f) {
-    auto next = [&] { return d(self).queue.take_head(); };
+    auto next = [&] { return take_head(self); };
     for (auto job = next(); job != nullptr; job = next()) {
       f(job);
     }
@@ -18,16 +18,19 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
-#include <map>
-#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "caf/actor_addr.hpp"
 #include "caf/actor_cast.hpp"
 #include "caf/actor_proxy.hpp"
+#include "caf/config.hpp"
+#include "caf/detail/actor_id_map.hpp"
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/shared_spinlock.hpp"
 #include "caf/exit_reason.hpp"
 #include "caf/fwd.hpp"
 #include "caf/node_id.hpp"
@@ -36,6 +39,11 @@ namespace caf {
 
 /// Groups a (distributed) set of actors and allows actors
 /// in the same namespace to exchange messages.
+///
+/// The registry distributes proxies over several shards by their actor ID.
+/// Each shard has its own reader-writer lock, i.e., concurrent lookups only
+/// contend on the same lock when accessing the same shard and never block each
+/// other unless a lookup needs to create a new proxy.
 class CAF_CORE_EXPORT proxy_registry {
 public:
   /// Responsible for creating proxy actors.
@@ -70,7 +78,10 @@ public:
   actor_addr read(deserializer* source);
 
   /// A map that stores all proxies for known remote actors.
-  using proxy_map = std::map<actor_id, strong_actor_ptr>;
+  using proxy_map = detail::actor_id_map;
+
+  /// Configures the number of shards.
+  static constexpr size_t num_shards = 16;
 
   /// Returns the number of proxies for `node`.
   size_t count_proxies(const node_id& node) const;
@@ -92,6 +103,10 @@ public:
   void erase(const node_id& nid, actor_id aid,
              error rsn = exit_reason::remote_link_unreachable);
 
+  /// Deletes `proxy` for `nid` unless the registry already stores a different
+  /// proxy with the same actor ID.
+  void erase(const node_id& nid, const strong_actor_ptr& proxy, error rsn);
+
   /// Queries whether there are any proxies left.
   bool empty() const;
 
@@ -114,13 +129,26 @@ public:
   }
 
 private:
-  /// @pre mtx_ is locked
+  /// Stores all proxies with an actor ID that maps to this shard.
+  struct alignas(CAF_CACHE_LINE_SIZE) shard {
+    mutable detail::shared_spinlock mtx;
+    std::unordered_map<node_id, proxy_map> proxies;
+  };
+
+  shard& shard_for(actor_id aid) noexcept {
+    return shards_[aid % num_shards];
+  }
+
+  const shard& shard_for(actor_id aid) const noexcept {
+    return shards_[aid % num_shards];
+  }
+
+  /// @pre no shard is locked
   void kill_proxy(strong_actor_ptr&, error);
 
   actor_system& system_;
   backend& backend_;
-  mutable std::mutex mtx_;
-  std::unordered_map<node_id, proxy_map> proxies_;
+  std::array<shard, num_shards> shards_;
 };
 
 } // namespace caf
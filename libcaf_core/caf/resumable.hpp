@@ -21,6 +21,7 @@
 #include <type_traits>
 
 #include "caf/detail/core_export.hpp"
+#include "caf/detail/injection_queue.hpp"
 #include "caf/fwd.hpp"
 
 namespace caf {
@@ -30,7 +31,7 @@ namespace caf {
 /// meant as mixin for reference counted object, i.e., the
 /// subclass is required to inherit from `ref_counted`
 /// at some point.
-class CAF_CORE_EXPORT resumable {
+class CAF_CORE_EXPORT resumable : public detail::injection_queue_node {
 public:
   /// Denotes the state in which a `resumable`
   /// returned from its last call to `resume`.
@@ -24,6 +24,7 @@
 #  include <exception>
 #endif // CAF_ENABLE_EXCEPTIONS
 
+#include <atomic>
 #include <forward_list>
 #include <map>
 #include <type_traits>
@@ -256,8 +257,16 @@ public:
 
   void enqueue(mailbox_element_ptr ptr, execution_unit* eu) override;
 
+  void enqueue_batch(mailbox_element_chain xs, execution_unit* eu) override;
+
   mailbox_element* peek_at_next_mailbox_element() override;
 
+  size_t mailbox_size_hint() const noexcept override;
+
+  void enable_mailbox_size_hint() noexcept override;
+
+  void disable_mailbox_size_hint() noexcept override;
+
   // -- overridden functions of local_actor ------------------------------------
 
   const char* name() const override;
@@ -429,6 +438,14 @@ public:
   /// Requests a new timeout and returns its ID.
   uint64_t set_stream_timeout(actor_clock::time_point x);
 
+  /// Requests a timeout for the response to `mid`. Adds the timeout to a
+  /// shared bucket if `request_timeout_slack_` is non-zero.
+  void request_response_timeout(timespan d, message_id mid);
+
+  /// Sends `sec::request_timeout` to this actor for all responses that are
+  /// still pending in an expired bucket.
+  void handle_coalesced_request_timeouts();
+
   // -- message processing -----------------------------------------------------
 
   /// Adds a callback for an awaited response.
@@ -446,6 +463,16 @@ public:
   /// Tries to consume `x`.
   void consume(mailbox_element_ptr x);
 
+  /// Schedules the actor for execution after a sender has unblocked its
+  /// mailbox.
+  void reschedule(execution_unit* eu);
+
+  /// Adds `n` to the number of pushed messages if this actor runs in a pool.
+  void count_pushed(size_t n) noexcept {
+    if (mailbox_counting_.load(std::memory_order_relaxed) != 0)
+      mailbox_pushed_.fetch_add(n, std::memory_order_relaxed);
+  }
+
   /// Activates an actor and runs initialization code if necessary.
   /// @returns `true` if the actor is alive and ready for `reactivate`,
   ///          `false` otherwise.
@@ -657,6 +684,17 @@ protected:
   /// Stores incoming messages.
   mailbox_type mailbox_;
 
+  /// Enables the counters for `mailbox_size_hint` if greater than 0. Senders
+  /// skip the counting unless this actor runs in at least one pool.
+  std::atomic<size_t> mailbox_counting_;
+
+  /// Counts all messages that senders added to the mailbox.
+  std::atomic<size_t> mailbox_pushed_;
+
+  /// Counts all messages that this actor took from its mailbox. Only the actor
+  /// itself writes to this counter.
+  std::atomic<size_t> mailbox_handled_;
+
   /// Stores user-defined callbacks for message handling.
   detail::behavior_stack bhvr_stack_;
 
@@ -669,6 +707,15 @@ protected:
   /// Stores callbacks for multiplexed responses.
   detail::unordered_flat_map<message_id, behavior> multiplexed_responses_;
 
+  /// Granularity for coalescing request timeouts or zero if each request has
+  /// its own timeout.
+  timespan request_timeout_slack_;
+
+  /// Groups the IDs of pending responses by their coalesced deadline. Responses
+  /// that arrive in time remain in their bucket until it expires.
+  std::map<actor_clock::time_point, std::vector<message_id>>
+    request_timeouts_;
+
   /// Customization point for setting a default `message` callback.
   default_handler default_handler_;
 
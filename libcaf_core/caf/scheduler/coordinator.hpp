@@ -24,9 +24,13 @@
 #include <limits>
 #include <memory>
 #include <thread>
+#include <variant>
 
+#include "caf/actor_system_config.hpp"
+#include "caf/defaults.hpp"
 #include "caf/detail/set_thread_name.hpp"
 #include "caf/detail/thread_safe_actor_clock.hpp"
+#include "caf/detail/timing_wheel_actor_clock.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
 #include "caf/scheduler/worker.hpp"
 
@@ -59,6 +63,17 @@ public:
   }
 
 protected:
+  void init(actor_system_config& cfg) override {
+    namespace sr = defaults::scheduler;
+    super::init(cfg);
+    if (get_or(cfg, "scheduler.clock", sr::clock) == "timing-wheel") {
+      auto res = get_or(cfg, "scheduler.clock-resolution",
+                        sr::clock_resolution);
+      clock_.template emplace<detail::timing_wheel_actor_clock>(num_workers(),
+                                                                res);
+    }
+  }
+
   void start() override {
     // Create initial state for all workers.
     typename worker_type::policy_data init{this};
@@ -77,7 +92,7 @@ protected:
       CAF_SET_LOGGER_SYS(&system());
       detail::set_thread_name("caf.clock");
       system().thread_started();
-      clock_.run_dispatch_loop();
+      std::visit([](auto& clk) { clk.run_dispatch_loop(); }, clock_);
       system().thread_terminates();
     }};
     // Run remaining startup code.
@@ -140,7 +155,7 @@ protected:
       policy_.foreach_resumable(w.get(), f);
     policy_.foreach_central_resumable(this, f);
     // stop timer thread
-    clock_.cancel_dispatch_loop();
+    std::visit([](auto& clk) { clk.cancel_dispatch_loop(); }, clock_);
     timer_.join();
   }
 
@@ -148,13 +163,15 @@ protected:
     policy_.central_enqueue(this, ptr);
   }
 
-  detail::thread_safe_actor_clock& clock() noexcept override {
-    return clock_;
+  actor_clock& clock() noexcept override {
+    return std::visit([](auto& clk) -> actor_clock& { return clk; }, clock_);
   }
 
 private:
-  /// System-wide clock.
-  detail::thread_safe_actor_clock clock_;
+  /// System-wide clock, selected via `scheduler.clock`.
+  std::variant<detail::thread_safe_actor_clock,
+               detail::timing_wheel_actor_clock>
+    clock_;
 
   /// Set of workers.
   std::vector<std::unique_ptr<worker_type>> workers_;
@@ -108,6 +108,7 @@ public:
 private:
   void run() {
     CAF_SET_LOGGER_SYS(&system());
+    policy_.init_worker(this);
     // scheduling loop
     for (;;) {
       auto job = policy_.dequeue(this);
@@ -0,0 +1,300 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+#include "caf/buffered_downstream_manager.hpp"
+#include "caf/detail/algorithms.hpp"
+#include "caf/detail/unordered_flat_map.hpp"
+#include "caf/message.hpp"
+#include "caf/outbound_path.hpp"
+
+namespace caf {
+
+/// Broadcasts all elements to all paths, like `broadcast_downstream_manager`
+/// without filters, but builds each batch only once. Paths share a queue of
+/// immutable batches and each path keeps a cursor to its next batch instead of
+/// buffering elements individually. Sending a batch on a path thus only copies
+/// a reference to the shared batch.
+///
+/// All batches have the smallest desired batch size and maximum capacity of
+/// all paths at the time of building the batch. A path receives a batch only
+/// after receiving enough credit for the entire batch. Paths with a maximum
+/// capacity below the size of an already built batch receive copies of slices
+/// instead.
+template <class T>
+class shared_broadcast_downstream_manager
+  : public buffered_downstream_manager<T> {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Base type.
+  using super = buffered_downstream_manager<T>;
+
+  /// Type of `paths_`.
+  using typename super::map_type;
+
+  /// Unique pointer to an outbound path.
+  using typename super::unique_path_ptr;
+
+  /// A batch that all paths share.
+  struct batch {
+    /// Wraps a `std::vector<T>`.
+    message xs;
+
+    /// Number of elements in `xs`.
+    int32_t size;
+
+    /// Number of elements in all batches before this one.
+    uint64_t offset;
+  };
+
+  /// Stores the position of a path in the queue of shared batches.
+  struct path_state {
+    /// Sequence number of the next batch for this path.
+    uint64_t cursor;
+
+    /// Sequence number of the first batch this path no longer receives. Set
+    /// once the path starts closing.
+    uint64_t limit;
+
+    /// Number of elements in the batch at `cursor` that this path already
+    /// received as slices.
+    int32_t skip;
+  };
+
+  /// Maps slot IDs to path states.
+  using state_map_type = detail::unordered_flat_map<stream_slot, path_state>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  explicit shared_broadcast_downstream_manager(stream_manager* parent)
+    : super(parent), first_seq_(0), total_(0) {
+    // nop
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  size_t buffered() const noexcept override {
+    // Each element in the shared batches counts only once.
+    auto shared = ring_.empty() ? 0u : total_ - ring_.front().offset;
+    return this->buf_.size() + static_cast<size_t>(shared);
+  }
+
+  /// Returns the number of elements in shared batches that `slot` did not
+  /// receive yet.
+  size_t buffered(stream_slot slot) const noexcept override {
+    auto i = state_map_.find(slot);
+    return i != state_map_.end() ? pending(i->second) : 0u;
+  }
+
+  int32_t max_capacity() const noexcept override {
+    // The maximum capacity is limited by the slowest downstream path.
+    auto result = std::numeric_limits<int32_t>::max();
+    for (auto& kvp : this->paths_) {
+      auto mc = kvp.second->max_capacity;
+      // max_capacity is 0 if and only if we didn't receive an ack_batch yet.
+      if (mc > 0)
+        result = std::min(result, mc);
+    }
+    return result;
+  }
+
+  /// Returns the number of shared batches that at least one path still needs.
+  size_t num_batches() const noexcept {
+    return ring_.size();
+  }
+
+  /// Returns the states for all paths.
+  const state_map_type& states() const {
+    return state_map_;
+  }
+
+  // -- overridden functions ---------------------------------------------------
+
+  bool insert_path(unique_path_ptr ptr) override {
+    CAF_LOG_TRACE(CAF_ARG(ptr));
+    // Make sure state_map_ and paths_ are always equally sorted, otherwise
+    // we'll run into UB when calling `zip_foreach`.
+    CAF_ASSERT(state_map_.size() == this->paths_.size());
+    auto slot = ptr->slots.sender;
+    if (!super::insert_path(std::move(ptr))) {
+      CAF_LOG_DEBUG("unable to insert path at slot" << slot);
+      return false;
+    }
+    // New paths only receive batches we build from now on.
+    path_state st{end_seq(), std::numeric_limits<uint64_t>::max(), 0};
+    if (!state_map_.emplace(slot, st).second) {
+      CAF_LOG_DEBUG("unable to add state for slot" << slot);
+      super::remove_path(slot, none, true);
+      return false;
+    }
+    return true;
+  }
+
+  void emit_batches() override {
+    CAF_LOG_TRACE(CAF_ARG2("buffered", this->buffered())
+                  << CAF_ARG2("paths", this->paths_.size()));
+    emit_batches_impl(false);
+  }
+
+  void force_emit_batches() override {
+    CAF_LOG_TRACE(CAF_ARG2("buffered", this->buffered())
+                  << CAF_ARG2("paths", this->paths_.size()));
+    emit_batches_impl(true);
+  }
+
+protected:
+  void about_to_erase(outbound_path* ptr, bool silent, error* reason) override {
+    CAF_ASSERT(ptr != nullptr);
+    CAF_LOG_TRACE(CAF_ARG2("slot", ptr->slots.sender)
+                  << CAF_ARG(silent) << CAF_ARG(reason));
+    state_map_.erase(ptr->slots.sender);
+    super::about_to_erase(ptr, silent, reason);
+    drop_consumed_batches();
+  }
+
+private:
+  uint64_t end_seq() const noexcept {
+    return first_seq_ + ring_.size();
+  }
+
+  // Returns the number of elements in all batches before `seq`.
+  uint64_t offset_of(uint64_t seq) const noexcept {
+    return seq < end_seq() ? ring_[seq - first_seq_].offset : total_;
+  }
+
+  uint64_t last_seq(const path_state& st) const noexcept {
+    return std::min(st.limit, end_seq());
+  }
+
+  size_t pending(const path_state& st) const noexcept {
+    auto last = last_seq(st);
+    if (st.cursor >= last)
+      return 0;
+    return static_cast<size_t>(offset_of(last) - offset_of(st.cursor))
+           - static_cast<size_t>(st.skip);
+  }
+
+  // Sends the next slice of the batch at the cursor of `st` as a copy.
+  void emit_slice(outbound_path& path, path_state& st, const batch& b) {
+    CAF_ASSERT(path.open_credit > 0);
+    auto& xs = b.xs.template get_as<std::vector<T>>(0);
+    auto n = std::min(path.open_credit, b.size - st.skip);
+    auto first = xs.begin() + st.skip;
+    std::vector<T> ys(first, first + n);
+    path.emit_batch(this->self(), n, make_message(std::move(ys)));
+    st.skip += n;
+    if (st.skip == b.size) {
+      st.skip = 0;
+      ++st.cursor;
+    }
+  }
+
+  // Moves elements from the central buffer into new shared batches.
+  void make_batches(size_t batch_size, bool force_underfull) {
+    auto& buf = this->buf_;
+    while (buf.size() >= batch_size || (force_underfull && !buf.empty())) {
+      auto xs = super::get_chunk(std::min(batch_size, buf.size()));
+      auto size = static_cast<int32_t>(xs.size());
+      ring_.push_back(batch{make_message(std::move(xs)), size, total_});
+      total_ += static_cast<uint64_t>(size);
+    }
+  }
+
+  // Drops all batches that no path needs anymore.
+  void drop_consumed_batches() {
+    auto min_seq = end_seq();
+    for (auto& kvp : state_map_) {
+      auto& st = kvp.second;
+      if (st.cursor < last_seq(st))
+        min_seq = std::min(min_seq, st.cursor);
+    }
+    while (first_seq_ < min_seq) {
+      ring_.pop_front();
+      ++first_seq_;
+    }
+  }
+
+  void emit_batches_impl(bool force_underfull) {
+    CAF_ASSERT(this->paths_.size() <= state_map_.size());
+    if (this->paths_.empty())
+      return;
+    // Stop feeding closing paths and pick the batch size for new batches.
+    auto batch_size = std::numeric_limits<int32_t>::max();
+    auto f = [&](typename map_type::value_type& x,
+                 typename state_map_type::value_type& y) {
+      auto& path = *x.second;
+      auto& st = y.second;
+      if (path.closing) {
+        if (st.limit == std::numeric_limits<uint64_t>::max())
+          st.limit = end_seq();
+      } else if (!path.pending()) {
+        batch_size = std::min(batch_size, path.desired_batch_size);
+        if (path.max_capacity > 0)
+          batch_size = std::min(batch_size, path.max_capacity);
+      }
+    };
+    detail::zip_foreach(f, this->paths_.container(), state_map_.container());
+    if (batch_size != std::numeric_limits<int32_t>::max())
+      make_batches(static_cast<size_t>(batch_size), force_underfull);
+    // Hand out shared batches to all paths with sufficient credit.
+    auto g = [&](typename map_type::value_type& x,
+                 typename state_map_type::value_type& y) {
+      auto& path = *x.second;
+      auto& st = y.second;
+      if (path.pending())
+        return;
+      auto last = last_seq(st);
+      while (st.cursor < last && path.open_credit > 0) {
+        auto& b = ring_[st.cursor - first_seq_];
+        if (st.skip == 0 && path.open_credit >= b.size) {
+          path.emit_batch(this->self(), b.size, b.xs);
+          ++st.cursor;
+        } else if (st.skip > 0
+                   || (path.max_capacity > 0 && path.max_capacity < b.size)) {
+          // This path never gets enough credit for the entire batch.
+          emit_slice(path, st, b);
+        } else {
+          break;
+        }
+      }
+    };
+    detail::zip_foreach(g, this->paths_.container(), state_map_.container());
+    drop_consumed_batches();
+  }
+
+  /// Stores batches that at least one path did not receive yet.
+  std::deque<batch> ring_;
+
+  /// Sequence number of the first element in `ring_`.
+  uint64_t first_seq_;
+
+  /// Number of elements in all batches so far.
+  uint64_t total_;
+
+  /// Stores the cursor of each path.
+  state_map_type state_map_;
+};
+
+} // namespace caf
@@ -61,6 +61,11 @@ void abstract_actor::enqueue(strong_actor_ptr sender, message_id mid,
   enqueue(make_mailbox_element(sender, mid, {}, std::move(msg)), host);
 }
 
+void abstract_actor::enqueue_batch(mailbox_element_chain what,
+                                   execution_unit* host) {
+  what.drain([&](mailbox_element_ptr x) { enqueue(std::move(x), host); });
+}
+
 abstract_actor::abstract_actor(actor_config& cfg)
     : abstract_channel(cfg.flags) {
   // nop
@@ -91,6 +96,18 @@ mailbox_element* abstract_actor::peek_at_next_mailbox_element() {
   return nullptr;
 }
 
+size_t abstract_actor::mailbox_size_hint() const noexcept {
+  return 0;
+}
+
+void abstract_actor::enable_mailbox_size_hint() noexcept {
+  // nop
+}
+
+void abstract_actor::disable_mailbox_size_hint() noexcept {
+  // nop
+}
+
 void abstract_actor::register_at_system() {
   if (getf(is_registered_flag))
     return;
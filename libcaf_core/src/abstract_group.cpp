@@ -40,4 +40,11 @@ abstract_group::~abstract_group() {
   // nop
 }
 
+void abstract_group::enqueue_batch(strong_actor_ptr sender, message_id mid,
+                                   std::vector<message> xs,
+                                   execution_unit* host) {
+  for (auto& x : xs)
+    enqueue(sender, mid, std::move(x), host);
+}
+
 } // namespace caf
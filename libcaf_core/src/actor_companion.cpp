@@ -51,6 +51,13 @@ void actor_companion::enqueue(strong_actor_ptr src, message_id mid,
   enqueue(std::move(ptr), eu);
 }
 
+void actor_companion::enqueue_batch(mailbox_element_chain xs,
+                                    execution_unit*) {
+  shared_lock<lock_type> guard(lock_);
+  if (on_enqueue_)
+    xs.drain([this](mailbox_element_ptr x) { on_enqueue_(std::move(x)); });
+}
+
 void actor_companion::launch(execution_unit*, bool, bool hide) {
   if (!hide)
     register_at_system();
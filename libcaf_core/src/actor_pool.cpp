@@ -19,7 +19,9 @@
 #include "caf/actor_pool.hpp"
 
 #include <atomic>
+#include <limits>
 #include <random>
+#include <thread>
 
 #include "caf/send.hpp"
 #include "caf/default_attachable.hpp"
@@ -28,6 +30,32 @@
 
 namespace caf {
 
+namespace {
+
+std::minstd_rand& thread_rng() {
+  thread_local std::minstd_rand rng{std::random_device{}()};
+  return rng;
+}
+
+// Returns a random number in the range [0, n).
+size_t random_index(size_t n) {
+  CAF_ASSERT(n > 0);
+  std::uniform_int_distribution<size_t> dis{0, n - 1};
+  return dis(thread_rng());
+}
+
+// Finalizer of MurmurHash3, scatters the bits of `x` over the entire result.
+uint64_t mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+} // namespace
+
 actor_pool::policy actor_pool::round_robin() {
   struct impl {
     impl() : pos_(0) {
@@ -36,12 +64,11 @@ actor_pool::policy actor_pool::round_robin() {
     impl(const impl&) : pos_(0) {
       // nop
     }
-    void operator()(actor_system&, uplock& guard, const actor_vec& vec,
+    void operator()(actor_system&, const actor_vec& vec,
                     mailbox_element_ptr& ptr, execution_unit* host) {
       CAF_ASSERT(!vec.empty());
-      actor selected = vec[pos_++ % vec.size()];
-      guard.unlock();
-      selected->enqueue(std::move(ptr), host);
+      auto pos = pos_.fetch_add(1, std::memory_order_relaxed);
+      vec[pos % vec.size()]->enqueue(std::move(ptr), host);
     }
     std::atomic<size_t> pos_;
   };
@@ -50,8 +77,7 @@ actor_pool::policy actor_pool::round_robin() {
 
 namespace {
 
-void broadcast_dispatch(actor_system&, actor_pool::uplock&,
-                        const actor_pool::actor_vec& vec,
+void broadcast_dispatch(actor_system&, const actor_pool::actor_vec& vec,
                         mailbox_element_ptr& ptr, execution_unit* host) {
   CAF_ASSERT(!vec.empty());
   auto msg = ptr->payload;
@@ -59,6 +85,49 @@ void broadcast_dispatch(actor_system&, actor_pool::uplock&,
     worker->enqueue(ptr->sender, ptr->mid, msg, host);
 }
 
+void random_dispatch(actor_system&, const actor_pool::actor_vec& vec,
+                     mailbox_element_ptr& ptr, execution_unit* host) {
+  CAF_ASSERT(!vec.empty());
+  vec[random_index(vec.size())]->enqueue(std::move(ptr), host);
+}
+
+void least_loaded_dispatch(actor_system&, const actor_pool::actor_vec& vec,
+                           mailbox_element_ptr& ptr, execution_unit* host) {
+  CAF_ASSERT(!vec.empty());
+  auto selected = &vec.front();
+  auto min_load = std::numeric_limits<size_t>::max();
+  for (auto& worker : vec) {
+    auto load = worker->mailbox_size_hint();
+    if (load < min_load) {
+      selected = &worker;
+      if (load == 0)
+        break;
+      min_load = load;
+    }
+  }
+  (*selected)->enqueue(std::move(ptr), host);
+}
+
+void power_of_two_choices_dispatch(actor_system&,
+                                   const actor_pool::actor_vec& vec,
+                                   mailbox_element_ptr& ptr,
+                                   execution_unit* host) {
+  CAF_ASSERT(!vec.empty());
+  if (vec.size() == 1) {
+    vec.front()->enqueue(std::move(ptr), host);
+    return;
+  }
+  // Draw two distinct workers.
+  auto i = random_index(vec.size());
+  auto j = random_index(vec.size() - 1);
+  if (j >= i)
+    ++j;
+  auto& x = vec[i];
+  auto& y = vec[j];
+  auto& selected = x->mailbox_size_hint() <= y->mailbox_size_hint() ? x : y;
+  selected->enqueue(std::move(ptr), host);
+}
+
 } // namespace
 
 actor_pool::policy actor_pool::broadcast() {
@@ -66,29 +135,124 @@ actor_pool::policy actor_pool::broadcast() {
 }
 
 actor_pool::policy actor_pool::random() {
+  return random_dispatch;
+}
+
+actor_pool::policy actor_pool::least_loaded() {
+  return least_loaded_dispatch;
+}
+
+actor_pool::policy actor_pool::power_of_two_choices() {
+  return power_of_two_choices_dispatch;
+}
+
+actor_pool::policy actor_pool::consistent_hash(key_function f) {
+  // Uses rendezvous hashing: each message goes to the worker with the highest
+  // score for its key. Unlike a hash ring, this requires no state that we
+  // would need to rebuild whenever the set of workers changes.
   struct impl {
-    impl() : rd_() {
-      // nop
-    }
-    impl(const impl&) : rd_() {
-      // nop
-    }
-    void operator()(actor_system&, uplock& guard, const actor_vec& vec,
+    void operator()(actor_system&, const actor_vec& vec,
                     mailbox_element_ptr& ptr, execution_unit* host) {
-      upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-      auto selected =
-          vec[dis_(rd_, decltype(dis_)::param_type(0, vec.size() - 1))];
-      unique_guard.unlock();
-      selected->enqueue(std::move(ptr), host);
+      CAF_ASSERT(!vec.empty());
+      auto key = mix(static_cast<uint64_t>(key_(ptr->payload)));
+      auto selected = &vec.front();
+      uint64_t max_score = 0;
+      for (auto& worker : vec) {
+        auto score = mix(key ^ worker->id());
+        if (score >= max_score) {
+          selected = &worker;
+          max_score = score;
+        }
+      }
+      (*selected)->enqueue(std::move(ptr), host);
     }
-    std::random_device rd_;
-    std::uniform_int_distribution<size_t> dis_;
+    key_function key_;
   };
-  return impl{};
+  return impl{std::move(f)};
+}
+
+actor_pool::reader_guard::reader_guard(actor_pool& pool) : pool_(pool) {
+  thread_local auto index
+    = mix(std::hash<std::thread::id>{}(std::this_thread::get_id()))
+      % reader_slots;
+  for (;;) {
+    auto epoch = pool_.epoch_.load(std::memory_order_seq_cst);
+    slot_ = &pool_.readers_[epoch & 1][index].value;
+    slot_->fetch_add(1, std::memory_order_seq_cst);
+    // Only readers that announce themselves in the current epoch may access
+    // `workers_`, because writers stop waiting for the previous epoch.
+    if (pool_.epoch_.load(std::memory_order_seq_cst) == epoch)
+      break;
+    pool_.leave(*slot_);
+  }
+  workers_ = pool_.workers_.load(std::memory_order_seq_cst);
+}
+
+actor_pool::reader_guard::~reader_guard() {
+  pool_.leave(*slot_);
+}
+
+void actor_pool::leave(std::atomic<size_t>& slot) {
+  slot.fetch_sub(1, std::memory_order_seq_cst);
+  if (reclaim_pending_.load(std::memory_order_seq_cst)) {
+    // Destroy retired worker sets only after releasing the lock.
+    std::vector<std::unique_ptr<const actor_vec>> garbage;
+    std::unique_lock<std::mutex> guard{workers_mtx_};
+    reclaim(garbage);
+  }
+}
+
+void actor_pool::reclaim(
+  std::vector<std::unique_ptr<const actor_vec>>& garbage) {
+  auto drained = [this](size_t parity) {
+    for (auto& slot : readers_[parity])
+      if (slot.value.load(std::memory_order_seq_cst) != 0)
+        return false;
+    return true;
+  };
+  auto move_to_garbage = [&] {
+    for (auto& x : draining_)
+      garbage.emplace_back(std::move(x));
+    draining_.clear();
+  };
+  // Readers of an epoch may access all worker sets retired in that epoch or
+  // later. Hence, we can free the sets of the previous epoch once all of its
+  // readers left. New readers only enter the current epoch.
+  auto epoch = epoch_.load(std::memory_order_relaxed);
+  if (!draining_.empty()) {
+    if (!drained((epoch - 1) & 1))
+      return;
+    move_to_garbage();
+  }
+  if (!retired_.empty()) {
+    epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    draining_.swap(retired_);
+    if (drained(epoch & 1))
+      move_to_garbage();
+  }
+  reclaim_pending_.store(!draining_.empty(), std::memory_order_seq_cst);
+}
+
+template <class F>
+size_t actor_pool::update_workers(F f) {
+  // Destroy retired worker sets only after releasing the lock.
+  std::vector<std::unique_ptr<const actor_vec>> garbage;
+  std::unique_lock<std::mutex> guard{workers_mtx_};
+  auto old = workers_.load(std::memory_order_relaxed);
+  auto next = std::make_unique<actor_vec>(*old);
+  f(*next);
+  auto result = next->size();
+  workers_.store(next.release(), std::memory_order_seq_cst);
+  retired_.emplace_back(old);
+  // Announce the retired set before checking for readers. Either we see a
+  // reader or the reader sees the flag and frees the set when leaving.
+  reclaim_pending_.store(true, std::memory_order_seq_cst);
+  reclaim(garbage);
+  return result;
 }
 
 actor_pool::~actor_pool() {
-  // nop
+  delete workers_.load();
 }
 
 actor actor_pool::make(execution_unit* eu, policy pol) {
@@ -107,24 +271,43 @@ actor actor_pool::make(execution_unit* eu, size_t num_workers,
   auto res = make(eu, std::move(pol));
   auto ptr = static_cast<actor_pool*>(actor_cast<abstract_actor*>(res));
   auto res_addr = ptr->address();
+  actor_vec workers;
+  workers.reserve(num_workers);
   for (size_t i = 0; i < num_workers; ++i) {
     auto worker = fac();
+    worker->enable_mailbox_size_hint();
     worker->attach(default_attachable::make_monitor(worker.address(), res_addr));
-    ptr->workers_.push_back(std::move(worker));
+    workers.push_back(std::move(worker));
   }
+  ptr->update_workers([&](actor_vec& xs) { xs.swap(workers); });
   return res;
 }
 
 void actor_pool::enqueue(mailbox_element_ptr what, execution_unit* eu) {
-  upgrade_lock<detail::shared_spinlock> guard{workers_mtx_};
-  if (filter(guard, what->sender, what->mid, what->payload, eu))
+  if (filter(what->sender, what->mid, what->payload, eu))
+    return;
+  reader_guard guard{*this};
+  auto& workers = guard.workers();
+  if (workers.empty()) {
+    if (what->mid.is_request() && what->sender != nullptr) {
+      // Tell client we have ignored this request message by sending and empty
+      // message back.
+      what->sender->enqueue(nullptr, what->mid.response_id(), message{}, eu);
+    }
     return;
-  policy_(home_system(), guard, workers_, what, eu);
+  }
+  policy_(home_system(), workers, what, eu);
 }
 
 actor_pool::actor_pool(actor_config& cfg)
     : monitorable_actor(cfg),
+      workers_(new actor_vec),
+      epoch_(0),
+      reclaim_pending_(false),
       planned_reason_(exit_reason::normal) {
+  for (auto& slots : readers_)
+    for (auto& slot : slots)
+      slot.value.store(0, std::memory_order_relaxed);
   register_at_system();
 }
 
@@ -143,22 +326,20 @@ void actor_pool::on_cleanup(const error& reason) {
   CAF_LOG_TERMINATE_EVENT(this, reason);
 }
 
-bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
-                        const strong_actor_ptr& sender, message_id mid,
+bool actor_pool::filter(const strong_actor_ptr& sender, message_id mid,
                         message& content, execution_unit* eu) {
   CAF_LOG_TRACE(CAF_ARG(mid) << CAF_ARG(content));
   if (auto view = make_const_typed_message_view<exit_msg>(content)) {
-    // acquire second mutex as well
     std::vector<actor> workers;
     auto reason = get<0>(view).reason;
     if (cleanup(std::move(reason), eu)) {
       // send exit messages *always* to all workers and clear vector afterwards
       // but first swap workers_ out of the critical section
-      upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-      workers_.swap(workers);
-      unique_guard.unlock();
-      for (auto& w : workers)
+      update_workers([&](actor_vec& xs) { xs.swap(workers); });
+      for (auto& w : workers) {
+        w->disable_mailbox_size_hint();
         anon_send(w, content);
+      }
       unregister_from_system();
     }
     return true;
@@ -166,68 +347,67 @@ bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
   if (auto view = make_const_typed_message_view<down_msg>(content)) {
     // remove failed worker from pool
     const auto& dm = get<0>(view);
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-    auto last = workers_.end();
-    auto i = std::find(workers_.begin(), workers_.end(), dm.source);
-    CAF_LOG_DEBUG_IF(i == last, "received down message for an unknown worker");
-    if (i != last)
-      workers_.erase(i);
-    if (workers_.empty()) {
-      planned_reason_ = exit_reason::out_of_workers;
-      unique_guard.unlock();
+    auto remaining = update_workers([&](actor_vec& xs) {
+      auto last = xs.end();
+      auto i = std::find(xs.begin(), last, dm.source);
+      CAF_LOG_DEBUG_IF(i == last,
+                       "received down message for an unknown worker");
+      if (i != last)
+        xs.erase(i);
+      if (xs.empty())
+        planned_reason_ = exit_reason::out_of_workers;
+    });
+    if (remaining == 0)
       quit(eu);
-    }
     return true;
   }
   if (auto view
       = make_const_typed_message_view<sys_atom, put_atom, actor>(content)) {
     const auto& worker = get<2>(view);
+    worker->enable_mailbox_size_hint();
     worker->attach(default_attachable::make_monitor(worker.address(),
                                                     address()));
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-    workers_.push_back(worker);
+    update_workers([&](actor_vec& xs) { xs.push_back(worker); });
     return true;
   }
   if (auto view
       = make_const_typed_message_view<sys_atom, delete_atom, actor>(content)) {
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
     auto& what = get<2>(view);
-    auto last = workers_.end();
-    auto i = std::find(workers_.begin(), last, what);
-    if (i != last) {
-      default_attachable::observe_token tk{address(),
-                                           default_attachable::monitor};
-      what->detach(tk);
-      workers_.erase(i);
-    }
+    update_workers([&](actor_vec& xs) {
+      auto last = xs.end();
+      auto i = std::find(xs.begin(), last, what);
+      if (i != last) {
+        default_attachable::observe_token tk{address(),
+                                             default_attachable::monitor};
+        what->detach(tk);
+        what->disable_mailbox_size_hint();
+        xs.erase(i);
+      }
+    });
     return true;
   }
   if (content.match_elements<sys_atom, delete_atom>()) {
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-    for (auto& worker : workers_) {
-      default_attachable::observe_token tk{address(),
-                                           default_attachable::monitor};
-      worker->detach(tk);
-    }
-    workers_.clear();
+    update_workers([&](actor_vec& xs) {
+      for (auto& worker : xs) {
+        default_attachable::observe_token tk{address(),
+                                             default_attachable::monitor};
+        worker->detach(tk);
+        worker->disable_mailbox_size_hint();
+      }
+      xs.clear();
+    });
     return true;
   }
   if (content.match_elements<sys_atom, get_atom>()) {
-    auto cpy = workers_;
-    guard.unlock();
+    actor_vec cpy;
+    {
+      reader_guard guard{*this};
+      cpy = guard.workers();
+    }
     sender->enqueue(nullptr, mid.response_id(),
                     make_message(std::move(cpy)), eu);
     return true;
   }
-  if (workers_.empty()) {
-    guard.unlock();
-    if (mid.is_request() && sender != nullptr) {
-      // Tell client we have ignored this request message by sending and empty
-      // message back.
-      sender->enqueue(nullptr, mid.response_id(), message{}, eu);
-    }
-    return true;
-  }
   return false;
 }
 
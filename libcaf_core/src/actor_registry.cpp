@@ -53,10 +53,10 @@ actor_registry::actor_registry(actor_system& sys) : running_(0), system_(sys) {
 }
 
 strong_actor_ptr actor_registry::get_impl(actor_id key) const {
-  shared_guard guard(instances_mtx_);
-  auto i = entries_.find(key);
-  if (i != entries_.end())
-    return i->second;
+  auto& x = shard_for(key);
+  shared_guard guard{x.mtx};
+  if (auto result = x.entries.get(key))
+    return result;
   CAF_LOG_DEBUG("key invalid, assume actor no longer exists:" << CAF_ARG(key));
   return nullptr;
 }
@@ -66,9 +66,11 @@ void actor_registry::put_impl(actor_id key, strong_actor_ptr val) {
   if (!val)
     return;
   { // lifetime scope of guard
-    exclusive_guard guard(instances_mtx_);
-    if (!entries_.emplace(key, val).second)
+    auto& x = shard_for(key);
+    exclusive_guard guard{x.mtx};
+    if (x.entries.get(key) != nullptr)
       return;
+    x.entries.put(key, val);
   }
   // attach functor without lock
   CAF_LOG_DEBUG("added actor:" << CAF_ARG(key));
@@ -85,12 +87,9 @@ void actor_registry::erase(actor_id key) {
   // that in turn calls this function and we can end up in a deadlock.
   strong_actor_ptr ref;
   { // Lifetime scope of guard.
-    exclusive_guard guard{instances_mtx_};
-    auto i = entries_.find(key);
-    if (i != entries_.end()) {
-      ref.swap(i->second);
-      entries_.erase(i);
-    }
+    auto& x = shard_for(key);
+    exclusive_guard guard{x.mtx};
+    ref = x.entries.take(key);
   }
 }
 
@@ -23,6 +23,7 @@
 #include "caf/actor.hpp"
 #include "caf/actor_system_config.hpp"
 #include "caf/defaults.hpp"
+#include "caf/detail/memory_pool.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/event_based_actor.hpp"
 #include "caf/policy/work_sharing.hpp"
@@ -249,6 +250,10 @@ actor_system::actor_system(actor_system_config& cfg)
                    "caf::io::middleman::init_global_meta_objects() before");
     }
   }
+  // Pooling is a process-wide setting that we never turn off again, because
+  // other actor systems in the same process may have turned it on.
+  if (get_or(cfg, "scheduler.enable-memory-pool", false))
+    detail::memory_pool::enable(true);
   // Make sure we have a scheduler up and running.
   auto& sched = modules_[module::scheduler];
   using namespace scheduler;
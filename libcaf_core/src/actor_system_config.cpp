@@ -60,6 +60,7 @@ actor_system_config::actor_system_config()
   stream_desired_batch_complexity = defaults::stream::desired_batch_complexity;
   stream_max_batch_delay = defaults::stream::max_batch_delay;
   stream_credit_round_interval = defaults::stream::credit_round_interval;
+  request_timeout_slack = defaults::scheduler::request_timeout_slack;
   // fill our options vector for creating INI and CLI parsers
   using std::string;
   opt_group{custom_options_, "global"}
@@ -83,7 +84,14 @@ actor_system_config::actor_system_config()
     .add<size_t>("max-throughput", "nr. of messages actors can consume per run")
     .add<bool>("enable-profiling", "enables profiler output")
     .add<timespan>("profiling-resolution", "data collection rate")
-    .add<string>("profiling-output-file", "output file for the profiler");
+    .add<string>("profiling-output-file", "output file for the profiler")
+    .add<bool>("enable-memory-pool",
+               "allocate messages from per-thread memory pools")
+    .add<string>("clock", "'simple' (default) or 'timing-wheel'")
+    .add<timespan>("clock-resolution",
+                   "tick length of the timing wheel clock")
+    .add<timespan>(request_timeout_slack, "request-timeout-slack",
+                   "coalesces request timeouts into buckets of this size");
   opt_group(custom_options_, "work-stealing")
     .add<size_t>("aggressive-poll-attempts", "nr. of aggressive steal attempts")
     .add<size_t>("aggressive-steal-interval",
@@ -92,11 +100,13 @@ actor_system_config::actor_system_config()
     .add<size_t>("moderate-steal-interval",
                  "frequency of moderate steal attempts")
     .add<timespan>("moderate-sleep-duration",
-                   "sleep duration between moderate steal attempts")
+                   "max. wait duration between moderate steal attempts")
     .add<size_t>("relaxed-steal-interval",
                  "frequency of relaxed steal attempts")
     .add<timespan>("relaxed-sleep-duration",
-                   "sleep duration between relaxed steal attempts");
+                   "max. wait duration between relaxed steal attempts")
+    .add<bool>("topology-aware",
+               "pin workers to CPUs and steal from nearby workers first");
   opt_group{custom_options_, "logger"}
     .add<std::string>("verbosity", "default verbosity for file and console")
     .add<string>("file-name", "filesystem path of the log file")
@@ -111,7 +121,7 @@ actor_system_config::actor_system_config()
     .add<bool>("inline-output", "disable logger thread (for testing only!)");
   opt_group{custom_options_, "middleman"}
     .add<std::string>("network-backend",
-                      "either 'default' or 'asio' (if available)")
+                      "either 'default' or 'io_uring' (Linux only)")
     .add<std::vector<string>>("app-identifiers",
                               "valid application identifiers of this node")
     .add<string>("app-identifier", "DEPRECATED: use app-identifiers instead")
@@ -119,12 +129,31 @@ actor_system_config::actor_system_config()
                "enables automatic connection management")
     .add<size_t>("max-consecutive-reads",
                  "max. number of consecutive reads per broker")
+    .add<bool>("epoll-edge-triggered",
+               "registers sockets once in edge-triggered mode (Linux only)")
     .add<timespan>("heartbeat-interval", "interval of heartbeat messages")
     .add<bool>("attach-utility-actors",
                "schedule utility actors instead of dedicating threads")
     .add<bool>("manual-multiplexing",
                "disables background activity of the multiplexer")
-    .add<size_t>("workers", "number of deserialization workers");
+    .add<size_t>("multiplexers", "number of I/O event loops for brokers")
+    .add<bool>("serialize-on-send",
+               "serializes remote messages on the sending thread")
+    .add<size_t>("workers", "number of deserialization workers")
+    .add<std::vector<string>>("compression-codecs",
+                              "payload compression codecs in order of "
+                              "preference, e.g., [\"lz4\"]")
+    .add<size_t>("compression-threshold",
+                 "min. payload size in bytes for compressing BASP messages")
+    .add<bool>("coalesce-messages",
+               "packs multiple remote messages into a single BASP frame")
+    .add<size_t>("max-batch-size",
+                 "max. size in bytes of a BASP frame with coalesced messages")
+    .add<timespan>("max-batch-delay",
+                   "max. delay for sending coalesced messages")
+    .add<size_t>("zerocopy-threshold",
+                 "min. size in bytes for sending with MSG_ZEROCOPY "
+                 "(Linux only, 0 disables)");
   opt_group(custom_options_, "openssl")
     .add<string>(openssl_certificate, "certificate",
                  "path to the PEM-formatted certificate file")
@@ -167,6 +196,12 @@ settings actor_system_config::dump_content() const {
   put_missing(scheduler_group, "profiling-resolution",
               defaults::scheduler::profiling_resolution);
   put_missing(scheduler_group, "profiling-output-file", std::string{});
+  put_missing(scheduler_group, "enable-memory-pool", false);
+  put_missing(scheduler_group, "clock", defaults::scheduler::clock);
+  put_missing(scheduler_group, "clock-resolution",
+              defaults::scheduler::clock_resolution);
+  put_missing(scheduler_group, "request-timeout-slack",
+              defaults::scheduler::request_timeout_slack);
   // -- work-stealing parameters
   auto& work_stealing_group = result["work-stealing"].as_dictionary();
   put_missing(work_stealing_group, "aggressive-poll-attempts",
@@ -183,6 +218,8 @@ settings actor_system_config::dump_content() const {
               defaults::work_stealing::relaxed_steal_interval);
   put_missing(work_stealing_group, "relaxed-sleep-duration",
               defaults::work_stealing::relaxed_sleep_duration);
+  put_missing(work_stealing_group, "topology-aware",
+              defaults::work_stealing::topology_aware);
   // -- logger parameters
   auto& logger_group = result["logger"].as_dictionary();
   put_missing(logger_group, "file-name", defaults::logger::file_name);
@@ -201,9 +238,24 @@ settings actor_system_config::dump_content() const {
   put_missing(middleman_group, "enable-automatic-connections", false);
   put_missing(middleman_group, "max-consecutive-reads",
               defaults::middleman::max_consecutive_reads);
+  put_missing(middleman_group, "epoll-edge-triggered", false);
   put_missing(middleman_group, "heartbeat-interval",
               defaults::middleman::heartbeat_interval);
+  put_missing(middleman_group, "multiplexers",
+              defaults::middleman::multiplexers);
+  put_missing(middleman_group, "serialize-on-send", false);
   put_missing(middleman_group, "workers", defaults::middleman::workers);
+  put_missing(middleman_group, "compression-codecs",
+              std::vector<std::string>{});
+  put_missing(middleman_group, "compression-threshold",
+              defaults::middleman::compression_threshold);
+  put_missing(middleman_group, "coalesce-messages", false);
+  put_missing(middleman_group, "max-batch-size",
+              defaults::middleman::max_batch_size);
+  put_missing(middleman_group, "max-batch-delay",
+              defaults::middleman::max_batch_delay);
+  put_missing(middleman_group, "zerocopy-threshold",
+              defaults::middleman::zerocopy_threshold);
   // -- openssl parameters
   auto& openssl_group = result["openssl"].as_dictionary();
   put_missing(openssl_group, "certificate", std::string{});
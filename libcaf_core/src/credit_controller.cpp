@@ -36,4 +36,8 @@ int32_t credit_controller::threshold() const noexcept {
   return -1;
 }
 
+void credit_controller::credit_granted(int32_t, int32_t) {
+  // nop
+}
+
 } // namespace caf
@@ -85,6 +85,9 @@ string_view profiling_output_file = "";
 const size_t max_threads = max(std::thread::hardware_concurrency(), 4u);
 const size_t max_throughput = std::numeric_limits<size_t>::max();
 const timespan profiling_resolution = ms(100);
+const string_view clock = "simple";
+const timespan clock_resolution = ms(1);
+const timespan request_timeout_slack = ms(0);
 
 } // namespace scheduler
 
@@ -97,6 +100,7 @@ const size_t moderate_steal_interval = 5;
 const timespan moderate_sleep_duration = us(50);
 const size_t relaxed_steal_interval = 1;
 const timespan relaxed_sleep_duration = ms(10);
+const bool topology_aware = false;
 
 } // namespace work_stealing
 
@@ -120,7 +124,12 @@ const size_t max_consecutive_reads = 50;
 const size_t heartbeat_interval = 0;
 const size_t cached_udp_buffers = 10;
 const size_t max_pending_msgs = 10;
+const size_t multiplexers = 1;
 const size_t workers = min(3u, std::thread::hardware_concurrency() / 4u) + 1;
+const size_t compression_threshold = 1024;
+const size_t max_batch_size = 64 * 1024;
+const timespan max_batch_delay = timespan{0};
+const size_t zerocopy_threshold = 0;
 
 } // namespace middleman
 
@@ -0,0 +1,131 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/actor_id_map.hpp"
+
+#include <utility>
+
+namespace caf::detail {
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+actor_id_map::actor_id_map() noexcept : mask_(0), size_(0) {
+  // nop
+}
+
+actor_id_map::actor_id_map(actor_id_map&& other) noexcept
+  : slots_(std::move(other.slots_)), mask_(other.mask_), size_(other.size_) {
+  other.mask_ = 0;
+  other.size_ = 0;
+}
+
+actor_id_map& actor_id_map::operator=(actor_id_map&& other) noexcept {
+  slots_ = std::move(other.slots_);
+  mask_ = other.mask_;
+  size_ = other.size_;
+  other.mask_ = 0;
+  other.size_ = 0;
+  return *this;
+}
+
+actor_id_map::~actor_id_map() {
+  // nop
+}
+
+// -- lookup and modifiers -----------------------------------------------------
+
+strong_actor_ptr actor_id_map::get(actor_id key) const noexcept {
+  auto i = find(key);
+  return i != capacity() ? slots_[i].value : nullptr;
+}
+
+void actor_id_map::put(actor_id key, strong_actor_ptr value) {
+  CAF_ASSERT(value != nullptr);
+  if (auto i = find(key); i != capacity()) {
+    slots_[i].value.swap(value);
+    return;
+  }
+  // Keep the load factor at or below 50%.
+  if ((size_ + 1) * 2 > capacity())
+    grow();
+  auto i = home_of(key);
+  while (slots_[i].value != nullptr)
+    i = (i + 1) & mask_;
+  slots_[i].key = key;
+  slots_[i].value.swap(value);
+  ++size_;
+}
+
+strong_actor_ptr actor_id_map::take(actor_id key) noexcept {
+  auto i = find(key);
+  if (i == capacity())
+    return nullptr;
+  strong_actor_ptr result;
+  result.swap(slots_[i].value);
+  --size_;
+  // Move subsequent entries of the same probe sequence into the gap.
+  for (auto j = (i + 1) & mask_; slots_[j].value != nullptr;
+       j = (j + 1) & mask_) {
+    auto home = home_of(slots_[j].key);
+    // Skip entries that would become unreachable when moving them to `i`,
+    // i.e., entries with their home slot cyclically in (i, j].
+    if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+      continue;
+    slots_[i].key = slots_[j].key;
+    slots_[i].value.swap(slots_[j].value);
+    i = j;
+  }
+  return result;
+}
+
+void actor_id_map::clear() noexcept {
+  for (size_t i = 0; i < capacity(); ++i)
+    slots_[i].value.reset();
+  size_ = 0;
+}
+
+// -- private utility ----------------------------------------------------------
+
+size_t actor_id_map::find(actor_id key) const noexcept {
+  if (size_ == 0)
+    return capacity();
+  for (auto i = home_of(key); slots_[i].value != nullptr; i = (i + 1) & mask_)
+    if (slots_[i].key == key)
+      return i;
+  return capacity();
+}
+
+void actor_id_map::grow() {
+  auto old_capacity = capacity();
+  auto new_capacity = old_capacity > 0 ? old_capacity * 2 : min_capacity;
+  auto old_slots = std::move(slots_);
+  slots_.reset(new slot[new_capacity]);
+  mask_ = new_capacity - 1;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    auto& x = old_slots[i];
+    if (x.value == nullptr)
+      continue;
+    auto j = home_of(x.key);
+    while (slots_[j].value != nullptr)
+      j = (j + 1) & mask_;
+    slots_[j].key = x.key;
+    slots_[j].value.swap(x.value);
+  }
+}
+
+} // namespace caf::detail
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/cpu_topology.hpp"
+
+#include "caf/config.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+#ifdef CAF_LINUX
+#  include <pthread.h>
+#  include <sched.h>
+#endif // CAF_LINUX
+
+namespace caf::detail {
+
+namespace {
+
+#ifdef CAF_LINUX
+
+constexpr const char* sysfs_cpu_dir = "/sys/devices/system/cpu/cpu";
+
+constexpr const char* sysfs_node_dir = "/sys/devices/system/node/";
+
+// Reads the first line of `path` and parses it as CPU list.
+std::vector<size_t> read_cpu_list(const std::string& path) {
+  std::ifstream in{path};
+  std::string line;
+  if (!in || !std::getline(in, line))
+    return {};
+  return cpu_topology::parse_cpu_list(line);
+}
+
+#endif // CAF_LINUX
+
+} // namespace
+
+cpu_topology::cpu_topology(std::vector<cpu> cpus) : cpus_(std::move(cpus)) {
+  auto key = [](const cpu& x) { return std::tie(x.node, x.cache, x.id); };
+  std::sort(cpus_.begin(), cpus_.end(),
+            [&](const cpu& x, const cpu& y) { return key(x) < key(y); });
+}
+
+cpu_topology cpu_topology::query() {
+#ifdef CAF_LINUX
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return cpu_topology{};
+  std::vector<cpu> cpus;
+  for (size_t id = 0; id < CPU_SETSIZE; ++id)
+    if (CPU_ISSET(id, &allowed))
+      cpus.emplace_back(cpu{id, 0, 0});
+  // Assign NUMA nodes. Machines without NUMA support simply have no node
+  // directory, i.e., all CPUs remain on node 0.
+  for (auto node : read_cpu_list(std::string{sysfs_node_dir} + "online")) {
+    auto path = std::string{sysfs_node_dir} + "node" + std::to_string(node)
+                + "/cpulist";
+    for (auto id : read_cpu_list(path))
+      for (auto& x : cpus)
+        if (x.id == id)
+          x.node = node;
+  }
+  // Group CPUs by their L3 cache. The lowest CPU ID in the shared list serves
+  // as ID for the group. Without L3 information, we group by NUMA node.
+  for (auto& x : cpus) {
+    auto path = std::string{sysfs_cpu_dir} + std::to_string(x.id)
+                + "/cache/index3/shared_cpu_list";
+    auto shared = read_cpu_list(path);
+    if (!shared.empty())
+      x.cache = *std::min_element(shared.begin(), shared.end());
+    else
+      x.cache = x.node;
+  }
+  return cpu_topology{std::move(cpus)};
+#else  // CAF_LINUX
+  return cpu_topology{};
+#endif // CAF_LINUX
+}
+
+cpu_topology::distance_level cpu_topology::distance(const cpu& x,
+                                                    const cpu& y) noexcept {
+  if (x.node != y.node)
+    return remote_node;
+  if (x.cache != y.cache)
+    return same_node;
+  return same_cache;
+}
+
+std::vector<size_t> cpu_topology::parse_cpu_list(string_view str) {
+  std::vector<size_t> result;
+  auto i = str.begin();
+  auto e = str.end();
+  auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+  auto read_num = [&](size_t& x) {
+    if (i == e || !is_digit(*i))
+      return false;
+    x = 0;
+    while (i != e && is_digit(*i))
+      x = x * 10 + static_cast<size_t>(*i++ - '0');
+    return true;
+  };
+  while (i != e && *i != '\n') {
+    size_t first = 0;
+    if (!read_num(first))
+      return {};
+    auto last = first;
+    if (i != e && *i == '-') {
+      ++i;
+      if (!read_num(last) || last < first)
+        return {};
+    }
+    for (auto id = first; id <= last; ++id)
+      result.emplace_back(id);
+    if (i != e && *i == ',')
+      ++i;
+  }
+  return result;
+}
+
+bool cpu_topology::pin_this_thread(size_t cpu_id) {
+#ifdef CAF_LINUX
+  if (cpu_id >= CPU_SETSIZE)
+    return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu_id, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else  // CAF_LINUX
+  CAF_IGNORE_UNUSED(cpu_id);
+  return false;
+#endif // CAF_LINUX
+}
+
+} // namespace caf::detail
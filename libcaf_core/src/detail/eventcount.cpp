@@ -0,0 +1,48 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/eventcount.hpp"
+
+namespace caf::detail {
+
+eventcount::eventcount() : state_(0) {
+  // nop
+}
+
+bool eventcount::commit_wait(key_type key, timespan timeout) {
+  bool result;
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{mtx_};
+    result = cv_.wait_for(guard, timeout, [&] { return epoch() != key; });
+  }
+  state_.fetch_sub(1, std::memory_order_relaxed);
+  return result;
+}
+
+void eventcount::notify_impl(bool all) {
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{mtx_};
+    state_.fetch_add(uint64_t{1} << epoch_shift, std::memory_order_release);
+  }
+  if (all)
+    cv_.notify_all();
+  else
+    cv_.notify_one();
+}
+
+} // namespace caf::detail
@@ -0,0 +1,224 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/memory_pool.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include "caf/byte.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+// -- constants ----------------------------------------------------------------
+
+// Each block starts with a header that links back to its pool.
+constexpr size_t header_size = alignof(max_align_t);
+
+// Block sizes (including the header) are 64, 128, ..., 1024.
+constexpr size_t min_block_size = 64;
+
+constexpr size_t num_size_classes = 5;
+
+// Each pool carves blocks from slabs of this size.
+constexpr size_t slab_size = 64 * 1024;
+
+static_assert((min_block_size << (num_size_classes - 1))
+                == memory_pool::max_block_size,
+              "size classes must cover max_block_size");
+
+// -- member types -------------------------------------------------------------
+
+struct thread_pool;
+
+struct block_header {
+  // Points to the owning pool or is `nullptr` for blocks from `malloc`.
+  thread_pool* owner;
+
+  // Index into `thread_pool::free_lists`.
+  size_t size_class;
+};
+
+static_assert(sizeof(block_header) <= header_size);
+
+// Overlays the payload of released blocks.
+struct free_block {
+  free_block* next;
+};
+
+struct thread_pool {
+  // Blocks released by the owning thread, accessed by the owner only.
+  free_block* free_lists[num_size_classes] = {};
+
+  // Blocks released by other threads.
+  std::atomic<free_block*> remote_frees{nullptr};
+
+  // Links pools without owner.
+  thread_pool* next_orphan = nullptr;
+};
+
+// -- global state -------------------------------------------------------------
+
+std::atomic<bool> pooling_enabled{false};
+
+// Guards `orphans`.
+std::mutex orphans_mtx;
+
+// Pools of terminated threads. We never destroy pools, because other threads
+// may still hold blocks from them.
+thread_pool* orphans = nullptr;
+
+// -- thread-local state -------------------------------------------------------
+
+thread_local thread_pool* this_pool = nullptr;
+
+thread_local bool this_pool_released = false;
+
+struct pool_guard {
+  ~pool_guard() {
+    std::unique_lock<std::mutex> guard{orphans_mtx};
+    this_pool->next_orphan = orphans;
+    orphans = this_pool;
+    this_pool = nullptr;
+    this_pool_released = true;
+  }
+};
+
+// Returns the pool of the calling thread or `nullptr` while the thread shuts
+// down.
+thread_pool* local_pool() {
+  if (this_pool != nullptr || this_pool_released)
+    return this_pool;
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{orphans_mtx};
+    if (orphans != nullptr) {
+      this_pool = orphans;
+      orphans = orphans->next_orphan;
+      this_pool->next_orphan = nullptr;
+    }
+  }
+  if (this_pool == nullptr)
+    this_pool = new thread_pool;
+  static thread_local pool_guard guard;
+  return this_pool;
+}
+
+// -- utility functions --------------------------------------------------------
+
+block_header* header_of(void* ptr) noexcept {
+  return reinterpret_cast<block_header*>(reinterpret_cast<byte*>(ptr)
+                                         - header_size);
+}
+
+size_t size_class_of(size_t block_size) noexcept {
+  size_t result = 0;
+  for (auto n = min_block_size; n < block_size; n <<= 1)
+    ++result;
+  return result;
+}
+
+void reclaim_remote_frees(thread_pool* pool) noexcept {
+  auto ptr = pool->remote_frees.exchange(nullptr, std::memory_order_acquire);
+  while (ptr != nullptr) {
+    auto next = ptr->next;
+    auto& head = pool->free_lists[header_of(ptr)->size_class];
+    ptr->next = head;
+    head = ptr;
+    ptr = next;
+  }
+}
+
+void carve_slab(thread_pool* pool, size_t size_class) {
+  auto block_size = min_block_size << size_class;
+  auto slab = static_cast<byte*>(malloc(slab_size));
+  if (slab == nullptr)
+    throw std::bad_alloc();
+  auto& head = pool->free_lists[size_class];
+  for (size_t offset = 0; offset + block_size <= slab_size;
+       offset += block_size) {
+    new (slab + offset) block_header{pool, size_class};
+    auto blk = reinterpret_cast<free_block*>(slab + offset + header_size);
+    blk->next = head;
+    head = blk;
+  }
+}
+
+} // namespace
+
+void* memory_pool::allocate(size_t size) {
+  auto block_size = size + header_size;
+  if (block_size <= max_block_size
+      && pooling_enabled.load(std::memory_order_relaxed)) {
+    if (auto pool = local_pool()) {
+      auto size_class = size_class_of(block_size);
+      auto& head = pool->free_lists[size_class];
+      if (head == nullptr) {
+        reclaim_remote_frees(pool);
+        if (head == nullptr)
+          carve_slab(pool, size_class);
+      }
+      auto result = head;
+      head = result->next;
+      return result;
+    }
+  }
+  auto vptr = malloc(block_size);
+  if (vptr == nullptr)
+    throw std::bad_alloc();
+  new (vptr) block_header{nullptr, 0};
+  return static_cast<byte*>(vptr) + header_size;
+}
+
+void memory_pool::deallocate(void* ptr) noexcept {
+  if (ptr == nullptr)
+    return;
+  auto hdr = header_of(ptr);
+  auto owner = hdr->owner;
+  if (owner == nullptr) {
+    free(hdr);
+    return;
+  }
+  auto blk = static_cast<free_block*>(ptr);
+  if (owner == this_pool) {
+    auto& head = owner->free_lists[hdr->size_class];
+    blk->next = head;
+    head = blk;
+    return;
+  }
+  auto& remote = owner->remote_frees;
+  blk->next = remote.load(std::memory_order_relaxed);
+  while (!remote.compare_exchange_weak(blk->next, blk,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    // nop
+  }
+}
+
+void memory_pool::enable(bool flag) noexcept {
+  pooling_enabled = flag;
+}
+
+bool memory_pool::enabled() noexcept {
+  return pooling_enabled;
+}
+
+} // namespace caf::detail
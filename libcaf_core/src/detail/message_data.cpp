@@ -53,9 +53,7 @@ message_data* message_data::copy() const {
   for (auto id : types_)
     storage_size += gmos[id].padded_size;
   auto total_size = sizeof(message_data) + storage_size;
-  auto vptr = malloc(total_size);
-  if (vptr == nullptr)
-    throw std::bad_alloc();
+  auto vptr = memory_pool::allocate(total_size);
   auto ptr = new (vptr) message_data(types_);
   auto src = storage();
   auto dst = ptr->storage();
@@ -0,0 +1,90 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/message_shape_cache.hpp"
+
+#include <cstring>
+
+#include "caf/hash/fnv.hpp"
+#include "caf/span.hpp"
+
+namespace caf::detail {
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+message_shape_cache::message_shape_cache() {
+  for (auto& slot : slots_)
+    slot.store(nullptr, std::memory_order_relaxed);
+}
+
+message_shape_cache::~message_shape_cache() {
+  for (auto& slot : slots_)
+    delete slot.load(std::memory_order_relaxed);
+}
+
+// -- properties ---------------------------------------------------------------
+
+size_t message_shape_cache::hash(const type_id_t* ids) noexcept {
+  auto first = reinterpret_cast<const uint8_t*>(ids);
+  auto last = first + ((ids[0] + 1) * sizeof(type_id_t));
+  return caf::hash::fnv<size_t>::compute(make_span(first, last));
+}
+
+size_t message_shape_cache::size() const noexcept {
+  size_t result = 0;
+  for (auto& slot : slots_)
+    if (slot.load(std::memory_order_relaxed) != nullptr)
+      ++result;
+  return result;
+}
+
+// -- lookup and modifiers -----------------------------------------------------
+
+const message_shape_cache::shape*
+message_shape_cache::find(const type_id_t* ids, size_t hash) const noexcept {
+  auto num_bytes = (ids[0] + 1) * sizeof(type_id_t);
+  for (size_t i = 0; i < max_probes; ++i) {
+    auto ptr = slots_[(hash + i) % capacity].load(std::memory_order_acquire);
+    // Shapes never leave the cache, i.e., an empty slot ends the search.
+    if (ptr == nullptr)
+      return nullptr;
+    if (ptr->hash == hash && ptr->types.size() == ids[0]
+        && memcmp(ptr->types.data(), ids, num_bytes) == 0)
+      return ptr;
+  }
+  return nullptr;
+}
+
+void message_shape_cache::add(type_id_list types, size_t data_size,
+                              size_t hash) {
+  auto entry = new shape{types, data_size, hash};
+  for (size_t i = 0; i < max_probes; ++i) {
+    auto& slot = slots_[(hash + i) % capacity];
+    const shape* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, entry,
+                                     std::memory_order_acq_rel,
+                                     std::memory_order_acquire))
+      return;
+    // Stop if another thread stored the same shape concurrently.
+    if (expected->hash == hash && expected->types == types)
+      break;
+  }
+  delete entry;
+}
+
+} // namespace caf::detail
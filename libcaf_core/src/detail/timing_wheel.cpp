@@ -0,0 +1,193 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/timing_wheel.hpp"
+
+#include <algorithm>
+
+#include "caf/config.hpp"
+
+#ifdef CAF_MSVC
+#  include <intrin.h>
+#endif
+
+namespace caf::detail {
+
+namespace {
+
+using tick_type = timing_wheel::tick_type;
+
+constexpr uint8_t ready_level = timing_wheel::num_levels;
+
+constexpr tick_type slot_mask = timing_wheel::num_slots - 1;
+
+constexpr uint64_t bit(size_t slot) noexcept {
+  return uint64_t{1} << slot;
+}
+
+size_t count_trailing_zeros(uint64_t x) noexcept {
+  CAF_ASSERT(x != 0);
+#ifdef CAF_MSVC
+  unsigned long result;
+  _BitScanForward64(&result, x);
+  return static_cast<size_t>(result);
+#else
+  return static_cast<size_t>(__builtin_ctzll(x));
+#endif
+}
+
+// Returns the distance from `pos` to the next set bit in `bits` when walking
+// the slots in circular order. The result is in the range [1, 64], whereas 64
+// means that only the bit at `pos` itself is set.
+size_t next_set_bit(uint64_t bits, size_t pos) noexcept {
+  CAF_ASSERT(bits != 0);
+  auto shift = (pos + 1) & slot_mask;
+  auto rotated = shift == 0 ? bits : (bits >> shift) | (bits << (64 - shift));
+  return count_trailing_zeros(rotated) + 1;
+}
+
+} // namespace
+
+timing_wheel::timing_wheel(tick_type start) : now_(start), size_(0) {
+  occupied_.fill(0);
+}
+
+tick_type timing_wheel::next_event() const noexcept {
+  if (ready_.head != nullptr)
+    return now_;
+  if (size_ == 0)
+    return infinite;
+  auto result = infinite;
+  for (size_t level = 0; level < num_levels; ++level) {
+    if (occupied_[level] == 0)
+      continue;
+    auto shift = slot_bits * level;
+    auto pos = now_ >> shift;
+    auto dist = next_set_bit(occupied_[level], pos & slot_mask);
+    result = std::min(result, (pos + dist) << shift);
+  }
+  return result;
+}
+
+void timing_wheel::insert(node* x) noexcept {
+  CAF_ASSERT(x != nullptr);
+  CAF_ASSERT(x->prev == nullptr && x->next == nullptr);
+  ++size_;
+  if (x->due <= now_) {
+    x->level = ready_level;
+    link(ready_, x);
+    return;
+  }
+  auto delta = x->due - now_;
+  size_t level = 0;
+  while (level + 1 < num_levels
+         && delta >= (tick_type{1} << (slot_bits * (level + 1))))
+    ++level;
+  auto shift = slot_bits * level;
+  size_t slot;
+  if (level + 1 == num_levels
+      && delta >= (tick_type{1} << (slot_bits * num_levels))) {
+    // Out of range: park in the slot that cascades last and try again later.
+    slot = (now_ >> shift) & slot_mask;
+  } else {
+    slot = (x->due >> shift) & slot_mask;
+  }
+  x->level = static_cast<uint8_t>(level);
+  x->slot = static_cast<uint8_t>(slot);
+  link(slots_[level][slot], x);
+  occupied_[level] |= bit(slot);
+}
+
+void timing_wheel::erase(node* x) noexcept {
+  CAF_ASSERT(x != nullptr);
+  CAF_ASSERT(size_ > 0);
+  --size_;
+  if (x->level == ready_level) {
+    unlink(ready_, x);
+    return;
+  }
+  auto& xs = slots_[x->level][x->slot];
+  unlink(xs, x);
+  if (xs.head == nullptr)
+    occupied_[x->level] &= ~bit(x->slot);
+}
+
+void timing_wheel::cascade() noexcept {
+  // Process higher levels first. Timers from higher levels never end up in a
+  // slot of a lower level that has already been processed for this tick.
+  for (auto level = num_levels - 1; level > 0; --level) {
+    auto shift = slot_bits * level;
+    if ((now_ & ((tick_type{1} << shift) - 1)) != 0)
+      continue;
+    auto slot = (now_ >> shift) & slot_mask;
+    if ((occupied_[level] & bit(slot)) == 0)
+      continue;
+    auto x = slots_[level][slot].head;
+    slots_[level][slot] = list{};
+    occupied_[level] &= ~bit(slot);
+    while (x != nullptr) {
+      auto next = x->next;
+      x->prev = nullptr;
+      x->next = nullptr;
+      --size_;
+      insert(x);
+      x = next;
+    }
+  }
+  // All timers in the current slot of level 0 are due now.
+  auto slot = now_ & slot_mask;
+  if ((occupied_[0] & bit(slot)) == 0)
+    return;
+  auto x = slots_[0][slot].head;
+  slots_[0][slot] = list{};
+  occupied_[0] &= ~bit(slot);
+  while (x != nullptr) {
+    auto next = x->next;
+    CAF_ASSERT(x->due == now_);
+    x->prev = nullptr;
+    x->next = nullptr;
+    x->level = ready_level;
+    link(ready_, x);
+    x = next;
+  }
+}
+
+void timing_wheel::link(list& xs, node* x) noexcept {
+  x->prev = xs.tail;
+  x->next = nullptr;
+  if (xs.tail != nullptr)
+    xs.tail->next = x;
+  else
+    xs.head = x;
+  xs.tail = x;
+}
+
+void timing_wheel::unlink(list& xs, node* x) noexcept {
+  if (x->prev != nullptr)
+    x->prev->next = x->next;
+  else
+    xs.head = x->next;
+  if (x->next != nullptr)
+    x->next->prev = x->prev;
+  else
+    xs.tail = x->prev;
+  x->prev = nullptr;
+  x->next = nullptr;
+}
+
+} // namespace caf::detail
@@ -0,0 +1,619 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/timing_wheel_actor_clock.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "caf/abstract_actor.hpp"
+#include "caf/actor_control_block.hpp"
+#include "caf/config.hpp"
+#include "caf/detail/memory_pool.hpp"
+#include "caf/group.hpp"
+#include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/message.hpp"
+#include "caf/message_id.hpp"
+#include "caf/sec.hpp"
+#include "caf/system_messages.hpp"
+
+namespace caf::detail {
+
+namespace {
+
+using tick_type = timing_wheel::tick_type;
+
+enum class entry_type : uint8_t {
+  ordinary_timeout,
+  multi_timeout,
+  request_timeout,
+  actor_msg,
+  group_msg,
+};
+
+struct entry;
+
+/// Links an entry into a bucket of an `intrusive_index`.
+struct hook {
+  entry* prev = nullptr;
+  entry* next = nullptr;
+  size_t hash = 0;
+};
+
+/// Stores all state for a timeout or a delayed message.
+struct entry : timing_wheel::node {
+  entry(entry_type type, actor_id aid) : type(type), aid(aid) {
+    // nop
+  }
+
+  /// Returns whether actors can cancel this entry.
+  bool cancellable() const noexcept {
+    return type <= entry_type::request_timeout;
+  }
+
+  static void* operator new(size_t size) {
+    return memory_pool::allocate(size);
+  }
+
+  static void operator delete(void* ptr) noexcept {
+    memory_pool::deallocate(ptr);
+  }
+
+  entry_type type;
+
+  /// Owner of a timeout or `invalid_actor_id` for delayed messages.
+  actor_id aid;
+
+  /// Owner of a timeout, receiver of an actor message or sender of a group
+  /// message.
+  strong_actor_ptr self;
+
+  /// Timeout type.
+  std::string name;
+
+  /// Timeout ID.
+  uint64_t id = 0;
+
+  /// Message ID of a request.
+  message_id mid;
+
+  /// Content of an actor message.
+  mailbox_element_ptr content;
+
+  /// Receiver of a group message.
+  group target;
+
+  /// Content of a group message.
+  message payload;
+
+  /// Links all entries of the same actor.
+  hook by_actor;
+
+  /// Links entries with the same key, i.e., ordinary timeouts of the same
+  /// type or request timeouts for the same message ID.
+  hook by_key;
+};
+
+/// Mixes the bits of `x` (finalizer of MurmurHash3).
+size_t mix(uint64_t x) noexcept {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return static_cast<size_t>(x);
+}
+
+size_t actor_hash(actor_id aid) noexcept {
+  return mix(aid);
+}
+
+size_t ordinary_key_hash(actor_id aid, const std::string& name) noexcept {
+  return mix(aid ^ std::hash<std::string>{}(name));
+}
+
+size_t request_key_hash(actor_id aid, message_id mid) noexcept {
+  return mix(aid ^ mix(mid.integer_value()));
+}
+
+/// A hash index with intrusive chaining. Inserting and erasing only allocates
+/// when growing the bucket array.
+template <hook entry::*Hook>
+class intrusive_index {
+public:
+  intrusive_index() : buckets_(initial_size, nullptr), size_(0) {
+    // nop
+  }
+
+  template <class Predicate>
+  entry* find(size_t hash, Predicate pred) const {
+    for (auto x = buckets_[hash & mask()]; x != nullptr; x = (x->*Hook).next)
+      if ((x->*Hook).hash == hash && pred(*x))
+        return x;
+    return nullptr;
+  }
+
+  template <class Predicate, class F>
+  void find_all(size_t hash, Predicate pred, F f) const {
+    for (auto x = buckets_[hash & mask()]; x != nullptr;) {
+      // Read the successor first, since `f` may remove `x`.
+      auto next = (x->*Hook).next;
+      if ((x->*Hook).hash == hash && pred(*x))
+        f(x);
+      x = next;
+    }
+  }
+
+  void insert(size_t hash, entry* x) {
+    if (size_ >= buckets_.size())
+      grow();
+    (x->*Hook).hash = hash;
+    link(buckets_[hash & mask()], x);
+    ++size_;
+  }
+
+  void erase(entry* x) noexcept {
+    auto& h = x->*Hook;
+    if (h.prev != nullptr)
+      (h.prev->*Hook).next = h.next;
+    else
+      buckets_[h.hash & mask()] = h.next;
+    if (h.next != nullptr)
+      (h.next->*Hook).prev = h.prev;
+    h.prev = nullptr;
+    h.next = nullptr;
+    --size_;
+  }
+
+  void clear() noexcept {
+    std::fill(buckets_.begin(), buckets_.end(), nullptr);
+    size_ = 0;
+  }
+
+private:
+  static constexpr size_t initial_size = 64;
+
+  size_t mask() const noexcept {
+    return buckets_.size() - 1;
+  }
+
+  static void link(entry*& head, entry* x) noexcept {
+    auto& h = x->*Hook;
+    h.prev = nullptr;
+    h.next = head;
+    if (head != nullptr)
+      (head->*Hook).prev = x;
+    head = x;
+  }
+
+  void grow() {
+    std::vector<entry*> tmp(buckets_.size() * 2, nullptr);
+    tmp.swap(buckets_);
+    for (auto x : tmp) {
+      while (x != nullptr) {
+        auto next = (x->*Hook).next;
+        link(buckets_[(x->*Hook).hash & mask()], x);
+        x = next;
+      }
+    }
+  }
+
+  std::vector<entry*> buckets_;
+
+  size_t size_;
+};
+
+/// A singly linked list of entries, reusing the links of the wheel.
+struct entry_list {
+  entry* head = nullptr;
+  entry* tail = nullptr;
+
+  void push_back(entry* x) noexcept {
+    x->next = nullptr;
+    if (tail == nullptr)
+      head = x;
+    else
+      tail->next = x;
+    tail = x;
+  }
+
+  template <class F>
+  size_t consume(F f) {
+    size_t result = 0;
+    auto x = head;
+    head = nullptr;
+    tail = nullptr;
+    while (x != nullptr) {
+      auto next = static_cast<entry*>(x->next);
+      x->next = nullptr;
+      f(x);
+      delete x;
+      x = next;
+      ++result;
+    }
+    return result;
+  }
+
+  void clear() {
+    consume([](entry*) {});
+  }
+};
+
+void ship(entry& x) {
+  switch (x.type) {
+    case entry_type::ordinary_timeout:
+    case entry_type::multi_timeout: {
+      x.self->get()->eq_impl(make_message_id(), x.self, nullptr,
+                             timeout_msg{std::move(x.name), x.id});
+      break;
+    }
+    case entry_type::request_timeout: {
+      x.self->get()->eq_impl(x.mid, x.self, nullptr, sec::request_timeout);
+      break;
+    }
+    case entry_type::actor_msg: {
+      x.self->enqueue(std::move(x.content), nullptr);
+      break;
+    }
+    case entry_type::group_msg: {
+      if (auto dst = x.target->get())
+        dst->enqueue(std::move(x.self), make_message_id(),
+                     std::move(x.payload), nullptr);
+      break;
+    }
+  }
+}
+
+} // namespace
+
+// -- shard --------------------------------------------------------------------
+
+struct alignas(CAF_CACHE_LINE_SIZE) timing_wheel_actor_clock::shard {
+  std::mutex mtx;
+
+  timing_wheel wheel;
+
+  intrusive_index<&entry::by_actor> actors;
+
+  intrusive_index<&entry::by_key> keys;
+
+  void add(entry* x) {
+    wheel.insert(x);
+    if (!x->cancellable())
+      return;
+    actors.insert(actor_hash(x->aid), x);
+    switch (x->type) {
+      case entry_type::ordinary_timeout:
+        keys.insert(ordinary_key_hash(x->aid, x->name), x);
+        break;
+      case entry_type::request_timeout:
+        keys.insert(request_key_hash(x->aid, x->mid), x);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void remove(entry* x) noexcept {
+    wheel.erase(x);
+    unindex(x);
+  }
+
+  void unindex(entry* x) noexcept {
+    if (!x->cancellable())
+      return;
+    actors.erase(x);
+    if (x->type != entry_type::multi_timeout)
+      keys.erase(x);
+  }
+
+  entry* find_ordinary(actor_id aid, const std::string& name) const {
+    auto pred = [&](const entry& y) {
+      return y.type == entry_type::ordinary_timeout && y.aid == aid
+             && y.name == name;
+    };
+    return keys.find(ordinary_key_hash(aid, name), pred);
+  }
+
+  entry* find_request(actor_id aid, message_id mid) const {
+    auto pred = [&](const entry& y) {
+      return y.type == entry_type::request_timeout && y.aid == aid
+             && y.mid == mid;
+    };
+    return keys.find(request_key_hash(aid, mid), pred);
+  }
+
+  void clear(entry_list& dropped) {
+    wheel.clear([&](timing_wheel::node* x) {
+      dropped.push_back(static_cast<entry*>(x));
+    });
+    actors.clear();
+    keys.clear();
+  }
+};
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+timing_wheel_actor_clock::timing_wheel_actor_clock(size_t num_shards,
+                                                   timespan resolution)
+  : epoch_(clock_type::now()),
+    resolution_(std::chrono::duration_cast<duration_type>(resolution)),
+    wakeup_tick_(0),
+    dirty_(false),
+    shutdown_(false) {
+  if (num_shards == 0)
+    num_shards = 1;
+  if (resolution_.count() <= 0)
+    resolution_ = duration_type{1};
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i)
+    shards_.emplace_back(std::make_unique<shard>());
+}
+
+timing_wheel_actor_clock::~timing_wheel_actor_clock() {
+  entry_list dropped;
+  for (auto& s : shards_)
+    s->clear(dropped);
+  dropped.clear();
+}
+
+// -- properties ---------------------------------------------------------------
+
+size_t timing_wheel_actor_clock::pending() const {
+  size_t result = 0;
+  for (auto& s : shards_) {
+    std::unique_lock<std::mutex> guard{s->mtx};
+    result += s->wheel.size();
+  }
+  return result;
+}
+
+// -- overridden member functions ----------------------------------------------
+
+void timing_wheel_actor_clock::set_ordinary_timeout(time_point t,
+                                                    abstract_actor* self,
+                                                    std::string type,
+                                                    uint64_t id) {
+  auto x = new entry(entry_type::ordinary_timeout, self->id());
+  x->due = to_tick(t);
+  x->self = self->ctrl();
+  x->name = std::move(type);
+  x->id = id;
+  auto due = x->due;
+  entry_list dropped;
+  auto& s = shard_for(x->aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    // Only one ordinary timeout per type can be active.
+    if (auto prev = s.find_ordinary(x->aid, x->name)) {
+      s.remove(prev);
+      dropped.push_back(prev);
+    }
+    s.add(x);
+  }
+  dropped.clear();
+  notify_dispatcher(due);
+}
+
+void timing_wheel_actor_clock::set_multi_timeout(time_point t,
+                                                 abstract_actor* self,
+                                                 std::string type,
+                                                 uint64_t id) {
+  auto x = new entry(entry_type::multi_timeout, self->id());
+  x->due = to_tick(t);
+  x->self = self->ctrl();
+  x->name = std::move(type);
+  x->id = id;
+  auto due = x->due;
+  auto& s = shard_for(x->aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    s.add(x);
+  }
+  notify_dispatcher(due);
+}
+
+void timing_wheel_actor_clock::set_request_timeout(time_point t,
+                                                   abstract_actor* self,
+                                                   message_id id) {
+  auto x = new entry(entry_type::request_timeout, self->id());
+  x->due = to_tick(t);
+  x->self = self->ctrl();
+  x->mid = id;
+  auto due = x->due;
+  auto& s = shard_for(x->aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    s.add(x);
+  }
+  notify_dispatcher(due);
+}
+
+void timing_wheel_actor_clock::cancel_ordinary_timeout(abstract_actor* self,
+                                                       std::string type) {
+  auto aid = self->id();
+  entry_list dropped;
+  auto& s = shard_for(aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    if (auto x = s.find_ordinary(aid, type)) {
+      s.remove(x);
+      dropped.push_back(x);
+    }
+  }
+  dropped.clear();
+}
+
+void timing_wheel_actor_clock::cancel_request_timeout(abstract_actor* self,
+                                                      message_id id) {
+  auto aid = self->id();
+  entry_list dropped;
+  auto& s = shard_for(aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    if (auto x = s.find_request(aid, id)) {
+      s.remove(x);
+      dropped.push_back(x);
+    }
+  }
+  dropped.clear();
+}
+
+void timing_wheel_actor_clock::cancel_timeouts(abstract_actor* self) {
+  auto aid = self->id();
+  entry_list dropped;
+  auto& s = shard_for(aid);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    auto pred = [aid](const entry& y) { return y.aid == aid; };
+    s.actors.find_all(actor_hash(aid), pred, [&](entry* x) {
+      s.remove(x);
+      dropped.push_back(x);
+    });
+  }
+  dropped.clear();
+}
+
+void timing_wheel_actor_clock::schedule_message(time_point t,
+                                                strong_actor_ptr receiver,
+                                                mailbox_element_ptr content) {
+  auto x = new entry(entry_type::actor_msg, invalid_actor_id);
+  x->due = to_tick(t);
+  x->self = std::move(receiver);
+  x->content = std::move(content);
+  auto due = x->due;
+  auto& s = shard_for(x->self->id());
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    s.add(x);
+  }
+  notify_dispatcher(due);
+}
+
+void timing_wheel_actor_clock::schedule_message(time_point t, group target,
+                                                strong_actor_ptr sender,
+                                                message content) {
+  auto x = new entry(entry_type::group_msg, invalid_actor_id);
+  x->due = to_tick(t);
+  x->self = std::move(sender);
+  x->target = std::move(target);
+  x->payload = std::move(content);
+  auto due = x->due;
+  auto& s = shard_for(x->self != nullptr ? x->self->id() : invalid_actor_id);
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{s.mtx};
+    s.add(x);
+  }
+  notify_dispatcher(due);
+}
+
+void timing_wheel_actor_clock::cancel_all() {
+  entry_list dropped;
+  for (auto& s : shards_) {
+    std::unique_lock<std::mutex> guard{s->mtx};
+    s->clear(dropped);
+  }
+  dropped.clear();
+}
+
+// -- dispatching --------------------------------------------------------------
+
+size_t timing_wheel_actor_clock::trigger_expired_timeouts() {
+  size_t result = 0;
+  // Round down to never ship an entry early.
+  auto t = static_cast<tick_type>((now() - epoch_) / resolution_);
+  entry_list expired;
+  for (auto& s : shards_) {
+    { // Lifetime scope of guard.
+      std::unique_lock<std::mutex> guard{s->mtx};
+      s->wheel.advance(t, [&](timing_wheel::node* ptr) {
+        auto x = static_cast<entry*>(ptr);
+        s->unindex(x);
+        expired.push_back(x);
+      });
+    }
+    result += expired.consume([](entry* x) { ship(*x); });
+  }
+  return result;
+}
+
+void timing_wheel_actor_clock::run_dispatch_loop() {
+  for (;;) {
+    trigger_expired_timeouts();
+    // Publish that we are about to go to sleep before looking at the shards.
+    // Any entry added afterwards notifies us if it expires before `next`.
+    wakeup_tick_.store(timing_wheel::infinite);
+    auto next = timing_wheel::infinite;
+    for (auto& s : shards_) {
+      std::unique_lock<std::mutex> guard{s->mtx};
+      next = std::min(next, s->wheel.next_event());
+    }
+    std::unique_lock<std::mutex> guard{mtx_};
+    if (!dirty_ && !shutdown_) {
+      wakeup_tick_.store(next);
+      auto pred = [this] { return dirty_ || shutdown_; };
+      if (next == timing_wheel::infinite)
+        cv_.wait(guard, pred);
+      else
+        cv_.wait_until(guard, to_time_point(next), pred);
+    }
+    wakeup_tick_.store(0);
+    dirty_ = false;
+    if (shutdown_)
+      break;
+  }
+  cancel_all();
+}
+
+void timing_wheel_actor_clock::cancel_dispatch_loop() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  shutdown_ = true;
+  cv_.notify_all();
+}
+
+// -- utility functions --------------------------------------------------------
+
+timing_wheel_actor_clock::shard&
+timing_wheel_actor_clock::shard_for(actor_id id) {
+  return *shards_[id % shards_.size()];
+}
+
+timing_wheel::tick_type
+timing_wheel_actor_clock::to_tick(time_point t) const noexcept {
+  if (t <= epoch_)
+    return 0;
+  // Round up to never ship an entry early.
+  auto ticks = (t - epoch_ + resolution_ - duration_type{1}) / resolution_;
+  return static_cast<tick_type>(ticks);
+}
+
+actor_clock::time_point
+timing_wheel_actor_clock::to_time_point(tick_type t) const noexcept {
+  return epoch_ + resolution_ * static_cast<duration_type::rep>(t);
+}
+
+void timing_wheel_actor_clock::notify_dispatcher(tick_type due) {
+  if (due < wakeup_tick_.load()) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    dirty_ = true;
+    cv_.notify_one();
+  }
+}
+
+} // namespace caf::detail
@@ -58,6 +58,13 @@ intptr_t group::compare(const group& other) const noexcept {
   return compare(ptr_.get(), other.ptr_.get());
 }
 
+void group::eq_batch_impl(message_id mid, strong_actor_ptr sender,
+                          execution_unit* ctx, std::vector<message> xs) const {
+  CAF_ASSERT(!mid.is_request());
+  if (ptr_ && !xs.empty())
+    ptr_->enqueue_batch(std::move(sender), mid, std::move(xs), ctx);
+}
+
 namespace {
 
 template <class Serializer>
@@ -16,13 +16,17 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
-#include <set>
 #include <mutex>
+#include <utility>
+#include <vector>
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <condition_variable>
 
 #include "caf/locks.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/no_stages.hpp"
 
 #include "caf/all.hpp"
 #include "caf/group.hpp"
@@ -60,16 +64,103 @@ void await_all_locals_down(actor_system& sys, std::initializer_list<actor> xs) {
     self->wait_for(ys);
 }
 
+/// Immutable, sorted snapshot of all subscribers of a local group. Writers
+/// replace the snapshot instead of modifying it in place, which allows
+/// publishers to iterate a contiguous array without holding a lock.
+class subscriber_list : public ref_counted {
+public:
+  using value_type = strong_actor_ptr;
+
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  subscriber_list() = default;
+
+  explicit subscriber_list(std::vector<value_type> xs) : xs_(std::move(xs)) {
+    // nop
+  }
+
+  const_iterator begin() const noexcept {
+    return xs_.begin();
+  }
+
+  const_iterator end() const noexcept {
+    return xs_.end();
+  }
+
+  size_t size() const noexcept {
+    return xs_.size();
+  }
+
+  /// Returns the position of `who` or the position for inserting `who`.
+  const_iterator lower_bound(const actor_control_block* who) const {
+    return std::lower_bound(xs_.begin(), xs_.end(), who,
+                            [](const value_type& x,
+                               const actor_control_block* y) {
+                              return std::less<>{}(x.get(), y);
+                            });
+  }
+
+  /// Returns a copy of this list with `who` inserted at `pos`.
+  intrusive_ptr<subscriber_list> insert(const_iterator pos,
+                                        value_type who) const {
+    std::vector<value_type> ys;
+    ys.reserve(xs_.size() + 1);
+    ys.insert(ys.end(), xs_.begin(), pos);
+    ys.emplace_back(std::move(who));
+    ys.insert(ys.end(), pos, xs_.end());
+    return make_counted<subscriber_list>(std::move(ys));
+  }
+
+  /// Returns a copy of this list without the element at `pos`.
+  intrusive_ptr<subscriber_list> erase(const_iterator pos) const {
+    std::vector<value_type> ys;
+    ys.reserve(xs_.size() - 1);
+    ys.insert(ys.end(), xs_.begin(), pos);
+    ys.insert(ys.end(), pos + 1, xs_.end());
+    return make_counted<subscriber_list>(std::move(ys));
+  }
+
+private:
+  std::vector<value_type> xs_;
+};
+
+using subscriber_list_ptr = intrusive_ptr<subscriber_list>;
+
+mailbox_element_chain make_batch(const strong_actor_ptr& sender,
+                                 message_id mid,
+                                 const std::vector<message>& xs) {
+  mailbox_element_chain result;
+  for (auto& x : xs)
+    result.push_back(make_mailbox_element(sender, mid, no_stages, x));
+  return result;
+}
+
 class local_group : public abstract_group {
 public:
+  /// Returns the current set of subscribers. The snapshot remains valid and
+  /// unchanged after concurrent calls to `subscribe` or `unsubscribe`.
+  subscriber_list_ptr subscribers() {
+    shared_guard guard(mtx_);
+    return subscribers_;
+  }
+
   void send_all_subscribers(const strong_actor_ptr& sender, const message& msg,
                             execution_unit* host) {
     CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(msg));
-    shared_guard guard(mtx_);
-    for (auto& s : subscribers_)
+    auto subs = subscribers();
+    for (auto& s : *subs)
       s->enqueue(sender, make_message_id(), msg, host);
   }
 
+  void send_all_subscribers(const strong_actor_ptr& sender, message_id mid,
+                            const std::vector<message>& xs,
+                            execution_unit* host) {
+    CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(mid) << CAF_ARG(xs));
+    auto subs = subscribers();
+    for (auto& s : *subs)
+      s->get()->enqueue_batch(make_batch(sender, mid, xs), host);
+  }
+
   void enqueue(strong_actor_ptr sender, message_id, message msg,
                execution_unit* host) override {
     CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(msg));
@@ -77,27 +168,36 @@ public:
     broker_->enqueue(sender, make_message_id(), msg, host);
   }
 
+  void enqueue_batch(strong_actor_ptr sender, message_id mid,
+                     std::vector<message> xs, execution_unit* host) override {
+    CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(mid) << CAF_ARG(xs));
+    send_all_subscribers(sender, mid, xs, host);
+    broker_->enqueue_batch(make_batch(sender, mid, xs), host);
+  }
+
   std::pair<bool, size_t> add_subscriber(strong_actor_ptr who) {
     CAF_LOG_TRACE(CAF_ARG(who));
-    if (!who)
-      return {false, subscribers_.size()};
+    // Destroy the previous snapshot only after releasing the lock.
+    subscriber_list_ptr old;
     exclusive_guard guard(mtx_);
-    auto res = subscribers_.emplace(std::move(who)).second;
-    return {res, subscribers_.size()};
+    if (!who)
+      return {false, subscribers_->size()};
+    auto i = subscribers_->lower_bound(who.get());
+    if (i != subscribers_->end() && i->get() == who.get())
+      return {false, subscribers_->size()};
+    old = std::exchange(subscribers_, subscribers_->insert(i, std::move(who)));
+    return {true, subscribers_->size()};
   }
 
   std::pair<bool, size_t> erase_subscriber(const actor_control_block* who) {
     CAF_LOG_TRACE(""); // serializing who would cause a deadlock
+    subscriber_list_ptr old;
     exclusive_guard guard(mtx_);
-    auto e = subscribers_.end();
-    auto cmp = [&](const strong_actor_ptr& lhs) {
-      return lhs.get() == who;
-    };
-    auto i = std::find_if(subscribers_.begin(), e, cmp);
-    if(i == e)
-      return {false, subscribers_.size()};
-    subscribers_.erase(i);
-    return {true, subscribers_.size()};
+    auto i = subscribers_->lower_bound(who);
+    if (i == subscribers_->end() || i->get() != who)
+      return {false, subscribers_->size()};
+    old = std::exchange(subscribers_, subscribers_->erase(i));
+    return {true, subscribers_->size()};
   }
 
   bool subscribe(strong_actor_ptr who) override {
@@ -130,11 +230,7 @@ public:
 
 protected:
   detail::shared_spinlock mtx_;
-#if __cplusplus > 201103L
-  std::set<strong_actor_ptr, std::less<>> subscribers_;
-#else
-  std::set<strong_actor_ptr> subscribers_;
-#endif
+  subscriber_list_ptr subscribers_;
   actor broker_;
 };
 
@@ -180,15 +276,20 @@ public:
     return {
       [=](join_atom, const actor& other) {
         CAF_LOG_TRACE(CAF_ARG(other));
-        if (acquaintances_.insert(other).second) {
+        auto last = acquaintances_.end();
+        if (std::find(acquaintances_.begin(), last, other) == last) {
+          acquaintances_.emplace_back(other);
           monitor(other);
         }
       },
       [=](leave_atom, const actor& other) {
         CAF_LOG_TRACE(CAF_ARG(other));
-        acquaintances_.erase(other);
-        if (acquaintances_.erase(other) > 0)
+        auto last = acquaintances_.end();
+        auto i = std::find(acquaintances_.begin(), last, other);
+        if (i != last) {
+          acquaintances_.erase(i);
           demonitor(other);
+        }
       },
       [=](forward_atom, const message& what) {
         CAF_LOG_TRACE(CAF_ARG(what));
@@ -211,7 +312,7 @@ private:
   }
 
   local_group_ptr group_;
-  std::set<actor> acquaintances_;
+  std::vector<actor> acquaintances_;
 };
 
 // Send a join message to the original group if a proxy
@@ -281,6 +382,17 @@ public:
                      make_message(forward_atom_v, std::move(msg)), eu);
   }
 
+  void enqueue_batch(strong_actor_ptr sender, message_id mid,
+                     std::vector<message> xs, execution_unit* eu) override {
+    CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(mid) << CAF_ARG(xs));
+    // forward all messages to the broker at once
+    mailbox_element_chain batch;
+    for (auto& x : xs)
+      batch.push_back(make_mailbox_element(sender, mid, no_stages,
+                                           forward_atom_v, std::move(x)));
+    broker_->enqueue_batch(std::move(batch), eu);
+  }
+
   void stop() override {
     CAF_LOG_TRACE("");
     await_all_locals_down(system_, {monitor_, proxy_broker_, broker_});
@@ -437,6 +549,7 @@ private:
 local_group::local_group(local_group_module& mod, std::string id, node_id nid,
                          optional<actor> lb)
     : abstract_group(mod, std::move(id), std::move(nid)),
+      subscribers_(make_counted<subscriber_list>()),
       broker_(lb ? *lb : mod.system().spawn<local_broker, hidden>(this)) {
   CAF_LOG_TRACE(CAF_ARG(id) << CAF_ARG(nid));
 }
@@ -22,6 +22,7 @@
 #include "caf/defaults.hpp"
 #include "caf/detail/complexity_based_credit_controller.hpp"
 #include "caf/detail/meta_object.hpp"
+#include "caf/detail/rate_based_credit_controller.hpp"
 #include "caf/detail/size_based_credit_controller.hpp"
 #include "caf/detail/test_credit_controller.hpp"
 #include "caf/logger.hpp"
@@ -58,6 +59,7 @@ void emit_ack_batch(inbound_path& path, credit_controller::assignment x,
   if (new_credit < 1)
     return;
   guard.disable();
+  path.controller_->credit_granted(path.assigned_credit, new_credit);
   unsafe_send_as(path.self(), path.hdl,
                  make<upstream_msg::ack_batch>(
                    path.slots.invert(), path.self()->address(), new_credit,
@@ -83,6 +85,8 @@ inbound_path::inbound_path(stream_manager_ptr mgr_ptr, stream_slots id,
       controller_.reset(new detail::test_credit_controller(self()));
     else if (*str == "size")
       controller_.reset(new detail::size_based_credit_controller(self()));
+    else if (*str == "rate")
+      controller_.reset(new detail::rate_based_credit_controller(self()));
     else
       controller_.reset(new detail::complexity_based_credit_controller(self()));
   } else {
@@ -112,10 +116,10 @@ void inbound_path::handle(downstream_msg::batch& x) {
     assigned_credit -= batch_size;
     CAF_ASSERT(assigned_credit >= 0);
   }
+  controller_->before_processing(x);
   auto threshold = controller_->threshold();
   if (threshold >= 0 && assigned_credit <= threshold)
     caf::emit_ack_batch(*this, controller_->compute_bridge());
-  controller_->before_processing(x);
   mgr->handle(this, x);
   controller_->after_processing(x);
   mgr->push();
@@ -127,6 +131,7 @@ void inbound_path::emit_ack_open(local_actor* self, actor_addr rebind_from) {
   auto initial = controller_->compute_initial();
   assigned_credit = mgr->acquire_credit(this, initial.credit);
   CAF_ASSERT(assigned_credit >= 0);
+  controller_->credit_granted(0, assigned_credit);
   desired_batch_size = std::min(initial.batch_size, assigned_credit);
   // Make sure we receive errors from this point on.
   stream_aborter::add(hdl, self->address(), slots.receiver,
@@ -19,6 +19,7 @@
 #include "caf/mailbox_element.hpp"
 
 #include <memory>
+#include <utility>
 
 namespace caf {
 
@@ -74,4 +75,49 @@ make_mailbox_element(strong_actor_ptr sender, message_id id,
     std::move(sender), id, std::move(stages), std::move(payload));
 }
 
+mailbox_element_chain::mailbox_element_chain() noexcept
+  : head_(nullptr), tail_(nullptr), size_(0) {
+  // nop
+}
+
+mailbox_element_chain::mailbox_element_chain(
+  mailbox_element_chain&& other) noexcept
+  : head_(other.head_), tail_(other.tail_), size_(other.size_) {
+  other.release();
+}
+
+mailbox_element_chain&
+mailbox_element_chain::operator=(mailbox_element_chain&& other) noexcept {
+  using std::swap;
+  swap(head_, other.head_);
+  swap(tail_, other.tail_);
+  swap(size_, other.size_);
+  return *this;
+}
+
+mailbox_element_chain::~mailbox_element_chain() {
+  auto ptr = head_;
+  while (ptr != nullptr) {
+    auto next = static_cast<mailbox_element*>(ptr->next);
+    delete ptr;
+    ptr = next;
+  }
+}
+
+void mailbox_element_chain::push_back(mailbox_element_ptr ptr) noexcept {
+  CAF_ASSERT(ptr != nullptr);
+  auto x = ptr.release();
+  x->next = head_;
+  head_ = x;
+  if (tail_ == nullptr)
+    tail_ = x;
+  ++size_;
+}
+
+void mailbox_element_chain::release() noexcept {
+  head_ = nullptr;
+  tail_ = nullptr;
+  size_ = 0;
+}
+
 } // namespace caf
@@ -24,6 +24,8 @@
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/deserializer.hpp"
+#include "caf/detail/memory_pool.hpp"
+#include "caf/detail/message_shape_cache.hpp"
 #include "caf/detail/meta_object.hpp"
 #include "caf/detail/type_id_list_builder.hpp"
 #include "caf/message_builder.hpp"
@@ -35,41 +37,35 @@ namespace caf {
 
 namespace {
 
-template <class Deserializer>
-typename Deserializer::result_type
-load_data(Deserializer& source, message::data_ptr& data) {
-  uint16_t ids_size = 0;
-  if (auto err = source.apply(ids_size))
-    return err;
-  if (ids_size == 0) {
-    data.reset();
-    return caf::none;
-  }
-  detail::type_id_list_builder ids;
-  ids.reserve(ids_size + 1); // +1 for the prefixed size
-  for (size_t i = 0; i < ids_size; ++i) {
-    type_id_t id = 0;
-    if (auto err = source.apply(id))
-      return err;
-    ids.push_back(id);
-  }
-  CAF_ASSERT(ids.size() == ids_size);
+// Computes the combined padded size of the elements for the first `size` type
+// IDs in `ids`. Returns `false` if `ids` contains an unknown type.
+template <class Ids>
+bool padded_data_size(const Ids& ids, size_t size, size_t& result) {
   auto gmos = detail::global_meta_objects();
-  size_t data_size = 0;
-  for (size_t i = 0; i < ids_size; ++i) {
+  result = 0;
+  for (size_t i = 0; i < size; ++i) {
     auto id = ids[i];
     if (id >= gmos.size())
-      return sec::unknown_type;
+      return false;
     auto& mo = gmos[id];
     if (mo.type_name == nullptr)
-      return sec::unknown_type;
-    data_size += mo.padded_size;
+      return false;
+    result += mo.padded_size;
   }
-  auto vptr = malloc(sizeof(detail::message_data) + data_size);
-  auto ptr = new (vptr) detail::message_data(ids.move_to_list());
+  return true;
+}
+
+template <class Deserializer>
+typename Deserializer::result_type
+load_elements(Deserializer& source, type_id_list types, size_t data_size,
+              message::data_ptr& data) {
+  auto gmos = detail::global_meta_objects();
+  auto vptr = detail::memory_pool::allocate(sizeof(detail::message_data)
+                                            + data_size);
+  auto ptr = new (vptr) detail::message_data(types);
   auto pos = ptr->storage();
-  auto types = ptr->types();
-  for (auto i = 0; i < ids_size; ++i) {
+  auto ids_size = types.size();
+  for (size_t i = 0; i < ids_size; ++i) {
     auto& meta = gmos[types[i]];
     meta.default_construct(pos);
     if (auto err = load(meta, source, pos)) {
@@ -80,7 +76,7 @@ load_data(Deserializer& source, message::data_ptr& data) {
         rpos -= jmeta.padded_size;
       }
       ptr->~message_data();
-      free(vptr);
+      detail::memory_pool::deallocate(vptr);
       return err;
     }
     pos += meta.padded_size;
@@ -89,6 +85,73 @@ load_data(Deserializer& source, message::data_ptr& data) {
   return caf::none;
 }
 
+template <class Deserializer>
+typename Deserializer::result_type
+load_data(Deserializer& source, uint16_t ids_size, message::data_ptr& data) {
+  detail::type_id_list_builder ids;
+  ids.reserve(ids_size + 1); // +1 for the prefixed size
+  for (size_t i = 0; i < ids_size; ++i) {
+    type_id_t id = 0;
+    if (auto err = source.apply(id))
+      return err;
+    ids.push_back(id);
+  }
+  CAF_ASSERT(ids.size() == ids_size);
+  size_t data_size = 0;
+  if (!padded_data_size(ids, ids_size, data_size))
+    return sec::unknown_type;
+  return load_elements(source, ids.move_to_list(), data_size, data);
+}
+
+template <class Deserializer>
+typename Deserializer::result_type
+load_data(Deserializer& source, message::data_ptr& data) {
+  uint16_t ids_size = 0;
+  if (auto err = source.apply(ids_size))
+    return err;
+  if (ids_size == 0) {
+    data.reset();
+    return caf::none;
+  }
+  return load_data(source, ids_size, data);
+}
+
+// Same as above, but skips validating and interning the type IDs for message
+// shapes found in `cache`.
+error_code<sec> load_data(binary_deserializer& source,
+                          detail::message_shape_cache& cache,
+                          message::data_ptr& data) {
+  using detail::message_shape_cache;
+  uint16_t ids_size = 0;
+  if (auto err = source.apply(ids_size))
+    return err;
+  if (ids_size == 0) {
+    data.reset();
+    return caf::none;
+  }
+  if (ids_size > message_shape_cache::max_shape_size)
+    return load_data(source, ids_size, data);
+  // Read the type IDs into a size-prefixed list on the stack.
+  type_id_t ids[message_shape_cache::max_shape_size + 1];
+  ids[0] = ids_size;
+  for (size_t i = 1; i <= ids_size; ++i)
+    if (auto err = source.apply(ids[i]))
+      return err;
+  auto hash = message_shape_cache::hash(ids);
+  if (auto shape = cache.find(ids, hash))
+    return load_elements(source, shape->types, shape->data_size, data);
+  size_t data_size = 0;
+  if (!padded_data_size(ids + 1, ids_size, data_size))
+    return sec::unknown_type;
+  detail::type_id_list_builder builder;
+  builder.reserve(ids_size + 1);
+  for (size_t i = 1; i <= ids_size; ++i)
+    builder.push_back(ids[i]);
+  auto types = builder.move_to_list();
+  cache.add(types, data_size, hash);
+  return load_elements(source, types, data_size, data);
+}
+
 } // namespace
 
 error message::load(deserializer& source) {
@@ -96,6 +159,8 @@ error message::load(deserializer& source) {
 }
 
 error_code<sec> message::load(binary_deserializer& source) {
+  if (auto cache = source.shape_cache())
+    return load_data(source, *cache, data_);
   return load_data(source, data_);
 }
 
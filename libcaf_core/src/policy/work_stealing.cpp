@@ -47,13 +47,18 @@ work_stealing::worker_data::worker_data(scheduler::abstract_coordinator* p)
         CONFIG("moderate-sleep-duration", moderate_sleep_duration)},
        {1, 0, CONFIG("relaxed-steal-interval", relaxed_steal_interval),
         CONFIG("relaxed-sleep-duration", relaxed_sleep_duration)}}} {
-  // nop
+  if (CONFIG("topology-aware", topology_aware)) {
+    auto cpus = detail::cpu_topology::query();
+    if (!cpus.empty())
+      topology = std::make_shared<detail::cpu_topology>(std::move(cpus));
+  }
 }
 
 work_stealing::worker_data::worker_data(const worker_data& other)
   : rengine(std::random_device{}()),
     uniform(other.uniform),
-    strategies(other.strategies) {
+    strategies(other.strategies),
+    topology(other.topology) {
   // nop
 }
 
@@ -27,10 +27,18 @@
 #include "caf/serializer.hpp"
 
 #include "caf/actor_registry.hpp"
+#include "caf/locks.hpp"
 #include "caf/logger.hpp"
 
 namespace caf {
 
+namespace {
+
+using exclusive_guard = unique_lock<detail::shared_spinlock>;
+using shared_guard = shared_lock<detail::shared_spinlock>;
+
+} // namespace
+
 proxy_registry::backend::~backend() {
   // nop
 }
@@ -45,26 +53,54 @@ proxy_registry::~proxy_registry() {
 }
 
 size_t proxy_registry::count_proxies(const node_id& node) const {
-  std::unique_lock<std::mutex> guard{mtx_};
-  auto i = proxies_.find(node);
-  return i != proxies_.end() ? i->second.size() : 0;
+  size_t result = 0;
+  for (auto& x : shards_) {
+    shared_guard guard{x.mtx};
+    auto i = x.proxies.find(node);
+    if (i != x.proxies.end())
+      result += i->second.size();
+  }
+  return result;
 }
 
 strong_actor_ptr proxy_registry::get(const node_id& node, actor_id aid) const {
-  std::unique_lock<std::mutex> guard{mtx_};
-  auto i = proxies_.find(node);
-  if (i == proxies_.end())
+  auto& x = shard_for(aid);
+  shared_guard guard{x.mtx};
+  auto i = x.proxies.find(node);
+  if (i == x.proxies.end())
     return nullptr;
-  auto j = i->second.find(aid);
-  return j != i->second.end() ? j->second : nullptr;
+  return i->second.get(aid);
 }
 
 strong_actor_ptr proxy_registry::get_or_put(const node_id& nid, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid));
-  std::unique_lock<std::mutex> guard{mtx_};
-  auto& result = proxies_[nid][aid];
-  if (!result)
-    result = backend_.make_proxy(nid, aid);
+  auto& x = shard_for(aid);
+  { // Lookups of existing proxies only need a shared lock.
+    shared_guard guard{x.mtx};
+    auto i = x.proxies.find(nid);
+    if (i != x.proxies.end())
+      if (auto result = i->second.get(aid))
+        return result;
+  }
+  // Create the proxy outside of the critical section. Otherwise, all threads
+  // accessing this shard would spin while the backend creates the actor.
+  auto proxy = backend_.make_proxy(nid, aid);
+  if (!proxy)
+    return nullptr;
+  strong_actor_ptr result;
+  { // Lifetime scope of guard.
+    exclusive_guard guard{x.mtx};
+    auto& submap = x.proxies[nid];
+    // Another thread may have created the proxy in the meantime.
+    result = submap.get(aid);
+    if (!result) {
+      submap.put(aid, proxy);
+      return proxy;
+    }
+  }
+  // Discard our proxy. Nobody else has seen it, so killing it only releases
+  // its resources.
+  kill_proxy(proxy, exit_reason::normal);
   return result;
 }
 
@@ -73,35 +109,44 @@ proxy_registry::get_all(const node_id& node) const {
   // Reserve at least some memory outside of the critical section.
   std::vector<strong_actor_ptr> result;
   result.reserve(128);
-  std::unique_lock<std::mutex> guard{mtx_};
-  auto i = proxies_.find(node);
-  if (i != proxies_.end())
-    for (auto& kvp : i->second)
-      result.emplace_back(kvp.second);
+  for (auto& x : shards_) {
+    shared_guard guard{x.mtx};
+    auto i = x.proxies.find(node);
+    if (i != x.proxies.end())
+      i->second.for_each([&](actor_id, const strong_actor_ptr& ptr) {
+        result.emplace_back(ptr);
+      });
+  }
   return result;
 }
 
 bool proxy_registry::empty() const {
-  std::unique_lock<std::mutex> guard{mtx_};
-  return proxies_.empty();
+  for (auto& x : shards_) {
+    shared_guard guard{x.mtx};
+    if (!x.proxies.empty())
+      return false;
+  }
+  return true;
 }
 
 void proxy_registry::erase(const node_id& nid) {
   CAF_LOG_TRACE(CAF_ARG(nid));
-  // Move submap for `nid` to a local variable.
-  proxy_map tmp;
-  {
-    using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
-    auto i = proxies_.find(nid);
-    if (i == proxies_.end())
-      return;
-    swap(i->second, tmp);
-    proxies_.erase(i);
+  // Move the submaps for `nid` to a local variable.
+  std::vector<proxy_map> tmp;
+  for (auto& x : shards_) {
+    exclusive_guard guard{x.mtx};
+    auto i = x.proxies.find(nid);
+    if (i == x.proxies.end())
+      continue;
+    tmp.emplace_back(std::move(i->second));
+    x.proxies.erase(i);
   }
   // Call kill_proxy outside the critical section.
-  for (auto& kvp : tmp)
-    kill_proxy(kvp.second, exit_reason::remote_link_unreachable);
+  for (auto& submap : tmp)
+    submap.for_each([&](actor_id, const strong_actor_ptr& ptr) {
+      auto hdl = ptr;
+      kill_proxy(hdl, exit_reason::remote_link_unreachable);
+    });
 }
 
 void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
@@ -109,18 +154,38 @@ void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
   // Try to find the actor handle in question.
   strong_actor_ptr erased_proxy;
   {
-    using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
-    auto i = proxies_.find(nid);
-    if (i != proxies_.end()) {
+    auto& x = shard_for(aid);
+    exclusive_guard guard{x.mtx};
+    auto i = x.proxies.find(nid);
+    if (i != x.proxies.end()) {
       auto& submap = i->second;
-      auto j = submap.find(aid);
-      if (j == submap.end())
-        return;
-      swap(j->second, erased_proxy);
-      submap.erase(j);
+      erased_proxy = submap.take(aid);
       if (submap.empty())
-        proxies_.erase(i);
+        x.proxies.erase(i);
+    }
+  }
+  // Call kill_proxy outside the critical section.
+  if (erased_proxy != nullptr)
+    kill_proxy(erased_proxy, std::move(rsn));
+}
+
+void proxy_registry::erase(const node_id& nid, const strong_actor_ptr& proxy,
+                           error rsn) {
+  CAF_ASSERT(proxy != nullptr);
+  CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(proxy));
+  auto aid = proxy->id();
+  strong_actor_ptr erased_proxy;
+  {
+    auto& x = shard_for(aid);
+    exclusive_guard guard{x.mtx};
+    auto i = x.proxies.find(nid);
+    if (i != x.proxies.end()) {
+      auto& submap = i->second;
+      if (submap.get(aid) == proxy) {
+        erased_proxy = submap.take(aid);
+        if (submap.empty())
+          x.proxies.erase(i);
+      }
     }
   }
   // Call kill_proxy outside the critical section.
@@ -130,18 +195,21 @@ void proxy_registry::erase(const node_id& nid, actor_id aid, error rsn) {
 
 void proxy_registry::clear() {
   CAF_LOG_TRACE("");
-  // Move the content of proxies_ to a local variable.
-  std::unordered_map<node_id, proxy_map> tmp;
-  {
-    using std::swap;
-    std::unique_lock<std::mutex> guard{mtx_};
-    swap(proxies_, tmp);
+  // Move the content of all shards to a local variable.
+  std::vector<std::unordered_map<node_id, proxy_map>> tmp;
+  tmp.reserve(num_shards);
+  for (auto& x : shards_) {
+    exclusive_guard guard{x.mtx};
+    tmp.emplace_back(std::move(x.proxies));
+    x.proxies.clear();
   }
   // Call kill_proxy outside the critical section.
-  for (auto& kvp : tmp)
-    for (auto& sub_kvp : kvp.second)
-      kill_proxy(sub_kvp.second, exit_reason::remote_link_unreachable);
-  proxies_.clear();
+  for (auto& proxies : tmp)
+    for (auto& kvp : proxies)
+      kvp.second.for_each([&](actor_id, const strong_actor_ptr& ptr) {
+        auto hdl = ptr;
+        kill_proxy(hdl, exit_reason::remote_link_unreachable);
+      });
 }
 
 void proxy_registry::kill_proxy(strong_actor_ptr& ptr, error rsn) {
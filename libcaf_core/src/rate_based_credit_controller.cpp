@@ -0,0 +1,175 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/rate_based_credit_controller.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/scheduled_actor.hpp"
+
+// Safe us some typing and very ugly formatting.
+#define impl rate_based_credit_controller
+
+namespace caf::detail {
+
+namespace {
+
+constexpr int64_t ns_per_second = 1'000'000'000;
+
+// Truncates a 64-bit integer to a 32-bit integer with a minimum value of 1.
+int32_t clamp_i32(int64_t x) {
+  static constexpr auto upper_bound = std::numeric_limits<int32_t>::max();
+  if (x > upper_bound)
+    return upper_bound;
+  if (x <= 0)
+    return 1;
+  return static_cast<int32_t>(x);
+}
+
+// Returns how many elements arrive within `t` at `rate` elements per second.
+int64_t elements_within(int64_t rate, timespan t) {
+  // Computing rate * t in 64-bit integers overflows quickly for long RTTs.
+  auto result = static_cast<double>(rate) * static_cast<double>(t.count())
+                / ns_per_second;
+  if (result >= static_cast<double>(std::numeric_limits<int64_t>::max()))
+    return std::numeric_limits<int64_t>::max();
+  return static_cast<int64_t>(result);
+}
+
+} // namespace
+
+impl::impl(scheduled_actor* self) : super(self) {
+  auto& cfg = self->system().config();
+  complexity_ = cfg.stream_desired_batch_complexity;
+}
+
+impl::~impl() {
+  // nop
+}
+
+int64_t impl::bottleneck_rate() const noexcept {
+  return *std::max_element(rate_samples_.begin(), rate_samples_.end());
+}
+
+void impl::before_processing(downstream_msg::batch& x) {
+  auto t = now();
+  received_ += x.xs_size;
+  total_received_ += x.xs_size;
+  // The first batch that exceeds the marker carries elements that the source
+  // sent with the probed credit. The time between granting the credit and
+  // receiving the batch includes the network delay as well as the time the
+  // batch spent in our mailbox.
+  if (probe_marker_ >= 0 && total_received_ > probe_marker_) {
+    add_rtt_sample(std::chrono::duration_cast<timespan>(t - probe_start_), t);
+    probe_marker_ = -1;
+  }
+  processing_begin_ = t;
+}
+
+void impl::after_processing(downstream_msg::batch&) {
+  processing_time_ += std::chrono::duration_cast<timespan>(now()
+                                                           - processing_begin_);
+}
+
+credit_controller::assignment impl::compute_initial() {
+  last_round_ = now();
+  return {credit_, batch_size_};
+}
+
+credit_controller::assignment
+impl::compute(timespan cycle, int32_t downstream_capacity) {
+  auto t = now();
+  auto elapsed = std::chrono::duration_cast<timespan>(t - last_round_);
+  last_round_ = t;
+  // Rounds without any input carry no information about the throughput, so we
+  // only record samples if the source actually delivered elements.
+  if (received_ > 0 && elapsed.count() > 0) {
+    rate_samples_[rate_sample_pos_] = (received_ * ns_per_second)
+                                      / elapsed.count();
+    rate_sample_pos_ = (rate_sample_pos_ + 1) % rate_window;
+  }
+  // Calculate the batch size the same way the complexity-based controller
+  // does: D * (N / t), where D = desired complexity, N = processed items and
+  // t = measured processing time.
+  if (processing_time_.count() > 0)
+    batch_size_ = clamp_i32((complexity_.count() * received_)
+                            / processing_time_.count());
+  received_ = 0;
+  processing_time_ = timespan{0};
+  auto rate = bottleneck_rate();
+  if (rate == 0)
+    return {credit_, batch_size_};
+  // During startup, we double the credit each round until the throughput stops
+  // growing by at least 25%.
+  if (startup_) {
+    if (rate >= startup_rate_ + startup_rate_ / 4) {
+      startup_rate_ = rate;
+      startup_stalls_ = 0;
+    } else if (++startup_stalls_ >= startup_rounds) {
+      startup_ = false;
+    }
+  }
+  // Keep enough credit in flight to cover the RTT plus the time until the next
+  // credit round at the bottleneck rate.
+  auto rtt = min_rtt_ == timespan::max() ? timespan{0} : min_rtt_;
+  auto target = elements_within(rate, rtt + cycle);
+  if (target < std::numeric_limits<int64_t>::max() / credit_gain)
+    target *= credit_gain;
+  if (startup_)
+    target = std::max(target, int64_t{2} * credit_);
+  credit_ = clamp_i32(std::min(target, int64_t{downstream_capacity}));
+  // Make sure the source can have several batches in flight.
+  batch_size_ = std::min(batch_size_, std::max(credit_ / 4, int32_t{1}));
+  // Grant bridge credit as soon as the remaining credit no longer covers the
+  // bandwidth-delay product, i.e., before the source starves.
+  auto bdp = std::max(elements_within(rate, rtt), int64_t{batch_size_});
+  threshold_ = std::min(clamp_i32(bdp), credit_ - 1);
+  return {credit_, batch_size_};
+}
+
+credit_controller::assignment impl::compute_bridge() {
+  return {credit_, batch_size_};
+}
+
+int32_t impl::threshold() const noexcept {
+  return threshold_;
+}
+
+void impl::credit_granted(int32_t outstanding, int32_t granted) {
+  // Only measure one grant at a time.
+  if (granted > 0 && probe_marker_ < 0) {
+    probe_marker_ = total_received_ + outstanding;
+    probe_start_ = now();
+  }
+}
+
+actor_clock::time_point impl::now() noexcept {
+  return self()->clock().now();
+}
+
+void impl::add_rtt_sample(timespan rtt, actor_clock::time_point t) {
+  if (rtt <= min_rtt_ || t - min_rtt_stamp_ > min_rtt_window) {
+    min_rtt_ = rtt;
+    min_rtt_stamp_ = t;
+  }
+}
+
+} // namespace caf::detail
@@ -18,6 +18,8 @@
 
 #include "caf/scheduled_actor.hpp"
 
+#include <algorithm>
+
 #include "caf/actor_ostream.hpp"
 #include "caf/actor_system_config.hpp"
 #include "caf/config.hpp"
@@ -28,6 +30,7 @@
 
 #include "caf/detail/default_invoke_result_visitor.hpp"
 #include "caf/detail/private_thread.hpp"
+#include "caf/detail/scope_guard.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
 
 using namespace std::string_literals;
@@ -122,6 +125,9 @@ error scheduled_actor::default_exception_handler(pointer ptr,
 scheduled_actor::scheduled_actor(actor_config& cfg)
   : super(cfg),
     mailbox_(unit, unit, unit, unit, unit),
+    mailbox_counting_(0),
+    mailbox_pushed_(0),
+    mailbox_handled_(0),
     timeout_id_(0),
     default_handler_(print_and_drop),
     error_handler_(default_error_handler),
@@ -148,6 +154,7 @@ scheduled_actor::scheduled_actor(actor_config& cfg)
   CAF_ASSERT(credit_round_ticks_ > 0);
   CAF_LOG_DEBUG(CAF_ARG(interval) << CAF_ARG(max_batch_delay_ticks_)
                                   << CAF_ARG(credit_round_ticks_));
+  request_timeout_slack_ = sys_cfg.request_timeout_slack;
 }
 
 scheduled_actor::~scheduled_actor() {
@@ -169,17 +176,8 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
   switch (mailbox().push_back(std::move(ptr))) {
     case intrusive::inbox_result::unblocked_reader: {
       CAF_LOG_ACCEPT_EVENT(true);
-      // add a reference count to this actor and re-schedule it
-      intrusive_ptr_add_ref(ctrl());
-      if (getf(is_detached_flag)) {
-        CAF_ASSERT(private_thread_ != nullptr);
-        private_thread_->resume();
-      } else {
-        if (eu != nullptr)
-          eu->exec_later(this);
-        else
-          home_system().scheduler().enqueue(this);
-      }
+      count_pushed(1);
+      reschedule(eu);
       break;
     }
     case intrusive::inbox_result::queue_closed: {
@@ -193,13 +191,66 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr, execution_unit* eu) {
     case intrusive::inbox_result::success:
       // enqueued to a running actors' mailbox; nothing to do
       CAF_LOG_ACCEPT_EVENT(false);
+      count_pushed(1);
+      break;
+  }
+}
+
+void scheduled_actor::enqueue_batch(mailbox_element_chain xs,
+                                    execution_unit* eu) {
+  CAF_ASSERT(!getf(is_blocking_flag));
+  CAF_LOG_TRACE(CAF_ARG2("size", xs.size()));
+  if (xs.empty())
+    return;
+  auto n = xs.size();
+  switch (mailbox().splice_back(xs.head(), xs.tail())) {
+    case intrusive::inbox_result::unblocked_reader: {
+      CAF_LOG_ACCEPT_EVENT(true);
+      xs.release();
+      count_pushed(n);
+      reschedule(eu);
+      break;
+    }
+    case intrusive::inbox_result::queue_closed: {
+      CAF_LOG_REJECT_EVENT();
+      // The chain still owns all elements, bounce requests before dropping.
+      detail::sync_request_bouncer f{exit_reason()};
+      xs.drain([&](mailbox_element_ptr x) {
+        if (x->mid.is_request())
+          f(x->sender, x->mid);
+      });
+      break;
+    }
+    case intrusive::inbox_result::success:
+      // enqueued to a running actors' mailbox; nothing to do
+      CAF_LOG_ACCEPT_EVENT(false);
+      xs.release();
+      count_pushed(n);
       break;
   }
 }
+
 mailbox_element* scheduled_actor::peek_at_next_mailbox_element() {
   return mailbox().closed() || mailbox().blocked() ? nullptr : mailbox().peek();
 }
 
+size_t scheduled_actor::mailbox_size_hint() const noexcept {
+  // Both counters change concurrently, so `handled` may overtake `pushed`.
+  auto handled = mailbox_handled_.load(std::memory_order_relaxed);
+  auto pushed = mailbox_pushed_.load(std::memory_order_relaxed);
+  return pushed > handled ? pushed - handled : 0;
+}
+
+void scheduled_actor::enable_mailbox_size_hint() noexcept {
+  // Messages that are already in the mailbox remain uncounted until the
+  // mailbox runs empty for the next time (see `resume`).
+  mailbox_counting_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void scheduled_actor::disable_mailbox_size_hint() noexcept {
+  mailbox_counting_.fetch_sub(1, std::memory_order_relaxed);
+}
+
 // -- overridden functions of local_actor --------------------------------------
 
 const char* scheduled_actor::name() const {
@@ -402,6 +453,25 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
       set_stream_timeout(tout);
     }
   };
+  // Publish the number of handled messages for `mailbox_size_hint`. Once the
+  // mailbox runs empty, we have handled all messages that senders counted
+  // before. Rebasing the counter at this point drops any error from messages
+  // that arrived before the counting started.
+  size_t pushed_before_block = 0;
+  bool blocked = false;
+  auto publish_handled = detail::make_scope_guard([&] {
+    if (mailbox_counting_.load(std::memory_order_relaxed) == 0)
+      return;
+    auto n = blocked ? pushed_before_block
+                     : mailbox_handled_.load(std::memory_order_relaxed)
+                         + handled_msgs;
+    mailbox_handled_.store(n, std::memory_order_relaxed);
+  });
+  auto try_block = [&] {
+    pushed_before_block = mailbox_pushed_.load(std::memory_order_relaxed);
+    blocked = mailbox().try_block();
+    return blocked;
+  };
   mailbox_visitor f{this, handled_msgs, max_throughput};
   mailbox_element_ptr ptr;
   // Timeout for calling `advance_streams`.
@@ -411,7 +481,7 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
     // Dispatch on the different message categories in our mailbox.
     if (!mailbox_.new_round(3, f).consumed_items) {
       reset_timeouts_if_needed();
-      if (mailbox().try_block())
+      if (try_block())
         return resumable::awaiting_message;
     }
     // Check whether the visitor left the actor without behavior.
@@ -425,7 +495,7 @@ resumable::resume_result scheduled_actor::resume(execution_unit* ctx,
   }
   CAF_LOG_DEBUG("max throughput reached");
   reset_timeouts_if_needed();
-  if (mailbox().try_block())
+  if (try_block())
     return resumable::awaiting_message;
   // time's up
   return resumable::resume_later;
@@ -537,6 +607,50 @@ uint64_t scheduled_actor::set_stream_timeout(actor_clock::time_point x) {
   return set_timeout("stream", x);
 }
 
+void scheduled_actor::request_response_timeout(timespan d, message_id mid) {
+  CAF_LOG_TRACE(CAF_ARG(d) << CAF_ARG(mid));
+  if (d == infinite)
+    return;
+  if (request_timeout_slack_.count() <= 0) {
+    local_actor::request_response_timeout(d, mid);
+    return;
+  }
+  // Round the deadline up to the next multiple of the slack.
+  auto slack = std::chrono::duration_cast<actor_clock::duration_type>(
+    request_timeout_slack_);
+  auto t = clock().now() + d;
+  auto n = (t.time_since_epoch() + slack - actor_clock::duration_type{1})
+           / slack;
+  auto deadline = actor_clock::time_point{slack * n};
+  auto i = request_timeouts_.find(deadline);
+  if (i == request_timeouts_.end()) {
+    i = request_timeouts_.emplace(deadline, std::vector<message_id>{}).first;
+    clock().set_multi_timeout(deadline, this, "request",
+                              static_cast<uint64_t>(n));
+  }
+  i->second.emplace_back(mid.is_request() ? mid.response_id() : mid);
+}
+
+void scheduled_actor::handle_coalesced_request_timeouts() {
+  CAF_LOG_TRACE("");
+  auto first = request_timeouts_.begin();
+  auto last = request_timeouts_.upper_bound(clock().now());
+  auto pending = [this](message_id id) {
+    if (multiplexed_responses_.count(id) > 0)
+      return true;
+    auto pred = [id](const pending_response& x) { return x.first == id; };
+    return std::any_of(awaited_responses_.begin(), awaited_responses_.end(),
+                       pred);
+  };
+  // Responses that arrived in the meantime have no handler anymore. All other
+  // responses receive the same error the clock sends for individual timeouts.
+  for (auto i = first; i != last; ++i)
+    for (auto id : i->second)
+      if (pending(id))
+        eq_impl(id, ctrl(), context(), make_error(sec::request_timeout));
+  request_timeouts_.erase(first, last);
+}
+
 // -- message processing -------------------------------------------------------
 
 void scheduled_actor::add_awaited_response_handler(message_id response_id,
@@ -583,6 +697,9 @@ scheduled_actor::categorize(mailbox_element& x) {
     } else if (tm.type == "stream") {
       CAF_LOG_DEBUG("handle stream timeout message");
       set_stream_timeout(advance_streams(clock().now()));
+    } else if (tm.type == "request") {
+      CAF_LOG_DEBUG("handle coalesced request timeouts");
+      handle_coalesced_request_timeouts();
     } else {
       // Drop. Other types not supported yet.
     }
@@ -653,9 +770,16 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
     if (!awaited_responses_.empty()) {
       auto invoke = select_invoke_fun();
       auto& pr = awaited_responses_.front();
-      // skip all messages until we receive the currently awaited response
-      if (x.mid != pr.first)
+      // skip all messages until we receive the currently awaited response,
+      // except for coalesced request timeouts that may fail it
+      if (x.mid != pr.first) {
+        if (auto view = make_typed_message_view<timeout_msg>(x.content());
+            view && get<0>(view).type == "request") {
+          handle_coalesced_request_timeouts();
+          return invoke_message_result::consumed;
+        }
         return invoke_message_result::skipped;
+      }
       auto f = std::move(pr.second);
       awaited_responses_.pop_front();
       if (!invoke(this, f, x)) {
@@ -724,6 +848,20 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
   return result;
 }
 
+void scheduled_actor::reschedule(execution_unit* eu) {
+  // add a reference count to this actor and re-schedule it
+  intrusive_ptr_add_ref(ctrl());
+  if (getf(is_detached_flag)) {
+    CAF_ASSERT(private_thread_ != nullptr);
+    private_thread_->resume();
+  } else {
+    if (eu != nullptr)
+      eu->exec_later(this);
+    else
+      home_system().scheduler().enqueue(this);
+  }
+}
+
 /// Tries to consume `x`.
 void scheduled_actor::consume(mailbox_element_ptr x) {
   switch (consume(*x)) {
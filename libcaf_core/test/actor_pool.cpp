@@ -77,6 +77,45 @@ struct fixture {
   }
 };
 
+behavior adder() {
+  return {
+    [](int32_t x, int32_t y) { return x + y; },
+  };
+}
+
+// Runs the workers only on demand, which keeps their mailbox sizes stable.
+struct deterministic_fixture : test_coordinator_fixture<> {
+  scoped_execution_unit context{&sys};
+
+  std::vector<actor> workers;
+
+  actor pool;
+
+  void make_pool(size_t num_workers, actor_pool::policy pol) {
+    for (size_t i = 0; i < num_workers; ++i)
+      workers.emplace_back(sys.spawn(adder));
+    size_t pos = 0;
+    auto fac = [&] { return workers[pos++]; };
+    pool = actor_pool::make(&context, num_workers, fac, std::move(pol));
+  }
+
+  // Sends `key` to the pool and returns the worker that received it.
+  actor dispatch(int32_t key) {
+    std::vector<size_t> before;
+    for (auto& worker : workers)
+      before.emplace_back(worker->mailbox_size_hint());
+    self->send(pool, key, 0);
+    for (size_t i = 0; i < workers.size(); ++i)
+      if (workers[i]->mailbox_size_hint() > before[i])
+        return workers[i];
+    return nullptr;
+  }
+
+  ~deterministic_fixture() {
+    anon_send_exit(pool, exit_reason::user_shutdown);
+  }
+};
+
 #define HANDLE_ERROR                                                           \
   [](const error& err) {                                                       \
     CAF_FAIL("AUT responded with an error: " + to_string(err));                \
@@ -175,3 +214,93 @@ CAF_TEST(random_actor_pool) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(actor_pool_policy_tests, deterministic_fixture)
+
+CAF_TEST(only pool workers track their mailbox size) {
+  auto worker = sys.spawn(adder);
+  self->send(worker, 1, 2);
+  CAF_CHECK_EQUAL(worker->mailbox_size_hint(), 0u);
+  make_pool(1, actor_pool::least_loaded());
+  self->send(workers[0], 1, 2);
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 1u);
+  run();
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 0u);
+}
+
+CAF_TEST(workers count messages that arrived before joining the pool) {
+  workers.emplace_back(sys.spawn(adder));
+  run();
+  self->send(workers[0], 1, 2);
+  self->send(workers[0], 1, 2);
+  auto fac = [&] { return workers[0]; };
+  pool = actor_pool::make(&context, 1, fac, actor_pool::least_loaded());
+  self->send(workers[0], 1, 2);
+  run();
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 0u);
+  self->send(workers[0], 1, 2);
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 1u);
+  run();
+  CAF_MESSAGE("workers stop counting after leaving the pool");
+  self->send(pool, sys_atom_v, delete_atom_v, workers[0]);
+  self->send(workers[0], 1, 2);
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 0u);
+}
+
+CAF_TEST(least loaded pools dispatch to the shortest mailbox) {
+  make_pool(3, actor_pool::least_loaded());
+  self->send(workers[0], 1, 2);
+  self->send(workers[1], 1, 2);
+  self->send(workers[1], 1, 2);
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 1u);
+  CAF_CHECK_EQUAL(workers[1]->mailbox_size_hint(), 2u);
+  CAF_CHECK_EQUAL(dispatch(1), workers[2]);
+  CAF_CHECK_EQUAL(dispatch(1), workers[0]);
+  CAF_CHECK_EQUAL(workers[0]->mailbox_size_hint(), 2u);
+  CAF_CHECK_EQUAL(workers[2]->mailbox_size_hint(), 1u);
+  run();
+  for (auto& worker : workers)
+    CAF_CHECK_EQUAL(worker->mailbox_size_hint(), 0u);
+}
+
+CAF_TEST(power of two choices pools dispatch to the shorter mailbox) {
+  make_pool(2, actor_pool::power_of_two_choices());
+  for (int i = 0; i < 5; ++i)
+    self->send(workers[0], 1, 2);
+  for (int i = 0; i < 5; ++i)
+    CAF_CHECK_EQUAL(dispatch(1), workers[1]);
+}
+
+CAF_TEST(consistent hash pools dispatch equal keys to the same worker) {
+  auto key = [](const message& msg) -> size_t {
+    return static_cast<size_t>(msg.get_as<int32_t>(0));
+  };
+  make_pool(4, actor_pool::consistent_hash(key));
+  std::vector<actor> targets;
+  for (int32_t k = 0; k < 20; ++k)
+    targets.emplace_back(dispatch(k));
+  for (int32_t k = 0; k < 20; ++k)
+    CAF_CHECK_EQUAL(dispatch(k), targets[k]);
+  CAF_MESSAGE("removing a worker only remaps the keys of that worker");
+  auto removed = workers.back();
+  self->send(pool, sys_atom_v, delete_atom_v, removed);
+  workers.pop_back();
+  for (int32_t k = 0; k < 20; ++k) {
+    auto target = dispatch(k);
+    CAF_CHECK_NOT_EQUAL(target, removed);
+    if (targets[k] != removed)
+      CAF_CHECK_EQUAL(target, targets[k]);
+  }
+  anon_send_exit(removed, exit_reason::user_shutdown);
+}
+
+CAF_TEST(pools release removed workers immediately) {
+  make_pool(2, actor_pool::round_robin());
+  run();
+  auto removed = actor_cast<weak_actor_ptr>(workers.back());
+  self->send(pool, sys_atom_v, delete_atom_v, workers.back());
+  workers.pop_back();
+  CAF_CHECK_EQUAL(removed.lock(), nullptr);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
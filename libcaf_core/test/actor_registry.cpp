@@ -49,6 +49,20 @@ CAF_TEST(erase) {
   CAF_CHECK_EQUAL(sys.registry().named_actors().size(), baseline);
 }
 
+CAF_TEST(the registry finds actors by ID) {
+  std::vector<actor> hdls;
+  for (int i = 0; i < 64; ++i) {
+    hdls.emplace_back(sys.spawn(dummy));
+    sys.registry().put(hdls.back().id(), hdls.back());
+  }
+  for (auto& hdl : hdls)
+    CAF_CHECK_EQUAL(sys.registry().get<actor>(hdl.id()), hdl);
+  for (auto& hdl : hdls)
+    sys.registry().erase(hdl.id());
+  for (auto& hdl : hdls)
+    CAF_CHECK_EQUAL(sys.registry().get(hdl.id()), nullptr);
+}
+
 CAF_TEST(serialization roundtrips go through the registry) {
   auto hdl = sys.spawn(dummy);
   byte_buffer buf;
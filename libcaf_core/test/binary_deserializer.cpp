@@ -158,6 +158,21 @@ CAF_TEST(container types) {
   }
 }
 
+CAF_TEST(blob serializable types read vectors from a single block) {
+  std::vector<blob_struct> xs{{1, 2.5f}, {3, 4.5f}, {5, 6.5f}};
+  byte_buffer buf;
+  binary_serializer sink{nullptr, buf};
+  if (auto err = sink(xs))
+    CAF_FAIL("binary_serializer failed to save: "
+             << actor_system_config::render(err));
+  CAF_CHECK(load<std::vector<blob_struct>>(buf) == xs);
+  CAF_MESSAGE("truncated input results in an error");
+  buf.pop_back();
+  std::vector<blob_struct> ys;
+  binary_deserializer source{nullptr, buf};
+  CAF_CHECK_EQUAL(source(ys), sec::end_of_stream);
+}
+
 CAF_TEST(binary serializer picks up inspect functions) {
   SUBTEST("node ID") {
     auto nid = make_node_id(123, "000102030405060708090A0B0C0D0E0F10111213");
@@ -157,6 +157,15 @@ CAF_TEST(container types) {
   }
 }
 
+CAF_TEST(blob serializable types write vectors as a single block) {
+  std::vector<blob_struct> xs{{1, 2.5f}, {3, 4.5f}};
+  byte_buffer expected{2_b};
+  auto bytes = as_bytes(make_span(xs));
+  expected.insert(expected.end(), bytes.begin(), bytes.end());
+  CAF_CHECK_EQUAL(bytes.size(), 2 * sizeof(blob_struct));
+  CAF_CHECK_EQUAL(save(xs), expected);
+}
+
 CAF_TEST(binary serializer picks up inspect functions) {
   SUBTEST("node ID") {
     auto nid = make_node_id(123, "000102030405060708090A0B0C0D0E0F10111213");
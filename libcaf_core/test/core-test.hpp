@@ -1,3 +1,4 @@
+#include "caf/blob_serializable.hpp"
 #include "caf/fwd.hpp"
 #include "caf/test/dsl.hpp"
 #include "caf/type_id.hpp"
@@ -136,6 +137,19 @@ decltype(auto) inspect(Inspector& f, raw_struct& x) {
   return lhs.str == rhs.str;
 }
 
+// A trivially copyable type that opts into blob serialization.
+struct blob_struct {
+  int32_t id;
+  float value;
+};
+
+[[maybe_unused]] inline bool operator==(const blob_struct& lhs,
+                                        const blob_struct& rhs) {
+  return lhs.id == rhs.id && lhs.value == rhs.value;
+}
+
+CAF_ALLOW_BLOB_SERIALIZATION(blob_struct)
+
 struct s1 {
   int value[3] = {10, 20, 30};
 };
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.actor_id_map
+
+#include "caf/detail/actor_id_map.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include "caf/actor_cast.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() {
+    hdl = actor_cast<strong_actor_ptr>(sys.spawn([] {}));
+  }
+
+  detail::actor_id_map uut;
+
+  strong_actor_ptr hdl;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(actor_id_map_tests, fixture)
+
+CAF_TEST(a default constructed map is empty) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.size(), 0u);
+  CAF_CHECK_EQUAL(uut.capacity(), 0u);
+  CAF_CHECK_EQUAL(uut.get(42), nullptr);
+  CAF_CHECK_EQUAL(uut.take(42), nullptr);
+}
+
+CAF_TEST(maps store one value per key) {
+  uut.put(42, hdl);
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(uut.capacity(), detail::actor_id_map::min_capacity);
+  CAF_CHECK_EQUAL(uut.get(42), hdl);
+  CAF_CHECK_EQUAL(uut.get(23), nullptr);
+  uut.put(42, hdl);
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(uut.take(42), hdl);
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.get(42), nullptr);
+}
+
+CAF_TEST(maps grow and keep all entries reachable after removals) {
+  for (actor_id id = 0; id < 1000; ++id)
+    uut.put(id, hdl);
+  CAF_CHECK_EQUAL(uut.size(), 1000u);
+  CAF_CHECK_GREATER_OR_EQUAL(uut.capacity(), 2000u);
+  for (actor_id id = 0; id < 1000; id += 2)
+    CAF_CHECK_EQUAL(uut.take(id), hdl);
+  CAF_CHECK_EQUAL(uut.size(), 500u);
+  for (actor_id id = 0; id < 1000; ++id) {
+    if (id % 2 == 0)
+      CAF_CHECK_EQUAL(uut.get(id), nullptr);
+    else
+      CAF_CHECK_EQUAL(uut.get(id), hdl);
+  }
+  size_t visited = 0;
+  uut.for_each([&](actor_id id, const strong_actor_ptr& ptr) {
+    CAF_CHECK_EQUAL(id % 2, 1u);
+    CAF_CHECK_EQUAL(ptr, hdl);
+    ++visited;
+  });
+  CAF_CHECK_EQUAL(visited, 500u);
+  uut.clear();
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.get(1), nullptr);
+}
+
+CAF_TEST(moving a map transfers all entries) {
+  uut.put(1, hdl);
+  uut.put(2, hdl);
+  detail::actor_id_map other{std::move(uut)};
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.get(1), nullptr);
+  CAF_CHECK_EQUAL(other.size(), 2u);
+  CAF_CHECK_EQUAL(other.get(1), hdl);
+  CAF_CHECK_EQUAL(other.get(2), hdl);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.circular_buffer
+
+#include "caf/detail/circular_buffer.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+using int_buffer = detail::circular_buffer<int>;
+
+std::vector<int> iota(int first, int last) {
+  std::vector<int> result(static_cast<size_t>(last - first));
+  std::iota(result.begin(), result.end(), first);
+  return result;
+}
+
+template <class Buffer>
+auto contents(const Buffer& xs) {
+  return std::vector<typename Buffer::value_type>(xs.begin(), xs.end());
+}
+
+struct fixture {
+  int_buffer uut;
+
+  // Fills the buffer such that its elements wrap around the end of the array.
+  void fill_wrapped() {
+    for (int i = 0; i < 12; ++i)
+      uut.push_back(i);
+    uut.pop_front(10);
+    for (int i = 12; i < 24; ++i)
+      uut.push_back(i);
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(circular_buffer_tests, fixture)
+
+CAF_TEST(buffers are FIFO queues) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.capacity(), 0u);
+  for (int i = 0; i < 10; ++i)
+    uut.push_back(i);
+  CAF_CHECK_EQUAL(uut.size(), 10u);
+  CAF_CHECK_EQUAL(uut.capacity(), int_buffer::min_capacity);
+  CAF_CHECK_EQUAL(uut.front(), 0);
+  CAF_CHECK_EQUAL(uut.back(), 9);
+  uut.pop_front(3);
+  CAF_CHECK_EQUAL(contents(uut), iota(3, 10));
+  uut.erase(uut.begin(), uut.begin() + 2);
+  CAF_CHECK_EQUAL(contents(uut), iota(5, 10));
+  uut.clear();
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(buffers reuse their storage when wrapping around) {
+  fill_wrapped();
+  CAF_CHECK_EQUAL(uut.capacity(), int_buffer::min_capacity);
+  CAF_CHECK_EQUAL(contents(uut), iota(10, 24));
+  CAF_MESSAGE("growing the buffer preserves the order of elements");
+  for (int i = 24; i < 40; ++i)
+    uut.push_back(i);
+  CAF_CHECK_EQUAL(uut.capacity(), 2 * int_buffer::min_capacity);
+  CAF_CHECK_EQUAL(contents(uut), iota(10, 40));
+}
+
+CAF_TEST(buffers move elements to containers in bulk) {
+  fill_wrapped();
+  std::vector<int> xs;
+  uut.move_front_to(10, xs);
+  CAF_CHECK_EQUAL(xs, iota(10, 20));
+  CAF_CHECK_EQUAL(contents(uut), iota(20, 24));
+  uut.move_front_to(4, xs);
+  CAF_CHECK_EQUAL(xs, iota(10, 24));
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(buffers append ranges) {
+  auto xs = iota(0, 20);
+  uut.insert(uut.end(), xs.begin(), xs.end());
+  CAF_CHECK_EQUAL(contents(uut), xs);
+}
+
+CAF_TEST(extending a buffer returns contiguous storage) {
+  fill_wrapped();
+  auto ys = uut.extend(6);
+  CAF_REQUIRE_EQUAL(ys.size(), 6u);
+  std::iota(ys.begin(), ys.end(), 24);
+  CAF_CHECK_EQUAL(contents(uut), iota(10, 30));
+  CAF_CHECK_EQUAL(&uut.back(), &ys.back());
+}
+
+CAF_TEST(buffers destroy non-trivial elements) {
+  detail::circular_buffer<std::string> xs;
+  for (int i = 0; i < 20; ++i)
+    xs.emplace_back(std::to_string(i));
+  xs.pop_front(15);
+  for (int i = 20; i < 30; ++i)
+    xs.emplace_back(std::to_string(i));
+  auto ys = xs;
+  CAF_CHECK_EQUAL(contents(ys), contents(xs));
+  std::vector<std::string> zs;
+  xs.move_front_to(xs.size(), zs);
+  CAF_CHECK_EQUAL(zs.front(), "15");
+  CAF_CHECK_EQUAL(zs.back(), "29");
+  CAF_CHECK(xs.empty());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
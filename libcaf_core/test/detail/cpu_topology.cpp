@@ -0,0 +1,77 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.cpu_topology
+
+#include "caf/detail/cpu_topology.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+
+using namespace caf;
+
+using detail::cpu_topology;
+
+namespace {
+
+using ids = std::vector<size_t>;
+
+ids parse(string_view str) {
+  return cpu_topology::parse_cpu_list(str);
+}
+
+} // namespace
+
+CAF_TEST(CPU lists use the Linux sysfs format) {
+  CAF_CHECK_EQUAL(parse(""), ids());
+  CAF_CHECK_EQUAL(parse("0"), ids({0}));
+  CAF_CHECK_EQUAL(parse("0-3"), ids({0, 1, 2, 3}));
+  CAF_CHECK_EQUAL(parse("0-1,4,6-7"), ids({0, 1, 4, 6, 7}));
+  CAF_CHECK_EQUAL(parse("12,14\n"), ids({12, 14}));
+  CAF_CHECK_EQUAL(parse("3-1"), ids());
+  CAF_CHECK_EQUAL(parse("1-"), ids());
+  CAF_CHECK_EQUAL(parse("a"), ids());
+}
+
+CAF_TEST(topologies sort CPUs by node and cache) {
+  cpu_topology uut{{{0, 0, 0}, {1, 2, 1}, {2, 0, 0}, {3, 2, 1}, {4, 4, 0}}};
+  ids order;
+  for (auto& x : uut.cpus())
+    order.emplace_back(x.id);
+  CAF_CHECK_EQUAL(order, ids({0, 2, 4, 1, 3}));
+}
+
+CAF_TEST(distances reflect the cache and memory hierarchy) {
+  cpu_topology::cpu x{0, 0, 0};
+  cpu_topology::cpu y{1, 0, 0};
+  cpu_topology::cpu z{2, 2, 0};
+  cpu_topology::cpu w{3, 3, 1};
+  CAF_CHECK_EQUAL(cpu_topology::distance(x, y), cpu_topology::same_cache);
+  CAF_CHECK_EQUAL(cpu_topology::distance(x, z), cpu_topology::same_node);
+  CAF_CHECK_EQUAL(cpu_topology::distance(x, w), cpu_topology::remote_node);
+}
+
+CAF_TEST(querying the topology lists each CPU once) {
+  auto uut = cpu_topology::query();
+  ids cpu_ids;
+  for (auto& x : uut.cpus())
+    cpu_ids.emplace_back(x.id);
+  std::sort(cpu_ids.begin(), cpu_ids.end());
+  CAF_CHECK(std::adjacent_find(cpu_ids.begin(), cpu_ids.end()) == cpu_ids.end());
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+#define CAF_SUITE detail.eventcount
+
+#include "caf/detail/eventcount.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace caf;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture {
+  detail::eventcount uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(eventcount_tests, fixture)
+
+CAF_TEST(cancel_wait unregisters a prepared waiter) {
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+  auto key = uut.prepare_wait();
+  CAF_CHECK_EQUAL(uut.waiters(), 1u);
+  uut.cancel_wait();
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+  CAF_MESSAGE("notifying without waiters leaves the epoch unchanged");
+  uut.notify_all();
+  CAF_CHECK_EQUAL(uut.prepare_wait(), key);
+  uut.cancel_wait();
+}
+
+CAF_TEST(commit_wait times out without notification) {
+  auto key = uut.prepare_wait();
+  CAF_CHECK_EQUAL(uut.commit_wait(key, timespan{1ms}), false);
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(notifications between prepare_wait and commit_wait are not lost) {
+  auto key = uut.prepare_wait();
+  uut.notify_one();
+  CAF_CHECK_NOT_EQUAL(uut.prepare_wait(), key);
+  uut.cancel_wait();
+  CAF_CHECK_EQUAL(uut.commit_wait(key, timespan{10s}), true);
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST(notifiers race a waiter that has not committed yet) {
+  for (int round = 0; round < 100; ++round) {
+    std::atomic<bool> prepared{false};
+    std::atomic<bool> ready{false};
+    std::atomic<bool> timed_out{false};
+    std::thread waiter{[&] {
+      for (;;) {
+        auto key = uut.prepare_wait();
+        prepared = true;
+        if (ready) {
+          uut.cancel_wait();
+          return;
+        }
+        if (!uut.commit_wait(key, timespan{10s}))
+          timed_out = true;
+      }
+    }};
+    while (!prepared)
+      std::this_thread::yield();
+    ready = true;
+    uut.notify_one();
+    waiter.join();
+    CAF_CHECK(!timed_out);
+    CAF_CHECK_EQUAL(uut.waiters(), 0u);
+  }
+}
+
+CAF_TEST(notify_all wakes up all blocked waiters) {
+  std::atomic<bool> ready{false};
+  std::atomic<size_t> woken{0};
+  auto f = [&] {
+    for (;;) {
+      auto key = uut.prepare_wait();
+      if (ready) {
+        uut.cancel_wait();
+        break;
+      }
+      uut.commit_wait(key, timespan{10s});
+    }
+    ++woken;
+  };
+  std::thread t1{f};
+  std::thread t2{f};
+  while (uut.waiters() < 2)
+    std::this_thread::yield();
+  ready = true;
+  uut.notify_all();
+  t1.join();
+  t2.join();
+  CAF_CHECK_EQUAL(woken.load(), 2u);
+  CAF_CHECK_EQUAL(uut.waiters(), 0u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.injection_queue
+
+#include "caf/detail/injection_queue.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+struct item : detail::injection_queue_node {
+  explicit item(int x = 0) : value(x) {
+    // nop
+  }
+
+  int value;
+};
+
+using item_queue = detail::injection_queue<item>;
+
+struct fixture {
+  item_queue uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(injection_queue_tests, fixture)
+
+CAF_TEST(a default constructed queue is empty) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.try_take(), nullptr);
+}
+
+CAF_TEST(the queue returns elements in FIFO order) {
+  item xs[] = {item{1}, item{2}, item{3}};
+  for (auto& x : xs)
+    uut.push(&x);
+  CAF_CHECK(!uut.empty());
+  CAF_CHECK_EQUAL(uut.try_take(), &xs[0]);
+  CAF_CHECK_EQUAL(uut.try_take(), &xs[1]);
+  CAF_CHECK_EQUAL(uut.try_take(), &xs[2]);
+  CAF_CHECK_EQUAL(uut.try_take(), nullptr);
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(elements can return to the queue after leaving it) {
+  item x{1};
+  item y{2};
+  for (int i = 0; i < 3; ++i) {
+    uut.push(&x);
+    CAF_CHECK_EQUAL(uut.try_take(), &x);
+    CAF_CHECK(uut.empty());
+  }
+  uut.push(&x);
+  uut.push(&y);
+  CAF_CHECK_EQUAL(uut.try_take(), &x);
+  uut.push(&x);
+  CAF_CHECK_EQUAL(uut.try_take(), &y);
+  CAF_CHECK_EQUAL(uut.try_take(), &x);
+  CAF_CHECK_EQUAL(uut.try_take(), nullptr);
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(concurrent producers never lose elements) {
+  std::vector<item> items(3000);
+  std::vector<int> values(items.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    items[i].value = static_cast<int>(i);
+    values[i] = static_cast<int>(i);
+  }
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 3; ++i)
+    producers.emplace_back([&, offset = i * 1000] {
+      for (size_t j = 0; j < 1000; ++j)
+        uut.push(&items[offset + j]);
+    });
+  std::vector<int> result;
+  while (result.size() < values.size())
+    if (auto ptr = uut.try_take())
+      result.push_back(ptr->value);
+  for (auto& t : producers)
+    t.join();
+  std::sort(result.begin(), result.end());
+  CAF_CHECK_EQUAL(result, values);
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
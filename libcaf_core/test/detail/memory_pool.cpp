@@ -0,0 +1,105 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.memory_pool
+
+#include "caf/detail/memory_pool.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+using detail::memory_pool;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    memory_pool::enable(true);
+  }
+
+  ~fixture() {
+    memory_pool::enable(false);
+  }
+
+  static bool is_aligned(void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignof(max_align_t) == 0;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(memory_pool_tests, fixture)
+
+CAF_TEST(pools reuse released blocks of the same size class) {
+  auto ptr = memory_pool::allocate(40);
+  CAF_CHECK(is_aligned(ptr));
+  memset(ptr, 0xFF, 40);
+  memory_pool::deallocate(ptr);
+  CAF_CHECK_EQUAL(memory_pool::allocate(48), ptr);
+  memory_pool::deallocate(ptr);
+}
+
+CAF_TEST(large blocks bypass the pool) {
+  auto ptr = memory_pool::allocate(memory_pool::max_block_size * 2);
+  CAF_CHECK(is_aligned(ptr));
+  memset(ptr, 0xFF, memory_pool::max_block_size * 2);
+  memory_pool::deallocate(ptr);
+}
+
+CAF_TEST(blocks from a disabled pool remain valid after enabling it) {
+  memory_pool::enable(false);
+  auto ptr = memory_pool::allocate(16);
+  memory_pool::enable(true);
+  memory_pool::deallocate(ptr);
+  ptr = memory_pool::allocate(16);
+  memory_pool::enable(false);
+  memory_pool::deallocate(ptr);
+}
+
+CAF_TEST(blocks released by other threads return to their owner) {
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < 1000; ++i)
+    blocks.emplace_back(memory_pool::allocate(100));
+  std::thread t{[&] {
+    for (auto ptr : blocks)
+      memory_pool::deallocate(ptr);
+  }};
+  t.join();
+  // The pool may hand out blocks that were never in use first, but it must
+  // eventually return the blocks released by the other thread.
+  std::sort(blocks.begin(), blocks.end());
+  std::vector<void*> reused;
+  size_t num_reused = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    reused.emplace_back(memory_pool::allocate(100));
+    if (std::binary_search(blocks.begin(), blocks.end(), reused.back()))
+      ++num_reused;
+  }
+  CAF_CHECK_GREATER(num_reused, 0u);
+  for (auto ptr : reused)
+    memory_pool::deallocate(ptr);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
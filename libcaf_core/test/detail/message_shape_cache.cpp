@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.message_shape_cache
+
+#include "caf/detail/message_shape_cache.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <string>
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/message.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() : cache(make_counted<detail::message_shape_cache>()) {
+    // nop
+  }
+
+  byte_buffer serialize(const message& msg) {
+    byte_buffer result;
+    binary_serializer sink{sys, result};
+    if (auto err = sink(msg))
+      CAF_FAIL("serialization failed: " << sys.render(err));
+    return result;
+  }
+
+  message deserialize(const byte_buffer& buf) {
+    message result;
+    binary_deserializer source{sys, buf};
+    source.shape_cache(cache.get());
+    if (auto err = source(result))
+      CAF_FAIL("deserialization failed: " << sys.render(err));
+    return result;
+  }
+
+  detail::message_shape_cache_ptr cache;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(message_shape_cache_tests, fixture)
+
+CAF_TEST(the cache stores each message shape once) {
+  CAF_CHECK_EQUAL(cache->size(), 0u);
+  for (int i = 0; i < 10; ++i) {
+    auto msg = make_message(i, std::string{"hello"});
+    auto copy = deserialize(serialize(msg));
+    CAF_CHECK_EQUAL(to_string(copy), to_string(msg));
+    CAF_CHECK_EQUAL(copy.types(), (make_type_id_list<int, std::string>()));
+  }
+  CAF_CHECK_EQUAL(cache->size(), 1u);
+  deserialize(serialize(make_message(1.0)));
+  CAF_CHECK_EQUAL(cache->size(), 2u);
+  deserialize(serialize(make_message()));
+  CAF_CHECK_EQUAL(cache->size(), 2u);
+}
+
+CAF_TEST(lookups return shapes with equal type IDs only) {
+  auto types = make_type_id_list<int, std::string>();
+  auto hash = detail::message_shape_cache::hash(types.data());
+  CAF_CHECK_EQUAL(cache->find(types.data(), hash), nullptr);
+  cache->add(types, 42, hash);
+  auto shape = cache->find(types.data(), hash);
+  CAF_REQUIRE_NOT_EQUAL(shape, nullptr);
+  CAF_CHECK_EQUAL(shape->types, types);
+  CAF_CHECK_EQUAL(shape->data_size, 42u);
+  auto other = make_type_id_list<std::string, int>();
+  CAF_CHECK_EQUAL(cache->find(other.data(), hash), nullptr);
+  cache->add(types, 42, hash);
+  CAF_CHECK_EQUAL(cache->size(), 1u);
+}
+
+CAF_TEST(the cache rejects unknown types) {
+  byte_buffer buf;
+  binary_serializer sink{sys, buf};
+  if (auto err = sink(uint16_t{1}, type_id_t{0xFFFF}))
+    CAF_FAIL("serialization failed: " << sys.render(err));
+  message result;
+  binary_deserializer source{sys, buf};
+  source.shape_cache(cache.get());
+  CAF_CHECK_EQUAL(source(result), sec::unknown_type);
+  CAF_CHECK_EQUAL(cache->size(), 0u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
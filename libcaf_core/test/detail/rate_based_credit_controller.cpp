@@ -0,0 +1,140 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.rate_based_credit_controller
+
+#include "caf/detail/rate_based_credit_controller.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <memory>
+
+#include "caf/scheduled_actor.hpp"
+
+using namespace caf;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture : test_coordinator_fixture<> {
+  fixture() {
+    hdl = sys.spawn([] {});
+    auto self = static_cast<scheduled_actor*>(actor_cast<abstract_actor*>(hdl));
+    uut = std::make_unique<detail::rate_based_credit_controller>(self);
+  }
+
+  void advance(timespan t) {
+    sched.clock().current_time += t;
+  }
+
+  void receive(int32_t n) {
+    downstream_msg::batch x{n, make_message(), 0};
+    uut->before_processing(x);
+    uut->after_processing(x);
+  }
+
+  // Receives 100 elements in 10 batches over one credit round of 10ms.
+  credit_controller::assignment run_round(int32_t capacity = 10'000) {
+    for (int i = 0; i < 10; ++i) {
+      advance(1ms);
+      receive(10);
+    }
+    return uut->compute(10ms, capacity);
+  }
+
+  actor hdl;
+
+  std::unique_ptr<detail::rate_based_credit_controller> uut;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(rate_based_credit_controller_tests, fixture)
+
+CAF_TEST(controllers start with the initial credit and without bridging) {
+  auto x = uut->compute_initial();
+  CAF_CHECK_EQUAL(x.credit, uut->initial_buffer_size);
+  CAF_CHECK_EQUAL(x.batch_size, uut->initial_batch_size);
+  CAF_CHECK_LESS(uut->threshold(), 0);
+  CAF_CHECK_EQUAL(uut->min_rtt(), timespan::max());
+  CAF_CHECK_EQUAL(uut->bottleneck_rate(), 0);
+  CAF_MESSAGE("rounds without input keep the current assignment");
+  advance(10ms);
+  auto y = uut->compute(10ms, 10'000);
+  CAF_CHECK_EQUAL(y.credit, x.credit);
+  CAF_CHECK_EQUAL(y.batch_size, x.batch_size);
+}
+
+CAF_TEST(controllers measure the RTT from granting credit to using it) {
+  uut->compute_initial();
+  uut->credit_granted(0, 50);
+  advance(20ms);
+  receive(10);
+  CAF_CHECK_EQUAL(uut->min_rtt(), timespan{20ms});
+  CAF_MESSAGE("batches that use previously granted credit produce no sample");
+  uut->credit_granted(40, 10);
+  for (int i = 0; i < 4; ++i) {
+    advance(1ms);
+    receive(10);
+  }
+  CAF_CHECK_EQUAL(uut->min_rtt(), timespan{20ms});
+  advance(1ms);
+  receive(10);
+  CAF_CHECK_EQUAL(uut->min_rtt(), timespan{5ms});
+  CAF_MESSAGE("larger samples do not replace the minimum");
+  uut->credit_granted(0, 10);
+  advance(30ms);
+  receive(10);
+  CAF_CHECK_EQUAL(uut->min_rtt(), timespan{5ms});
+}
+
+CAF_TEST(controllers assign credit for the bandwidth delay product) {
+  uut->compute_initial();
+  uut->credit_granted(0, 50);
+  advance(20ms);
+  receive(200);
+  CAF_REQUIRE_EQUAL(uut->min_rtt(), timespan{20ms});
+  CAF_MESSAGE("the startup phase doubles credit while the rate grows");
+  auto x = uut->compute(10ms, 10'000);
+  CAF_CHECK_EQUAL(uut->bottleneck_rate(), 10'000);
+  CAF_CHECK(uut->in_startup());
+  // 2 * 10'000 elements/s * (20ms RTT + 10ms cycle)
+  CAF_CHECK_EQUAL(x.credit, 600);
+  x = run_round();
+  CAF_CHECK(uut->in_startup());
+  CAF_CHECK_EQUAL(x.credit, 1200);
+  x = run_round();
+  CAF_CHECK(uut->in_startup());
+  CAF_CHECK_EQUAL(x.credit, 2400);
+  CAF_MESSAGE("a steady rate ends the startup phase");
+  x = run_round();
+  CAF_CHECK(!uut->in_startup());
+  CAF_CHECK_EQUAL(x.credit, 600);
+  CAF_CHECK_EQUAL(x.batch_size, uut->initial_batch_size);
+  // 10'000 elements/s * 20ms RTT
+  CAF_CHECK_EQUAL(uut->threshold(), 200);
+  auto y = uut->compute_bridge();
+  CAF_CHECK_EQUAL(y.credit, x.credit);
+  CAF_CHECK_EQUAL(y.batch_size, x.batch_size);
+  CAF_MESSAGE("credit never exceeds the downstream capacity");
+  x = run_round(100);
+  CAF_CHECK_EQUAL(x.credit, 100);
+  CAF_CHECK_LESS(uut->threshold(), x.credit);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,155 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.timing_wheel
+
+#include "caf/detail/timing_wheel.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace caf;
+
+using tick_type = detail::timing_wheel::tick_type;
+
+namespace {
+
+struct timer : detail::timing_wheel::node {
+  explicit timer(tick_type t) {
+    due = t;
+  }
+
+  tick_type fired_at = detail::timing_wheel::infinite;
+};
+
+struct fixture {
+  detail::timing_wheel uut;
+
+  std::vector<std::unique_ptr<timer>> timers;
+
+  std::vector<timer*> fired;
+
+  timer* add(tick_type due) {
+    timers.emplace_back(std::make_unique<timer>(due));
+    auto ptr = timers.back().get();
+    uut.insert(ptr);
+    return ptr;
+  }
+
+  void advance(tick_type t) {
+    uut.advance(t, [this](detail::timing_wheel::node* x) {
+      auto ptr = static_cast<timer*>(x);
+      ptr->fired_at = uut.now();
+      fired.emplace_back(ptr);
+    });
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(timing_wheel_tests, fixture)
+
+CAF_TEST(a default constructed wheel is empty) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.now(), 0u);
+  CAF_CHECK_EQUAL(uut.next_event(), detail::timing_wheel::infinite);
+}
+
+CAF_TEST(timers fire exactly at their due tick on all levels) {
+  tick_type dues[] = {1,    5,     63,     64,         65,       4095,
+                      4096, 12345, 262144, 1000000000, 1ull << 40};
+  for (auto due : dues)
+    add(due);
+  CAF_CHECK_EQUAL(uut.size(), std::size(dues));
+  advance(1ull << 41);
+  CAF_CHECK(uut.empty());
+  CAF_REQUIRE_EQUAL(fired.size(), std::size(dues));
+  for (size_t i = 0; i < fired.size(); ++i) {
+    CAF_CHECK_EQUAL(fired[i]->due, dues[i]);
+    CAF_CHECK_EQUAL(fired[i]->fired_at, dues[i]);
+  }
+}
+
+CAF_TEST(timers never fire before their due tick) {
+  add(100);
+  advance(99);
+  CAF_CHECK(fired.empty());
+  CAF_CHECK_EQUAL(uut.now(), 99u);
+  advance(100);
+  CAF_CHECK_EQUAL(fired.size(), 1u);
+}
+
+CAF_TEST(timers in the past fire on the next advance) {
+  advance(500);
+  add(200);
+  add(500);
+  CAF_CHECK_EQUAL(uut.next_event(), 500u);
+  advance(500);
+  CAF_CHECK_EQUAL(fired.size(), 2u);
+}
+
+CAF_TEST(erased timers never fire) {
+  auto x = add(10);
+  auto y = add(5000);
+  add(20);
+  uut.erase(x);
+  uut.erase(y);
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  advance(10000);
+  CAF_REQUIRE_EQUAL(fired.size(), 1u);
+  CAF_CHECK_EQUAL(fired[0]->due, 20u);
+}
+
+CAF_TEST(clear removes all timers) {
+  for (tick_type i = 0; i < 100; ++i)
+    add(i * 100);
+  size_t cleared = 0;
+  uut.clear([&](detail::timing_wheel::node*) { ++cleared; });
+  CAF_CHECK_EQUAL(cleared, 100u);
+  CAF_CHECK(uut.empty());
+  advance(100000);
+  CAF_CHECK(fired.empty());
+}
+
+CAF_TEST(random schedules fire in order) {
+  std::minstd_rand engine{42};
+  std::uniform_int_distribution<tick_type> due_dist{0, 1000000};
+  std::uniform_int_distribution<tick_type> step_dist{1, 5000};
+  for (size_t i = 0; i < 10000; ++i)
+    add(due_dist(engine));
+  tick_type now = 0;
+  while (!uut.empty()) {
+    now += step_dist(engine);
+    advance(now);
+    // Add a few more timers while the wheel is running.
+    if (timers.size() < 12000)
+      add(now + 1 + due_dist(engine));
+  }
+  CAF_CHECK_EQUAL(fired.size(), timers.size());
+  for (size_t i = 0; i < fired.size(); ++i) {
+    CAF_CHECK_EQUAL(fired[i]->fired_at, fired[i]->due);
+    if (i > 0)
+      CAF_CHECK_LESS_OR_EQUAL(fired[i - 1]->fired_at, fired[i]->fired_at);
+  }
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
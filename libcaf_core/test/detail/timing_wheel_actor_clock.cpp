@@ -0,0 +1,148 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.timing_wheel_actor_clock
+
+#include "caf/detail/timing_wheel_actor_clock.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <chrono>
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+using namespace std::chrono_literals;
+
+namespace {
+
+behavior testee_impl() {
+  return {
+    [](const std::string&) {
+      // nop
+    },
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  detail::timing_wheel_actor_clock uut{4, 1ms};
+
+  actor testee;
+
+  abstract_actor* testee_ptr;
+
+  fixture() {
+    testee = sys.spawn(testee_impl);
+    testee_ptr = actor_cast<abstract_actor*>(testee);
+    run();
+  }
+
+  actor_clock::time_point past() {
+    return uut.now() - 1s;
+  }
+
+  actor_clock::time_point future() {
+    return uut.now() + 1h;
+  }
+};
+
+struct tid {
+  uint64_t value;
+};
+
+inline bool operator==(const timeout_msg& x, const tid& y) {
+  return x.timeout_id == y.value;
+}
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(timing_wheel_actor_clock_tests, fixture)
+
+CAF_TEST(expired timeouts trigger messages) {
+  uut.set_ordinary_timeout(past(), testee_ptr, "foo", 42);
+  uut.set_multi_timeout(past(), testee_ptr, "bar", 23);
+  auto mid = make_message_id(7).response_id();
+  uut.set_request_timeout(past(), testee_ptr, mid);
+  CAF_CHECK_EQUAL(uut.pending(), 3u);
+  CAF_CHECK_EQUAL(uut.trigger_expired_timeouts(), 3u);
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+  expect((timeout_msg), to(testee).with(tid{42}));
+  expect((timeout_msg), to(testee).with(tid{23}));
+  expect((error), to(testee).with(sec::request_timeout));
+}
+
+CAF_TEST(pending timeouts do not trigger) {
+  uut.set_ordinary_timeout(future(), testee_ptr, "foo", 42);
+  CAF_CHECK_EQUAL(uut.trigger_expired_timeouts(), 0u);
+  CAF_CHECK_EQUAL(uut.pending(), 1u);
+}
+
+CAF_TEST(ordinary timeouts replace previous timeouts of the same type) {
+  uut.set_ordinary_timeout(future(), testee_ptr, "foo", 1);
+  uut.set_ordinary_timeout(future(), testee_ptr, "foo", 2);
+  uut.set_ordinary_timeout(future(), testee_ptr, "bar", 3);
+  CAF_CHECK_EQUAL(uut.pending(), 2u);
+  uut.cancel_ordinary_timeout(testee_ptr, "foo");
+  CAF_CHECK_EQUAL(uut.pending(), 1u);
+  uut.cancel_ordinary_timeout(testee_ptr, "bar");
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
+
+CAF_TEST(request timeouts are cancellable by message ID) {
+  for (uint64_t i = 1; i <= 1000; ++i)
+    uut.set_request_timeout(future(), testee_ptr,
+                            make_message_id(i).response_id());
+  CAF_CHECK_EQUAL(uut.pending(), 1000u);
+  for (uint64_t i = 1; i <= 1000; i += 2)
+    uut.cancel_request_timeout(testee_ptr, make_message_id(i).response_id());
+  CAF_CHECK_EQUAL(uut.pending(), 500u);
+  uut.cancel_timeouts(testee_ptr);
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
+
+CAF_TEST(delayed messages arrive after their timeout) {
+  auto hello = std::string{"hello"};
+  uut.schedule_message(past(), actor_cast<strong_actor_ptr>(testee),
+                       make_mailbox_element(nullptr, make_message_id(), {},
+                                            hello));
+  uut.schedule_message(future(), actor_cast<strong_actor_ptr>(testee),
+                       make_mailbox_element(nullptr, make_message_id(), {},
+                                            hello));
+  // Delayed messages are not affected by cancelling timeouts.
+  uut.cancel_timeouts(testee_ptr);
+  CAF_CHECK_EQUAL(uut.trigger_expired_timeouts(), 1u);
+  expect((std::string), to(testee).with(hello));
+  CAF_CHECK_EQUAL(uut.pending(), 1u);
+  uut.cancel_all();
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
+
+CAF_TEST(the dispatch loop ships timeouts in time) {
+  uut.set_ordinary_timeout(uut.now() + 5ms, testee_ptr, "foo", 42);
+  std::thread dispatcher{[this] { uut.run_dispatch_loop(); }};
+  auto deadline = uut.now() + 10s;
+  while (uut.pending() > 0 && uut.now() < deadline)
+    std::this_thread::sleep_for(1ms);
+  uut.cancel_dispatch_loop();
+  dispatcher.join();
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+  expect((timeout_msg), to(testee).with(tid{42}));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
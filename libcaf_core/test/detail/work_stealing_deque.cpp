@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE detail.work_stealing_deque
+
+#include "caf/detail/work_stealing_deque.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace caf;
+
+namespace {
+
+using int_deque = detail::work_stealing_deque<int>;
+
+struct fixture {
+  fixture() : uut(4) {
+    for (int i = 0; i < 100; ++i)
+      values.push_back(i);
+  }
+
+  int_deque uut;
+  std::vector<int> values;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(work_stealing_deque_tests, fixture)
+
+CAF_TEST(a default constructed deque is empty) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.size(), 0u);
+  CAF_CHECK_EQUAL(uut.take(), nullptr);
+  CAF_CHECK_EQUAL(uut.steal(), nullptr);
+}
+
+CAF_TEST(the owner takes elements in LIFO order) {
+  for (int i = 0; i < 3; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(uut.size(), 3u);
+  CAF_CHECK_EQUAL(uut.take(), &values[2]);
+  CAF_CHECK_EQUAL(uut.take(), &values[1]);
+  CAF_CHECK_EQUAL(uut.take(), &values[0]);
+  CAF_CHECK_EQUAL(uut.take(), nullptr);
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(thieves steal elements in FIFO order) {
+  for (int i = 0; i < 3; ++i)
+    uut.push(&values[i]);
+  CAF_CHECK_EQUAL(uut.steal(), &values[0]);
+  CAF_CHECK_EQUAL(uut.steal(), &values[1]);
+  CAF_CHECK_EQUAL(uut.take(), &values[2]);
+  CAF_CHECK_EQUAL(uut.steal(), nullptr);
+}
+
+CAF_TEST(the deque grows when exceeding its capacity) {
+  CAF_CHECK_EQUAL(uut.capacity(), 4u);
+  for (auto& x : values)
+    uut.push(&x);
+  CAF_CHECK_EQUAL(uut.size(), values.size());
+  CAF_CHECK_GREATER_OR_EQUAL(uut.capacity(), values.size());
+  CAF_CHECK_EQUAL(uut.steal(), &values.front());
+  for (auto i = values.size() - 1; i > 0; --i)
+    CAF_CHECK_EQUAL(uut.take(), &values[i]);
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(concurrent thieves receive each element exactly once) {
+  std::vector<int> many(10000);
+  for (size_t i = 0; i < many.size(); ++i)
+    many[i] = static_cast<int>(i);
+  std::atomic<bool> done{false};
+  std::vector<std::vector<int>> stolen(3);
+  std::vector<std::thread> thieves;
+  for (auto& result : stolen)
+    thieves.emplace_back([&, res = &result] {
+      for (;;) {
+        if (auto ptr = uut.steal())
+          res->push_back(*ptr);
+        else if (done)
+          return;
+      }
+    });
+  std::vector<int> taken;
+  for (size_t i = 0; i < many.size(); ++i) {
+    uut.push(&many[i]);
+    if (i % 3 == 0)
+      if (auto ptr = uut.take())
+        taken.push_back(*ptr);
+  }
+  while (auto ptr = uut.take())
+    taken.push_back(*ptr);
+  done = true;
+  for (auto& t : thieves)
+    t.join();
+  for (auto& xs : stolen)
+    taken.insert(taken.end(), xs.begin(), xs.end());
+  std::sort(taken.begin(), taken.end());
+  CAF_CHECK_EQUAL(taken, many);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
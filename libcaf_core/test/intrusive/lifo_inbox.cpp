@@ -122,6 +122,41 @@ CAF_TEST(unblock) {
   CAF_REQUIRE_EQUAL(close_and_fetch(), "21");
 }
 
+CAF_TEST(splice_front) {
+  auto x3 = new inode(3);
+  auto x2 = new inode(2);
+  x3->next = x2;
+  auto res = inbox.splice_front(x3, x2);
+  CAF_REQUIRE_EQUAL(res, inbox_result::success);
+  auto x5 = new inode(5);
+  auto x4 = new inode(4);
+  x5->next = x4;
+  res = inbox.splice_front(x5, x4);
+  CAF_REQUIRE_EQUAL(res, inbox_result::success);
+  CAF_REQUIRE_EQUAL(close_and_fetch(), "5432");
+}
+
+CAF_TEST(splice_front_unblocks) {
+  CAF_REQUIRE_EQUAL(inbox.try_block(), true);
+  auto x2 = new inode(2);
+  auto x1 = new inode(1);
+  x2->next = x1;
+  auto res = inbox.splice_front(x2, x1);
+  CAF_REQUIRE_EQUAL(res, inbox_result::unblocked_reader);
+  CAF_REQUIRE_EQUAL(close_and_fetch(), "21");
+}
+
+CAF_TEST(splice_after_close) {
+  inbox.close();
+  inode_policy::unique_pointer x2{new inode(2)};
+  inode_policy::unique_pointer x1{new inode(1)};
+  x2->next = x1.get();
+  auto res = inbox.splice_front(x2.get(), x1.get());
+  CAF_REQUIRE_EQUAL(res, inbox_result::queue_closed);
+  CAF_CHECK_EQUAL(x2->next, x1.get());
+  CAF_CHECK_EQUAL(x1->next, nullptr);
+}
+
 CAF_TEST(await) {
   std::mutex mx;
   std::condition_variable cv;
@@ -22,7 +22,12 @@
 
 #include "caf/test/dsl.hpp"
 
+#include "caf/actor_companion.hpp"
+#include "caf/scoped_execution_unit.hpp"
+
 #include <chrono>
+#include <string>
+#include <vector>
 
 using namespace caf;
 
@@ -103,4 +108,66 @@ CAF_TEST(anonymous messages receive no response) {
   disallow((std::string), from(testee).to(self).with(hello));
 }
 
+CAF_TEST(batches schedule the receiver only once) {
+  run();
+  CAF_REQUIRE(sched.jobs.empty());
+  std::vector<std::string> xs{"a", "b", "c"};
+  self->send_batch(testee, xs);
+  CAF_CHECK_EQUAL(sched.jobs.size(), 1u);
+  expect((std::string), from(self).to(testee).with("a"));
+  expect((std::string), from(self).to(testee).with("b"));
+  expect((std::string), from(self).to(testee).with("c"));
+  expect((std::string), from(testee).to(self).with("a"));
+  expect((std::string), from(testee).to(self).with("b"));
+  expect((std::string), from(testee).to(self).with("c"));
+}
+
+CAF_TEST(batches to groups schedule each subscriber only once) {
+  run();
+  CAF_REQUIRE(sched.jobs.empty());
+  std::vector<std::string> xs{"a", "b", "c"};
+  self->send_batch(grp, xs);
+  // One job for the testee plus one job for the broker of the group.
+  CAF_CHECK_EQUAL(sched.jobs.size(), 2u);
+  expect((std::string), from(self).to(testee).with("a"));
+  expect((std::string), from(self).to(testee).with("b"));
+  expect((std::string), from(self).to(testee).with("c"));
+  expect((std::string), from(testee).to(self).with("a"));
+  expect((std::string), from(testee).to(self).with("b"));
+  expect((std::string), from(testee).to(self).with("c"));
+}
+
+CAF_TEST(batches to companions go through the enqueue handler) {
+  auto companion = sys.spawn<actor_companion>();
+  auto& st = deref<actor_companion>(companion);
+  std::vector<std::string> received;
+  st.on_enqueue([&](mailbox_element_ptr ptr) {
+    received.emplace_back(ptr->content().get_as<std::string>(0));
+  });
+  run();
+  std::vector<std::string> xs{"a", "b", "c"};
+  self->send_batch(companion, xs);
+  CAF_CHECK(sched.jobs.empty());
+  CAF_CHECK_EQUAL(received, xs);
+  scoped_execution_unit host{&sys};
+  st.cleanup(exit_reason::user_shutdown, &host);
+}
+
+CAF_TEST(batches to groups keep the message priority) {
+  auto companion = sys.spawn<actor_companion>();
+  auto& st = deref<actor_companion>(companion);
+  std::vector<bool> urgent;
+  st.on_enqueue([&](mailbox_element_ptr ptr) {
+    urgent.emplace_back(ptr->mid.is_urgent_message());
+  });
+  st.join(grp);
+  run();
+  std::vector<std::string> xs{"a", "b"};
+  self->send_batch<message_priority::high>(grp, xs);
+  CAF_CHECK_EQUAL(urgent, std::vector<bool>({true, true}));
+  scoped_execution_unit host{&sys};
+  st.cleanup(exit_reason::user_shutdown, &host);
+  run();
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,268 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE parallel_stream_stage
+
+#include "caf/attach_parallel_stream_stage.hpp"
+
+#include "core-test.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <stdexcept>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/attach_stream_sink.hpp"
+#include "caf/attach_stream_source.hpp"
+#include "caf/event_based_actor.hpp"
+#include "caf/stateful_actor.hpp"
+
+using std::string;
+
+using namespace caf;
+
+namespace {
+
+TESTEE_SETUP();
+
+using buf = std::deque<int>;
+
+TESTEE_STATE(file_reader) {
+  // nop
+};
+
+VARARGS_TESTEE(file_reader, size_t buf_size) {
+  return {
+    [=](string& fname) -> result<stream<int>> {
+      CAF_CHECK_EQUAL(fname, "numbers.txt");
+      return attach_stream_source(
+        self,
+        [=](buf& xs) {
+          xs.resize(buf_size);
+          std::iota(xs.begin(), xs.end(), 1);
+        },
+        [](buf& xs, downstream<int>& out, size_t num) {
+          auto n = std::min(num, xs.size());
+          for (size_t i = 0; i < n; ++i)
+            out.push(xs[i]);
+          xs.erase(xs.begin(), xs.begin() + static_cast<ptrdiff_t>(n));
+        },
+        [](const buf& xs) { return xs.empty(); });
+    },
+  };
+}
+
+TESTEE_STATE(doubler) {
+  stream_manager_ptr mgr;
+};
+
+VARARGS_TESTEE(doubler, size_t num_workers, parallel_stage_ordering ordering,
+               int* worker_fins) {
+  return {
+    [=](stream<int>& in) {
+      auto result = attach_parallel_stream_stage(
+        self, in, num_workers, ordering,
+        // initialize state
+        [](unit_t&) {
+          // nop
+        },
+        // processing step
+        [](unit_t&, downstream<int>& out, int x) { out.push(x * 2); },
+        // cleanup
+        [worker_fins](unit_t&, const error&) { ++*worker_fins; });
+      self->state.mgr = result.ptr();
+      return result;
+    },
+  };
+}
+
+#ifdef CAF_ENABLE_EXCEPTIONS
+
+TESTEE_STATE(fragile_doubler) {
+  // nop
+};
+
+// Crashes the worker that receives the element 42.
+TESTEE(fragile_doubler) {
+  return {
+    [=](stream<int>& in) {
+      return attach_parallel_stream_stage(
+        self, in, 2u, parallel_stage_ordering::preserved,
+        [](unit_t&) {
+          // nop
+        },
+        [](unit_t&, downstream<int>& out, int x) {
+          if (x == 42)
+            throw std::runtime_error("fragile_doubler fails on 42");
+          out.push(x * 2);
+        },
+        [](unit_t&, const error&) {
+          // nop
+        });
+    },
+  };
+}
+
+#endif // CAF_ENABLE_EXCEPTIONS
+
+TESTEE_STATE(collect) {
+  std::vector<int> xs;
+  int fin_called = 0;
+  error fin_reason;
+};
+
+TESTEE(collect) {
+  return {
+    [=](stream<int>& in) {
+      return attach_stream_sink(
+        self, in,
+        [](unit_t&) {
+          // nop
+        },
+        [=](unit_t&, int x) { self->state.xs.emplace_back(x); },
+        [=](unit_t&, const error& err) {
+          self->state.fin_reason = err;
+          self->state.fin_called += 1;
+        });
+    },
+  };
+}
+
+struct fixture : test_coordinator_fixture<> {
+  // Runs the pipeline until the sink called its finalizer. Workers only run
+  // when no other actor has work left and in reverse order of their
+  // assignments. Hence, workers respond out of order whenever the stage has
+  // more than one pending batch.
+  void run_pipeline(const actor& src, const actor& stg, const actor& snk) {
+    auto run_pipeline_actor = [&] {
+      for (auto& x : {src, stg, snk}) {
+        if (sched.prioritize(x)) {
+          sched.run_once();
+          return true;
+        }
+      }
+      return false;
+    };
+    auto& st = deref<collect_actor>(snk).state;
+    for (int round = 0; round < 1000 && st.fin_called == 0; ++round) {
+      while (run_pipeline_actor() || sched.try_run_once_lifo())
+        ; // repeat
+      advance_time(cfg.stream_credit_round_interval);
+    }
+  }
+
+  std::vector<int> expected_output(int n) {
+    std::vector<int> result(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+      result[static_cast<size_t>(i)] = (i + 1) * 2;
+    return result;
+  }
+
+  int worker_fins = 0;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(parallel_stream_stage_tests, fixture)
+
+CAF_TEST(parallel stages process all elements and preserve their order) {
+  auto src = sys.spawn(file_reader, 500u);
+  auto stg = sys.spawn(doubler, 4u, parallel_stage_ordering::preserved,
+                       &worker_fins);
+  auto snk = sys.spawn(collect);
+  self->send(snk * stg * src, "numbers.txt");
+  run_pipeline(src, stg, snk);
+  auto& st = deref<collect_actor>(snk).state;
+  CAF_CHECK_EQUAL(st.fin_called, 1);
+  CAF_CHECK_EQUAL(st.fin_reason, none);
+  CAF_CHECK_EQUAL(st.xs, expected_output(500));
+  CAF_MESSAGE("the stage shuts down all of its workers");
+  CAF_CHECK_EQUAL(worker_fins, 4);
+}
+
+CAF_TEST(relaxed parallel stages emit results in the order of completion) {
+  auto src = sys.spawn(file_reader, 500u);
+  auto stg = sys.spawn(doubler, 4u, parallel_stage_ordering::relaxed,
+                       &worker_fins);
+  auto snk = sys.spawn(collect);
+  self->send(snk * stg * src, "numbers.txt");
+  run_pipeline(src, stg, snk);
+  auto& st = deref<collect_actor>(snk).state;
+  CAF_CHECK_EQUAL(st.fin_called, 1);
+  CAF_CHECK_EQUAL(st.fin_reason, none);
+  CAF_CHECK(!std::is_sorted(st.xs.begin(), st.xs.end()));
+  std::sort(st.xs.begin(), st.xs.end());
+  CAF_CHECK_EQUAL(st.xs, expected_output(500));
+  CAF_CHECK_EQUAL(worker_fins, 4);
+}
+
+CAF_TEST(parallel stages respect back pressure) {
+  auto src = sys.spawn(file_reader, 500u);
+  auto stg = sys.spawn(doubler, 2u, parallel_stage_ordering::preserved,
+                       &worker_fins);
+  auto snk = sys.spawn(collect);
+  self->send(snk * stg * src, "numbers.txt");
+  expect((string), from(self).to(src).with("numbers.txt"));
+  expect((open_stream_msg), from(self).to(stg));
+  expect((open_stream_msg), from(self).to(snk));
+  expect((upstream_msg::ack_open), from(snk).to(stg));
+  expect((upstream_msg::ack_open), from(stg).to(src));
+  CAF_MESSAGE("the stage forwards the first batch to a worker");
+  expect((downstream_msg::batch), from(src).to(stg));
+  CAF_MESSAGE("credit for elements at the workers remains unavailable");
+  auto& mgr = *deref<doubler_actor>(stg).state.mgr;
+  CAF_CHECK_EQUAL(mgr.acquire_credit(nullptr, 10), 0);
+  run_pipeline(src, stg, snk);
+  auto& st = deref<collect_actor>(snk).state;
+  CAF_CHECK_EQUAL(st.xs, expected_output(500));
+  CAF_CHECK_EQUAL(worker_fins, 2);
+}
+
+CAF_TEST(workers terminate together with their stage) {
+  auto src = sys.spawn(file_reader, 500u);
+  auto stg = sys.spawn(doubler, 2u, parallel_stage_ordering::preserved,
+                       &worker_fins);
+  auto snk = sys.spawn(collect);
+  self->send(snk * stg * src, "numbers.txt");
+  expect((string), from(self).to(src).with("numbers.txt"));
+  expect((open_stream_msg), from(self).to(stg));
+  anon_send_exit(stg, exit_reason::user_shutdown);
+  run();
+  CAF_CHECK_EQUAL(worker_fins, 2);
+}
+
+#ifdef CAF_ENABLE_EXCEPTIONS
+
+CAF_TEST(parallel stages fail when a worker fails) {
+  auto src = sys.spawn(file_reader, 500u);
+  auto stg = sys.spawn(fragile_doubler);
+  auto snk = sys.spawn(collect);
+  self->monitor(stg);
+  self->send(snk * stg * src, "numbers.txt");
+  run_pipeline(src, stg, snk);
+  expect((down_msg), from(stg).to(self));
+  auto& st = deref<collect_actor>(snk).state;
+  CAF_CHECK_EQUAL(st.fin_called, 1);
+  CAF_CHECK_NOT_EQUAL(st.fin_reason, none);
+}
+
+#endif // CAF_ENABLE_EXCEPTIONS
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -224,6 +224,42 @@ behavior ping_multiplexed3(ping_actor* self, bool* had_timeout,
   return {};
 }
 
+struct coalescing_config : actor_system_config {
+  coalescing_config() {
+    request_timeout_slack = milliseconds(1);
+  }
+};
+
+behavior ping_then(ping_actor* self, int* responses, int* timeouts,
+                   const actor& pong_actor) {
+  for (int i = 0; i < 2; ++i)
+    self->request(pong_actor, milliseconds(100), ping_atom_v)
+      .then([=](pong_atom) { ++*responses; },
+            [=](const error& err) {
+              CAF_REQUIRE_EQUAL(err, sec::request_timeout);
+              ++*timeouts;
+            });
+  return {
+    [](int) {
+      // nop
+    },
+  };
+}
+
+behavior ping_await(ping_actor* self, int* timeouts, const actor& pong_actor) {
+  self->request(pong_actor, milliseconds(100), ping_atom_v)
+    .await([=](pong_atom) { CAF_FAIL("received pong"); },
+           [=](const error& err) {
+             CAF_REQUIRE_EQUAL(err, sec::request_timeout);
+             ++*timeouts;
+           });
+  return {
+    [](int) {
+      // nop
+    },
+  };
+}
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(request_timeout_tests, test_coordinator_fixture<>)
@@ -301,3 +337,52 @@ CAF_TEST(multiplexed_timeout) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(coalesced_request_timeout_tests,
+                       test_coordinator_fixture<coalescing_config>)
+
+CAF_TEST(requests with the same timeout share a single clock entry) {
+  int responses = 0;
+  int timeouts = 0;
+  auto testee = sys.spawn(ping_then, &responses, &timeouts,
+                          sys.spawn<lazy_init>(pong));
+  sched.run_once();
+  CAF_CHECK_EQUAL(sched.clock().schedule().size(), 1u);
+  CAF_REQUIRE_EQUAL(sched.jobs.size(), 1u);
+  CAF_REQUIRE_EQUAL(sched.next_job<local_actor>().name(), "pong"s);
+  // The timeout arrives before pong responds and fails both requests at once.
+  sched.trigger_timeouts();
+  CAF_REQUIRE(sched.prioritize(testee));
+  sched.run_once();
+  CAF_CHECK_EQUAL(timeouts, 0);
+  sched.run();
+  CAF_CHECK_EQUAL(timeouts, 2);
+  CAF_CHECK_EQUAL(responses, 0);
+}
+
+CAF_TEST(responses cancel coalesced timeouts lazily) {
+  int responses = 0;
+  int timeouts = 0;
+  auto testee = sys.spawn(ping_then, &responses, &timeouts,
+                          sys.spawn<lazy_init>(pong));
+  sched.run();
+  CAF_CHECK_EQUAL(responses, 2);
+  // The bucket remains in the clock, but has no effect when expiring.
+  CAF_CHECK_EQUAL(sched.clock().schedule().size(), 1u);
+  sched.trigger_timeouts();
+  sched.run();
+  CAF_CHECK_EQUAL(timeouts, 0);
+}
+
+CAF_TEST(coalesced timeouts fail awaited responses) {
+  int timeouts = 0;
+  auto testee = sys.spawn(ping_await, &timeouts, sys.spawn<lazy_init>(pong));
+  sched.run_once();
+  CAF_REQUIRE_EQUAL(sched.next_job<local_actor>().name(), "pong"s);
+  sched.trigger_timeouts();
+  CAF_REQUIRE(sched.prioritize(testee));
+  sched.run();
+  CAF_CHECK_EQUAL(timeouts, 1);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
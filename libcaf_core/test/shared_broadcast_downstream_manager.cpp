@@ -0,0 +1,291 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE shared_broadcast_downstream_manager
+
+#include "caf/shared_broadcast_downstream_manager.hpp"
+
+#include "core-test.hpp"
+
+#include <numeric>
+#include <vector>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/scheduled_actor.hpp"
+
+using namespace caf;
+
+namespace {
+
+using manager_type = shared_broadcast_downstream_manager<int>;
+
+using batch_type = std::vector<int>;
+
+// Mocks just enough of a stream manager to serve our entity.
+class mock_stream_manager : public stream_manager {
+public:
+  mock_stream_manager(scheduled_actor* self) : stream_manager(self), out_(this) {
+    // nop
+  }
+
+  manager_type& out() override {
+    return out_;
+  }
+
+  bool done() const override {
+    return false;
+  }
+
+  bool idle() const noexcept override {
+    return false;
+  }
+
+private:
+  manager_type out_;
+};
+
+// Mocks just enough of an actor to receive and send batches.
+class entity : public scheduled_actor {
+public:
+  using signatures = none_t;
+
+  using behavior_type = behavior;
+
+  entity(actor_config& cfg) : scheduled_actor(cfg), mgr(this), next_slot(1) {
+    // nop
+  }
+
+  void enqueue(mailbox_element_ptr what, execution_unit*) override {
+    mbox.push_back(std::move(what->payload));
+  }
+
+  void attach(attachable_ptr) override {
+    // nop
+  }
+
+  size_t detach(const attachable::token&) override {
+    return 0;
+  }
+
+  void add_link(abstract_actor*) override {
+    // nop
+  }
+
+  void remove_link(abstract_actor*) override {
+    // nop
+  }
+
+  bool add_backlink(abstract_actor*) override {
+    return false;
+  }
+
+  bool remove_backlink(abstract_actor*) override {
+    return false;
+  }
+
+  void launch(execution_unit*, bool, bool) override {
+    // nop
+  }
+
+  outbound_path* add_path_to(entity& x, int32_t desired_batch_size) {
+    auto ptr = mgr.out().add_path(next_slot++, x.ctrl());
+    CAF_REQUIRE(ptr != nullptr);
+    ptr->set_desired_batch_size(desired_batch_size);
+    ptr->slots.receiver = x.next_slot++;
+    return ptr;
+  }
+
+  // Returns the content of all received batches and clears the mailbox.
+  std::vector<downstream_msg::batch> batches() {
+    std::vector<downstream_msg::batch> result;
+    for (auto& msg : mbox) {
+      CAF_REQUIRE(msg.match_elements<downstream_msg>());
+      auto& dm = msg.get_mutable_as<downstream_msg>(0);
+      CAF_REQUIRE(holds_alternative<downstream_msg::batch>(dm.content));
+      result.emplace_back(get<downstream_msg::batch>(dm.content));
+    }
+    mbox.clear();
+    return result;
+  }
+
+  mock_stream_manager mgr;
+
+  std::vector<message> mbox;
+
+  stream_slot next_slot;
+};
+
+struct fixture {
+  actor_system_config cfg;
+
+  actor_system sys{cfg};
+
+  strong_actor_ptr alice_hdl = spawn(0);
+
+  strong_actor_ptr bob_hdl = spawn(1);
+
+  strong_actor_ptr carl_hdl = spawn(2);
+
+  entity& alice = fetch(alice_hdl);
+
+  entity& bob = fetch(bob_hdl);
+
+  entity& carl = fetch(carl_hdl);
+
+  strong_actor_ptr spawn(actor_id id) {
+    actor_config conf;
+    auto hdl = make_actor<entity>(id, node_id{}, &sys, conf);
+    return actor_cast<strong_actor_ptr>(std::move(hdl));
+  }
+
+  static entity& fetch(const strong_actor_ptr& hdl) {
+    return *static_cast<entity*>(actor_cast<abstract_actor*>(hdl));
+  }
+
+  static batch_type make_batch(int first, int last) {
+    batch_type result(static_cast<size_t>(last + 1 - first));
+    std::iota(result.begin(), result.end(), first);
+    return result;
+  }
+
+  static batch_type content(const downstream_msg::batch& x) {
+    CAF_REQUIRE(x.xs.match_elements<batch_type>());
+    return x.xs.get_as<batch_type>(0);
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(shared_broadcast_downstream_manager_tests, fixture)
+
+CAF_TEST(all paths share the same batches) {
+  auto to_bob = alice.add_path_to(bob, 10);
+  auto to_carl = alice.add_path_to(carl, 10);
+  for (int i = 1; i <= 20; ++i)
+    alice.mgr.out().push(i);
+  to_bob->open_credit = 20;
+  to_carl->open_credit = 20;
+  alice.mgr.out().emit_batches();
+  auto xs = bob.batches();
+  auto ys = carl.batches();
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_REQUIRE_EQUAL(ys.size(), 2u);
+  CAF_CHECK_EQUAL(content(xs[0]), make_batch(1, 10));
+  CAF_CHECK_EQUAL(content(xs[1]), make_batch(11, 20));
+  for (size_t i = 0; i < 2; ++i)
+    CAF_CHECK_EQUAL(xs[i].xs.cptr(), ys[i].xs.cptr());
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 0u);
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(), 0u);
+}
+
+CAF_TEST(paths receive batches only with sufficient credit) {
+  auto to_bob = alice.add_path_to(bob, 10);
+  auto to_carl = alice.add_path_to(carl, 10);
+  for (int i = 1; i <= 25; ++i)
+    alice.mgr.out().push(i);
+  to_bob->open_credit = 20;
+  to_carl->open_credit = 5;
+  alice.mgr.out().emit_batches();
+  CAF_CHECK_EQUAL(bob.batches().size(), 2u);
+  CAF_CHECK(carl.batches().empty());
+  CAF_CHECK_EQUAL(to_bob->open_credit, 0);
+  CAF_CHECK_EQUAL(to_carl->open_credit, 5);
+  CAF_MESSAGE("the central buffer keeps elements for an incomplete batch");
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 2u);
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(), 25u);
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(to_bob->slots.sender), 0u);
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(to_carl->slots.sender), 20u);
+  CAF_MESSAGE("batches stay until the slowest path received them");
+  to_carl->open_credit += 15;
+  alice.mgr.out().emit_batches();
+  auto ys = carl.batches();
+  CAF_REQUIRE_EQUAL(ys.size(), 2u);
+  CAF_CHECK_EQUAL(content(ys[0]), make_batch(1, 10));
+  CAF_CHECK_EQUAL(content(ys[1]), make_batch(11, 20));
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 0u);
+  CAF_MESSAGE("forcing batches sends underfull batches");
+  to_bob->open_credit = 10;
+  alice.mgr.out().force_emit_batches();
+  auto zs = bob.batches();
+  CAF_REQUIRE_EQUAL(zs.size(), 1u);
+  CAF_CHECK_EQUAL(content(zs[0]), make_batch(21, 25));
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(), 5u);
+}
+
+CAF_TEST(batches use the smallest desired batch size) {
+  auto to_bob = alice.add_path_to(bob, 10);
+  auto to_carl = alice.add_path_to(carl, 4);
+  for (int i = 1; i <= 8; ++i)
+    alice.mgr.out().push(i);
+  to_bob->open_credit = 10;
+  to_carl->open_credit = 10;
+  alice.mgr.out().emit_batches();
+  auto xs = bob.batches();
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_CHECK_EQUAL(content(xs[0]), make_batch(1, 4));
+  CAF_CHECK_EQUAL(content(xs[1]), make_batch(5, 8));
+  CAF_CHECK_EQUAL(carl.batches().size(), 2u);
+}
+
+CAF_TEST(paths with a smaller capacity than a batch receive slices) {
+  auto to_bob = alice.add_path_to(bob, 10);
+  auto to_carl = alice.add_path_to(carl, 10);
+  for (int i = 1; i <= 20; ++i)
+    alice.mgr.out().push(i);
+  to_bob->open_credit = 20;
+  alice.mgr.out().emit_batches();
+  CAF_CHECK_EQUAL(bob.batches().size(), 2u);
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 2u);
+  CAF_MESSAGE("shrink the capacity of carl below the batch size");
+  to_carl->max_capacity = 4;
+  to_carl->open_credit = 4;
+  alice.mgr.out().emit_batches();
+  auto ys = carl.batches();
+  CAF_REQUIRE_EQUAL(ys.size(), 1u);
+  CAF_CHECK_EQUAL(content(ys[0]), make_batch(1, 4));
+  CAF_CHECK_EQUAL(alice.mgr.out().buffered(to_carl->slots.sender), 16u);
+  to_carl->open_credit = 10;
+  alice.mgr.out().emit_batches();
+  ys = carl.batches();
+  CAF_REQUIRE_EQUAL(ys.size(), 2u);
+  CAF_CHECK_EQUAL(content(ys[0]), make_batch(5, 10));
+  CAF_CHECK_EQUAL(content(ys[1]), make_batch(11, 14));
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 1u);
+  to_carl->open_credit = 6;
+  alice.mgr.out().emit_batches();
+  ys = carl.batches();
+  CAF_REQUIRE_EQUAL(ys.size(), 1u);
+  CAF_CHECK_EQUAL(content(ys[0]), make_batch(15, 20));
+  CAF_CHECK_EQUAL(alice.mgr.out().num_batches(), 0u);
+  CAF_MESSAGE("new batches respect the smaller capacity");
+  for (int i = 21; i <= 28; ++i)
+    alice.mgr.out().push(i);
+  to_bob->open_credit = 8;
+  to_carl->open_credit = 8;
+  alice.mgr.out().emit_batches();
+  auto xs = bob.batches();
+  ys = carl.batches();
+  CAF_REQUIRE_EQUAL(xs.size(), 2u);
+  CAF_REQUIRE_EQUAL(ys.size(), 2u);
+  CAF_CHECK_EQUAL(content(xs[0]), make_batch(21, 24));
+  for (size_t i = 0; i < 2; ++i)
+    CAF_CHECK_EQUAL(xs[i].xs.cptr(), ys[i].xs.cptr());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
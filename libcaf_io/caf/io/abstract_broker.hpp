@@ -97,6 +97,8 @@ public:
 
   void enqueue(strong_actor_ptr, message_id, message, execution_unit*) override;
 
+  void enqueue_batch(mailbox_element_chain, execution_unit*) override;
+
   // -- overridden modifiers of local_actor ------------------------------------
 
   void launch(execution_unit* eu, bool lazy, bool hide) override;
@@ -158,6 +160,15 @@ public:
   /// Writes `data` into the buffer for a given connection.
   void write(connection_handle hdl, size_t bs, const void* buf);
 
+  /// Appends `buf` to the output of a given connection. Avoids copying `buf`
+  /// if the connection supports scatter-gather output.
+  void write(connection_handle hdl, byte_buffer buf);
+
+  /// Appends a shared, immutable buffer to the output of a given connection.
+  /// Allows sending the same payload to multiple connections without copying
+  /// it if the connections support scatter-gather output.
+  void write(connection_handle hdl, shared_byte_buffer buf);
+
   /// Sends the content of the buffer for a given connection.
   void flush(connection_handle hdl);
 
@@ -359,6 +370,11 @@ public:
   /// Returns the `multiplexer` running this broker.
   network::multiplexer& backend();
 
+  /// Returns the `multiplexer` that performs the socket I/O for the next
+  /// connection of this broker. The default implementation returns
+  /// `backend()`.
+  virtual network::multiplexer& next_io_backend();
+
 protected:
   void init_broker();
 
@@ -432,6 +448,7 @@ private:
   doorman_map doormen_;
   datagram_servant_map datagram_servants_;
   byte_buffer dummy_wr_buf_;
+  network::multiplexer* backend_;
 };
 
 } // namespace caf::io
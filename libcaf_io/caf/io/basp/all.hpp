@@ -18,11 +18,16 @@
 
 #pragma once
 
+#include "caf/io/basp/codec.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/endpoint_context.hpp"
 #include "caf/io/basp/header.hpp"
 #include "caf/io/basp/instance.hpp"
+#include "caf/io/basp/lz4_codec.hpp"
+#include "caf/io/basp/message_batch.hpp"
 #include "caf/io/basp/message_type.hpp"
+#include "caf/io/basp/outbound_queue.hpp"
 #include "caf/io/basp/routing_table.hpp"
 #include "caf/io/basp/version.hpp"
 
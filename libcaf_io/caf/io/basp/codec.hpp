@@ -0,0 +1,60 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include "caf/byte.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/span.hpp"
+#include "caf/string_view.hpp"
+
+namespace caf::io::basp {
+
+/// @addtogroup BASP
+/// @{
+
+/// Compresses and decompresses BASP payloads. Nodes negotiate the codec for a
+/// connection by name during the handshake. Since actors may serialize
+/// messages on their own thread, implementations must allow concurrent calls
+/// to `compress` and `decompress`.
+class CAF_IO_EXPORT codec {
+public:
+  virtual ~codec();
+
+  /// Returns the name that identifies this codec in the handshake.
+  virtual string_view name() const noexcept = 0;
+
+  /// Appends the compressed form of `in` to `out`. Returns `false` without
+  /// modifying `out` if compressing `in` fails or would not save any space.
+  virtual bool compress(span<const byte> in, byte_buffer& out) const = 0;
+
+  /// Appends the decompressed form of `in` to `out`. Returns `false` if `in`
+  /// is malformed or does not decompress to exactly `size` bytes.
+  virtual bool
+  decompress(span<const byte> in, byte_buffer& out, size_t size) const = 0;
+};
+
+/// @relates codec
+using codec_ptr = std::shared_ptr<const codec>;
+
+/// @}
+
+} // namespace caf::io::basp
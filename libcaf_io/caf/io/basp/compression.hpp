@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/io/basp/codec.hpp"
+#include "caf/io/basp/header.hpp"
+#include "caf/meta/type_name.hpp"
+#include "caf/ref_counted.hpp"
+
+namespace caf::io::basp {
+
+/// @addtogroup BASP
+/// @{
+
+/// Summarizes the payload compression on a single connection.
+struct compression_stats {
+  /// Number of outgoing payloads that got sent in compressed form.
+  uint64_t compressed_payloads = 0;
+
+  /// Number of outgoing payloads above the threshold that did not shrink.
+  uint64_t incompressible_payloads = 0;
+
+  /// Total size of all compressed outgoing payloads before compression.
+  uint64_t uncompressed_bytes = 0;
+
+  /// Total size of all compressed outgoing payloads after compression.
+  uint64_t compressed_bytes = 0;
+
+  /// Number of incoming payloads that arrived in compressed form.
+  uint64_t decompressed_payloads = 0;
+
+  /// Returns `uncompressed_bytes / compressed_bytes` or 1 if no payload got
+  /// compressed yet.
+  double ratio() const noexcept {
+    if (compressed_bytes == 0)
+      return 1.;
+    return static_cast<double>(uncompressed_bytes)
+           / static_cast<double>(compressed_bytes);
+  }
+};
+
+/// @relates compression_stats
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, compression_stats& x) {
+  return f(meta::type_name("compression_stats"), x.compressed_payloads,
+           x.incompressible_payloads, x.uncompressed_bytes, x.compressed_bytes,
+           x.decompressed_payloads);
+}
+
+/// Applies the negotiated codec to the BASP payloads of a single connection.
+/// A compressed payload starts with its uncompressed size as 32-bit integer,
+/// followed by the output of the codec. The header of a compressed message
+/// carries `header::compressed_flag`.
+class CAF_IO_EXPORT compression : public ref_counted {
+public:
+  compression(codec_ptr impl, size_t threshold);
+
+  ~compression() override;
+
+  /// Returns the negotiated codec.
+  const codec& impl() const noexcept {
+    return *impl_;
+  }
+
+  /// Returns the minimum payload size for compressing a message.
+  size_t threshold() const noexcept {
+    return threshold_;
+  }
+
+  /// Tries to compress the payload of the BASP message starting at
+  /// `header_offset` in `buf`. On success, replaces the payload and updates
+  /// the flags and the payload size in `hdr`. Leaves messages below the
+  /// threshold untouched.
+  /// @pre `hdr.payload_len` is the size of the serialized payload that follows
+  ///      `header_size` bytes reserved for the header at `header_offset`.
+  /// @note Safe to call from any thread.
+  void compress(header& hdr, byte_buffer& buf, size_t header_offset);
+
+  /// Replaces a compressed `payload` with its original content and clears
+  /// `header::compressed_flag` in `hdr`. Returns `false` if `payload` is
+  /// malformed.
+  bool decompress(header& hdr, byte_buffer& payload);
+
+  /// Returns a snapshot of the statistics for this connection.
+  /// @note Safe to call from any thread.
+  compression_stats stats() const noexcept;
+
+private:
+  codec_ptr impl_;
+  size_t threshold_;
+  std::atomic<uint64_t> compressed_payloads_;
+  std::atomic<uint64_t> incompressible_payloads_;
+  std::atomic<uint64_t> uncompressed_bytes_;
+  std::atomic<uint64_t> compressed_bytes_;
+  std::atomic<uint64_t> decompressed_payloads_;
+};
+
+/// @relates compression
+using compression_ptr = intrusive_ptr<compression>;
+
+/// @}
+
+} // namespace caf::io::basp
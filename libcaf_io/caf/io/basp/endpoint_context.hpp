@@ -18,16 +18,22 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 
+#include "caf/detail/message_shape_cache.hpp"
 #include "caf/response_promise.hpp"
 #include "caf/variant.hpp"
 
 #include "caf/io/connection_handle.hpp"
 #include "caf/io/datagram_handle.hpp"
 
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/header.hpp"
+#include "caf/io/basp/message_batch.hpp"
+#include "caf/io/basp/message_queue.hpp"
+#include "caf/io/basp/outbound_queue.hpp"
 
 namespace caf::io::basp {
 
@@ -46,6 +52,17 @@ struct endpoint_context {
   uint16_t local_port;
   // pending operations to be performed after handshake completed
   optional<response_promise> callback;
+  // messages that senders serialized on their own thread
+  outbound_queue_ptr outbound;
+  // negotiated payload compression or nullptr
+  compression_ptr payload_compression;
+  // messages waiting for getting sent as a single frame or nullptr
+  std::unique_ptr<message_batch> batch;
+  // message shapes received on this connection, created on first use
+  detail::message_shape_cache_ptr shapes;
+  // delivers messages received on this connection in order, created on first
+  // use
+  message_queue_ptr queue;
 };
 
 } // namespace caf::io::basp
@@ -20,11 +20,18 @@
 
 namespace caf::io::basp {
 
+struct compression_stats;
 struct header;
 
+class codec;
+class compression;
+class lz4_codec;
+class message_batch;
 class worker;
 class worker_hub;
 class message_queue;
+class outbound_queue;
+class serializing_proxy;
 class instance;
 class routing_table;
 
@@ -63,6 +63,10 @@ struct header {
   /// Identifies a receiver by name rather than ID.
   static const uint8_t named_receiver_flag = 0x01;
 
+  /// Marks a payload as compressed with the codec negotiated for the
+  /// connection.
+  static const uint8_t compressed_flag = 0x02;
+
   /// Identifies the config server.
   static const uint64_t config_server_id = 1;
 
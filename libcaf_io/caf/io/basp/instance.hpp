@@ -24,10 +24,13 @@
 #include "caf/byte_buffer.hpp"
 #include "caf/callback.hpp"
 #include "caf/detail/io_export.hpp"
+#include "caf/detail/message_shape_cache.hpp"
 #include "caf/detail/worker_hub.hpp"
 #include "caf/error.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/connection_state.hpp"
 #include "caf/io/basp/header.hpp"
+#include "caf/io/basp/message_batch.hpp"
 #include "caf/io/basp/message_queue.hpp"
 #include "caf/io/basp/message_type.hpp"
 #include "caf/io/basp/routing_table.hpp"
@@ -101,6 +104,45 @@ public:
     /// Returns a handle to the callee actor.
     virtual strong_actor_ptr this_actor() = 0;
 
+    // -- payload compression --------------------------------------------------
+
+    /// Called after both nodes agreed on compressing payloads on the direct
+    /// connection `hdl` to `nid`.
+    virtual void enable_compression(connection_handle hdl, const node_id& nid,
+                                    compression_ptr ptr);
+
+    /// Returns the payload compression for `hdl` or `nullptr` if the
+    /// connection sends uncompressed payloads.
+    virtual compression* compression_for(connection_handle hdl);
+
+    // -- message coalescing ---------------------------------------------------
+
+    /// Called after both nodes agreed on coalescing messages on the direct
+    /// connection `hdl`.
+    virtual void enable_batching(connection_handle hdl);
+
+    /// Returns the pending batch for `hdl` or `nullptr` if the connection
+    /// sends each message in its own frame.
+    /// @note The callee must write pending messages of the batch before
+    ///       returning from `get_buffer` or `flush` to preserve ordering.
+    virtual message_batch* batch_for(connection_handle hdl);
+
+    /// Called after adding the first message to the empty batch for `hdl`,
+    /// i.e., the callee needs to flush `hdl` eventually.
+    virtual void batch_started(connection_handle hdl);
+
+    // -- deserialization ------------------------------------------------------
+
+    /// Returns the cache for message shapes received on `hdl` or `nullptr` to
+    /// deserialize messages without caching.
+    virtual detail::message_shape_cache* shape_cache_for(connection_handle hdl);
+
+    // -- message ordering -----------------------------------------------------
+
+    /// Returns the queue that delivers messages received on `hdl` in order or
+    /// `nullptr` to use the queue of the BASP instance for all connections.
+    virtual message_queue* queue_for(connection_handle hdl);
+
   protected:
     proxy_registry namespace_;
   };
@@ -176,9 +218,10 @@ public:
     return published_actors_;
   }
 
-  /// Writes a header followed by its payload to `storage`.
+  /// Writes a header followed by its payload to `storage`, compressing the
+  /// payload with `cmp` unless `cmp == nullptr`.
   static void write(execution_unit* ctx, byte_buffer& buf, header& hdr,
-                    payload_writer* pw = nullptr);
+                    payload_writer* pw = nullptr, compression* cmp = nullptr);
 
   /// Writes the server handshake containing the information of the
   /// actor published at `port` to `buf`. If `port == none` or
@@ -210,10 +253,16 @@ public:
     return hub_;
   }
 
+  /// Returns the queue for establishing strict ordering of messages that do
+  /// not belong to a particular connection.
   message_queue& queue() {
     return queue_;
   }
 
+  /// Returns the queue for establishing strict ordering of messages received
+  /// on `hdl`.
+  message_queue& queue_for(connection_handle hdl);
+
   actor_system& system() {
     return callee_.proxies().system();
   }
@@ -229,12 +278,55 @@ private:
   void forward(execution_unit* ctx, const node_id& dest_node, const header& hdr,
                byte_buffer& payload);
 
+  /// Returns the configured codecs that the middleman knows.
+  std::vector<std::string> supported_codecs();
+
+  /// Returns the optional protocol features that this node enables.
+  std::vector<std::string> supported_features();
+
+  /// Writes the handshake fields for optional protocol features.
+  template <class... Ts>
+  error_code<sec> write_handshake(binary_serializer& sink, const Ts&... xs) {
+    auto codecs = supported_codecs();
+    auto features = supported_features();
+    // Older nodes ignore any trailing fields.
+    if (!features.empty())
+      return sink(xs..., codecs, features);
+    if (!codecs.empty())
+      return sink(xs..., codecs);
+    return sink(xs...);
+  }
+
+  /// Reads the handshake fields for optional protocol features.
+  static error_code<sec> read_handshake_extensions(
+    binary_deserializer& source, std::vector<std::string>& codecs,
+    std::vector<std::string>& features);
+
+  /// Enables message coalescing for `hdl` if this node enables it and the
+  /// remote node announced support for batches.
+  void negotiate_batching(connection_handle hdl,
+                          const std::vector<std::string>& remote_features);
+
+  /// Handles all messages in the payload of a `batch` frame.
+  connection_state handle_batch(execution_unit* ctx, connection_handle hdl,
+                                const header& hdr, byte_buffer& payload);
+
+  /// Enables payload compression for `hdl` if the codec lists of both nodes
+  /// overlap. Both nodes pick the first codec from the list of the server.
+  void negotiate_compression(connection_handle hdl, const node_id& nid,
+                             const std::vector<std::string>& server_codecs,
+                             const std::vector<std::string>& client_codecs);
+
   routing_table tbl_;
   published_actor_map published_actors_;
   node_id this_node_;
   callee& callee_;
   message_queue queue_;
   detail::worker_hub<worker> hub_;
+  std::vector<std::string> codecs_;
+  size_t compression_threshold_;
+  bool coalesce_messages_;
+  size_t max_batch_size_;
 };
 
 /// @}
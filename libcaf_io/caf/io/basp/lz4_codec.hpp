@@ -0,0 +1,46 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include "caf/detail/io_export.hpp"
+#include "caf/io/basp/codec.hpp"
+
+namespace caf::io::basp {
+
+/// @addtogroup BASP
+/// @{
+
+/// A fast codec that produces data in the LZ4 block format. The compressor
+/// uses a single greedy pass without entropy coding, which trades ratio for
+/// throughput.
+class CAF_IO_EXPORT lz4_codec : public codec {
+public:
+  ~lz4_codec() override;
+
+  string_view name() const noexcept override;
+
+  bool compress(span<const byte> in, byte_buffer& out) const override;
+
+  bool
+  decompress(span<const byte> in, byte_buffer& out, size_t size) const override;
+};
+
+/// @}
+
+} // namespace caf::io::basp
@@ -0,0 +1,86 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/io/basp/compression.hpp"
+
+namespace caf::io::basp {
+
+/// @addtogroup BASP
+/// @{
+
+/// Collects complete BASP messages for a single connection in order to send
+/// them in a single `batch` frame.
+class CAF_IO_EXPORT message_batch {
+public:
+  /// Returns the buffer for appending the next message, including its header.
+  /// @post the caller must call `added` after writing the message
+  byte_buffer& buf() noexcept {
+    return buf_;
+  }
+
+  /// Counts the message that the caller wrote to `buf()`.
+  void added() noexcept {
+    ++size_;
+  }
+
+  /// Returns the number of pending messages.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns the number of bytes of all pending messages.
+  size_t bytes() const noexcept {
+    return buf_.size();
+  }
+
+  /// Queries whether this batch has no pending message.
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// Queries whether the broker already scheduled a timeout for this batch.
+  bool timeout_pending() const noexcept {
+    return timeout_pending_;
+  }
+
+  /// Sets whether the broker scheduled a timeout for this batch.
+  void timeout_pending(bool value) noexcept {
+    timeout_pending_ = value;
+  }
+
+  /// Appends all pending messages to `out` and clears the batch. Writes a
+  /// single message as is and multiple messages as `batch` frame. Compresses
+  /// the resulting frame with `cmp` unless `cmp == nullptr`.
+  void write_to(execution_unit* ctx, byte_buffer& out, compression* cmp);
+
+private:
+  byte_buffer buf_;
+  size_t size_ = 0;
+  bool timeout_pending_ = false;
+};
+
+/// @}
+
+} // namespace caf::io::basp
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <vector>
@@ -25,13 +26,21 @@
 #include "caf/actor_control_block.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/fwd.hpp"
+#include "caf/intrusive_ptr.hpp"
 #include "caf/mailbox_element.hpp"
+#include "caf/ref_counted.hpp"
 
 namespace caf::io::basp {
 
 /// Enforces strict order of message delivery, i.e., deliver messages in the
-/// same order as if they were deserialized by a single thread.
-class CAF_IO_EXPORT message_queue {
+/// same order as if they were deserialized by a single thread. The BASP broker
+/// uses one queue per connection, i.e., a slow deserialization only delays
+/// later messages from the same connection.
+///
+/// Tracking which ID to deliver next requires no locking. Messages that
+/// arrive in order go straight to their receiver. Only messages that arrive
+/// ahead of their predecessor wait in a buffer that has its own mutex.
+class CAF_IO_EXPORT message_queue : public ref_counted {
 public:
   // -- member types -----------------------------------------------------------
 
@@ -46,33 +55,64 @@ public:
 
   message_queue();
 
+  ~message_queue() override;
+
   // -- mutators ---------------------------------------------------------------
 
   /// Adds a new message to the queue or deliver it immediately if possible.
+  /// @note Safe to call from any thread.
   void push(execution_unit* ctx, uint64_t id, strong_actor_ptr receiver,
             mailbox_element_ptr content);
 
   /// Marks given ID as dropped, effectively skipping it without effect.
+  /// @note Safe to call from any thread.
   void drop(execution_unit* ctx, uint64_t id);
 
   /// Returns the next ascending ID.
+  /// @note Safe to call from any thread.
   uint64_t new_id();
 
-  // -- member variables -------------------------------------------------------
+  // -- properties -------------------------------------------------------------
 
-  /// Protects all other properties.
-  std::mutex lock;
+  /// Returns the number of messages that wait for a predecessor.
+  size_t num_pending() const noexcept {
+    return num_pending_.load();
+  }
+
+  // -- member variables -------------------------------------------------------
 
   /// The next available ascending ID. The counter is large enough to overflow
   /// after roughly 600 years if we dispatch a message every microsecond.
-  uint64_t next_id;
+  std::atomic<uint64_t> next_id;
 
   /// The next ID that we can ship.
-  uint64_t next_undelivered;
+  std::atomic<uint64_t> next_undelivered;
+
+private:
+  /// Delivers all consecutive messages starting at `next_undelivered`.
+  /// @pre the calling thread has set `delivering_`
+  void deliver_pending(execution_unit* ctx);
+
+  /// Grants exclusive access to the receivers, i.e., only the thread that
+  /// sets this flag may deliver messages.
+  std::atomic<bool> delivering_;
+
+  /// Stores the size of `pending_`.
+  std::atomic<size_t> num_pending_;
+
+  /// Protects `pending_`.
+  std::mutex pending_mtx_;
 
   /// Keeps messages in sorted order in case a message other than
   /// `next_undelivered` gets ready first.
-  std::vector<actor_msg> pending;
+  std::vector<actor_msg> pending_;
+
+  /// Stores messages taken from `pending_` for delivery. Only the thread that
+  /// holds `delivering_` accesses this buffer.
+  std::vector<actor_msg> ready_;
 };
 
+/// @relates message_queue
+using message_queue_ptr = intrusive_ptr<message_queue>;
+
 } // namespace caf::io::basp
@@ -72,6 +72,13 @@ enum class message_type : uint8_t {
   ///
   /// ![](heartbeat.png)
   heartbeat = 0x06,
+
+  /// Transmits multiple direct or routed messages in a single frame. The
+  /// payload consists of the complete messages, each with its own header, and
+  /// the operation data of the header stores the number of messages. Nodes
+  /// only send batches to nodes that announced support for them in the
+  /// handshake.
+  batch = 0x07,
 };
 
 CAF_IO_EXPORT std::string to_string(message_type);
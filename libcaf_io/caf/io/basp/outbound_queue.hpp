@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include "caf/actor_control_block.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/intrusive/lifo_inbox.hpp"
+#include "caf/intrusive/singly_linked.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/io/basp/compression.hpp"
+#include "caf/io/connection_handle.hpp"
+#include "caf/io/fwd.hpp"
+#include "caf/message_id.hpp"
+#include "caf/ref_counted.hpp"
+
+namespace caf::io::basp {
+
+/// Collects BASP messages that senders have serialized on their own thread for
+/// a single connection. Any thread may push to the queue, while only the event
+/// loop of the BASP broker drains it into the output of the connection.
+class CAF_IO_EXPORT outbound_queue : public ref_counted {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Stores a single serialized BASP message, including its header.
+  struct element : intrusive::singly_linked<element> {
+    element(byte_buffer xs, strong_actor_ptr src, message_id id)
+      : buf(std::move(xs)), sender(std::move(src)), mid(id) {
+      // nop
+    }
+
+    byte_buffer buf;
+
+    /// Receives an error if the broker closes the queue before sending a
+    /// request.
+    strong_actor_ptr sender;
+
+    /// Identifies the serialized message.
+    message_id mid;
+  };
+
+  /// Configures the inbox type.
+  struct policy {
+    using mapped_type = element;
+
+    using unique_pointer = std::unique_ptr<element>;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  outbound_queue(abstract_broker* parent, connection_handle hdl,
+                 compression_ptr cmp = nullptr);
+
+  ~outbound_queue() override;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the connection for this queue.
+  connection_handle hdl() const noexcept {
+    return hdl_;
+  }
+
+  /// Returns the payload compression for the connection or `nullptr`.
+  compression* payload_compression() const noexcept {
+    return cmp_.get();
+  }
+
+  /// Queries whether the broker has closed this queue.
+  bool closed() const noexcept {
+    return inbox_.closed();
+  }
+
+  // -- mutators ---------------------------------------------------------------
+
+  /// Appends a serialized BASP message to the queue and schedules a flush in
+  /// the event loop of the broker unless a flush is already pending.
+  /// @param buf The serialized message.
+  /// @param sender The original sender of the message.
+  /// @param mid The ID of the original message.
+  /// @returns `false` if the broker has closed this queue, `true` otherwise.
+  /// @threadsafe
+  bool push(byte_buffer buf, strong_actor_ptr sender, message_id mid);
+
+  /// Moves all pending messages to the output of the connection
+  /// without flushing it. The broker calls this member function before writing
+  /// to the connection itself in order to preserve message ordering.
+  /// @warning Call only from the event loop of the broker.
+  void drain();
+
+  /// Drains the queue and flushes the connection until the queue remains
+  /// empty.
+  /// @warning Call only from the event loop of the broker.
+  void flush();
+
+  /// Drops all pending messages and rejects any future message. Sends
+  /// `sec::request_receiver_down` to the senders of all pending requests.
+  /// @warning Call only from the event loop of the broker.
+  void close();
+
+private:
+  /// Points to the broker that owns the connection. Only valid until the
+  /// broker closes this queue.
+  abstract_broker* parent_;
+
+  /// Runs the event loop of `parent_`. Remains valid after closing.
+  network::multiplexer* backend_;
+
+  /// Identifies the connection.
+  connection_handle hdl_;
+
+  /// Compresses payloads with the codec negotiated for the connection.
+  compression_ptr cmp_;
+
+  /// Stores serialized messages in LIFO order.
+  intrusive::lifo_inbox<policy> inbox_;
+};
+
+/// @relates outbound_queue
+using outbound_queue_ptr = intrusive_ptr<outbound_queue>;
+
+} // namespace caf::io::basp
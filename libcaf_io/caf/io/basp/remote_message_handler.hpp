@@ -50,6 +50,7 @@ public:
     message msg;
     auto mid = make_message_id(dref.hdr_.operation_data);
     binary_deserializer source{ctx, dref.payload_};
+    source.shape_cache(dref.shapes_.get());
     // Make sure to drop the message in case we return abnormally.
     auto guard
       = detail::make_scope_guard([&] { dref.queue_->drop(ctx, dref.msg_id_); });
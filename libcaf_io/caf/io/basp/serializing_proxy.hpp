@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "caf/detail/io_export.hpp"
+#include "caf/detail/shared_spinlock.hpp"
+#include "caf/forwarding_actor_proxy.hpp"
+#include "caf/io/basp/outbound_queue.hpp"
+
+namespace caf::io::basp {
+
+/// A proxy that serializes messages on the sending thread and pushes them
+/// directly to the outbound queue of the connection to the remote node,
+/// bypassing the mailbox of the BASP broker. Falls back to forwarding messages
+/// to the broker whenever the direct path is unavailable, e.g., after losing
+/// the connection. Once the proxy forwarded a message to the broker, it keeps
+/// using the broker for all further messages to preserve message ordering.
+class CAF_IO_EXPORT serializing_proxy : public forwarding_actor_proxy {
+public:
+  using super = forwarding_actor_proxy;
+
+  serializing_proxy(actor_config& cfg, actor dest, outbound_queue_ptr queue);
+
+  ~serializing_proxy() override;
+
+  void enqueue(mailbox_element_ptr what, execution_unit* context) override;
+
+  void kill_proxy(execution_unit* ctx, error rsn) override;
+
+private:
+  bool try_write(mailbox_element& x, execution_unit* ctx);
+
+  mutable detail::shared_spinlock queue_mtx_;
+  outbound_queue_ptr queue_;
+
+  // Signals that this proxy forwarded a message to the broker while the
+  // connection was still available. The broker writes pending messages of the
+  // outbound queue before writing forwarded messages, but later messages on
+  // the direct path could overtake messages in the mailbox of the broker.
+  std::atomic<bool> forwarding_;
+};
+
+} // namespace caf::io::basp
@@ -26,10 +26,12 @@
 #include "caf/config.hpp"
 #include "caf/detail/abstract_worker.hpp"
 #include "caf/detail/io_export.hpp"
+#include "caf/detail/message_shape_cache.hpp"
 #include "caf/detail/worker_hub.hpp"
 #include "caf/fwd.hpp"
 #include "caf/io/basp/fwd.hpp"
 #include "caf/io/basp/header.hpp"
+#include "caf/io/basp/message_queue.hpp"
 #include "caf/io/basp/remote_message_handler.hpp"
 #include "caf/node_id.hpp"
 #include "caf/resumable.hpp"
@@ -55,14 +57,24 @@ public:
   // -- constructors, destructors, and assignment operators --------------------
 
   /// Only the ::worker_hub has access to the constructor.
-  worker(hub_type& hub, message_queue& queue, proxy_registry& proxies);
+  worker(hub_type& hub, proxy_registry& proxies);
 
   ~worker() override;
 
   // -- management -------------------------------------------------------------
 
+  /// Schedules deserialization of `payload`. Instead of copying, the worker
+  /// swaps `payload` with its own (cleared) buffer from the previous message.
+  /// Hence, payload buffers circulate between the receive path and the
+  /// workers and retain their capacity.
+  /// @param last_hop The node that sent us the message.
+  /// @param hdr The BASP header of a direct or routed message.
+  /// @param payload The serialized message.
+  /// @param shapes Caches message shapes of the connection or `nullptr`.
+  /// @param queue Establishes strict ordering for the connection.
   void launch(const node_id& last_hop, const basp::header& hdr,
-              const byte_buffer& payload);
+              byte_buffer& payload, detail::message_shape_cache* shapes,
+              message_queue& queue);
 
   // -- implementation of resumable --------------------------------------------
 
@@ -73,8 +85,7 @@ private:
 
   /// Stores how many bytes the "first half" of this object requires.
   static constexpr size_t pointer_members_size
-    = sizeof(hub_type*) + sizeof(message_queue*) + sizeof(proxy_registry*)
-      + sizeof(actor_system*);
+    = sizeof(hub_type*) + sizeof(proxy_registry*) + sizeof(actor_system*);
 
   static_assert(CAF_CACHE_LINE_SIZE > pointer_members_size,
                 "invalid cache line size");
@@ -84,9 +95,6 @@ private:
   /// Points to our home hub.
   hub_type* hub_;
 
-  /// Points to the queue for establishing strict ordering.
-  message_queue* queue_;
-
   /// Points to our proxy registry / factory.
   proxy_registry* proxies_;
 
@@ -108,6 +116,12 @@ private:
 
   /// Contains whatever this worker deserializes next.
   byte_buffer payload_;
+
+  /// Caches known message shapes for the connection of `last_hop_`.
+  detail::message_shape_cache_ptr shapes_;
+
+  /// Points to the queue for establishing strict ordering.
+  message_queue_ptr queue_;
 };
 
 } // namespace caf::io::basp
@@ -20,6 +20,7 @@
 
 #include <future>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stack>
 #include <string>
@@ -72,6 +73,10 @@ public:
 
   resume_result resume(execution_unit*, size_t) override;
 
+  /// Spreads connections to other nodes across all multiplexers of the
+  /// middleman in round-robin order.
+  network::multiplexer& next_io_backend() override;
+
   // -- implementation of proxy_registry::backend ------------------------------
 
   strong_actor_ptr make_proxy(node_id nid, actor_id aid) override;
@@ -102,6 +107,21 @@ public:
 
   strong_actor_ptr this_actor() override;
 
+  void enable_compression(connection_handle hdl, const node_id& nid,
+                          basp::compression_ptr ptr) override;
+
+  basp::compression* compression_for(connection_handle hdl) override;
+
+  void enable_batching(connection_handle hdl) override;
+
+  basp::message_batch* batch_for(connection_handle hdl) override;
+
+  void batch_started(connection_handle hdl) override;
+
+  detail::message_shape_cache* shape_cache_for(connection_handle hdl) override;
+
+  basp::message_queue* queue_for(connection_handle hdl) override;
+
   // -- utility functions ------------------------------------------------------
 
   /// Sends `node_down_msg` to all registered observers.
@@ -165,6 +185,28 @@ public:
 
   /// Keeps track of nodes that monitor local actors.
   monitored_actor_map monitored_actors;
+
+  /// Configures whether proxies serialize messages on the sending thread
+  /// instead of forwarding them to the broker.
+  bool serialize_on_send = false;
+
+  /// Configures how long coalesced messages may wait before the broker sends
+  /// them.
+  timespan max_batch_delay;
+
+  /// Protects `outbound_queues`, since `make_proxy` may run on any thread.
+  std::mutex outbound_queues_mtx;
+
+  /// Stores the outbound queue for each directly connected node.
+  std::unordered_map<node_id, basp::outbound_queue_ptr> outbound_queues;
+
+  /// Protects `compressions`, since the middleman reads statistics from any
+  /// thread.
+  std::mutex compressions_mtx;
+
+  /// Stores the payload compression for each directly connected node that
+  /// negotiated a codec.
+  std::unordered_map<node_id, basp::compression_ptr> compressions;
 };
 
 } // namespace caf::io
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -75,6 +76,7 @@ struct new_datagram_msg;
 using scribe_ptr = intrusive_ptr<scribe>;
 using doorman_ptr = intrusive_ptr<doorman>;
 using datagram_servant_ptr = intrusive_ptr<datagram_servant>;
+using shared_byte_buffer = std::shared_ptr<const byte_buffer>;
 
 // -- nested namespaces --------------------------------------------------------
 
@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -29,10 +31,13 @@
 #include "caf/detail/unique_function.hpp"
 #include "caf/expected.hpp"
 #include "caf/fwd.hpp"
+#include "caf/io/basp/codec.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/broker.hpp"
 #include "caf/io/middleman_actor.hpp"
 #include "caf/io/network/multiplexer.hpp"
 #include "caf/node_id.hpp"
+#include "caf/optional.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/send.hpp"
 #include "caf/timespan.hpp"
@@ -150,6 +155,20 @@ public:
   /// Returns the IO backend used by this middleman.
   virtual network::multiplexer& backend() = 0;
 
+  /// Returns the number of IO backends, i.e., event loops, used by this
+  /// middleman.
+  virtual size_t num_backends();
+
+  /// Returns the IO backend at `index`, whereas `backend(0)` is always the
+  /// same as `backend()`.
+  /// @pre `index < num_backends()`
+  virtual network::multiplexer& backend(size_t index);
+
+  /// Picks one of the IO backends in round-robin order for running a new
+  /// broker.
+  /// @note This member function is thread-safe.
+  network::multiplexer& next_backend();
+
   /// Returns the actor associated with `name` at `nid` or
   /// `invalid_actor` if `nid` is not connected or has no actor
   /// associated to this `name`.
@@ -157,6 +176,21 @@ public:
   ///       or an error occurred.
   strong_actor_ptr remote_lookup(std::string name, const node_id& nid);
 
+  /// Makes `x` available for compressing BASP payloads. Connections only use
+  /// codecs listed in `middleman.compression-codecs`. The middleman provides
+  /// the codec `lz4` by default.
+  /// @note This member function is thread-safe.
+  void add_codec(basp::codec_ptr x);
+
+  /// Returns the codec with given `name` or `nullptr` if no such codec exists.
+  /// @note This member function is thread-safe.
+  basp::codec_ptr codec(string_view name);
+
+  /// Returns statistics on the payload compression for the direct connection
+  /// to `nid` or `none` if the connection sends uncompressed payloads.
+  /// @note This member function is thread-safe.
+  optional<basp::compression_stats> compression_stats(const node_id& nid);
+
   /// @experimental
   template <class Handle>
   expected<Handle>
@@ -210,7 +244,7 @@ public:
     static constexpr bool spawnable = detail::spawnable<F, impl, Ts...>();
     static_assert(spawnable,
                   "cannot spawn function-based broker with given arguments");
-    actor_config cfg{&backend()};
+    actor_config cfg{&next_backend()};
     detail::bool_token<spawnable> enabled;
     return system().spawn_functor<Os>(enabled, cfg, fun,
                                       std::forward<Ts>(xs)...);
@@ -263,6 +297,8 @@ public:
         // nop
       }
 
+      using middleman::backend;
+
       network::multiplexer& backend() override {
         return backend_;
       }
@@ -280,13 +316,14 @@ private:
   template <spawn_options Os, class Impl, class F, class... Ts>
   expected<typename infer_handle_from_class<Impl>::type>
   spawn_client_impl(F fun, const std::string& host, uint16_t port, Ts&&... xs) {
-    auto eptr = backend().new_tcp_scribe(host, port);
+    auto& mpx = next_backend();
+    auto eptr = mpx.new_tcp_scribe(host, port);
     if (!eptr)
       return eptr.error();
     auto ptr = std::move(*eptr);
     CAF_ASSERT(ptr != nullptr);
     detail::init_fun_factory<Impl, F> fac;
-    actor_config cfg{&backend()};
+    actor_config cfg{&mpx};
     auto fptr = fac.make(std::move(fun), ptr->hdl(), std::forward<Ts>(xs)...);
     fptr->hook([=](local_actor* self) mutable {
       static_cast<abstract_broker*>(self)->add_scribe(std::move(ptr));
@@ -298,7 +335,8 @@ private:
   template <spawn_options Os, class Impl, class F, class... Ts>
   expected<typename infer_handle_from_class<Impl>::type>
   spawn_server_impl(F fun, uint16_t& port, Ts&&... xs) {
-    auto eptr = backend().new_tcp_doorman(port);
+    auto& mpx = next_backend();
+    auto eptr = mpx.new_tcp_doorman(port);
     if (!eptr)
       return eptr.error();
     auto ptr = std::move(*eptr);
@@ -308,7 +346,7 @@ private:
     fptr->hook([=](local_actor* self) mutable {
       static_cast<abstract_broker*>(self)->add_doorman(std::move(ptr));
     });
-    actor_config cfg{&backend()};
+    actor_config cfg{&mpx};
     cfg.init_fun.assign(fptr.release());
     return system().spawn_class<Impl, Os>(cfg);
   }
@@ -330,14 +368,20 @@ private:
 
   // environment
   actor_system& system_;
-  // prevents backend from shutting down unless explicitly requested
-  network::multiplexer::supervisor_ptr backend_supervisor_;
-  // runs the backend
-  std::thread thread_;
+  // prevents backends from shutting down unless explicitly requested
+  std::vector<network::multiplexer::supervisor_ptr> backend_supervisors_;
+  // runs the backends
+  std::vector<std::thread> threads_;
+  // selects the backend for the next broker
+  std::atomic<size_t> next_backend_;
   // keeps track of "singleton-like" brokers
   std::map<std::string, actor> named_brokers_;
   // actor offering asynchronous IO by managing this singleton instance
   middleman_actor manager_;
+  // protects codecs_
+  std::mutex codecs_mtx_;
+  // payload compression codecs for BASP
+  std::map<std::string, basp::codec_ptr> codecs_;
 };
 
 } // namespace caf::io
@@ -62,7 +62,8 @@ public:
 
 protected:
   /// Tries to connect to given `host` and `port`. The default implementation
-  /// calls `system().middleman().backend().new_tcp_scribe(host, port)`.
+  /// calls `system().middleman().backend().new_tcp_scribe(host, port, io)`,
+  /// where `io` is the next backend in round-robin order.
   virtual expected<scribe_ptr> connect(const std::string& host, uint16_t port);
 
   /// Tries to connect to given `host` and `port`. The default implementation
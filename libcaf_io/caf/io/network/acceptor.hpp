@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "caf/detail/io_export.hpp"
 #include "caf/io/fwd.hpp"
 #include "caf/io/network/acceptor_manager.hpp"
@@ -40,6 +42,8 @@ public:
 
   acceptor(default_multiplexer& backend_ref, native_socket sockfd);
 
+  ~acceptor() override;
+
   /// Returns the accepted socket. This member function should
   /// be called only from the `new_connection` callback.
   inline native_socket& accepted_socket() {
@@ -58,6 +62,10 @@ public:
 
   void graceful_shutdown() override;
 
+  void start_read(uring& ring, uint64_t user_data) override;
+
+  void read_completed(const uring::completion& x, const byte* buf) override;
+
 protected:
   template <class Policy>
   void handle_event_impl(io::network::operation op, Policy& policy) {
@@ -68,6 +76,9 @@ protected:
         if (sockfd != invalid_native_socket) {
           sock_ = sockfd;
           mgr_->new_connection();
+        } else {
+          // Accepting would block.
+          state_.readable = false;
         }
       }
     }
@@ -76,6 +87,12 @@ protected:
 private:
   manager_ptr mgr_;
   native_socket sock_;
+
+  // State for accepting via io_uring. Multishot accept requests may complete
+  // after the acceptor became passive. We keep the new connections until the
+  // acceptor becomes active again.
+  std::vector<native_socket> pending_;
+  bool replay_;
 };
 
 } // namespace caf::io::network
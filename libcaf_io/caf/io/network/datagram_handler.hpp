@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <deque>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "caf/byte_buffer.hpp"
@@ -106,6 +108,14 @@ public:
     return sender_;
   }
 
+  void start_read(uring& ring, uint64_t user_data) override;
+
+  void start_write(uring& ring, uint64_t user_data) override;
+
+  void read_completed(const uring::completion& x, const byte* buf) override;
+
+  void write_completed(const uring::completion& x) override;
+
 protected:
   template <class Policy>
   void handle_event_impl(io::network::operation op, Policy& policy) {
@@ -162,6 +172,9 @@ private:
 
   void handle_error();
 
+  /// Passes a datagram from `sender` to the manager.
+  void deliver(const ip_endpoint& sender, span<const byte> payload);
+
   // known endpoints and broker servants
   std::unordered_map<ip_endpoint, datagram_handle> hdl_by_ep_;
   std::unordered_map<datagram_handle, ip_endpoint> ep_by_hdl_;
@@ -178,6 +191,12 @@ private:
   std::deque<job_type> wr_offline_buf_;
   job_type wr_buf_;
   manager_ptr writer_;
+
+  // State for reading via io_uring. Multishot receive requests may complete
+  // after the handler became passive. We keep the datagrams until the handler
+  // becomes active again.
+  std::deque<std::pair<ip_endpoint, byte_buffer>> rd_pending_;
+  bool rd_replay_;
 };
 
 } // namespace caf::io::network
@@ -41,6 +41,10 @@ public:
     this->handle_event_impl(op, policy_);
   }
 
+  bool uses_completions() const noexcept override {
+    return has_native_socket_io<ProtocolPolicy>::value;
+  }
+
 private:
   ProtocolPolicy policy_;
 };
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -43,6 +44,7 @@
 #include "caf/io/network/receive_buffer.hpp"
 #include "caf/io/network/rw_state.hpp"
 #include "caf/io/network/stream_manager.hpp"
+#include "caf/io/network/uring.hpp"
 #include "caf/io/receive_policy.hpp"
 #include "caf/io/scribe.hpp"
 #include "caf/ref_counted.hpp"
@@ -118,6 +120,12 @@ public:
   expected<scribe_ptr>
   new_tcp_scribe(const std::string& host, uint16_t port) override;
 
+  /// Creates a `relay_scribe` unless `io` is this multiplexer.
+  scribe_ptr new_scribe(native_socket fd, multiplexer& io) override;
+
+  expected<scribe_ptr> new_tcp_scribe(const std::string& host, uint16_t port,
+                                      multiplexer& io) override;
+
   doorman_ptr new_doorman(native_socket fd) override;
 
   expected<doorman_ptr>
@@ -175,6 +183,12 @@ public:
   /// Returns the number of socket handlers.
   size_t num_socket_handlers() const noexcept;
 
+  /// Returns whether this multiplexer performs socket I/O via `io_uring`
+  /// instead of waiting for socket events with `epoll`.
+  bool uses_io_uring() const noexcept {
+    return uring_ != nullptr;
+  }
+
   /// Run all pending events generated from calls to `add` or `del`.
   void handle_internal_events();
 
@@ -182,6 +196,26 @@ private:
   /// Calls `epoll`, `kqueue`, or `poll` with or without blocking.
   bool poll_once_impl(bool block);
 
+  /// Submits queued `io_uring` requests and dispatches all completions.
+  bool poll_once_uring(bool block);
+
+  /// Registers `fd` with the ring, removes it, or updates its requests after
+  /// a change of its event mask, where `op` is either `EPOLL_CTL_ADD`,
+  /// `EPOLL_CTL_DEL` or 0.
+  void uring_ctl(int op, native_socket fd, event_handler* ptr);
+
+  /// Passes the completion of a read or write request to its handler.
+  void handle_completion(const uring::completion& x);
+
+  /// Returns `true` if the handler for `fd` waits for the completion of a
+  /// request for `op`, in which case we call `removed_from_loop` once the
+  /// request has completed.
+  bool uring_release_later(native_socket fd, operation op);
+
+  /// Starts, cancels or releases the requests of all handlers that changed
+  /// their event mask or completed a request since the last call.
+  void update_uring_requests();
+
   // platform-dependent additional initialization code
   void init();
 
@@ -228,6 +262,17 @@ private:
 
   void handle_socket_event(native_socket fd, int mask, event_handler* ptr);
 
+  /// Records the readiness reported by `epoll` for `ptr` in edge-triggered
+  /// mode.
+  void handle_socket_edge(int mask, event_handler* ptr);
+
+  /// Appends `ptr` to the ready list if its socket is ready for any operation
+  /// it has registered for.
+  void add_to_ready_list(event_handler* ptr);
+
+  /// Dispatches each handler on the ready list once.
+  void handle_ready_list();
+
   void close_pipe();
 
   void wr_dispatch_request(resumable* ptr);
@@ -246,6 +291,72 @@ private:
   /// event handlers from `pollfd`.
   multiplexer_poll_shadow_data shadow_;
 
+  /// Stores whether sockets stay registered for all events in edge-triggered
+  /// mode. Unused in the `poll` implementation.
+  bool edge_triggered_;
+
+  /// Handlers that may still read or write without blocking. Only used in
+  /// edge-triggered mode.
+  std::vector<event_handler*> ready_;
+
+  /// Swapped with `ready_` while dispatching to re-use its memory.
+  std::vector<event_handler*> ready_cache_;
+
+  /// Replaces `epoll` if the network backend is `io_uring`. Unused in the
+  /// `poll` implementation.
+  std::unique_ptr<uring> uring_;
+
+  struct uring_entry {
+    /// Points to the handler for the socket or is `nullptr` if the socket has
+    /// neither a registration nor a pending request.
+    event_handler* ptr;
+
+    /// Tags all requests for the current handler of the socket.
+    uint32_t generation;
+
+    /// Stores whether the handler performs I/O via completions. Otherwise, we
+    /// only submit a multishot poll request for the socket.
+    bool completions;
+
+    /// Stores whether the handler has a non-zero event mask.
+    bool registered;
+
+    /// Stores whether the handler has a pending read request.
+    bool reading;
+
+    /// Stores whether the handler has a pending write request.
+    bool writing;
+
+    /// Stores whether we have canceled the pending read request.
+    bool read_canceled;
+
+    /// Stores whether we have canceled the pending write request.
+    bool write_canceled;
+
+    /// Stores whether we call `removed_from_loop(operation::read)` after the
+    /// pending read request has completed.
+    bool release_read;
+
+    /// Stores whether we call `removed_from_loop(operation::write)` after the
+    /// pending write request has completed.
+    bool release_write;
+
+    /// Stores whether the socket is on `uring_dirty_`.
+    bool dirty;
+  };
+
+  /// Maps socket handles to their handler and the state of their requests.
+  /// Unused in the `poll` implementation.
+  std::vector<uring_entry> uring_entries_;
+
+  /// Sockets that need an update of their requests. Unused in the `poll`
+  /// implementation.
+  std::vector<native_socket> uring_dirty_;
+
+  /// Number of read and write requests that did not complete yet. Unused in
+  /// the `poll` implementation.
+  size_t uring_requests_;
+
   /// Pipe for pushing events and callbacks into the multiplexer's thread.
   std::pair<native_socket, native_socket> pipe_;
 
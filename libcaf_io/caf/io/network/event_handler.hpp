@@ -18,14 +18,29 @@
 
 #pragma once
 
+#include <cstdint>
+#include <type_traits>
+
+#include "caf/byte.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/io/fwd.hpp"
 #include "caf/io/network/native_socket.hpp"
 #include "caf/io/network/operation.hpp"
+#include "caf/io/network/uring.hpp"
 #include "caf/io/receive_policy.hpp"
 
 namespace caf::io::network {
 
+/// Checks whether `Policy` performs its I/O with plain socket calls, which
+/// allows the multiplexer to replace them with `io_uring` requests.
+template <class Policy, class = void>
+struct has_native_socket_io : std::false_type {};
+
+template <class Policy>
+struct has_native_socket_io<Policy,
+                            std::enable_if_t<Policy::native_socket_io>>
+  : std::true_type {};
+
 /// A socket I/O event handler.
 class CAF_IO_EXPORT event_handler {
 public:
@@ -45,6 +60,22 @@ public:
 
     /// Stores what receive policy is currently active.
     unsigned rd_flag : 2;
+
+    /// Stores whether the socket may have pending input. Handlers clear this
+    /// flag once a read would block. Only used in edge-triggered mode.
+    bool readable : 1;
+
+    /// Stores whether the socket may accept more output. Handlers clear this
+    /// flag once a write would block. Only used in edge-triggered mode.
+    bool writable : 1;
+
+    /// Stores whether the multiplexer has this handler on its ready list.
+    bool ready : 1;
+
+    /// Stores whether `passivate` was called after the last `activate`.
+    /// Handlers that read via `io_uring` keep all input that arrives in the
+    /// meantime until becoming active again.
+    bool passive : 1;
   };
 
   event_handler(default_multiplexer& dm, native_socket sockfd);
@@ -64,6 +95,39 @@ public:
   /// this event handler from the I/O loop.
   virtual void graceful_shutdown() = 0;
 
+  /// Consumes notifications from the error queue of the managed socket after
+  /// the multiplexer received an error event. Returns `true` if the handler
+  /// consumed at least one notification, in which case the multiplexer does
+  /// not treat the event as an error. The default implementation returns
+  /// `false`.
+  virtual bool handle_error_queue();
+
+  // -- I/O via io_uring completions -------------------------------------------
+
+  /// Returns whether this handler reads and writes its socket by submitting
+  /// requests to the `io_uring` instance of the multiplexer instead of waiting
+  /// for readiness events. Only relevant if the multiplexer uses `io_uring`.
+  /// The default implementation returns `false`.
+  virtual bool uses_completions() const noexcept;
+
+  /// Queues a request for reading from the socket. The multiplexer calls this
+  /// member function whenever the handler is registered for reading and has
+  /// no pending read request.
+  virtual void start_read(uring& ring, uint64_t user_data);
+
+  /// Queues a request for writing to the socket. The multiplexer calls this
+  /// member function whenever the handler is registered for writing and has
+  /// no pending write request.
+  virtual void start_write(uring& ring, uint64_t user_data);
+
+  /// Processes a completion of the read request. Receive requests pass the
+  /// registered buffer with the received data in `buf`, which the kernel
+  /// re-uses after this call returns.
+  virtual void read_completed(const uring::completion& x, const byte* buf);
+
+  /// Processes the completion of the write request.
+  virtual void write_completed(const uring::completion& x);
+
   /// Returns the native socket handle for this handler.
   native_socket fd() const {
     return fd_;
@@ -92,6 +156,36 @@ public:
   /// Removes the file descriptor from the event loop of the parent.
   void passivate();
 
+  /// Returns whether the socket may have pending input.
+  bool readable() const {
+    return state_.readable;
+  }
+
+  /// Sets whether the socket may have pending input.
+  void readable(bool x) {
+    state_.readable = x;
+  }
+
+  /// Returns whether the socket may accept more output.
+  bool writable() const {
+    return state_.writable;
+  }
+
+  /// Sets whether the socket may accept more output.
+  void writable(bool x) {
+    state_.writable = x;
+  }
+
+  /// Returns whether the multiplexer has this handler on its ready list.
+  bool ready() const {
+    return state_.ready;
+  }
+
+  /// Sets whether the multiplexer has this handler on its ready list.
+  void ready(bool x) {
+    state_.ready = x;
+  }
+
   /// Returns whether this event handlers signals successful writes to its
   /// parent actor.
   bool ack_writes() {
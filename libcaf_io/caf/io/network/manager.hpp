@@ -63,7 +63,7 @@ public:
   virtual void add_to_loop() = 0;
 
   /// Detaches this manager from its parent in case of an error.
-  void io_failure(execution_unit* ctx, operation op);
+  virtual void io_failure(execution_unit* ctx, operation op);
 
 protected:
   /// Creates a message signalizing a disconnect to the parent.
@@ -54,6 +54,21 @@ public:
   virtual expected<scribe_ptr>
   new_tcp_scribe(const std::string& host, uint16_t port) = 0;
 
+  /// Creates a new `scribe` from a native socket handle for a broker running
+  /// on this multiplexer, whereas `io` performs all reads and writes on the
+  /// socket. The default implementation ignores `io`.
+  /// @pre `io` has the same type as this multiplexer.
+  /// @threadsafe
+  virtual scribe_ptr new_scribe(native_socket fd, multiplexer& io);
+
+  /// Tries to connect to `host` on given `port` and returns a `scribe` for a
+  /// broker running on this multiplexer, whereas `io` performs all reads and
+  /// writes on the socket. The default implementation ignores `io`.
+  /// @pre `io` has the same type as this multiplexer.
+  /// @threadsafe
+  virtual expected<scribe_ptr>
+  new_tcp_scribe(const std::string& host, uint16_t port, multiplexer& io);
+
   /// Creates a new doorman from a native socket handle.
   /// @threadsafe
   virtual doorman_ptr new_doorman(native_socket fd) = 0;
@@ -103,6 +103,18 @@ CAF_IO_EXPORT expected<void> nonblocking(native_socket fd, bool new_value);
 /// @throws network_error
 CAF_IO_EXPORT expected<void> tcp_nodelay(native_socket fd, bool new_value);
 
+/// Enables or disables sending with `MSG_ZEROCOPY` on `fd`. Fails on
+/// platforms other than Linux.
+CAF_IO_EXPORT expected<void> zerocopy(native_socket fd, bool new_value);
+
+/// Reads completion notifications for `MSG_ZEROCOPY` sends from the error
+/// queue of `fd` until finding one. On success, stores the range of completed
+/// send calls in `first` and `last` (both inclusive).
+/// @returns `false` if the error queue has no more notifications, `true`
+///          otherwise.
+CAF_IO_EXPORT bool
+read_zerocopy_completion(native_socket fd, uint32_t& first, uint32_t& last);
+
 /// Enables or disables `SIGPIPE` events from `fd`.
 CAF_IO_EXPORT expected<void> allow_sigpipe(native_socket fd, bool new_value);
 
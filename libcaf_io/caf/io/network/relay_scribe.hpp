@@ -0,0 +1,147 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/intrusive_ptr.hpp"
+#include "caf/io/fwd.hpp"
+#include "caf/io/network/native_socket.hpp"
+#include "caf/io/network/operation.hpp"
+#include "caf/io/receive_policy.hpp"
+#include "caf/io/scribe.hpp"
+
+namespace caf::io::network {
+
+/// A scribe for a broker running on one multiplexer that performs all socket
+/// I/O on another multiplexer. The scribe only touches its socket from the
+/// event loop of the I/O multiplexer, which reads incoming data in large
+/// chunks and posts them to the multiplexer of the broker. There, the scribe
+/// applies the receive policy of the broker to the buffered data. Writes and
+/// changes to the read state travel the other way.
+/// @warning Must not move to a broker on another multiplexer.
+class CAF_IO_EXPORT relay_scribe : public scribe {
+public:
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Creates a scribe for a broker running on `home` that reads from and
+  /// writes to `sockfd` in the event loop of `loop`.
+  relay_scribe(default_multiplexer& home, default_multiplexer& loop,
+               native_socket sockfd);
+
+  ~relay_scribe() override;
+
+  // -- overridden member functions of scribe ----------------------------------
+
+  void configure_read(receive_policy::config config) override;
+
+  void ack_writes(bool enable) override;
+
+  byte_buffer& wr_buf() override;
+
+  void write(byte_buffer buf) override;
+
+  void write(shared_byte_buffer buf) override;
+
+  byte_buffer& rd_buf() override;
+
+  void graceful_shutdown() override;
+
+  void flush() override;
+
+  std::string addr() const override;
+
+  uint16_t port() const override;
+
+  void add_to_loop() override;
+
+  void remove_from_loop() override;
+
+  // -- callbacks for the I/O multiplexer --------------------------------------
+
+  /// Appends `buf` to the received data and passes as much of it to the broker
+  /// as the receive policy and the activity of the broker allow.
+  void receive(byte_buffer& buf);
+
+  /// Tells the broker how many bytes the I/O multiplexer has written.
+  void transferred(size_t written, size_t remaining);
+
+  /// Detaches from the broker after an error on the socket. Read errors only
+  /// take effect after passing all received data to the broker.
+  void failed(operation op);
+
+  /// Implements the socket I/O in the event loop of the I/O multiplexer.
+  class io_manager;
+
+  /// A buffer that waits for the next flush.
+  struct chunk {
+    byte_buffer buf;
+    shared_byte_buffer shared;
+  };
+
+protected:
+  void detach_from(abstract_broker* ptr) override;
+
+private:
+  /// Connects the I/O multiplexer to this scribe.
+  void launch();
+
+  /// Passes received data to the broker until the receive policy requires more
+  /// data or the broker stops reading.
+  void deliver();
+
+  /// Calls `deliver` from the event loop of the broker.
+  void schedule_deliver();
+
+  /// Returns the number of bytes for the next `new_data_msg` or 0 if the
+  /// receive policy requires more data.
+  size_t next_frame_size() const noexcept;
+
+  /// Tells the I/O multiplexer whether it should read from the socket.
+  void sync_reading();
+
+  /// Moves the content of `wr_buf_` to the pending chunks.
+  void stage_wr_buf();
+
+  default_multiplexer& home_;
+  intrusive_ptr<io_manager> io_;
+
+  // State of the broker side.
+  bool launched_;
+  bool active_;
+  bool reading_;
+  bool failed_;
+  bool delivering_;
+
+  // State for reading.
+  receive_policy_flag rd_flag_;
+  size_t rd_max_;
+  size_t rd_pos_;
+  byte_buffer in_buf_;
+  byte_buffer rd_buf_;
+  size_t unacked_;
+
+  // State for writing.
+  byte_buffer wr_buf_;
+  std::vector<chunk> wr_chunks_;
+};
+
+} // namespace caf::io::network
@@ -38,6 +38,10 @@ public:
 
   byte_buffer& wr_buf() override;
 
+  void write(byte_buffer buf) override;
+
+  void write(shared_byte_buffer buf) override;
+
   byte_buffer& rd_buf() override;
 
   void graceful_shutdown() override;
@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "caf/byte_buffer.hpp"
@@ -29,9 +33,34 @@
 #include "caf/io/receive_policy.hpp"
 #include "caf/logger.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/span.hpp"
 
 namespace caf::io::network {
 
+/// Checks whether `Policy` can write multiple buffers at once.
+template <class Policy, class = void>
+struct has_vectored_write : std::false_type {};
+
+template <class Policy>
+struct has_vectored_write<
+  Policy, std::void_t<decltype(static_cast<rw_state (*)(
+                                  size_t&, native_socket,
+                                  const span<const byte>*, size_t)>(
+            &Policy::write_some))>>
+  : std::true_type {};
+
+/// Checks whether `Policy` can write multiple buffers without copying them.
+template <class Policy, class = void>
+struct has_zerocopy_write : std::false_type {};
+
+template <class Policy>
+struct has_zerocopy_write<
+  Policy, std::void_t<decltype(static_cast<rw_state (*)(
+                                  size_t&, native_socket,
+                                  const span<const byte>*, size_t, bool&)>(
+            &Policy::write_some_zerocopy))>>
+  : std::true_type {};
+
 /// A stream capable of both reading and writing. The stream's input
 /// data is forwarded to its {@link stream_manager manager}.
 class CAF_IO_EXPORT stream : public event_handler {
@@ -56,6 +85,14 @@ public:
   /// @warning Not thread safe.
   void write(const void* buf, size_t num_bytes);
 
+  /// Appends `buf` to the output without copying it.
+  /// @warning Not thread safe.
+  void write(byte_buffer buf);
+
+  /// Appends a shared, immutable buffer to the output without copying it.
+  /// @warning Not thread safe.
+  void write(shared_byte_buffer buf);
+
   /// Returns the write buffer of this stream.
   /// @warning Must not be modified outside the IO multiplexers event loop
   ///          once the stream has been started.
@@ -84,6 +121,24 @@ public:
   /// write buffer.
   void force_empty_write(const manager_ptr& mgr);
 
+  /// Releases all buffers that the kernel no longer needs after sending them
+  /// with `MSG_ZEROCOPY`.
+  bool handle_error_queue() override;
+
+  /// Returns the number of written buffers that wait for the kernel to
+  /// complete sending them with `MSG_ZEROCOPY`.
+  size_t pending_zerocopy_buffers() const noexcept {
+    return zerocopy_chunks_.size();
+  }
+
+  void start_read(uring& ring, uint64_t user_data) override;
+
+  void start_write(uring& ring, uint64_t user_data) override;
+
+  void read_completed(const uring::completion& x, const byte* buf) override;
+
+  void write_completed(const uring::completion& x) override;
+
 protected:
   template <class Policy>
   void handle_event_impl(io::network::operation op, Policy& policy) {
@@ -110,8 +165,7 @@ protected:
       }
       case io::network::operation::write: {
         size_t wb; // Written bytes.
-        auto res = policy.write_some(wb, fd(), wr_buf_.data() + written_,
-                                     wr_buf_.size() - written_);
+        auto res = write_some(policy, wb);
         handle_write_result(res, wb);
         break;
       }
@@ -122,12 +176,92 @@ protected:
   }
 
 private:
+  /// Maximum number of buffers per vectored write.
+  static constexpr size_t max_write_chunks = 64;
+
+  /// A single buffer in the output queue.
+  struct chunk {
+    explicit chunk(byte_buffer xs) : buf(std::move(xs)) {
+      // nop
+    }
+
+    explicit chunk(shared_byte_buffer xs) : shared(std::move(xs)) {
+      // nop
+    }
+
+    const byte_buffer& bytes() const noexcept {
+      return shared != nullptr ? *shared : buf;
+    }
+
+    byte_buffer buf;
+    shared_byte_buffer shared;
+
+    /// Stores whether the kernel may still read from this buffer after a send
+    /// with `MSG_ZEROCOPY`.
+    bool zerocopy = false;
+
+    /// Identifies the last `MSG_ZEROCOPY` send that included this buffer.
+    uint32_t last_send = 0;
+  };
+
+  template <class Policy>
+  rw_state write_some(Policy& policy, size_t& wb) {
+    if (wr_chunks_.empty())
+      return policy.write_some(wb, fd(), static_cast<const void*>(nullptr), 0);
+    if constexpr (has_vectored_write<Policy>::value) {
+      span<const byte> bufs[max_write_chunks];
+      auto n = collect_chunks(bufs);
+      if constexpr (has_zerocopy_write<Policy>::value) {
+        if (use_zerocopy(bufs, n)) {
+          auto zerocopy = false;
+          auto res = policy.write_some_zerocopy(wb, fd(), bufs, n, zerocopy);
+          if (zerocopy)
+            zerocopy_sent(wb);
+          return res;
+        }
+      }
+      if (n > 1)
+        return policy.write_some(wb, fd(), bufs, n);
+    }
+    auto& xs = wr_chunks_.front().bytes();
+    return policy.write_some(wb, fd(), xs.data() + written_,
+                             xs.size() - written_);
+  }
+
+  /// Stores up to `max_write_chunks` pending buffers in `bufs`, skipping all
+  /// bytes that we have written already. Returns the number of buffers.
+  size_t collect_chunks(span<const byte>* bufs) const;
+
+  /// Checks whether we send the buffers with `MSG_ZEROCOPY` and enables it on
+  /// the socket if necessary.
+  bool use_zerocopy(const span<const byte>* bufs, size_t num_bufs);
+
+  /// Marks all buffers that the kernel may read from after sending `wb` bytes
+  /// with `MSG_ZEROCOPY`.
+  void zerocopy_sent(size_t wb);
+
+  /// Releases all buffers that the kernel no longer needs.
+  void release_zerocopy_chunks();
+
+  /// Moves the content of the offline buffer to the output queue.
+  void stage_offline_buf();
+
+  /// Returns the number of bytes in the output queue that wait for writing.
+  size_t pending_bytes() const noexcept;
+
   void prepare_next_read();
 
   void prepare_next_write();
 
   bool handle_read_result(rw_state read_result, size_t rb);
 
+  /// Passes `data` to the manager until the stream becomes passive. Returns
+  /// the number of consumed bytes.
+  size_t deliver(const byte* data, size_t size);
+
+  /// Passes input that arrived while passive to the manager.
+  void deliver_pending();
+
   void handle_write_result(rw_state write_result, size_t wb);
 
   void handle_error_propagation();
@@ -148,8 +282,26 @@ private:
   // State for writing.
   manager_ptr writer_;
   size_t written_;
-  byte_buffer wr_buf_;
+  std::deque<chunk> wr_chunks_;
   byte_buffer wr_offline_buf_;
+  byte_buffer wr_spare_buf_;
+
+  // State for sending with MSG_ZEROCOPY. The kernel numbers all sends with
+  // MSG_ZEROCOPY in ascending order and reports ranges of completed sends,
+  // usually but not necessarily in order.
+  size_t zerocopy_threshold_;
+  bool zerocopy_enabled_;
+  uint32_t zerocopy_next_;
+  uint32_t zerocopy_acked_;
+  std::vector<std::pair<uint32_t, uint32_t>> zerocopy_ranges_;
+  std::deque<chunk> zerocopy_chunks_;
+
+  // State for reading via io_uring. Multishot receive requests may complete
+  // after the stream became passive. We keep the input until the stream
+  // becomes active again.
+  byte_buffer rd_pending_;
+  bool rd_closed_;
+  bool rd_replay_;
 };
 
 } // namespace caf::io::network
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/detail/io_export.hpp"
+#include "caf/io/network/ip_endpoint.hpp"
+#include "caf/io/network/native_socket.hpp"
+#include "caf/span.hpp"
+
+namespace caf::io::network {
+
+/// A minimal wrapper for an `io_uring` instance. The ring performs socket I/O
+/// with multishot receive and accept requests that pick their memory from a
+/// ring of registered buffers, sends without waiting for the socket to become
+/// writable first, and falls back to multishot poll requests for all other
+/// file descriptors. Requests remain queued until the next call to `submit`,
+/// which allows the multiplexer to send all requests to the kernel with the
+/// same system call that waits for new completions.
+class CAF_IO_EXPORT uring {
+public:
+  /// A completion event.
+  struct completion {
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+  };
+
+  /// Signals that a completion belongs to a request that remains active.
+  static constexpr uint32_t more_flag = 2;
+
+  uring(const uring&) = delete;
+
+  uring& operator=(const uring&) = delete;
+
+  ~uring();
+
+  /// Creates a ring with room for `entries` pending requests and registers
+  /// `num_buffers` buffers with `buffer_size` bytes each for receiving data.
+  /// Returns `nullptr` if the platform or kernel does not support `io_uring`
+  /// with multishot receive requests, i.e., Linux 6.0 or later.
+  static std::unique_ptr<uring>
+  make(unsigned entries, unsigned num_buffers, size_t buffer_size);
+
+  // -- requests ---------------------------------------------------------------
+
+  /// Queues a multishot poll request for `fd`. Each completion carries
+  /// `user_data` and the triggered events in `res`.
+  void poll_add(native_socket fd, uint32_t mask, uint64_t user_data);
+
+  /// Queues the cancellation of the poll request with `user_data`. The
+  /// cancellation itself completes with a user data of 0.
+  void poll_remove(uint64_t user_data);
+
+  /// Queues a multishot receive request for the stream socket `fd`. Each
+  /// completion carries the number of received bytes in `res` and refers to
+  /// one of the registered buffers.
+  void recv(native_socket fd, uint64_t user_data);
+
+  /// Queues a multishot receive request for the datagram socket `fd`. Each
+  /// completion refers to one of the registered buffers, which holds a single
+  /// datagram. Use `unpack_datagram` to access its content.
+  void recvmsg(native_socket fd, uint64_t user_data);
+
+  /// Queues a multishot accept request for `fd`. Each completion carries the
+  /// new socket in `res`.
+  void accept(native_socket fd, uint64_t user_data);
+
+  /// Queues a request for sending up to `num_bufs` buffers from `bufs` to
+  /// `fd` with a single system call. Datagram sockets also pass the receiver
+  /// in `addr`. The completion carries the number of sent bytes in `res`.
+  /// @warning The buffers must remain valid until the request completes.
+  void sendmsg(native_socket fd, const span<const byte>* bufs, size_t num_bufs,
+               const ip_endpoint* addr, uint64_t user_data);
+
+  /// Queues a request that does nothing but produce a completion.
+  void nop(uint64_t user_data);
+
+  /// Queues the cancellation of the request with `user_data`. The request
+  /// produces a final completion with `res` set to `-ECANCELED` unless it
+  /// completed already. The cancellation itself completes with a user data
+  /// of 0.
+  void cancel(uint64_t user_data);
+
+  // -- completions ------------------------------------------------------------
+
+  /// Submits all queued requests and waits until at least `min_complete`
+  /// completions are available.
+  /// @returns `false` on an unrecoverable error, `true` otherwise.
+  bool submit(unsigned min_complete);
+
+  /// Removes the oldest completion from the queue and stores it in `x`.
+  /// @returns `false` if no completion is available, `true` otherwise.
+  bool next(completion& x);
+
+  /// Returns the registered buffer that holds the received data for `x` or
+  /// `nullptr` if `x` refers to no buffer.
+  const byte* buffer(const completion& x) const noexcept;
+
+  /// Returns the registered buffer of `x` to the kernel. Does nothing if `x`
+  /// refers to no buffer.
+  void recycle(const completion& x) noexcept;
+
+  /// Extracts the sender and the payload of the datagram that `x` has
+  /// received into `buf`.
+  /// @returns `false` if the kernel truncated the datagram, `true` otherwise.
+  static bool unpack_datagram(const completion& x, const byte* buf,
+                              ip_endpoint& sender, span<const byte>& payload);
+
+private:
+  /// Stores the message header and the vector of buffers for a `sendmsg` or
+  /// `recvmsg` request until the kernel has consumed it.
+  struct message;
+
+  uring() = default;
+
+  // Returns a zeroed submission queue entry, flushing the queue if needed.
+  void* acquire_sqe();
+
+  // Makes the last entry returned by `acquire_sqe` visible to the kernel.
+  void commit_sqe();
+
+  // Returns storage for a message header that remains valid until submitting
+  // the next batch of requests.
+  message& next_message();
+
+  // Registers the ring of receive buffers.
+  bool init_buffers(unsigned num_buffers, size_t buffer_size);
+
+  // Makes the buffer with index `id` available to the kernel again.
+  void add_buffer(uint16_t id) noexcept;
+
+  int fd_ = -1;
+
+  // Number of entries the kernel did not consume yet.
+  unsigned pending_ = 0;
+
+  // Submission queue.
+  void* sq_ptr_ = nullptr;
+  size_t sq_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_entries_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  void* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  // Completion queue.
+  void* cq_ptr_ = nullptr;
+  size_t cq_size_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  void* cqes_ = nullptr;
+
+  // Registered buffers for receive requests. The kernel picks buffers from
+  // the ring and we add them back after processing their completions.
+  void* buf_ring_ = nullptr;
+  size_t buf_ring_size_ = 0;
+  byte* bufs_ = nullptr;
+  size_t bufs_size_ = 0;
+  size_t buf_size_ = 0;
+  uint16_t buf_mask_ = 0;
+  uint16_t buf_tail_ = 0;
+
+  // Message headers for requests in the submission queue. The kernel copies
+  // them when consuming the request, so we re-use them after each submit.
+  std::vector<std::unique_ptr<message>> messages_;
+  size_t used_messages_ = 0;
+};
+
+} // namespace caf::io::network
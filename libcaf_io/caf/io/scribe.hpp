@@ -51,6 +51,14 @@ public:
   /// Returns the current output buffer.
   virtual byte_buffer& wr_buf() = 0;
 
+  /// Appends `buf` to the output. The default implementation copies `buf`
+  /// into `wr_buf()`.
+  virtual void write(byte_buffer buf);
+
+  /// Appends a shared, immutable buffer to the output. The default
+  /// implementation copies `buf` into `wr_buf()`.
+  virtual void write(shared_byte_buffer buf);
+
   /// Returns the current input buffer.
   virtual byte_buffer& rd_buf() = 0;
 
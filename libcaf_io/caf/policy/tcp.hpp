@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include "caf/byte.hpp"
 #include "caf/detail/io_export.hpp"
 #include "caf/io/network/native_socket.hpp"
 #include "caf/io/network/rw_state.hpp"
+#include "caf/span.hpp"
 
 namespace caf::policy {
 
@@ -42,6 +44,23 @@ struct CAF_IO_EXPORT tcp {
   write_some(size_t& result, io::network::native_socket fd, const void* buf,
              size_t len);
 
+  /// Writes up to `num_bufs` buffers from `bufs` to `fd` with a single system
+  /// call. Otherwise behaves like the single-buffer overload.
+  static io::network::rw_state
+  write_some(size_t& result, io::network::native_socket fd,
+             const span<const byte>* bufs, size_t num_bufs);
+
+  /// Writes up to `num_bufs` buffers from `bufs` to `fd` with `MSG_ZEROCOPY`.
+  /// Falls back to copying the data if the kernel cannot pin more pages for
+  /// the socket. Sets `zerocopy` to `true` if the kernel accepted the data
+  /// without copying it. In this case, the caller must keep the buffers alive
+  /// until reading the completion notification for this call from the error
+  /// queue of `fd`. Requires enabling zerocopy on `fd` first.
+  static io::network::rw_state
+  write_some_zerocopy(size_t& result, io::network::native_socket fd,
+                      const span<const byte>* bufs, size_t num_bufs,
+                      bool& zerocopy);
+
   /// Tries to accept a new connection from `fd`. On success,
   /// the new connection is stored in `result`. Returns true
   /// as long as
@@ -53,6 +72,10 @@ struct CAF_IO_EXPORT tcp {
   static constexpr bool must_read_more(io::network::native_socket, size_t) {
     return false;
   }
+
+  /// Signals that this policy only uses plain socket calls. Hence, the
+  /// multiplexer may perform the I/O via `io_uring` instead.
+  static constexpr bool native_socket_io = true;
 };
 
 } // namespace caf::policy
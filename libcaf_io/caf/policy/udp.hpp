@@ -47,6 +47,10 @@ struct CAF_IO_EXPORT udp {
   static constexpr bool must_read_more(io::network::native_socket, size_t) {
     return false;
   }
+
+  /// Signals that this policy only uses plain socket calls. Hence, the
+  /// multiplexer may perform the I/O via `io_uring` instead.
+  static constexpr bool native_socket_io = true;
 };
 
 } // namespace caf::policy
@@ -44,6 +44,12 @@ void abstract_broker::enqueue(mailbox_element_ptr ptr, execution_unit*) {
   scheduled_actor::enqueue(std::move(ptr), &backend());
 }
 
+void abstract_broker::enqueue_batch(mailbox_element_chain xs,
+                                    execution_unit*) {
+  CAF_PUSH_AID(id());
+  scheduled_actor::enqueue_batch(std::move(xs), &backend());
+}
+
 void abstract_broker::launch(execution_unit* eu, bool lazy, bool hide) {
   CAF_PUSH_AID_FROM_PTR(this);
   CAF_ASSERT(eu != nullptr);
@@ -104,6 +110,18 @@ void abstract_broker::write(connection_handle hdl, size_t bs, const void* buf) {
   out.insert(out.end(), first, last);
 }
 
+void abstract_broker::write(connection_handle hdl, byte_buffer buf) {
+  auto x = by_id(hdl);
+  if (x)
+    x->write(std::move(buf));
+}
+
+void abstract_broker::write(connection_handle hdl, shared_byte_buffer buf) {
+  auto x = by_id(hdl);
+  if (x)
+    x->write(std::move(buf));
+}
+
 void abstract_broker::flush(connection_handle hdl) {
   auto x = by_id(hdl);
   if (x)
@@ -373,12 +391,21 @@ void abstract_broker::init_broker() {
     kvp.second->launch();
 }
 
-abstract_broker::abstract_broker(actor_config& cfg) : scheduled_actor(cfg) {
-  // nop
+abstract_broker::abstract_broker(actor_config& cfg)
+  : scheduled_actor(cfg),
+    backend_(dynamic_cast<network::multiplexer*>(cfg.host)) {
+  // Brokers stay pinned to the multiplexer that spawned them, since all of
+  // their servants live in the event loop of that multiplexer.
+  if (backend_ == nullptr)
+    backend_ = &system().middleman().backend();
 }
 
 network::multiplexer& abstract_broker::backend() {
-  return system().middleman().backend();
+  return *backend_;
+}
+
+network::multiplexer& abstract_broker::next_io_backend() {
+  return *backend_;
 }
 
 void abstract_broker::launch_servant(doorman_ptr& ptr) {
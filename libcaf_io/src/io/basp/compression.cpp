@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/compression.hpp"
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/logger.hpp"
+
+namespace caf::io::basp {
+
+namespace {
+
+// Size of the prefix that stores the original payload size.
+constexpr size_t size_prefix = sizeof(uint32_t);
+
+} // namespace
+
+compression::compression(codec_ptr impl, size_t threshold)
+  : impl_(std::move(impl)),
+    threshold_(threshold),
+    compressed_payloads_(0),
+    incompressible_payloads_(0),
+    uncompressed_bytes_(0),
+    compressed_bytes_(0),
+    decompressed_payloads_(0) {
+  CAF_ASSERT(impl_ != nullptr);
+}
+
+compression::~compression() {
+  // nop
+}
+
+void compression::compress(header& hdr, byte_buffer& buf,
+                           size_t header_offset) {
+  if (hdr.payload_len < threshold_ || hdr.payload_len <= size_prefix
+      || hdr.has(header::compressed_flag))
+    return;
+  // Compress into a scratch buffer first, since we need to keep the original
+  // payload if the codec fails to shrink it.
+  thread_local byte_buffer scratch;
+  scratch.clear();
+  binary_serializer sink{nullptr, scratch};
+  if (auto err = sink(hdr.payload_len)) {
+    CAF_LOG_ERROR(CAF_ARG(err));
+    return;
+  }
+  auto payload_offset = header_offset + header_size;
+  span<const byte> payload{buf.data() + payload_offset, hdr.payload_len};
+  if (!impl_->compress(payload, scratch)
+      || scratch.size() >= hdr.payload_len) {
+    ++incompressible_payloads_;
+    return;
+  }
+  ++compressed_payloads_;
+  uncompressed_bytes_ += hdr.payload_len;
+  compressed_bytes_ += scratch.size();
+  buf.resize(payload_offset);
+  buf.insert(buf.end(), scratch.begin(), scratch.end());
+  hdr.flags |= header::compressed_flag;
+  hdr.payload_len = static_cast<uint32_t>(scratch.size());
+}
+
+bool compression::decompress(header& hdr, byte_buffer& payload) {
+  CAF_ASSERT(hdr.has(header::compressed_flag));
+  binary_deserializer source{nullptr, payload};
+  uint32_t size = 0;
+  if (auto err = source(size)) {
+    CAF_LOG_WARNING("compressed payload lacks its original size");
+    return false;
+  }
+  // Decompress into a buffer that keeps its capacity between calls. After
+  // swapping, the scratch buffer holds on to the compressed input instead.
+  thread_local byte_buffer result;
+  result.clear();
+  span<const byte> in{payload.data() + size_prefix,
+                      payload.size() - size_prefix};
+  if (!impl_->decompress(in, result, size)) {
+    CAF_LOG_WARNING("unable to decompress payload:" << CAF_ARG(hdr));
+    return false;
+  }
+  ++decompressed_payloads_;
+  payload.swap(result);
+  hdr.flags &= ~header::compressed_flag;
+  hdr.payload_len = size;
+  return true;
+}
+
+compression_stats compression::stats() const noexcept {
+  compression_stats result;
+  result.compressed_payloads = compressed_payloads_.load();
+  result.incompressible_payloads = incompressible_payloads_.load();
+  result.uncompressed_bytes = uncompressed_bytes_.load();
+  result.compressed_bytes = compressed_bytes_.load();
+  result.decompressed_payloads = decompressed_payloads_.load();
+  return result;
+}
+
+} // namespace caf::io::basp
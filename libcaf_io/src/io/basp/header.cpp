@@ -24,6 +24,8 @@ namespace caf::io::basp {
 
 const uint8_t header::named_receiver_flag;
 
+const uint8_t header::compressed_flag;
+
 std::string to_bin(uint8_t x) {
   std::string res;
   for (auto offset = 7; offset > -1; --offset)
@@ -84,6 +86,11 @@ bool heartbeat_valid(const header& hdr) {
          && zero(hdr.operation_data);
 }
 
+bool batch_valid(const header& hdr) {
+  return zero(hdr.source_actor) && zero(hdr.dest_actor)
+         && !zero(hdr.payload_len) && !zero(hdr.operation_data);
+}
+
 } // namespace
 
 bool valid(const header& hdr) {
@@ -104,6 +111,8 @@ bool valid(const header& hdr) {
       return down_message_valid(hdr);
     case message_type::heartbeat:
       return heartbeat_valid(hdr);
+    case message_type::batch:
+      return batch_valid(hdr);
   }
 }
 
@@ -38,13 +38,51 @@ instance::callee::~callee() {
   // nop
 }
 
+void instance::callee::enable_compression(connection_handle, const node_id&,
+                                          compression_ptr) {
+  // nop
+}
+
+compression* instance::callee::compression_for(connection_handle) {
+  return nullptr;
+}
+
+void instance::callee::enable_batching(connection_handle) {
+  // nop
+}
+
+message_batch* instance::callee::batch_for(connection_handle) {
+  return nullptr;
+}
+
+void instance::callee::batch_started(connection_handle) {
+  // nop
+}
+
+detail::message_shape_cache*
+instance::callee::shape_cache_for(connection_handle) {
+  return nullptr;
+}
+
+message_queue* instance::callee::queue_for(connection_handle) {
+  return nullptr;
+}
+
 instance::instance(abstract_broker* parent, callee& lstnr)
   : tbl_(parent), this_node_(parent->system().node()), callee_(lstnr) {
   CAF_ASSERT(this_node_ != none);
   auto workers
     = get_or(config(), "middleman.workers", defaults::middleman::workers);
   for (size_t i = 0; i < workers; ++i)
-    hub_.add_new_worker(queue_, proxies());
+    hub_.add_new_worker(proxies());
+  codecs_ = get_or(config(), "middleman.compression-codecs",
+                   std::vector<std::string>{});
+  compression_threshold_
+    = get_or(config(), "middleman.compression-threshold",
+             defaults::middleman::compression_threshold);
+  coalesce_messages_ = get_or(config(), "middleman.coalesce-messages", false);
+  max_batch_size_ = get_or(config(), "middleman.max-batch-size",
+                           defaults::middleman::max_batch_size);
 }
 
 connection_state instance::handle(execution_unit* ctx, new_data_msg& dm,
@@ -167,6 +205,10 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
   if (!path)
     return false;
   auto& source_node = sender ? sender->node() : this_node_;
+  // Batches get compressed as a whole when writing them to the connection.
+  auto batch = callee_.batch_for(path->hdl);
+  auto& buf = batch != nullptr ? batch->buf() : callee_.get_buffer(path->hdl);
+  auto cmp = batch != nullptr ? nullptr : callee_.compression_for(path->hdl);
   if (dest_node == path->next_hop && source_node == this_node_) {
     header hdr{message_type::direct_message,
                flags,
@@ -177,7 +219,7 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     auto writer = make_callback([&](binary_serializer& sink) { //
       return sink(forwarding_stack, msg);
     });
-    write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
+    write(ctx, buf, hdr, &writer, cmp);
   } else {
     header hdr{message_type::routed_message,
                flags,
@@ -188,14 +230,22 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     auto writer = make_callback([&](binary_serializer& sink) {
       return sink(source_node, dest_node, forwarding_stack, msg);
     });
-    write(ctx, callee_.get_buffer(path->hdl), hdr, &writer);
+    write(ctx, buf, hdr, &writer, cmp);
+  }
+  if (batch != nullptr) {
+    batch->added();
+    if (batch->bytes() < max_batch_size_) {
+      if (batch->size() == 1)
+        callee_.batch_started(path->hdl);
+      return true;
+    }
   }
   flush(*path);
   return true;
 }
 
 void instance::write(execution_unit* ctx, byte_buffer& buf, header& hdr,
-                     payload_writer* pw) {
+                     payload_writer* pw, compression* cmp) {
   CAF_LOG_TRACE(CAF_ARG(hdr));
   binary_serializer sink{ctx, buf};
   if (pw != nullptr) {
@@ -204,9 +254,11 @@ void instance::write(execution_unit* ctx, byte_buffer& buf, header& hdr,
     sink.skip(header_size);
     if (auto err = (*pw)(sink))
       CAF_LOG_ERROR(CAF_ARG(err));
-    sink.seek(header_offset);
     auto payload_len = buf.size() - (header_offset + basp::header_size);
     hdr.payload_len = static_cast<uint32_t>(payload_len);
+    if (cmp != nullptr)
+      cmp->compress(hdr, buf, header_offset);
+    sink.seek(header_offset);
   }
   if (auto err = sink(hdr))
     CAF_LOG_ERROR(CAF_ARG(err));
@@ -232,7 +284,7 @@ void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
       aid = pa->first->id();
       iface = pa->second;
     }
-    return sink(this_node_, app_ids, aid, iface);
+    return write_handshake(sink, this_node_, app_ids, aid, iface);
   });
   header hdr{message_type::server_handshake,
              0,
@@ -244,8 +296,8 @@ void instance::write_server_handshake(execution_unit* ctx, byte_buffer& out_buf,
 }
 
 void instance::write_client_handshake(execution_unit* ctx, byte_buffer& buf) {
-  auto writer = make_callback([&](binary_serializer& sink) { //
-    return sink(this_node_);
+  auto writer = make_callback([&](binary_serializer& sink) {
+    return write_handshake(sink, this_node_);
   });
   header hdr{message_type::client_handshake,
              0,
@@ -297,6 +349,15 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
     CAF_LOG_WARNING("actual payload size differs from advertised size");
     return malformed_basp_message;
   }
+  // Restore the original payload before processing compressed messages.
+  if (hdr.has(header::compressed_flag)) {
+    auto cmp = callee_.compression_for(hdl);
+    if (payload == nullptr || cmp == nullptr
+        || !cmp->decompress(hdr, *payload)) {
+      CAF_LOG_WARNING("received invalid compressed payload");
+      return malformed_basp_message;
+    }
+  }
   // Dispatch by message type.
   switch (hdr.operation) {
     case message_type::server_handshake: {
@@ -306,7 +367,12 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       std::vector<std::string> app_ids;
       actor_id aid = invalid_actor_id;
       std::set<std::string> sigs;
-      if (auto err = bd(source_node, app_ids, aid, sigs)) {
+      std::vector<std::string> server_codecs;
+      std::vector<std::string> server_features;
+      auto err = bd(source_node, app_ids, aid, sigs);
+      if (!err)
+        err = read_handshake_extensions(bd, server_codecs, server_features);
+      if (err) {
         CAF_LOG_WARNING("unable to deserialize payload of server handshake:"
                         << ctx->system().render(err));
         return serializing_basp_payload_failed;
@@ -338,6 +404,9 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
       auto was_indirect = tbl_.erase_indirect(source_node);
+      negotiate_compression(hdl, source_node, server_codecs,
+                            supported_codecs());
+      negotiate_batching(hdl, server_features);
       // write handshake as client in response
       auto path = tbl_.lookup(source_node);
       if (!path) {
@@ -352,7 +421,12 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       // Deserialize payload.
       binary_deserializer bd{ctx, *payload};
       node_id source_node;
-      if (auto err = bd(source_node)) {
+      std::vector<std::string> client_codecs;
+      std::vector<std::string> client_features;
+      auto err = bd(source_node);
+      if (!err)
+        err = read_handshake_extensions(bd, client_codecs, client_features);
+      if (err) {
         CAF_LOG_WARNING("unable to deserialize payload of client handshake:"
                         << ctx->system().render(err));
         return serializing_basp_payload_failed;
@@ -367,6 +441,9 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       CAF_LOG_DEBUG("new direct connection:" << CAF_ARG(source_node));
       tbl_.add_direct(hdl, source_node);
       auto was_indirect = tbl_.erase_indirect(source_node);
+      negotiate_compression(hdl, source_node, supported_codecs(),
+                            client_codecs);
+      negotiate_batching(hdl, client_features);
       callee_.learned_new_node_directly(source_node, was_indirect);
       break;
     }
@@ -395,10 +472,12 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
     case message_type::direct_message: {
       auto worker = hub_.pop();
       auto last_hop = tbl_.lookup_direct(hdl);
+      auto shapes = callee_.shape_cache_for(hdl);
+      auto& queue = queue_for(hdl);
       if (worker != nullptr) {
         CAF_LOG_DEBUG("launch BASP worker for deserializing a"
                       << hdr.operation);
-        worker->launch(last_hop, hdr, *payload);
+        worker->launch(last_hop, hdr, *payload, shapes, queue);
       } else {
         CAF_LOG_DEBUG("out of BASP workers, continue deserializing a"
                       << hdr.operation);
@@ -407,13 +486,14 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
         struct handler : remote_message_handler<handler> {
           handler(message_queue* queue, proxy_registry* proxies,
                   actor_system* system, node_id last_hop, basp::header& hdr,
-                  byte_buffer& payload)
+                  byte_buffer& payload, detail::message_shape_cache* shapes)
             : queue_(queue),
               proxies_(proxies),
               system_(system),
               last_hop_(std::move(last_hop)),
               hdr_(hdr),
-              payload_(payload) {
+              payload_(payload),
+              shapes_(shapes) {
             msg_id_ = queue_->new_id();
           }
           message_queue* queue_;
@@ -422,9 +502,11 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
           node_id last_hop_;
           basp::header& hdr_;
           byte_buffer& payload_;
+          detail::message_shape_cache_ptr shapes_;
           uint64_t msg_id_;
         };
-        handler f{&queue_, &proxies(), &system(), last_hop, hdr, *payload};
+        handler f{&queue, &proxies(), &system(), last_hop, hdr, *payload,
+                  shapes};
         f.handle_remote_message(callee_.current_execution_unit());
       }
       break;
@@ -458,13 +540,14 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       }
       if (dest_node == this_node_) {
         // Delay this message to make sure we don't skip in-flight messages.
-        auto msg_id = queue_.new_id();
+        auto& queue = queue_for(hdl);
+        auto msg_id = queue.new_id();
         auto ptr = make_mailbox_element(nullptr, make_message_id(), {},
                                         delete_atom_v, source_node,
                                         hdr.source_actor,
                                         std::move(fail_state));
-        queue_.push(callee_.current_execution_unit(), msg_id,
-                    callee_.this_actor(), std::move(ptr));
+        queue.push(callee_.current_execution_unit(), msg_id,
+                   callee_.this_actor(), std::move(ptr));
       } else {
         forward(ctx, dest_node, hdr, *payload);
       }
@@ -475,6 +558,9 @@ connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
       callee_.handle_heartbeat();
       break;
     }
+    case message_type::batch: {
+      return handle_batch(ctx, hdl, hdr, *payload);
+    }
     default: {
       CAF_LOG_ERROR("invalid operation");
       return malformed_basp_message;
@@ -488,16 +574,136 @@ void instance::forward(execution_unit* ctx, const node_id& dest_node,
   CAF_LOG_TRACE(CAF_ARG(dest_node) << CAF_ARG(hdr) << CAF_ARG(payload));
   auto path = lookup(dest_node);
   if (path) {
-    binary_serializer bs{ctx, callee_.get_buffer(path->hdl)};
-    if (auto err = bs(hdr)) {
+    auto& buf = callee_.get_buffer(path->hdl);
+    auto header_offset = buf.size();
+    binary_serializer bs{ctx, buf};
+    bs.skip(header_size);
+    bs.apply(span<const byte>{payload.data(), payload.size()});
+    auto fwd_hdr = hdr;
+    if (auto cmp = callee_.compression_for(path->hdl))
+      cmp->compress(fwd_hdr, buf, header_offset);
+    bs.seek(header_offset);
+    if (auto err = bs(fwd_hdr)) {
       CAF_LOG_ERROR("unable to serialize BASP header");
+      buf.resize(header_offset);
       return;
     }
-    bs.apply(span<const byte>{payload.data(), payload.size()});
     flush(*path);
   } else {
     CAF_LOG_WARNING("cannot forward message, no route to destination");
   }
 }
 
+connection_state instance::handle_batch(execution_unit* ctx,
+                                        connection_handle hdl,
+                                        const header& hdr,
+                                        byte_buffer& payload) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(hdr));
+  uint64_t num_messages = 0;
+  size_t pos = 0;
+  byte_buffer msg_payload;
+  while (pos < payload.size()) {
+    if (payload.size() - pos < header_size) {
+      CAF_LOG_WARNING("batch ends with an incomplete header");
+      return malformed_basp_message;
+    }
+    header msg_hdr;
+    binary_deserializer bd{ctx, payload.data() + pos, header_size};
+    if (auto err = bd(msg_hdr); err || !valid(msg_hdr)) {
+      CAF_LOG_WARNING("batch contains an invalid header:" << CAF_ARG(msg_hdr));
+      return malformed_basp_message;
+    }
+    // Batches only carry ordinary messages and never nest.
+    if ((msg_hdr.operation != message_type::direct_message
+         && msg_hdr.operation != message_type::routed_message)
+        || msg_hdr.has(header::compressed_flag)) {
+      CAF_LOG_WARNING("batch contains an unexpected message:"
+                      << CAF_ARG(msg_hdr));
+      return malformed_basp_message;
+    }
+    pos += header_size;
+    if (payload.size() - pos < msg_hdr.payload_len) {
+      CAF_LOG_WARNING("batch ends with an incomplete payload");
+      return malformed_basp_message;
+    }
+    auto first = payload.begin() + pos;
+    msg_payload.assign(first, first + msg_hdr.payload_len);
+    pos += msg_hdr.payload_len;
+    auto res = handle(ctx, hdl, msg_hdr, &msg_payload);
+    if (res != await_header)
+      return res;
+    ++num_messages;
+  }
+  if (num_messages != hdr.operation_data) {
+    CAF_LOG_WARNING("batch contains" << num_messages << "messages, expected"
+                                     << hdr.operation_data);
+    return malformed_basp_message;
+  }
+  return await_header;
+}
+
+message_queue& instance::queue_for(connection_handle hdl) {
+  auto ptr = callee_.queue_for(hdl);
+  return ptr != nullptr ? *ptr : queue_;
+}
+
+std::vector<std::string> instance::supported_codecs() {
+  std::vector<std::string> result;
+  auto& mm = system().middleman();
+  for (auto& name : codecs_)
+    if (mm.codec(name) != nullptr)
+      result.emplace_back(name);
+  return result;
+}
+
+std::vector<std::string> instance::supported_features() {
+  std::vector<std::string> result;
+  if (coalesce_messages_)
+    result.emplace_back("batch");
+  return result;
+}
+
+error_code<sec>
+instance::read_handshake_extensions(binary_deserializer& source,
+                                    std::vector<std::string>& codecs,
+                                    std::vector<std::string>& features) {
+  if (source.remaining() > 0)
+    if (auto err = source(codecs))
+      return err;
+  if (source.remaining() > 0)
+    if (auto err = source(features))
+      return err;
+  return none;
+}
+
+void instance::negotiate_batching(
+  connection_handle hdl, const std::vector<std::string>& remote_features) {
+  if (!coalesce_messages_)
+    return;
+  auto i = std::find(remote_features.begin(), remote_features.end(), "batch");
+  if (i != remote_features.end()) {
+    CAF_LOG_DEBUG("enable message coalescing:" << CAF_ARG(hdl));
+    callee_.enable_batching(hdl);
+  }
+}
+
+void instance::negotiate_compression(
+  connection_handle hdl, const node_id& nid,
+  const std::vector<std::string>& server_codecs,
+  const std::vector<std::string>& client_codecs) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(nid) << CAF_ARG(server_codecs)
+                             << CAF_ARG(client_codecs));
+  auto i = std::find_first_of(server_codecs.begin(), server_codecs.end(),
+                              client_codecs.begin(), client_codecs.end());
+  if (i == server_codecs.end())
+    return;
+  if (auto impl = system().middleman().codec(*i)) {
+    CAF_LOG_DEBUG("enable payload compression:" << CAF_ARG(nid)
+                                                << CAF_ARG2("codec", *i));
+    auto ptr = make_counted<compression>(std::move(impl),
+                                         compression_threshold_);
+    callee_.enable_compression(hdl, nid, std::move(ptr));
+  }
+}
+
 } // namespace caf::io::basp
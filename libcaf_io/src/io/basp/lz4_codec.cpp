@@ -0,0 +1,199 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/lz4_codec.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace caf::io::basp {
+
+namespace {
+
+// Every match encodes at least this many bytes.
+constexpr size_t min_match = 4;
+
+// The block format requires the last 5 bytes to be literals.
+constexpr size_t last_literals = 5;
+
+// The block format requires the last match to start at least 12 bytes before
+// the end of the input.
+constexpr size_t match_find_limit = 12;
+
+// Matches refer to data with a 16-bit offset.
+constexpr size_t max_offset = 65535;
+
+// Number of bits for indexing the hash table of the compressor.
+constexpr int hash_log = 12;
+
+uint32_t read32(const byte* ptr) {
+  uint32_t result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+uint64_t read64(const byte* ptr) {
+  uint64_t result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+uint32_t hash(uint32_t x) {
+  return (x * 2654435761u) >> (32 - hash_log);
+}
+
+void write_length(byte_buffer& out, size_t len) {
+  for (; len >= 255; len -= 255)
+    out.push_back(byte{255});
+  out.push_back(static_cast<byte>(len));
+}
+
+void write_sequence(byte_buffer& out, const byte* literals, size_t num_literals,
+                    size_t offset, size_t match_len) {
+  auto token_pos = out.size();
+  auto lit_nibble = num_literals < 15 ? num_literals : size_t{15};
+  out.push_back(static_cast<byte>(lit_nibble << 4));
+  if (num_literals >= 15)
+    write_length(out, num_literals - 15);
+  out.insert(out.end(), literals, literals + num_literals);
+  // The final sequence consists of literals only.
+  if (match_len == 0)
+    return;
+  out.push_back(static_cast<byte>(offset & 0xFF));
+  out.push_back(static_cast<byte>(offset >> 8));
+  auto len = match_len - min_match;
+  auto match_nibble = len < 15 ? len : size_t{15};
+  out[token_pos] |= static_cast<byte>(match_nibble);
+  if (len >= 15)
+    write_length(out, len - 15);
+}
+
+// Reads the remainder of a length that starts with the nibble 15.
+bool read_length(span<const byte> in, size_t& pos, size_t& len) {
+  uint8_t x;
+  do {
+    if (pos == in.size())
+      return false;
+    x = to_integer<uint8_t>(in[pos++]);
+    len += x;
+  } while (x == 255);
+  return true;
+}
+
+} // namespace
+
+lz4_codec::~lz4_codec() {
+  // nop
+}
+
+string_view lz4_codec::name() const noexcept {
+  return "lz4";
+}
+
+bool lz4_codec::compress(span<const byte> in, byte_buffer& out) const {
+  auto first = in.data();
+  auto n = in.size();
+  auto start_size = out.size();
+  size_t anchor = 0;
+  if (n > match_find_limit) {
+    uint32_t table[size_t{1} << hash_log] = {};
+    auto match_limit = n - match_find_limit;
+    auto match_end_limit = n - last_literals;
+    size_t pos = 0;
+    while (pos < match_limit) {
+      auto seq = read32(first + pos);
+      auto& entry = table[hash(seq)];
+      size_t candidate = entry;
+      entry = static_cast<uint32_t>(pos);
+      if (candidate < pos && pos - candidate <= max_offset
+          && read32(first + candidate) == seq) {
+        auto len = min_match;
+        while (pos + len + sizeof(uint64_t) <= match_end_limit
+               && read64(first + candidate + len) == read64(first + pos + len))
+          len += sizeof(uint64_t);
+        while (pos + len < match_end_limit
+               && first[candidate + len] == first[pos + len])
+          ++len;
+        write_sequence(out, first + anchor, pos - anchor, pos - candidate, len);
+        pos += len;
+        anchor = pos;
+      } else {
+        ++pos;
+      }
+    }
+  }
+  write_sequence(out, first + anchor, n - anchor, 0, 0);
+  if (out.size() - start_size >= n) {
+    out.resize(start_size);
+    return false;
+  }
+  return true;
+}
+
+bool lz4_codec::decompress(span<const byte> in, byte_buffer& out,
+                           size_t size) const {
+  auto start_size = out.size();
+  out.resize(start_size + size);
+  auto first = out.data() + start_size;
+  size_t produced = 0;
+  size_t pos = 0;
+  auto fail = [&] {
+    out.resize(start_size);
+    return false;
+  };
+  while (pos < in.size()) {
+    auto token = to_integer<uint8_t>(in[pos++]);
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !read_length(in, pos, num_literals))
+      return fail();
+    if (num_literals > in.size() - pos || num_literals > size - produced)
+      return fail();
+    memcpy(first + produced, in.data() + pos, num_literals);
+    produced += num_literals;
+    pos += num_literals;
+    // The final sequence has no match part.
+    if (pos == in.size())
+      break;
+    if (in.size() - pos < 2)
+      return fail();
+    auto offset = to_integer<size_t>(in[pos])
+                  | (to_integer<size_t>(in[pos + 1]) << 8);
+    pos += 2;
+    size_t match_len = token & 0x0F;
+    if (match_len == 15 && !read_length(in, pos, match_len))
+      return fail();
+    match_len += min_match;
+    if (offset == 0 || offset > produced || match_len > size - produced)
+      return fail();
+    auto dst = first + produced;
+    auto src = dst - offset;
+    if (offset >= match_len) {
+      memcpy(dst, src, match_len);
+    } else {
+      // Overlapping matches encode runs and need a forward byte-wise copy.
+      for (size_t i = 0; i < match_len; ++i)
+        dst[i] = src[i];
+    }
+    produced += match_len;
+  }
+  if (produced != size)
+    return fail();
+  return true;
+}
+
+} // namespace caf::io::basp
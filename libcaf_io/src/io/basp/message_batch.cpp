@@ -0,0 +1,62 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/message_batch.hpp"
+
+#include "caf/binary_deserializer.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/io/basp/header.hpp"
+#include "caf/logger.hpp"
+
+namespace caf::io::basp {
+
+void message_batch::write_to(execution_unit* ctx, byte_buffer& out,
+                             compression* cmp) {
+  if (size_ == 0)
+    return;
+  auto header_offset = out.size();
+  header hdr;
+  if (size_ == 1) {
+    // A single message needs no enclosing frame.
+    binary_deserializer source{ctx, buf_};
+    if (auto err = source(hdr)) {
+      CAF_LOG_ERROR("unable to read BASP header in batch:" << CAF_ARG(err));
+      return;
+    }
+    out.insert(out.end(), buf_.begin(), buf_.end());
+  } else {
+    hdr = header{message_type::batch,
+                 0,
+                 static_cast<uint32_t>(buf_.size()),
+                 size_,
+                 invalid_actor_id,
+                 invalid_actor_id};
+    out.resize(header_offset + header_size);
+    out.insert(out.end(), buf_.begin(), buf_.end());
+  }
+  buf_.clear();
+  size_ = 0;
+  if (cmp != nullptr)
+    cmp->compress(hdr, out, header_offset);
+  binary_serializer sink{ctx, out};
+  sink.seek(header_offset);
+  if (auto err = sink(hdr))
+    CAF_LOG_ERROR(CAF_ARG(err));
+}
+
+} // namespace caf::io::basp
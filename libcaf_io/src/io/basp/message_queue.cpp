@@ -18,47 +18,45 @@
 
 #include "caf/io/basp/message_queue.hpp"
 
+#include <algorithm>
 #include <iterator>
 
 namespace caf::io::basp {
 
-message_queue::message_queue() : next_id(0), next_undelivered(0) {
+message_queue::message_queue()
+  : next_id(0), next_undelivered(0), delivering_(false), num_pending_(0) {
+  // nop
+}
+
+message_queue::~message_queue() {
   // nop
 }
 
 void message_queue::push(execution_unit* ctx, uint64_t id,
                          strong_actor_ptr receiver,
                          mailbox_element_ptr content) {
-  std::unique_lock<std::mutex> guard{lock};
   CAF_ASSERT(id >= next_undelivered);
   CAF_ASSERT(id < next_id);
-  auto first = pending.begin();
-  auto last = pending.end();
-  if (id == next_undelivered) {
-    // Dispatch current head.
+  // Only the delivering thread advances `next_undelivered` and it never moves
+  // past `id` before we push it. Hence, `id` remains the next ID to ship
+  // after acquiring the flag.
+  if (id == next_undelivered.load() && !delivering_.exchange(true)) {
     if (receiver != nullptr)
       receiver->enqueue(std::move(content), ctx);
-    auto next = id + 1;
-    // Check whether we can deliver more.
-    if (first == last || first->id != next) {
-      next_undelivered = next;
-      CAF_ASSERT(next_undelivered <= next_id);
-      return;
-    }
-    // Deliver everything until reaching a non-consecutive ID or the end.
-    auto i = first;
-    for (; i != last && i->id == next; ++i, ++next)
-      if (i->receiver != nullptr)
-        i->receiver->enqueue(std::move(i->content), ctx);
-    next_undelivered = next;
-    pending.erase(first, i);
-    CAF_ASSERT(next_undelivered <= next_id);
+    next_undelivered.store(id + 1);
+    deliver_pending(ctx);
     return;
   }
-  // Get the insertion point.
-  auto pred = [&](const actor_msg& x) { return x.id >= id; };
-  pending.emplace(std::find_if(first, last, pred),
-                  actor_msg{id, std::move(receiver), std::move(content)});
+  // Park the message until its predecessors arrive.
+  {
+    std::unique_lock<std::mutex> guard{pending_mtx_};
+    auto pred = [&](const actor_msg& x) { return x.id >= id; };
+    pending_.emplace(std::find_if(pending_.begin(), pending_.end(), pred),
+                     actor_msg{id, std::move(receiver), std::move(content)});
+    ++num_pending_;
+  }
+  if (!delivering_.exchange(true))
+    deliver_pending(ctx);
 }
 
 void message_queue::drop(execution_unit* ctx, uint64_t id) {
@@ -66,8 +64,48 @@ void message_queue::drop(execution_unit* ctx, uint64_t id) {
 }
 
 uint64_t message_queue::new_id() {
-  std::unique_lock<std::mutex> guard{lock};
   return next_id++;
 }
 
+void message_queue::deliver_pending(execution_unit* ctx) {
+  CAF_ASSERT(delivering_);
+  for (;;) {
+    auto next = next_undelivered.load();
+    if (num_pending_ > 0) {
+      // Take all consecutive messages while holding the lock but deliver them
+      // outside of the critical section.
+      {
+        std::unique_lock<std::mutex> guard{pending_mtx_};
+        auto first = pending_.begin();
+        auto last = pending_.end();
+        auto i = first;
+        for (auto expected = next; i != last && i->id == expected; ++i)
+          ++expected;
+        std::move(first, i, std::back_inserter(ready_));
+        pending_.erase(first, i);
+        num_pending_ -= ready_.size();
+      }
+      for (auto& x : ready_)
+        if (x.receiver != nullptr)
+          x.receiver->enqueue(std::move(x.content), ctx);
+      next += ready_.size();
+      ready_.clear();
+      next_undelivered.store(next);
+    }
+    delivering_.store(false);
+    // Another thread may have parked the next message after we took all
+    // consecutive messages but before we released the flag. In this case, the
+    // other thread failed to acquire the flag and we need to continue.
+    if (num_pending_ == 0)
+      return;
+    {
+      std::unique_lock<std::mutex> guard{pending_mtx_};
+      if (pending_.empty() || pending_.front().id != next_undelivered.load())
+        return;
+    }
+    if (delivering_.exchange(true))
+      return;
+  }
+}
+
 } // namespace caf::io::basp
@@ -27,6 +27,8 @@ std::string to_string(message_type x) {
       return "down_message";
     case message_type::heartbeat:
       return "heartbeat";
+    case message_type::batch:
+      return "batch";
   };
 }
 
@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/outbound_queue.hpp"
+
+#include "caf/detail/sync_request_bouncer.hpp"
+#include "caf/exit_reason.hpp"
+#include "caf/io/abstract_broker.hpp"
+#include "caf/io/network/multiplexer.hpp"
+#include "caf/logger.hpp"
+
+namespace caf::io::basp {
+
+outbound_queue::outbound_queue(abstract_broker* parent, connection_handle hdl,
+                               compression_ptr cmp)
+  : parent_(parent),
+    backend_(&parent->backend()),
+    hdl_(hdl),
+    cmp_(std::move(cmp)) {
+  // The first push schedules a flush.
+  inbox_.try_block();
+}
+
+outbound_queue::~outbound_queue() {
+  // nop
+}
+
+bool outbound_queue::push(byte_buffer buf, strong_actor_ptr sender,
+                          message_id mid) {
+  switch (inbox_.emplace_front(std::move(buf), std::move(sender), mid)) {
+    case intrusive::inbox_result::unblocked_reader: {
+      intrusive_ptr<outbound_queue> self{this};
+      backend_->post([self] { self->flush(); });
+      return true;
+    }
+    case intrusive::inbox_result::queue_closed:
+      return false;
+    default:
+      return true;
+  }
+}
+
+void outbound_queue::drain() {
+  if (inbox_.closed() || inbox_.blocked())
+    return;
+  auto head = inbox_.take_head();
+  if (head == nullptr)
+    return;
+  // Restore FIFO order before writing to the connection.
+  element* fifo = nullptr;
+  while (head != nullptr) {
+    auto next = static_cast<element*>(head->next);
+    head->next = fifo;
+    fifo = head;
+    head = next;
+  }
+  while (fifo != nullptr) {
+    auto next = static_cast<element*>(fifo->next);
+    parent_->write(hdl_, std::move(fifo->buf));
+    delete fifo;
+    fifo = next;
+  }
+}
+
+void outbound_queue::flush() {
+  CAF_LOG_TRACE(CAF_ARG(hdl_));
+  do {
+    if (inbox_.closed())
+      return;
+    drain();
+    parent_->flush(hdl_);
+  } while (!inbox_.try_block());
+}
+
+void outbound_queue::close() {
+  CAF_LOG_TRACE(CAF_ARG(hdl_));
+  if (inbox_.closed())
+    return;
+  detail::sync_request_bouncer bouncer{exit_reason::remote_link_unreachable};
+  auto f = [&](element* x) {
+    bouncer(x->sender, x->mid);
+    delete x;
+  };
+  inbox_.close(f);
+}
+
+} // namespace caf::io::basp
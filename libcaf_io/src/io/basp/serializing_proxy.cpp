@@ -0,0 +1,114 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/serializing_proxy.hpp"
+
+#include "caf/actor_registry.hpp"
+#include "caf/actor_system.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/exit_reason.hpp"
+#include "caf/io/basp/header.hpp"
+#include "caf/locks.hpp"
+#include "caf/logger.hpp"
+#include "caf/mailbox_element.hpp"
+
+namespace caf::io::basp {
+
+serializing_proxy::serializing_proxy(actor_config& cfg, actor dest,
+                                     outbound_queue_ptr queue)
+  : super(cfg, std::move(dest)),
+    queue_(std::move(queue)),
+    forwarding_(false) {
+  // nop
+}
+
+serializing_proxy::~serializing_proxy() {
+  // nop
+}
+
+void serializing_proxy::enqueue(mailbox_element_ptr what,
+                                execution_unit* context) {
+  CAF_PUSH_AID(0);
+  CAF_ASSERT(what);
+  if (!try_write(*what, context))
+    super::enqueue(std::move(what), context);
+}
+
+void serializing_proxy::kill_proxy(execution_unit* ctx, error rsn) {
+  outbound_queue_ptr tmp;
+  { // lifetime scope of guard
+    std::unique_lock<detail::shared_spinlock> guard(queue_mtx_);
+    queue_.swap(tmp);
+  }
+  super::kill_proxy(ctx, std::move(rsn));
+}
+
+bool serializing_proxy::try_write(mailbox_element& x, execution_unit* ctx) {
+  // Messages from remote senders require a routed_message, which only the
+  // broker can send. Since these senders never use the direct path, their
+  // messages cannot overtake each other.
+  auto& sys = home_system();
+  if (x.sender != nullptr && x.sender->node() != sys.node())
+    return false;
+  if (forwarding_.load(std::memory_order_acquire))
+    return false;
+  // Exit messages also need to unlink the proxy, which the default path takes
+  // care of.
+  if (x.payload.match_elements<exit_msg>()) {
+    forwarding_.store(true, std::memory_order_release);
+    return false;
+  }
+  shared_lock<detail::shared_spinlock> guard(queue_mtx_);
+  if (queue_ == nullptr || queue_->closed())
+    return false;
+  CAF_LOG_TRACE(CAF_ARG(id()) << CAF_ARG2("sender", x.sender)
+                              << CAF_ARG2("mid", x.mid)
+                              << CAF_ARG2("msg", x.payload));
+  // Enable the remote node to send responses to the sender.
+  if (x.sender != nullptr)
+    sys.registry().put(x.sender->id(), x.sender);
+  header hdr{message_type::direct_message,
+             0,
+             0,
+             x.mid.integer_value(),
+             x.sender != nullptr ? x.sender->id() : invalid_actor_id,
+             id()};
+  byte_buffer buf;
+  // Serializing actor handles requires a context.
+  binary_serializer sink{ctx != nullptr ? ctx : sys.dummy_execution_unit(),
+                         buf};
+  // Write the BASP header after the payload.
+  sink.skip(header_size);
+  if (auto err = sink(x.stages, x.payload)) {
+    CAF_LOG_ERROR(CAF_ARG(err));
+    forwarding_.store(true, std::memory_order_release);
+    return false;
+  }
+  hdr.payload_len = static_cast<uint32_t>(buf.size() - header_size);
+  if (auto cmp = queue_->payload_compression())
+    cmp->compress(hdr, buf, 0);
+  sink.seek(0);
+  if (auto err = sink(hdr)) {
+    CAF_LOG_ERROR(CAF_ARG(err));
+    forwarding_.store(true, std::memory_order_release);
+    return false;
+  }
+  return queue_->push(std::move(buf), x.sender, x.mid);
+}
+
+} // namespace caf::io::basp
@@ -27,8 +27,8 @@ namespace caf::io::basp {
 
 // -- constructors, destructors, and assignment operators ----------------------
 
-worker::worker(hub_type& hub, message_queue& queue, proxy_registry& proxies)
-  : hub_(&hub), queue_(&queue), proxies_(&proxies), system_(&proxies.system()) {
+worker::worker(hub_type& hub, proxy_registry& proxies)
+  : hub_(&hub), proxies_(&proxies), system_(&proxies.system()) {
   CAF_IGNORE_UNUSED(pad_);
 }
 
@@ -39,14 +39,19 @@ worker::~worker() {
 // -- management ---------------------------------------------------------------
 
 void worker::launch(const node_id& last_hop, const basp::header& hdr,
-                    const byte_buffer& payload) {
+                    byte_buffer& payload,
+                    detail::message_shape_cache* shapes,
+                    message_queue& queue) {
   CAF_ASSERT(hdr.dest_actor != 0);
   CAF_ASSERT(hdr.operation == basp::message_type::direct_message
              || hdr.operation == basp::message_type::routed_message);
+  queue_.reset(&queue);
   msg_id_ = queue_->new_id();
   last_hop_ = last_hop;
   memcpy(&hdr_, &hdr, sizeof(basp::header));
-  payload_.assign(payload.begin(), payload.end());
+  payload_.clear();
+  payload_.swap(payload);
+  shapes_.reset(shapes);
   ref();
   system_->scheduler().enqueue(this);
 }
@@ -56,6 +61,8 @@ void worker::launch(const node_id& last_hop, const basp::header& hdr,
 resumable::resume_result worker::resume(execution_unit* ctx, size_t) {
   ctx->proxy_registry_ptr(proxies_);
   handle_remote_message(ctx);
+  shapes_.reset();
+  queue_.reset();
   hub_->push(this);
   return resumable::awaiting_message;
 }
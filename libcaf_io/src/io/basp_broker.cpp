@@ -29,6 +29,7 @@
 #include "caf/event_based_actor.hpp"
 #include "caf/forwarding_actor_proxy.hpp"
 #include "caf/io/basp/all.hpp"
+#include "caf/io/basp/serializing_proxy.hpp"
 #include "caf/io/connection_helper.hpp"
 #include "caf/io/middleman.hpp"
 #include "caf/io/network/interfaces.hpp"
@@ -63,6 +64,9 @@ basp_broker::basp_broker(actor_config& cfg)
     this_context(nullptr) {
   new (&instance) basp::instance(this, *this);
   CAF_ASSERT(this_node() != none);
+  serialize_on_send = get_or(config(), "middleman.serialize-on-send", false);
+  max_batch_delay = get_or(config(), "middleman.max-batch-delay",
+                           defaults::middleman::max_batch_delay);
 }
 
 basp_broker::~basp_broker() {
@@ -84,6 +88,17 @@ void basp_broker::on_exit() {
       if (auto hdl = actor_cast<actor>(observer))
         anon_send(hdl, node_down_msg{node, error{}});
   node_observers.clear();
+  // Reject any message that proxies try to serialize from now on.
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{outbound_queues_mtx};
+    for (auto& kvp : outbound_queues)
+      kvp.second->close();
+    outbound_queues.clear();
+  }
+  { // Lifetime scope of guard.
+    std::unique_lock<std::mutex> guard{compressions_mtx};
+    compressions.clear();
+  }
   // Release any obsolete state.
   ctx.clear();
   // Make sure all spawn servers are down before clearing the container.
@@ -265,7 +280,7 @@ behavior basp_broker::make_behavior() {
       // sending us a message through the queue. This message gets
       // delivered only after all received messages up to this point were
       // deserialized and delivered.
-      auto& q = instance.queue();
+      auto& q = instance.queue_for(msg.handle);
       auto msg_id = q.new_id();
       q.push(context(), msg_id, ctrl(),
              make_mailbox_element(nullptr, make_message_id(), {}, delete_atom_v,
@@ -376,6 +391,15 @@ behavior basp_broker::make_behavior() {
       }
       return {x, std::move(addr), port};
     },
+    // received from ourselves after starting a new batch
+    [=](flush_atom, connection_handle hdl) {
+      auto i = ctx.find(hdl);
+      if (i == ctx.end() || i->second.batch == nullptr)
+        return;
+      i->second.batch->timeout_pending(false);
+      if (!i->second.batch->empty())
+        flush(hdl);
+    },
     [=](tick_atom, size_t interval) {
       instance.handle_heartbeat(context());
       delayed_send(this, std::chrono::milliseconds{interval}, tick_atom_v,
@@ -394,6 +418,10 @@ resumable::resume_result basp_broker::resume(execution_unit* ctx, size_t mt) {
   return super::resume(ctx, mt);
 }
 
+network::multiplexer& basp_broker::next_io_backend() {
+  return system().middleman().next_backend();
+}
+
 strong_actor_ptr basp_broker::make_proxy(node_id nid, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid));
   CAF_ASSERT(nid != this_node());
@@ -411,17 +439,28 @@ strong_actor_ptr basp_broker::make_proxy(node_id nid, actor_id aid) {
   // create proxy and add functor that will be called if we
   // receive a basp::down_message
   actor_config cfg;
-  auto res = make_actor<forwarding_actor_proxy, strong_actor_ptr>(
-    aid, nid, &(system()), cfg, this);
+  basp::outbound_queue_ptr queue;
+  if (serialize_on_send) {
+    std::unique_lock<std::mutex> guard{outbound_queues_mtx};
+    auto i = outbound_queues.find(nid);
+    if (i != outbound_queues.end())
+      queue = i->second;
+  }
+  auto res = queue != nullptr
+               ? make_actor<basp::serializing_proxy, strong_actor_ptr>(
+                 aid, nid, &(system()), cfg, this, std::move(queue))
+               : make_actor<forwarding_actor_proxy, strong_actor_ptr>(
+                 aid, nid, &(system()), cfg, this);
   strong_actor_ptr selfptr{ctrl()};
   res->get()->attach_functor([=](const error& rsn) {
     mm->backend().post([=] {
-      // using res->id() instead of aid keeps this actor instance alive
+      // using res instead of aid keeps this actor instance alive
       // until the original instance terminates, thus preventing subtle
-      // bugs with attachables
+      // bugs with attachables; it also leaves other proxies for the same
+      // actor alone, e.g., after get_or_put discarded this proxy
       auto bptr = static_cast<basp_broker*>(selfptr->get());
       if (!bptr->getf(abstract_actor::is_terminated_flag))
-        bptr->proxies().erase(nid, res->id(), rsn);
+        bptr->proxies().erase(nid, res, rsn);
     });
   });
   return res;
@@ -573,6 +612,22 @@ void basp_broker::learned_new_node(const node_id& nid) {
 void basp_broker::learned_new_node_directly(const node_id& nid,
                                             bool was_indirectly_before) {
   CAF_LOG_TRACE(CAF_ARG(nid));
+  if (serialize_on_send) {
+    // Allow proxies for `nid` to bypass our mailbox.
+    if (auto hdl = instance.tbl().lookup_direct(nid)) {
+      auto i = ctx.find(*hdl);
+      if (i != ctx.end()) {
+        auto queue = make_counted<basp::outbound_queue>(
+          this, *hdl, i->second.payload_compression);
+        i->second.outbound = queue;
+        std::unique_lock<std::mutex> guard{outbound_queues_mtx};
+        auto& entry = outbound_queues[nid];
+        if (entry != nullptr)
+          entry->close();
+        entry = std::move(queue);
+      }
+    }
+  }
   if (!was_indirectly_before)
     learned_new_node(nid);
 }
@@ -639,15 +694,44 @@ void basp_broker::connection_cleanup(connection_handle hdl, sec code) {
       auto x = code != sec::none ? code : sec::disconnect_during_handshake;
       ref.callback->deliver(x);
     }
+    if (ref.outbound != nullptr) {
+      ref.outbound->close();
+      std::unique_lock<std::mutex> guard{outbound_queues_mtx};
+      auto j = outbound_queues.find(ref.id);
+      if (j != outbound_queues.end() && j->second == ref.outbound)
+        outbound_queues.erase(j);
+    }
+    if (ref.payload_compression != nullptr) {
+      std::unique_lock<std::mutex> guard{compressions_mtx};
+      auto j = compressions.find(ref.id);
+      if (j != compressions.end() && j->second == ref.payload_compression)
+        compressions.erase(j);
+    }
     ctx.erase(i);
   }
 }
 
 byte_buffer& basp_broker::get_buffer(connection_handle hdl) {
+  // Append messages that senders serialized on their own thread as well as
+  // coalesced messages first to make sure that no message overtakes any
+  // message sent earlier.
+  auto i = ctx.find(hdl);
+  if (i != ctx.end()) {
+    auto& ref = i->second;
+    if (ref.outbound != nullptr)
+      ref.outbound->drain();
+    if (ref.batch != nullptr && !ref.batch->empty())
+      ref.batch->write_to(context(), wr_buf(hdl),
+                          ref.payload_compression.get());
+  }
   return wr_buf(hdl);
 }
 
 void basp_broker::flush(connection_handle hdl) {
+  auto i = ctx.find(hdl);
+  if (i != ctx.end() && i->second.batch != nullptr
+      && !i->second.batch->empty())
+    get_buffer(hdl);
   super::flush(hdl);
 }
 
@@ -663,4 +747,73 @@ strong_actor_ptr basp_broker::this_actor() {
   return ctrl();
 }
 
+void basp_broker::enable_compression(connection_handle hdl, const node_id& nid,
+                                     basp::compression_ptr ptr) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(nid));
+  auto i = ctx.find(hdl);
+  if (i == ctx.end())
+    return;
+  i->second.payload_compression = ptr;
+  std::unique_lock<std::mutex> guard{compressions_mtx};
+  compressions[nid] = std::move(ptr);
+}
+
+basp::compression* basp_broker::compression_for(connection_handle hdl) {
+  auto i = ctx.find(hdl);
+  if (i != ctx.end())
+    return i->second.payload_compression.get();
+  return nullptr;
+}
+
+void basp_broker::enable_batching(connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(hdl));
+  // Proxies bypass the broker when serializing on the sending thread. Hence,
+  // coalescing the remaining messages in the broker would only risk
+  // reordering.
+  if (serialize_on_send)
+    return;
+  auto i = ctx.find(hdl);
+  if (i != ctx.end() && i->second.batch == nullptr)
+    i->second.batch = std::make_unique<basp::message_batch>();
+}
+
+basp::message_batch* basp_broker::batch_for(connection_handle hdl) {
+  auto i = ctx.find(hdl);
+  if (i != ctx.end())
+    return i->second.batch.get();
+  return nullptr;
+}
+
+void basp_broker::batch_started(connection_handle hdl) {
+  auto batch = batch_for(hdl);
+  if (batch == nullptr || batch->timeout_pending())
+    return;
+  batch->timeout_pending(true);
+  if (max_batch_delay.count() > 0)
+    delayed_send(this, max_batch_delay, flush_atom_v, hdl);
+  else
+    send(this, flush_atom_v, hdl);
+}
+
+detail::message_shape_cache*
+basp_broker::shape_cache_for(connection_handle hdl) {
+  auto i = ctx.find(hdl);
+  if (i == ctx.end())
+    return nullptr;
+  auto& ptr = i->second.shapes;
+  if (ptr == nullptr)
+    ptr = make_counted<detail::message_shape_cache>();
+  return ptr.get();
+}
+
+basp::message_queue* basp_broker::queue_for(connection_handle hdl) {
+  auto i = ctx.find(hdl);
+  if (i == ctx.end())
+    return nullptr;
+  auto& ptr = i->second.queue;
+  if (ptr == nullptr)
+    ptr = make_counted<basp::message_queue>();
+  return ptr.get();
+}
+
 } // namespace caf::io
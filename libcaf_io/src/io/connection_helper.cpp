@@ -58,10 +58,11 @@ connection_helper(stateful_actor<connection_helper_state>* self, actor b) {
       message_handler f{
         [&](uint16_t port, network::address_listing& addresses) {
           if (item == "basp.default-connectivity-tcp") {
-            auto& mx = self->system().middleman().backend();
+            auto& mm = self->system().middleman();
             for (auto& kvp : addresses) {
               for (auto& addr : kvp.second) {
-                auto hdl = mx.new_tcp_scribe(addr, port);
+                auto hdl = mm.backend().new_tcp_scribe(addr, port,
+                                                       mm.next_backend());
                 if (hdl) {
                   // gotcha! send scribe to our BASP broker
                   // to initiate handshake etc.
@@ -18,6 +18,7 @@
 
 #include "caf/io/middleman.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <memory>
@@ -41,6 +42,7 @@
 #include "caf/function_view.hpp"
 #include "caf/init_global_meta_objects.hpp"
 #include "caf/io/basp/header.hpp"
+#include "caf/io/basp/lz4_codec.hpp"
 #include "caf/io/basp_broker.hpp"
 #include "caf/io/network/default_multiplexer.hpp"
 #include "caf/io/network/interfaces.hpp"
@@ -67,16 +69,30 @@ namespace {
 template <class T>
 class mm_impl : public middleman {
 public:
-  mm_impl(actor_system& ref) : middleman(ref), backend_(&ref) {
-    // nop
+  explicit mm_impl(actor_system& ref, size_t num_backends = 1)
+    : middleman(ref), backend_(&ref) {
+    for (size_t i = 1; i < num_backends; ++i)
+      extra_backends_.emplace_back(std::make_unique<T>(&ref));
   }
 
   network::multiplexer& backend() override {
     return backend_;
   }
 
+  size_t num_backends() override {
+    return extra_backends_.size() + 1;
+  }
+
+  network::multiplexer& backend(size_t index) override {
+    CAF_ASSERT(index < num_backends());
+    if (index == 0)
+      return backend_;
+    return *extra_backends_[index - 1];
+  }
+
 private:
   T backend_;
+  std::vector<std::unique_ptr<T>> extra_backends_;
 };
 
 } // namespace
@@ -90,12 +106,33 @@ actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
                      defaults::middleman::network_backend);
   if (impl == "testing")
     return new mm_impl<network::test_multiplexer>(sys);
-  else
-    return new mm_impl<network::default_multiplexer>(sys);
+  // Without a background thread, only the first multiplexer would ever run.
+  auto n = get_or(sys.config(), "middleman.multiplexers",
+                  defaults::middleman::multiplexers);
+  if (get_or(sys.config(), "middleman.manual-multiplexing", false))
+    n = 1;
+  return new mm_impl<network::default_multiplexer>(sys, std::max(n, size_t{1}));
 }
 
-middleman::middleman(actor_system& sys) : system_(sys) {
-  // nop
+middleman::middleman(actor_system& sys) : system_(sys), next_backend_(0) {
+  add_codec(std::make_shared<basp::lz4_codec>());
+}
+
+size_t middleman::num_backends() {
+  return 1;
+}
+
+network::multiplexer& middleman::backend(size_t index) {
+  CAF_IGNORE_UNUSED(index);
+  CAF_ASSERT(index == 0);
+  return backend();
+}
+
+network::multiplexer& middleman::next_backend() {
+  auto n = num_backends();
+  if (n == 1)
+    return backend();
+  return backend(next_backend_.fetch_add(1, std::memory_order_relaxed) % n);
 }
 
 expected<strong_actor_ptr>
@@ -270,31 +307,35 @@ strong_actor_ptr middleman::remote_lookup(std::string name,
 
 void middleman::start() {
   CAF_LOG_TRACE("");
-  // Launch backend.
+  // Launch backends.
   if (!get_or(config(), "middleman.manual-multiplexing", false))
-    backend_supervisor_ = backend().make_supervisor();
+    for (size_t i = 0; i < num_backends(); ++i)
+      backend_supervisors_.emplace_back(backend(i).make_supervisor());
   // The only backend that returns a `nullptr` by default is the
   // `test_multiplexer` which does not have its own thread but uses the main
   // thread instead. Other backends can set `middleman_detach_multiplexer` to
   // false to suppress creation of the supervisor.
-  if (backend_supervisor_ != nullptr) {
+  for (size_t i = 0; i < backend_supervisors_.size(); ++i) {
+    if (backend_supervisors_[i] == nullptr)
+      continue;
+    auto mpx = &backend(i);
     std::atomic<bool> init_done{false};
     std::mutex mtx;
     std::condition_variable cv;
-    thread_ = std::thread{[&, this] {
+    threads_.emplace_back([&, mpx, this] {
       CAF_SET_LOGGER_SYS(&system());
       detail::set_thread_name("caf.multiplexer");
       system().thread_started();
       CAF_LOG_TRACE("");
       {
         std::unique_lock<std::mutex> guard{mtx};
-        backend().thread_id(std::this_thread::get_id());
+        mpx->thread_id(std::this_thread::get_id());
         init_done = true;
         cv.notify_one();
       }
-      backend().run();
+      mpx->run();
       system().thread_terminates();
-    }};
+    });
     std::unique_lock<std::mutex> guard{mtx};
     while (init_done == false)
       cv.wait(guard);
@@ -321,9 +362,18 @@ void middleman::stop() {
     }
   });
   if (!get_or(config(), "middleman.manual-multiplexing", false)) {
-    backend_supervisor_.reset();
-    if (thread_.joinable())
-      thread_.join();
+    // Stop the first backend before all others, because closing connections
+    // of the BASP broker posts work to the backends that run their socket I/O.
+    if (!backend_supervisors_.empty() && backend_supervisors_[0] != nullptr) {
+      backend_supervisors_[0].reset();
+      if (!threads_.empty() && threads_[0].joinable())
+        threads_[0].join();
+    }
+    backend_supervisors_.clear();
+    for (auto& t : threads_)
+      if (t.joinable())
+        t.join();
+    threads_.clear();
   } else {
     while (backend().try_run_once())
       ; // nop
@@ -391,6 +441,32 @@ void* middleman::subtype_ptr() {
   return this;
 }
 
+void middleman::add_codec(basp::codec_ptr x) {
+  CAF_ASSERT(x != nullptr);
+  std::unique_lock<std::mutex> guard{codecs_mtx_};
+  auto name = x->name();
+  codecs_[std::string{name.begin(), name.end()}] = std::move(x);
+}
+
+basp::codec_ptr middleman::codec(string_view name) {
+  std::unique_lock<std::mutex> guard{codecs_mtx_};
+  auto i = codecs_.find(std::string{name.begin(), name.end()});
+  if (i != codecs_.end())
+    return i->second;
+  return nullptr;
+}
+
+optional<basp::compression_stats>
+middleman::compression_stats(const node_id& nid) {
+  auto hdl = named_broker<basp_broker>("BASP");
+  auto bb = static_cast<basp_broker*>(actor_cast<abstract_actor*>(hdl));
+  std::unique_lock<std::mutex> guard{bb->compressions_mtx};
+  auto i = bb->compressions.find(nid);
+  if (i != bb->compressions.end())
+    return i->second->stats();
+  return none;
+}
+
 void middleman::monitor(const node_id& node, const actor_addr& observer) {
   auto basp = named_broker<basp_broker>("BASP");
   anon_send(basp, monitor_atom_v, node, observer);
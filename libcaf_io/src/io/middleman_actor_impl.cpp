@@ -245,7 +245,10 @@ middleman_actor_impl::pending(const endpoint& ep) {
 
 expected<scribe_ptr>
 middleman_actor_impl::connect(const std::string& host, uint16_t port) {
-  return system().middleman().backend().new_tcp_scribe(host, port);
+  // The BASP broker runs on the first backend, but connections to other nodes
+  // spread across all backends.
+  auto& mm = system().middleman();
+  return mm.backend().new_tcp_scribe(host, port, mm.next_backend());
 }
 
 expected<datagram_servant_ptr>
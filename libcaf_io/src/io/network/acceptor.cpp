@@ -18,15 +18,25 @@
 
 #include "caf/io/network/acceptor.hpp"
 
+#include <cerrno>
+#include <cstring>
+
 #include "caf/logger.hpp"
 
 namespace caf::io::network {
 
 acceptor::acceptor(default_multiplexer& backend_ref, native_socket sockfd)
-  : event_handler(backend_ref, sockfd), sock_(invalid_native_socket) {
+  : event_handler(backend_ref, sockfd),
+    sock_(invalid_native_socket),
+    replay_(false) {
   // nop
 }
 
+acceptor::~acceptor() {
+  for (auto x : pending_)
+    close_socket(x);
+}
+
 void acceptor::start(acceptor_manager* mgr) {
   CAF_LOG_TRACE(CAF_ARG2("fd", fd_));
   CAF_ASSERT(mgr != nullptr);
@@ -56,4 +66,41 @@ void acceptor::graceful_shutdown() {
   shutdown_both(fd_);
 }
 
+void acceptor::start_read(uring& ring, uint64_t user_data) {
+  // Hand out the connections that arrived while passive before accepting more.
+  if (!pending_.empty()) {
+    replay_ = true;
+    ring.nop(user_data);
+  } else {
+    ring.accept(fd(), user_data);
+  }
+}
+
+void acceptor::read_completed(const uring::completion& x, const byte*) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", fd_) << CAF_ARG2("res", x.res));
+  if (replay_) {
+    replay_ = false;
+    size_t n = 0;
+    for (; n < pending_.size() && !state_.passive; ++n) {
+      sock_ = pending_[n];
+      mgr_->new_connection();
+    }
+    pending_.erase(pending_.begin(),
+                   pending_.begin() + static_cast<ptrdiff_t>(n));
+    return;
+  }
+  if (x.res >= 0) {
+    auto sockfd = static_cast<native_socket>(x.res);
+    if (state_.passive || !pending_.empty()) {
+      pending_.emplace_back(sockfd);
+    } else {
+      sock_ = sockfd;
+      mgr_->new_connection();
+    }
+  } else if (x.res != -ECANCELED) {
+    // Same as with try_accept: errors do not stop the acceptor.
+    CAF_LOG_DEBUG("accept failed:" << strerror(-x.res));
+  }
+}
+
 } // namespace caf::io::network
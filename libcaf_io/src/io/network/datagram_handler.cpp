@@ -19,6 +19,8 @@
 #include "caf/io/network/datagram_handler.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/config_value.hpp"
@@ -43,7 +45,8 @@ datagram_handler::datagram_handler(default_multiplexer& backend_ref,
                                   defaults::middleman::max_consecutive_reads)),
     max_datagram_size_(receive_buffer_size),
     rd_buf_(receive_buffer_size),
-    send_buffer_size_(0) {
+    send_buffer_size_(0),
+    rd_replay_(false) {
   allow_udp_connreset(sockfd, false);
   auto es = send_buffer_size(sockfd);
   if (!es)
@@ -152,6 +155,78 @@ void datagram_handler::graceful_shutdown() {
   // registered for reading or writing.
 }
 
+void datagram_handler::start_read(uring& ring, uint64_t user_data) {
+  // Deliver the datagrams that arrived while passive before receiving more.
+  if (!rd_pending_.empty()) {
+    rd_replay_ = true;
+    ring.nop(user_data);
+  } else {
+    ring.recvmsg(fd(), user_data);
+  }
+}
+
+void datagram_handler::start_write(uring& ring, uint64_t user_data) {
+  auto itr = ep_by_hdl_.find(wr_buf_.first);
+  if (itr == ep_by_hdl_.end())
+    CAF_RAISE_ERROR("got write event for undefined endpoint");
+  auto& buf = wr_buf_.second;
+  auto size_as_int = static_cast<int>(buf.size());
+  if (size_as_int > send_buffer_size_) {
+    send_buffer_size_ = size_as_int;
+    send_buffer_size(fd(), size_as_int);
+  }
+  span<const byte> bytes{buf.data(), buf.size()};
+  ring.sendmsg(fd(), &bytes, 1, &itr->second, user_data);
+}
+
+void datagram_handler::read_completed(const uring::completion& x,
+                                      const byte* buf) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", fd_) << CAF_ARG2("res", x.res));
+  if (rd_replay_) {
+    rd_replay_ = false;
+    while (!rd_pending_.empty() && !state_.passive) {
+      auto& [sender, payload] = rd_pending_.front();
+      deliver(sender, payload);
+      rd_pending_.pop_front();
+    }
+    return;
+  }
+  if (x.res > 0 && buf != nullptr) {
+    ip_endpoint sender;
+    span<const byte> payload;
+    if (!uring::unpack_datagram(x, buf, sender, payload))
+      CAF_LOG_WARNING("recvmsg cut off a datagram after"
+                      << payload.size() << "bytes");
+    if (state_.passive || !rd_pending_.empty())
+      rd_pending_.emplace_back(sender,
+                               byte_buffer{payload.begin(), payload.end()});
+    else
+      deliver(sender, payload);
+    return;
+  }
+  // The multiplexer restarts requests that the kernel has stopped for running
+  // out of buffers and cancels requests only after the handler became passive.
+  if (x.res == -ECANCELED || x.res == -ENOBUFS)
+    return;
+  CAF_LOG_ERROR("recvmsg failed:" << strerror(-x.res));
+  if (!state_.passive)
+    handle_read_result(false);
+}
+
+void datagram_handler::write_completed(const uring::completion& x) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", fd_) << CAF_ARG2("res", x.res));
+  // The multiplexer only cancels writes after removing the handler.
+  if (x.res == -ECANCELED)
+    return;
+  if (x.res < 0)
+    CAF_LOG_ERROR("sendmsg failed:" << strerror(-x.res));
+  auto id = wr_buf_.first;
+  byte_buffer buf;
+  std::swap(buf, wr_buf_.second);
+  auto wb = x.res > 0 ? static_cast<size_t>(x.res) : size_t{0};
+  handle_write_result(x.res >= 0, id, buf, wb);
+}
+
 void datagram_handler::prepare_next_read() {
   CAF_LOG_TRACE(CAF_ARG(wr_buf_.second.size())
                 << CAF_ARG(wr_offline_buf_.size()));
@@ -176,6 +251,8 @@ bool datagram_handler::handle_read_result(bool read_result) {
     passivate();
     return false;
   }
+  // The last read decides whether the socket may have more input.
+  state_.readable = num_bytes_ > 0;
   if (num_bytes_ > 0) {
     rd_buf_.resize(num_bytes_);
     auto itr = hdl_by_ep_.find(sender_);
@@ -205,11 +282,21 @@ void datagram_handler::handle_write_result(bool write_result,
       writer_->datagram_sent(&backend(), id, wb, std::move(buf));
     prepare_next_write();
   } else {
+    if (!buf.empty())
+      state_.writable = false;
     if (writer_)
       writer_->io_failure(&backend(), operation::write);
   }
 }
 
+void datagram_handler::deliver(const ip_endpoint& sender,
+                               span<const byte> payload) {
+  sender_ = sender;
+  num_bytes_ = std::min(payload.size(), rd_buf_.size());
+  memcpy(rd_buf_.data(), payload.data(), num_bytes_);
+  handle_read_result(true);
+}
+
 void datagram_handler::handle_error() {
   if (reader_)
     reader_->io_failure(&backend(), operation::read);
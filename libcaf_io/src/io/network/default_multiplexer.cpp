@@ -18,6 +18,7 @@
 
 #include "caf/io/network/default_multiplexer.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "caf/actor_system_config.hpp"
@@ -32,6 +33,7 @@
 #include "caf/io/network/doorman_impl.hpp"
 #include "caf/io/network/interfaces.hpp"
 #include "caf/io/network/protocol.hpp"
+#include "caf/io/network/relay_scribe.hpp"
 #include "caf/io/network/scribe_impl.hpp"
 
 #include "caf/detail/call_cfun.hpp"
@@ -133,13 +135,58 @@ const event_mask_type input_mask = POLLIN;
 const event_mask_type input_mask = POLLIN | POLLPRI;
 #  endif
 const event_mask_type error_mask = POLLRDHUP | POLLERR | POLLHUP | POLLNVAL;
+const event_mask_type error_queue_mask = POLLERR;
 const event_mask_type output_mask = POLLOUT;
 #else
 const event_mask_type input_mask = EPOLLIN;
 const event_mask_type error_mask = EPOLLRDHUP | EPOLLERR | EPOLLHUP;
+const event_mask_type error_queue_mask = EPOLLERR;
 const event_mask_type output_mask = EPOLLOUT;
 #endif
 
+namespace {
+
+#ifdef CAF_EPOLL_MULTIPLEXER
+
+// Upper bound for the number of events we fetch with a single epoll_wait.
+constexpr size_t max_pollset_size = 1024;
+
+// Number of requests the io_uring backend can queue before submitting.
+constexpr unsigned uring_queue_size = 256;
+
+// Number of registered buffers for receive requests of the io_uring backend.
+constexpr unsigned uring_num_buffers = 64;
+
+// Size of a registered buffer. Large enough for any UDP datagram plus the
+// header and the sender address that the kernel puts in front of it.
+constexpr size_t uring_buffer_size = 64 * 1024 + 256;
+
+// Sockets stay registered for all events when using io_uring.
+constexpr uint32_t uring_poll_mask = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+
+// Distinguishes the requests of a socket in their user data.
+enum uring_request : uint64_t {
+  uring_poll_request,
+  uring_read_request,
+  uring_write_request,
+};
+
+// Generations occupy the upper 30 bits of the user data.
+constexpr uint32_t uring_generation_mask = 0x3FFFFFFF;
+
+// Tags requests with the socket, the type of the request and a generation
+// counter to filter completions for sockets that we have removed in the
+// meantime.
+uint64_t uring_user_data(native_socket fd, uint32_t generation,
+                         uring_request type = uring_poll_request) {
+  return (static_cast<uint64_t>(generation) << 34) | (type << 32)
+         | static_cast<uint32_t>(fd);
+}
+
+#endif // CAF_EPOLL_MULTIPLEXER
+
+} // namespace
+
 // -- Platform-dependent abstraction over epoll() or poll() --------------------
 
 #ifdef CAF_EPOLL_MULTIPLEXER
@@ -151,21 +198,51 @@ default_multiplexer::default_multiplexer(actor_system* sys)
   : multiplexer(sys),
     epollfd_(invalid_native_socket),
     shadow_(1),
+    edge_triggered_(false),
+    uring_requests_(0),
     pipe_reader_(*this),
     servant_ids_(0),
     max_throughput_(0) {
   init();
-  epollfd_ = epoll_create1(EPOLL_CLOEXEC);
-  if (epollfd_ == -1) {
-    CAF_LOG_ERROR("epoll_create1: " << strerror(errno));
-    exit(errno);
+  auto backend = get_or(system().config(), "middleman.network-backend",
+                        defaults::middleman::network_backend);
+  if (backend == "io_uring") {
+    uring_ = uring::make(uring_queue_size, uring_num_buffers,
+                         uring_buffer_size);
+    if (uring_ == nullptr)
+      CAF_LOG_WARNING("io_uring not available, fall back to epoll");
   }
-  // handle at most 64 events at a time
+  if (uring_ != nullptr) {
+    // Handlers that cannot perform their I/O via completions fall back to
+    // multishot poll requests. These have the same semantics as
+    // edge-triggered epoll, i.e., handlers need to track the readiness of
+    // their socket.
+    edge_triggered_ = true;
+  } else {
+    epollfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd_ == -1) {
+      CAF_LOG_ERROR("epoll_create1: " << strerror(errno));
+      exit(errno);
+    }
+    edge_triggered_ = get_or(system().config(),
+                             "middleman.epoll-edge-triggered", false);
+  }
+  // handle at most 64 events at a time, edge-triggered mode grows the pollset
+  // on demand
   pollset_.resize(64);
   pipe_ = create_pipe();
   pipe_reader_.init(pipe_.first);
+  // The pipe bypasses handle(), but the ready list checks its event mask.
+  pipe_reader_.eventbf(input_mask);
+  // The pipe reader reads until the pipe runs dry in edge-triggered mode.
+  if (edge_triggered_)
+    nonblocking(pipe_.first, true);
+  if (uring_ != nullptr) {
+    uring_ctl(EPOLL_CTL_ADD, pipe_.first, nullptr);
+    return;
+  }
   epoll_event ee;
-  ee.events = input_mask;
+  ee.events = edge_triggered_ ? input_mask | EPOLLET : input_mask;
   ee.data.ptr = &pipe_reader_;
   if (epoll_ctl(epollfd_, EPOLL_CTL_ADD, pipe_reader_.fd(), &ee) < 0) {
     CAF_LOG_ERROR("epoll_ctl: " << strerror(errno));
@@ -174,12 +251,16 @@ default_multiplexer::default_multiplexer(actor_system* sys)
 }
 
 bool default_multiplexer::poll_once_impl(bool block) {
+  if (uring_ != nullptr)
+    return poll_once_uring(block);
   CAF_LOG_TRACE("epoll()-based multiplexer");
   CAF_ASSERT(block == false || internally_posted_.empty());
   // Keep running in case of `EINTR`.
   for (;;) {
+    // Never block while handlers on the ready list wait for their next turn.
+    auto timeout = block && ready_.empty() ? -1 : 0;
     int presult = epoll_wait(epollfd_, pollset_.data(),
-                             static_cast<int>(pollset_.size()), block ? -1 : 0);
+                             static_cast<int>(pollset_.size()), timeout);
     CAF_LOG_DEBUG("epoll_wait() on" << shadow_ << "sockets reported" << presult
                                     << "event(s)");
     if (presult < 0) {
@@ -195,6 +276,26 @@ bool default_multiplexer::poll_once_impl(bool block) {
         }
       }
     }
+    if (edge_triggered_) {
+      // Collect readiness of all sockets first and then dispatch each ready
+      // handler once, which includes handlers that did not drain their socket
+      // in a previous round.
+      for (int i = 0; i < presult; ++i) {
+        auto ptr = reinterpret_cast<event_handler*>(pollset_[i].data.ptr);
+        handle_socket_edge(static_cast<int>(pollset_[i].events), ptr);
+      }
+      if (static_cast<size_t>(presult) == pollset_.size()
+          && pollset_.size() < max_pollset_size)
+        pollset_.resize(pollset_.size() * 2);
+      if (ready_.empty()) {
+        if (presult == 0)
+          return false;
+      } else {
+        handle_ready_list();
+      }
+      handle_internal_events();
+      return true;
+    }
     if (presult == 0)
       return false;
     auto iter = pollset_.begin();
@@ -211,7 +312,9 @@ bool default_multiplexer::poll_once_impl(bool block) {
 
 void default_multiplexer::run() {
   CAF_LOG_TRACE("epoll()-based multiplexer");
-  while (shadow_ > 0)
+  // Canceled requests still refer to the memory of their handler until they
+  // complete.
+  while (shadow_ > 0 || uring_requests_ > 0)
     poll_once(true);
 }
 
@@ -237,17 +340,38 @@ void default_multiplexer::handle(const default_multiplexer::event& e) {
                                               << " from epoll");
     op = EPOLL_CTL_DEL;
     --shadow_;
+    // Make sure we never dispatch a handler after removing it.
+    auto ptr = e.ptr != nullptr ? e.ptr : &pipe_reader_;
+    if (ptr->ready()) {
+      ready_.erase(std::find(ready_.begin(), ready_.end(), ptr));
+      ptr->ready(false);
+    }
+    ptr->readable(false);
+    ptr->writable(false);
   } else if (old == 0) {
     CAF_LOG_DEBUG("attempt to add socket " << CAF_ARG(e.fd) << " to epoll");
     op = EPOLL_CTL_ADD;
     ++shadow_;
+    // In edge-triggered mode, we register all events once and keep them until
+    // removing the socket. Adding a socket reports its current state.
+    if (edge_triggered_)
+      ee.events = input_mask | output_mask | error_mask | EPOLLET;
+  } else if (edge_triggered_) {
+    CAF_LOG_DEBUG("change event mask for socket without calling epoll_ctl "
+                  << CAF_ARG(e.fd) << ": " << CAF_ARG(old) << " -> "
+                  << CAF_ARG(e.mask));
+    // The socket won't trigger again if it already became ready before.
+    add_to_ready_list(e.ptr);
+    op = 0;
   } else {
     CAF_LOG_DEBUG("modify epoll event mask for socket "
                   << CAF_ARG(e.fd) << ": " << CAF_ARG(old) << " -> "
                   << CAF_ARG(e.mask));
     op = EPOLL_CTL_MOD;
   }
-  if (epoll_ctl(epollfd_, op, e.fd, &ee) < 0) {
+  if (uring_ != nullptr) {
+    uring_ctl(op, e.fd, e.ptr);
+  } else if (op != 0 && epoll_ctl(epollfd_, op, e.fd, &ee) < 0) {
     switch (last_socket_error()) {
       // supplied file descriptor is already registered
       case EEXIST:
@@ -272,6 +396,9 @@ void default_multiplexer::handle(const default_multiplexer::event& e) {
   if (e.ptr) {
     auto remove_from_loop_if_needed = [&](int flag, operation flag_op) {
       if ((old & flag) && !(e.mask & flag)) {
+        // Pending requests still refer to the handler.
+        if (uring_ != nullptr && uring_release_later(e.fd, flag_op))
+          return;
         e.ptr->removed_from_loop(flag_op);
       }
     };
@@ -284,6 +411,267 @@ size_t default_multiplexer::num_socket_handlers() const noexcept {
   return shadow_;
 }
 
+bool default_multiplexer::poll_once_uring(bool block) {
+  CAF_LOG_TRACE("io_uring-based multiplexer");
+  CAF_ASSERT(block == false || internally_posted_.empty());
+  // Submit all queued changes with the same system call that waits for new
+  // events. Never block while the ready list is not empty.
+  if (!uring_->submit(block && ready_.empty() ? 1 : 0))
+    CAF_CRITICAL("io_uring_enter failed");
+  size_t num_events = 0;
+  uring::completion cqe;
+  while (uring_->next(cqe)) {
+    // Skip completions of poll_remove and cancel requests.
+    if (cqe.user_data == 0)
+      continue;
+    auto fd = static_cast<native_socket>(cqe.user_data & 0xFFFFFFFF);
+    auto type = static_cast<uring_request>((cqe.user_data >> 32) & 0x3);
+    auto generation = static_cast<uint32_t>(cqe.user_data >> 34);
+    auto index = static_cast<size_t>(fd);
+    // Skip completions for sockets that we have removed in the meantime.
+    if (index >= uring_entries_.size()
+        || uring_entries_[index].ptr == nullptr
+        || uring_entries_[index].generation != generation) {
+      uring_->recycle(cqe);
+      continue;
+    }
+    ++num_events;
+    if (type != uring_poll_request) {
+      handle_completion(cqe);
+      continue;
+    }
+    auto ptr = uring_entries_[index].ptr;
+    if (cqe.res < 0) {
+      CAF_LOG_DEBUG("poll request failed:" << CAF_ARG(fd)
+                                           << CAF_ARG2("errno", -cqe.res));
+      handle_socket_edge(EPOLLERR, ptr);
+      continue;
+    }
+    // The kernel may terminate multishot requests, e.g., when running out of
+    // space in the completion queue.
+    if ((cqe.flags & uring::more_flag) == 0)
+      uring_->poll_add(fd, uring_poll_mask, cqe.user_data);
+    handle_socket_edge(cqe.res, ptr);
+  }
+  if (ready_.empty()) {
+    if (num_events == 0)
+      return false;
+  } else {
+    handle_ready_list();
+  }
+  handle_internal_events();
+  return true;
+}
+
+void default_multiplexer::uring_ctl(int op, native_socket fd,
+                                    event_handler* ptr) {
+  auto index = static_cast<size_t>(fd);
+  if (index >= uring_entries_.size())
+    uring_entries_.resize(index + 1, uring_entry{});
+  auto& entry = uring_entries_[index];
+  if (op == EPOLL_CTL_ADD) {
+    if (entry.registered) {
+      CAF_LOG_ERROR("file descriptor registered twice");
+      --shadow_;
+      return;
+    }
+    entry.registered = true;
+    // Handlers may return before their previous requests have completed.
+    if (entry.ptr == nullptr) {
+      entry.ptr = ptr != nullptr ? ptr : &pipe_reader_;
+      entry.completions = entry.ptr->uses_completions();
+      // Generation 0 is reserved for filtering completions of removals.
+      entry.generation = (entry.generation + 1) & uring_generation_mask;
+      if (entry.generation == 0)
+        entry.generation = 1;
+      if (!entry.completions)
+        uring_->poll_add(fd, uring_poll_mask,
+                         uring_user_data(fd, entry.generation));
+    }
+  } else if (op == EPOLL_CTL_DEL) {
+    if (!entry.registered) {
+      CAF_LOG_ERROR("cannot delete file descriptor "
+                    "because it isn't registered");
+      ++shadow_;
+      return;
+    }
+    entry.registered = false;
+    if (!entry.completions) {
+      entry.ptr = nullptr;
+      uring_->poll_remove(uring_user_data(fd, entry.generation));
+      return;
+    }
+  }
+  // Handlers with completions need new requests for their new event mask,
+  // which we queue after handling all events.
+  if (entry.completions && !entry.dirty) {
+    entry.dirty = true;
+    uring_dirty_.emplace_back(fd);
+  }
+}
+
+void default_multiplexer::handle_completion(const uring::completion& x) {
+  auto fd = static_cast<native_socket>(x.user_data & 0xFFFFFFFF);
+  auto type = static_cast<uring_request>((x.user_data >> 32) & 0x3);
+  auto& entry = uring_entries_[static_cast<size_t>(fd)];
+  auto ptr = entry.ptr;
+  CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG2("type", static_cast<int>(type))
+                            << CAF_ARG2("res", x.res));
+  // The kernel may terminate multishot requests at any time, e.g., when
+  // running out of buffers. We restart the request unless the handler has
+  // lost interest in the meantime.
+  if ((x.flags & uring::more_flag) == 0) {
+    if (type == uring_read_request) {
+      entry.reading = false;
+      entry.read_canceled = false;
+    } else {
+      entry.writing = false;
+      entry.write_canceled = false;
+    }
+    --uring_requests_;
+    if (!entry.dirty) {
+      entry.dirty = true;
+      uring_dirty_.emplace_back(fd);
+    }
+  }
+  if (type == uring_read_request) {
+    ptr->read_completed(x, uring_->buffer(x));
+    uring_->recycle(x);
+  } else {
+    ptr->write_completed(x);
+  }
+}
+
+bool default_multiplexer::uring_release_later(native_socket fd,
+                                              operation op) {
+  auto& entry = uring_entries_[static_cast<size_t>(fd)];
+  if (!entry.completions)
+    return false;
+  if (op == operation::read && entry.reading) {
+    entry.release_read = true;
+    return true;
+  }
+  if (op == operation::write && entry.writing) {
+    entry.release_write = true;
+    return true;
+  }
+  return false;
+}
+
+void default_multiplexer::update_uring_requests() {
+  if (uring_dirty_.empty())
+    return;
+  // Releasing handlers may run arbitrary code.
+  std::vector<native_socket> fds;
+  fds.swap(uring_dirty_);
+  for (auto fd : fds) {
+    auto& entry = uring_entries_[static_cast<size_t>(fd)];
+    entry.dirty = false;
+    auto ptr = entry.ptr;
+    if (ptr == nullptr)
+      continue;
+    auto bf = entry.registered ? ptr->eventbf() : 0;
+    auto release_read = false;
+    auto release_write = false;
+    if ((bf & input_mask) != 0) {
+      entry.release_read = false;
+      if (!entry.reading) {
+        entry.reading = true;
+        ++uring_requests_;
+        ptr->start_read(*uring_, uring_user_data(fd, entry.generation,
+                                                 uring_read_request));
+      }
+    } else if (entry.reading) {
+      if (!entry.read_canceled) {
+        entry.read_canceled = true;
+        uring_->cancel(uring_user_data(fd, entry.generation,
+                                       uring_read_request));
+      }
+    } else if (entry.release_read) {
+      entry.release_read = false;
+      release_read = true;
+    }
+    if ((bf & output_mask) != 0) {
+      entry.release_write = false;
+      if (!entry.writing) {
+        entry.writing = true;
+        ++uring_requests_;
+        ptr->start_write(*uring_, uring_user_data(fd, entry.generation,
+                                                  uring_write_request));
+      }
+    } else if (entry.writing) {
+      if (!entry.write_canceled) {
+        entry.write_canceled = true;
+        uring_->cancel(uring_user_data(fd, entry.generation,
+                                       uring_write_request));
+      }
+    } else if (entry.release_write) {
+      entry.release_write = false;
+      release_write = true;
+    }
+    if (!entry.registered && !entry.reading && !entry.writing) {
+      entry.ptr = nullptr;
+      entry.completions = false;
+    }
+    if (release_read)
+      ptr->removed_from_loop(operation::read);
+    if (release_write)
+      ptr->removed_from_loop(operation::write);
+  }
+}
+
+void default_multiplexer::handle_socket_edge(int mask, event_handler* ptr) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", ptr->fd()) << CAF_ARG(mask));
+  CAF_ASSERT(ptr != nullptr);
+  // Sockets also signal errors for notifications in their error queue, e.g.,
+  // after completing MSG_ZEROCOPY sends.
+  if ((mask & error_queue_mask) != 0 && ptr->handle_error_queue())
+    mask &= ~error_queue_mask;
+  if ((mask & input_mask) != 0)
+    ptr->readable(true);
+  if ((mask & output_mask) != 0)
+    ptr->writable(true);
+  // Sockets report all events in edge-triggered mode. Mimic level-triggered
+  // mode by only propagating errors to handlers that have no operation to
+  // discover the error with.
+  if ((mask & ptr->eventbf() & (input_mask | output_mask)) == 0
+      && (mask & error_mask) != 0) {
+    handle_socket_event(ptr->fd(), mask & error_mask, ptr);
+    return;
+  }
+  add_to_ready_list(ptr);
+}
+
+void default_multiplexer::add_to_ready_list(event_handler* ptr) {
+  if (ptr->ready())
+    return;
+  auto bf = ptr->eventbf();
+  if ((ptr->readable() && (bf & input_mask) != 0)
+      || (ptr->writable() && (bf & output_mask) != 0)) {
+    ptr->ready(true);
+    ready_.emplace_back(ptr);
+  }
+}
+
+void default_multiplexer::handle_ready_list() {
+  CAF_LOG_TRACE(CAF_ARG2("ready", ready_.size()));
+  // Handlers that keep some input or output pending re-enter ready_ for the
+  // next round, which keeps a single busy socket from starving the others.
+  ready_cache_.swap(ready_);
+  for (auto ptr : ready_cache_)
+    ptr->ready(false);
+  for (auto ptr : ready_cache_) {
+    auto bf = ptr->eventbf();
+    if (ptr->readable() && (bf & input_mask) != 0
+        && !ptr->read_channel_closed())
+      ptr->handle_event(operation::read);
+    if (ptr->writable() && (bf & output_mask) != 0)
+      ptr->handle_event(operation::write);
+    add_to_ready_list(ptr);
+  }
+  ready_cache_.clear();
+}
+
 #else // CAF_EPOLL_MULTIPLEXER
 
 // Let's be honest: the API of poll() sucks. When dealing with 1000 sockets
@@ -299,7 +687,12 @@ size_t default_multiplexer::num_socket_handlers() const noexcept {
 // i.e., O(1), access the actual object when handling socket events.
 
 default_multiplexer::default_multiplexer(actor_system* sys)
-  : multiplexer(sys), epollfd_(-1), pipe_reader_(*this), servant_ids_(0) {
+  : multiplexer(sys),
+    epollfd_(-1),
+    edge_triggered_(false),
+    uring_requests_(0),
+    pipe_reader_(*this),
+    servant_ids_(0) {
   init();
   // initial setup
   pipe_ = create_pipe();
@@ -559,6 +952,12 @@ void default_multiplexer::handle_socket_event(native_socket fd, int mask,
                                               event_handler* ptr) {
   CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(mask));
   CAF_ASSERT(ptr != nullptr);
+  // Sockets also signal errors for notifications in their error queue, e.g.,
+  // after completing MSG_ZEROCOPY sends. We need to drain the error queue even
+  // for read or write events, because poll and epoll in level-triggered mode
+  // report the error until the queue is empty.
+  if ((mask & error_queue_mask) != 0 && ptr->handle_error_queue())
+    mask &= ~error_queue_mask;
   bool checkerror = true;
   if ((mask & input_mask) != 0) {
     checkerror = false;
@@ -679,6 +1078,25 @@ default_multiplexer::new_tcp_scribe(const std::string& host, uint16_t port) {
   return new_scribe(*fd);
 }
 
+scribe_ptr default_multiplexer::new_scribe(native_socket fd, multiplexer& io) {
+  CAF_LOG_TRACE(CAF_ARG(fd));
+  if (&io == this)
+    return new_scribe(fd);
+  keepalive(fd, true);
+  // All backends of a middleman share the same type.
+  auto& loop = static_cast<default_multiplexer&>(io);
+  return make_counted<relay_scribe>(*this, loop, fd);
+}
+
+expected<scribe_ptr>
+default_multiplexer::new_tcp_scribe(const std::string& host, uint16_t port,
+                                    multiplexer& io) {
+  auto fd = new_tcp_connection(host, port);
+  if (!fd)
+    return std::move(fd.error());
+  return new_scribe(*fd, io);
+}
+
 doorman_ptr default_multiplexer::new_doorman(native_socket fd) {
   CAF_LOG_TRACE(CAF_ARG(fd));
   CAF_ASSERT(fd != network::invalid_native_socket);
@@ -737,6 +1155,10 @@ void default_multiplexer::handle_internal_events() {
   for (auto& e : events_)
     handle(e);
   events_.clear();
+#ifdef CAF_EPOLL_MULTIPLEXER
+  if (uring_ != nullptr)
+    update_uring_requests();
+#endif // CAF_EPOLL_MULTIPLEXER
 }
 
 // -- Related helper functions -------------------------------------------------
@@ -40,7 +40,8 @@ bool doorman_impl::new_connection() {
     // further activities for the broker
     return false;
   auto& dm = acceptor_.backend();
-  auto sptr = dm.new_scribe(acceptor_.accepted_socket());
+  auto sptr = dm.new_scribe(acceptor_.accepted_socket(),
+                            parent()->next_io_backend());
   auto hdl = sptr->hdl();
   parent()->add_scribe(std::move(sptr));
   return doorman::new_connection(&dm, hdl);
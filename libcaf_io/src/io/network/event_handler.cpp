@@ -33,7 +33,8 @@ namespace caf::io::network {
 event_handler::event_handler(default_multiplexer& dm, native_socket sockfd)
   : fd_(sockfd),
     state_{true, false, false, false,
-           to_integer(receive_policy_flag::at_least)},
+           to_integer(receive_policy_flag::at_least), false, false, false,
+           false},
     eventbf_(0),
     backend_(dm) {
   set_fd_flags();
@@ -46,11 +47,37 @@ event_handler::~event_handler() {
   }
 }
 
+bool event_handler::handle_error_queue() {
+  return false;
+}
+
+bool event_handler::uses_completions() const noexcept {
+  return false;
+}
+
+void event_handler::start_read(uring&, uint64_t) {
+  // nop
+}
+
+void event_handler::start_write(uring&, uint64_t) {
+  // nop
+}
+
+void event_handler::read_completed(const uring::completion&, const byte*) {
+  // nop
+}
+
+void event_handler::write_completed(const uring::completion&) {
+  // nop
+}
+
 void event_handler::passivate() {
+  state_.passive = true;
   backend().del(operation::read, fd(), this);
 }
 
 void event_handler::activate() {
+  state_.passive = false;
   backend().add(operation::read, fd(), this);
 }
 
@@ -31,6 +31,15 @@ multiplexer_ptr multiplexer::make(actor_system& sys) {
   return multiplexer_ptr{new default_multiplexer(&sys)};
 }
 
+scribe_ptr multiplexer::new_scribe(native_socket fd, multiplexer&) {
+  return new_scribe(fd);
+}
+
+expected<scribe_ptr> multiplexer::new_tcp_scribe(const std::string& host,
+                                                 uint16_t port, multiplexer&) {
+  return new_tcp_scribe(host, port);
+}
+
 multiplexer_backend* multiplexer::pimpl() {
   return nullptr;
 }
@@ -18,6 +18,8 @@
 
 #include "caf/io/network/native_socket.hpp"
 
+#include <cstring>
+
 #include "caf/logger.hpp"
 #include "caf/sec.hpp"
 
@@ -54,6 +56,9 @@
 #  include <netinet/tcp.h>
 #  include <sys/socket.h>
 #  include <unistd.h>
+#  ifdef CAF_LINUX
+#    include <linux/errqueue.h>
+#  endif
 #endif
 // clang-format on
 
@@ -376,6 +381,59 @@ expected<void> tcp_nodelay(native_socket fd, bool new_value) {
   return unit;
 }
 
+#if defined(CAF_LINUX) && defined(SO_ZEROCOPY)                                \
+  && defined(SO_EE_ORIGIN_ZEROCOPY)
+
+expected<void> zerocopy(native_socket fd, bool new_value) {
+  CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(new_value));
+  int flag = new_value ? 1 : 0;
+  CALL_CFUN(res, detail::cc_zero, "setsockopt",
+            setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &flag,
+                       static_cast<socket_size_type>(sizeof(flag))));
+  return unit;
+}
+
+bool read_zerocopy_completion(native_socket fd, uint32_t& first,
+                              uint32_t& last) {
+  for (;;) {
+    char control[128];
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+      return false;
+    for (auto cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      if ((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+          || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) {
+        sock_extended_err err;
+        std::memcpy(&err, CMSG_DATA(cm), sizeof(err));
+        if (err.ee_origin == SO_EE_ORIGIN_ZEROCOPY && err.ee_errno == 0) {
+          first = err.ee_info;
+          last = err.ee_data;
+          return true;
+        }
+      }
+    }
+  }
+}
+
+#else // CAF_LINUX && SO_ZEROCOPY && SO_EE_ORIGIN_ZEROCOPY
+
+expected<void> zerocopy(native_socket, bool new_value) {
+  if (!new_value)
+    return unit;
+  return make_error(sec::network_syscall_failed, "setsockopt",
+                    "MSG_ZEROCOPY is not available on this platform");
+}
+
+bool read_zerocopy_completion(native_socket, uint32_t&, uint32_t&) {
+  return false;
+}
+
+#endif // CAF_LINUX && SO_ZEROCOPY && SO_EE_ORIGIN_ZEROCOPY
+
 bool is_error(signed_size_type res, bool is_nonblock) {
   if (res < 0) {
     auto err = last_socket_error();
@@ -65,6 +65,8 @@ void pipe_reader::handle_event(operation op) {
     auto ptr = try_read_next();
     if (ptr != nullptr)
       backend().resume({ptr, false});
+    else
+      state_.readable = false;
   }
   // else: ignore errors
 }
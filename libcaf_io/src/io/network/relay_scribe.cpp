@@ -0,0 +1,407 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/relay_scribe.hpp"
+
+#include <algorithm>
+
+#include "caf/logger.hpp"
+#include "caf/make_counted.hpp"
+
+#include "caf/io/network/default_multiplexer.hpp"
+#include "caf/io/network/stream_impl.hpp"
+#include "caf/policy/tcp.hpp"
+
+namespace caf::io::network {
+
+namespace {
+
+/// Number of bytes the I/O multiplexer tries to read at once.
+constexpr size_t read_chunk_size = 64 * 1024;
+
+/// Number of received bytes the I/O multiplexer may post to the broker before
+/// it needs an acknowledgement. Bounds the memory of a slow broker.
+constexpr size_t max_unacked_bytes = 1024 * 1024;
+
+} // namespace
+
+// -- relay_scribe::io_manager -------------------------------------------------
+
+class relay_scribe::io_manager : public stream_manager {
+public:
+  io_manager(default_multiplexer& loop, native_socket sockfd)
+    : stream_(loop, sockfd),
+      enabled_(false),
+      throttled_(false),
+      unacked_(0) {
+    stream_.configure_read(receive_policy::at_most(read_chunk_size));
+  }
+
+  default_multiplexer& loop() noexcept {
+    return stream_.backend();
+  }
+
+  // -- callbacks for the broker -----------------------------------------------
+
+  void start(intrusive_ptr<relay_scribe> relay) {
+    relay_ = std::move(relay);
+  }
+
+  void set_reading(bool enable) {
+    enabled_ = enable;
+    update_reading();
+  }
+
+  void acked(size_t num_bytes) {
+    CAF_ASSERT(num_bytes <= unacked_);
+    unacked_ -= num_bytes;
+    if (throttled_ && unacked_ < max_unacked_bytes) {
+      throttled_ = false;
+      update_reading();
+    }
+  }
+
+  void ack_writes(bool enable) {
+    stream_.ack_writes(enable);
+  }
+
+  void write(std::vector<chunk>& xs) {
+    for (auto& x : xs) {
+      if (x.shared != nullptr)
+        stream_.write(std::move(x.shared));
+      else
+        stream_.write(std::move(x.buf));
+    }
+    stream_.flush(this);
+  }
+
+  void shutdown() {
+    stream_.graceful_shutdown();
+    set_reading(false);
+  }
+
+  void release() {
+    relay_.reset();
+  }
+
+  // -- overridden member functions of stream_manager --------------------------
+
+  bool consume(execution_unit*, const void* buf, size_t num_bytes) override {
+    if (relay_ == nullptr || !enabled_)
+      return false;
+    auto first = reinterpret_cast<const byte*>(buf);
+    byte_buffer xs{first, first + num_bytes};
+    relay_->home_.post([ptr{relay_}, xs{std::move(xs)}]() mutable {
+      ptr->receive(xs);
+    });
+    unacked_ += num_bytes;
+    if (unacked_ >= max_unacked_bytes) {
+      CAF_LOG_DEBUG("stop reading until the broker catches up");
+      throttled_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  void data_transferred(execution_unit*, size_t written,
+                        size_t remaining) override {
+    if (relay_ != nullptr)
+      relay_->home_.post([ptr{relay_}, written, remaining] {
+        ptr->transferred(written, remaining);
+      });
+  }
+
+  void io_failure(execution_unit*, operation op) override {
+    if (relay_ != nullptr)
+      relay_->home_.post([ptr{relay_}, op] { ptr->failed(op); });
+  }
+
+  uint16_t port() const override {
+    auto x = remote_port_of_fd(stream_.fd());
+    return x ? *x : 0;
+  }
+
+  std::string addr() const override {
+    auto x = remote_addr_of_fd(stream_.fd());
+    return x ? std::move(*x) : std::string{};
+  }
+
+  void graceful_shutdown() override {
+    shutdown();
+  }
+
+  void add_to_loop() override {
+    set_reading(true);
+  }
+
+  void remove_from_loop() override {
+    set_reading(false);
+  }
+
+protected:
+  message detach_message() override {
+    return make_message();
+  }
+
+  void detach_from(abstract_broker*) override {
+    // nop
+  }
+
+private:
+  void update_reading() {
+    if (enabled_ && !throttled_)
+      stream_.activate(this);
+    else
+      stream_.passivate();
+  }
+
+  intrusive_ptr<relay_scribe> relay_;
+  stream_impl<policy::tcp> stream_;
+  bool enabled_;
+  bool throttled_;
+  size_t unacked_;
+};
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+relay_scribe::relay_scribe(default_multiplexer& home, default_multiplexer& loop,
+                           native_socket sockfd)
+  : scribe(network::conn_hdl_from_socket(sockfd)),
+    home_(home),
+    launched_(false),
+    active_(true),
+    reading_(false),
+    failed_(false),
+    delivering_(false),
+    rd_flag_(receive_policy_flag::at_most),
+    rd_max_(1024),
+    rd_pos_(0),
+    unacked_(0) {
+  io_ = make_counted<io_manager>(loop, sockfd);
+}
+
+relay_scribe::~relay_scribe() {
+  // nop
+}
+
+// -- overridden member functions of scribe ------------------------------------
+
+void relay_scribe::configure_read(receive_policy::config config) {
+  CAF_LOG_TRACE(CAF_ARG(config));
+  rd_flag_ = config.first;
+  rd_max_ = config.second;
+  if (!launched_)
+    launch();
+  sync_reading();
+  // Calls from inside the broker apply to the next message right away.
+  if (!delivering_ && next_frame_size() > 0)
+    schedule_deliver();
+}
+
+void relay_scribe::ack_writes(bool enable) {
+  CAF_LOG_TRACE(CAF_ARG(enable));
+  io_->loop().post([ptr{io_}, enable] { ptr->ack_writes(enable); });
+}
+
+byte_buffer& relay_scribe::wr_buf() {
+  return wr_buf_;
+}
+
+void relay_scribe::write(byte_buffer buf) {
+  if (buf.empty())
+    return;
+  stage_wr_buf();
+  wr_chunks_.emplace_back(chunk{std::move(buf), nullptr});
+}
+
+void relay_scribe::write(shared_byte_buffer buf) {
+  if (buf == nullptr || buf->empty())
+    return;
+  stage_wr_buf();
+  wr_chunks_.emplace_back(chunk{byte_buffer{}, std::move(buf)});
+}
+
+byte_buffer& relay_scribe::rd_buf() {
+  return rd_buf_;
+}
+
+void relay_scribe::graceful_shutdown() {
+  CAF_LOG_TRACE("");
+  io_->loop().post([ptr{io_}] { ptr->shutdown(); });
+  detach(&home_, false);
+}
+
+void relay_scribe::flush() {
+  CAF_LOG_TRACE(CAF_ARG(wr_buf_.size()));
+  stage_wr_buf();
+  if (wr_chunks_.empty())
+    return;
+  io_->loop().post([ptr{io_}, xs{std::move(wr_chunks_)}]() mutable {
+    ptr->write(xs);
+  });
+  wr_chunks_.clear();
+}
+
+std::string relay_scribe::addr() const {
+  return io_->addr();
+}
+
+uint16_t relay_scribe::port() const {
+  return io_->port();
+}
+
+void relay_scribe::add_to_loop() {
+  CAF_LOG_TRACE("");
+  if (!launched_)
+    launch();
+  active_ = true;
+  sync_reading();
+  if (!delivering_ && (failed_ || next_frame_size() > 0))
+    schedule_deliver();
+}
+
+void relay_scribe::remove_from_loop() {
+  CAF_LOG_TRACE("");
+  active_ = false;
+  sync_reading();
+}
+
+// -- callbacks for the I/O multiplexer ----------------------------------------
+
+void relay_scribe::receive(byte_buffer& buf) {
+  CAF_LOG_TRACE(CAF_ARG2("num_bytes", buf.size()));
+  if (detached())
+    return;
+  unacked_ += buf.size();
+  if (unacked_ >= max_unacked_bytes / 4) {
+    io_->loop().post([ptr{io_}, n{unacked_}] { ptr->acked(n); });
+    unacked_ = 0;
+  }
+  if (rd_pos_ == in_buf_.size()) {
+    in_buf_.swap(buf);
+    rd_pos_ = 0;
+  } else {
+    in_buf_.insert(in_buf_.end(), buf.begin(), buf.end());
+  }
+  deliver();
+}
+
+void relay_scribe::transferred(size_t written, size_t remaining) {
+  data_transferred(&home_, written, remaining);
+}
+
+void relay_scribe::failed(operation op) {
+  CAF_LOG_TRACE(CAF_ARG(op));
+  if (op == operation::read) {
+    failed_ = true;
+    deliver();
+  } else if (!detached()) {
+    io_failure(&home_, op);
+  }
+}
+
+// -- overridden member functions of manager -----------------------------------
+
+void relay_scribe::detach_from(abstract_broker* ptr) {
+  scribe::detach_from(ptr);
+  // Break the cycle between the two sides of the relay.
+  io_->loop().post([ptr{io_}] { ptr->release(); });
+}
+
+// -- private member functions -------------------------------------------------
+
+void relay_scribe::launch() {
+  CAF_ASSERT(!launched_);
+  if (detached())
+    return;
+  launched_ = true;
+  // The I/O multiplexer keeps the relay alive until it detaches.
+  io_->loop().post([ptr{io_}, relay{intrusive_ptr<relay_scribe>{this}}] {
+    ptr->start(relay);
+  });
+}
+
+void relay_scribe::deliver() {
+  if (delivering_)
+    return;
+  delivering_ = true;
+  while (active_ && !detached()) {
+    auto num_bytes = next_frame_size();
+    if (num_bytes == 0)
+      break;
+    auto first = in_buf_.begin() + rd_pos_;
+    rd_buf_.assign(first, first + num_bytes);
+    rd_pos_ += num_bytes;
+    // Same as stream::handle_read_result: the broker stops reading whenever
+    // consume returns false.
+    if (!consume(&home_, rd_buf_.data(), num_bytes))
+      active_ = false;
+  }
+  delivering_ = false;
+  if (rd_pos_ == in_buf_.size()) {
+    in_buf_.clear();
+    rd_pos_ = 0;
+  } else if (rd_pos_ >= in_buf_.size() / 2) {
+    in_buf_.erase(in_buf_.begin(), in_buf_.begin() + rd_pos_);
+    rd_pos_ = 0;
+  }
+  // Report read errors only after the broker consumed all data up to the
+  // error, like a scribe that reads from the socket directly.
+  if (failed_ && active_ && !detached()) {
+    io_failure(&home_, operation::read);
+    return;
+  }
+  sync_reading();
+}
+
+void relay_scribe::schedule_deliver() {
+  home_.post([ptr{intrusive_ptr<relay_scribe>{this}}] { ptr->deliver(); });
+}
+
+size_t relay_scribe::next_frame_size() const noexcept {
+  auto available = in_buf_.size() - rd_pos_;
+  switch (rd_flag_) {
+    case receive_policy_flag::exactly:
+      return available >= rd_max_ ? rd_max_ : 0;
+    case receive_policy_flag::at_most:
+      return std::min(available, rd_max_);
+    case receive_policy_flag::at_least:
+      // Same upper bound as the read buffer of a stream.
+      if (available < rd_max_)
+        return 0;
+      return std::min(available, rd_max_ + std::max<size_t>(100, rd_max_ / 10));
+  }
+  return 0;
+}
+
+void relay_scribe::sync_reading() {
+  auto enable = launched_ && active_ && !failed_ && !detached();
+  if (enable == reading_)
+    return;
+  reading_ = enable;
+  io_->loop().post([ptr{io_}, enable] { ptr->set_reading(enable); });
+}
+
+void relay_scribe::stage_wr_buf() {
+  if (wr_buf_.empty())
+    return;
+  wr_chunks_.emplace_back(chunk{std::move(wr_buf_), nullptr});
+  wr_buf_.clear();
+}
+
+} // namespace caf::io::network
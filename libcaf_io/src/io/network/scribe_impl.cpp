@@ -26,6 +26,9 @@
 
 namespace caf::io::network {
 
+static_assert(has_vectored_write<policy::tcp>::value,
+              "TCP streams must use scatter-gather writes");
+
 scribe_impl::scribe_impl(default_multiplexer& mx, native_socket sockfd)
   : scribe(network::conn_hdl_from_socket(sockfd)),
     launched_(false),
@@ -49,6 +52,14 @@ byte_buffer& scribe_impl::wr_buf() {
   return stream_.wr_buf();
 }
 
+void scribe_impl::write(byte_buffer buf) {
+  stream_.write(std::move(buf));
+}
+
+void scribe_impl::write(shared_byte_buffer buf) {
+  stream_.write(std::move(buf));
+}
+
 byte_buffer& scribe_impl::rd_buf() {
   return stream_.rd_buf();
 }
@@ -19,6 +19,8 @@
 #include "caf/io/network/stream.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 
 #include "caf/actor_system_config.hpp"
 #include "caf/config_value.hpp"
@@ -35,7 +37,15 @@ stream::stream(default_multiplexer& backend_ref, native_socket sockfd)
                                   defaults::middleman::max_consecutive_reads)),
     read_threshold_(1),
     collected_(0),
-    written_(0) {
+    written_(0),
+    zerocopy_threshold_(get_or(backend().system().config(),
+                               "middleman.zerocopy-threshold",
+                               defaults::middleman::zerocopy_threshold)),
+    zerocopy_enabled_(false),
+    zerocopy_next_(0),
+    zerocopy_acked_(0),
+    rd_closed_(false),
+    rd_replay_(false) {
   configure_read(receive_policy::at_most(1024));
 }
 
@@ -49,6 +59,9 @@ void stream::activate(stream_manager* mgr) {
     reader_.reset(mgr);
     event_handler::activate();
     prepare_next_read();
+  } else {
+    // Cancels a pending removal from the event loop after a passivate().
+    event_handler::activate();
   }
 }
 
@@ -64,14 +77,30 @@ void stream::write(const void* buf, size_t num_bytes) {
   wr_offline_buf_.insert(wr_offline_buf_.end(), first, last);
 }
 
+void stream::write(byte_buffer buf) {
+  CAF_LOG_TRACE(CAF_ARG2("num_bytes", buf.size()));
+  if (buf.empty())
+    return;
+  stage_offline_buf();
+  wr_chunks_.emplace_back(std::move(buf));
+}
+
+void stream::write(shared_byte_buffer buf) {
+  if (buf == nullptr || buf->empty())
+    return;
+  CAF_LOG_TRACE(CAF_ARG2("num_bytes", buf->size()));
+  stage_offline_buf();
+  wr_chunks_.emplace_back(std::move(buf));
+}
+
 void stream::flush(const manager_ptr& mgr) {
   CAF_ASSERT(mgr != nullptr);
   CAF_LOG_TRACE(CAF_ARG(wr_offline_buf_.size()));
-  if (!wr_offline_buf_.empty() && !state_.writing) {
+  stage_offline_buf();
+  if (!wr_chunks_.empty() && !state_.writing) {
     backend().add(operation::write, fd(), this);
     writer_ = mgr;
     state_.writing = true;
-    prepare_next_write();
   }
 }
 
@@ -108,6 +137,95 @@ void stream::force_empty_write(const manager_ptr& mgr) {
   }
 }
 
+bool stream::handle_error_queue() {
+  if (!zerocopy_enabled_)
+    return false;
+  auto consumed = false;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  while (read_zerocopy_completion(fd(), first, last)) {
+    consumed = true;
+    zerocopy_ranges_.emplace_back(first, last);
+  }
+  if (!consumed)
+    return false;
+  // Advance to the first send that the kernel has not completed yet.
+  auto predicate = [this](const std::pair<uint32_t, uint32_t>& x) {
+    return x.first == zerocopy_acked_;
+  };
+  auto i = std::find_if(zerocopy_ranges_.begin(), zerocopy_ranges_.end(),
+                        predicate);
+  while (i != zerocopy_ranges_.end()) {
+    zerocopy_acked_ = i->second + 1;
+    zerocopy_ranges_.erase(i);
+    i = std::find_if(zerocopy_ranges_.begin(), zerocopy_ranges_.end(),
+                     predicate);
+  }
+  release_zerocopy_chunks();
+  return true;
+}
+
+void stream::start_read(uring& ring, uint64_t user_data) {
+  // Deliver the input that arrived while passive before receiving more.
+  if (!rd_pending_.empty() || rd_closed_) {
+    rd_replay_ = true;
+    ring.nop(user_data);
+  } else {
+    ring.recv(fd(), user_data);
+  }
+}
+
+void stream::start_write(uring& ring, uint64_t user_data) {
+  // An empty write only reports the state of the output queue to the writer.
+  if (wr_chunks_.empty()) {
+    ring.nop(user_data);
+    return;
+  }
+  span<const byte> bufs[max_write_chunks];
+  auto n = collect_chunks(bufs);
+  ring.sendmsg(fd(), bufs, n, nullptr, user_data);
+}
+
+void stream::read_completed(const uring::completion& x, const byte* buf) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", fd_) << CAF_ARG2("res", x.res));
+  if (rd_replay_) {
+    rd_replay_ = false;
+    deliver_pending();
+    return;
+  }
+  if (x.res > 0) {
+    auto size = static_cast<size_t>(x.res);
+    // Input must not overtake what we have received before.
+    auto n = rd_pending_.empty() ? deliver(buf, size) : 0;
+    rd_pending_.insert(rd_pending_.end(), buf + n, buf + size);
+    return;
+  }
+  // The multiplexer restarts requests that the kernel has stopped for running
+  // out of buffers and cancels requests only after the stream became passive.
+  if (x.res == -ECANCELED || x.res == -ENOBUFS)
+    return;
+  if (x.res < 0)
+    CAF_LOG_DEBUG("recv failed:" << strerror(-x.res));
+  // Reading 0 bytes means the peer has closed the connection. Either way, we
+  // report the failure after delivering all pending input.
+  rd_closed_ = true;
+  if (rd_pending_.empty())
+    deliver_pending();
+}
+
+void stream::write_completed(const uring::completion& x) {
+  CAF_LOG_TRACE(CAF_ARG2("fd", fd_) << CAF_ARG2("res", x.res));
+  // The multiplexer only cancels writes after removing the stream.
+  if (x.res == -ECANCELED)
+    return;
+  if (x.res < 0) {
+    CAF_LOG_DEBUG("sendmsg failed:" << strerror(-x.res));
+    handle_write_result(rw_state::failure, 0);
+    return;
+  }
+  handle_write_result(rw_state::success, static_cast<size_t>(x.res));
+}
+
 void stream::prepare_next_read() {
   collected_ = 0;
   // This cast does nothing, but prevents a weird compiler error on GCC <= 4.9.
@@ -134,17 +252,88 @@ void stream::prepare_next_read() {
   }
 }
 
+void stream::stage_offline_buf() {
+  if (wr_offline_buf_.empty())
+    return;
+  wr_chunks_.emplace_back(std::move(wr_offline_buf_));
+  // Continue with the capacity of a previously written buffer.
+  wr_offline_buf_.clear();
+  wr_offline_buf_.swap(wr_spare_buf_);
+}
+
+size_t stream::collect_chunks(span<const byte>* bufs) const {
+  CAF_ASSERT(!wr_chunks_.empty());
+  size_t n = 0;
+  auto first = wr_chunks_.begin();
+  auto last = wr_chunks_.end();
+  for (auto i = first; i != last && n < max_write_chunks; ++i)
+    bufs[n++] = make_span(i->bytes());
+  bufs[0] = bufs[0].subspan(written_, bufs[0].size() - written_);
+  return n;
+}
+
+bool stream::use_zerocopy(const span<const byte>* bufs, size_t num_bufs) {
+  if (zerocopy_threshold_ == 0)
+    return false;
+  size_t total = 0;
+  for (size_t i = 0; i < num_bufs; ++i)
+    total += bufs[i].size();
+  if (total < zerocopy_threshold_)
+    return false;
+  if (!zerocopy_enabled_) {
+    if (auto res = zerocopy(fd(), true); !res) {
+      CAF_LOG_DEBUG("unable to enable MSG_ZEROCOPY:" << res.error());
+      zerocopy_threshold_ = 0;
+      return false;
+    }
+    zerocopy_enabled_ = true;
+  } else if (zerocopy_acked_ != zerocopy_next_) {
+    // Release buffers early if the multiplexer did not see the error event
+    // yet.
+    handle_error_queue();
+  }
+  return true;
+}
+
+void stream::zerocopy_sent(size_t wb) {
+  auto offset = written_;
+  for (auto& x : wr_chunks_) {
+    x.zerocopy = true;
+    x.last_send = zerocopy_next_;
+    auto n = x.bytes().size() - offset;
+    if (wb <= n)
+      break;
+    wb -= n;
+    offset = 0;
+  }
+  ++zerocopy_next_;
+}
+
+void stream::release_zerocopy_chunks() {
+  // We store chunks in the order of their last send. The cast takes care of
+  // wrapping around.
+  auto completed = [this](const chunk& x) {
+    return static_cast<int32_t>(x.last_send - zerocopy_acked_) < 0;
+  };
+  while (!zerocopy_chunks_.empty() && completed(zerocopy_chunks_.front()))
+    zerocopy_chunks_.pop_front();
+}
+
+size_t stream::pending_bytes() const noexcept {
+  size_t result = 0;
+  for (auto& x : wr_chunks_)
+    result += x.bytes().size();
+  return result - written_;
+}
+
 void stream::prepare_next_write() {
-  CAF_LOG_TRACE(CAF_ARG(wr_buf_.size()) << CAF_ARG(wr_offline_buf_.size()));
-  written_ = 0;
-  wr_buf_.clear();
-  if (wr_offline_buf_.empty()) {
+  CAF_LOG_TRACE(CAF_ARG(wr_chunks_.size()) << CAF_ARG(wr_offline_buf_.size()));
+  stage_offline_buf();
+  if (wr_chunks_.empty()) {
     state_.writing = false;
     backend().del(operation::write, fd(), this);
     if (state_.shutting_down)
       send_fin();
-  } else {
-    wr_buf_.swap(wr_offline_buf_);
   }
 }
 
@@ -155,10 +344,14 @@ bool stream::handle_read_result(rw_state read_result, size_t rb) {
       passivate();
       return false;
     case rw_state::indeterminate:
+      state_.readable = false;
       return false;
     case rw_state::success:
-      if (rb == 0)
+      if (rb == 0) {
+        // Reading would block.
+        state_.readable = false;
         return false;
+      }
       collected_ += rb;
       if (collected_ >= read_threshold_) {
         auto res = reader_->consume(&backend(), rd_buf_.data(), collected_);
@@ -173,6 +366,26 @@ bool stream::handle_read_result(rw_state read_result, size_t rb) {
   return true;
 }
 
+size_t stream::deliver(const byte* data, size_t size) {
+  size_t pos = 0;
+  while (pos < size && !state_.passive) {
+    auto n = std::min(size - pos, rd_buf_.size() - collected_);
+    memcpy(rd_buf_.data() + collected_, data + pos, n);
+    pos += n;
+    if (!handle_read_result(rw_state::success, n))
+      break;
+  }
+  return pos;
+}
+
+void stream::deliver_pending() {
+  auto n = deliver(rd_pending_.data(), rd_pending_.size());
+  rd_pending_.erase(rd_pending_.begin(),
+                    rd_pending_.begin() + static_cast<ptrdiff_t>(n));
+  if (rd_pending_.empty() && rd_closed_ && !state_.passive)
+    handle_read_result(rw_state::failure, 0);
+}
+
 void stream::handle_write_result(rw_state write_result, size_t wb) {
   switch (write_result) {
     case rw_state::failure:
@@ -183,14 +396,35 @@ void stream::handle_write_result(rw_state write_result, size_t wb) {
       prepare_next_write();
       break;
     case rw_state::success:
+      if (wb == 0 && !wr_chunks_.empty()) {
+        // Writing would block.
+        state_.writable = false;
+      }
+      // Drop all chunks that we have written entirely.
       written_ += wb;
-      CAF_ASSERT(written_ <= wr_buf_.size());
-      auto remaining = wr_buf_.size() - written_;
+      while (!wr_chunks_.empty()) {
+        auto& front = wr_chunks_.front();
+        auto size = front.bytes().size();
+        if (written_ < size)
+          break;
+        written_ -= size;
+        if (front.zerocopy) {
+          // The kernel may still read from this buffer.
+          zerocopy_chunks_.emplace_back(std::move(front));
+        } else if (front.shared == nullptr
+                   && front.buf.capacity() > wr_spare_buf_.capacity()) {
+          front.buf.clear();
+          wr_spare_buf_.swap(front.buf);
+        }
+        wr_chunks_.pop_front();
+      }
+      release_zerocopy_chunks();
+      CAF_ASSERT(written_ == 0 || !wr_chunks_.empty());
       if (state_.ack_writes)
         writer_->data_transferred(&backend(), wb,
-                                  remaining + wr_offline_buf_.size());
+                                  pending_bytes() + wr_offline_buf_.size());
       // prepare next send (or stop sending)
-      if (remaining == 0)
+      if (wr_chunks_.empty())
         prepare_next_write();
       break;
   }
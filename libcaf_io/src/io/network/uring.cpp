@@ -0,0 +1,500 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/network/uring.hpp"
+
+#include "caf/config.hpp"
+#include "caf/logger.hpp"
+
+#if defined(CAF_LINUX) && __has_include(<linux/io_uring.h>)
+#  include <linux/io_uring.h>
+// Multishot receive requests require Linux 6.0 headers.
+#  ifdef IORING_RECV_MULTISHOT
+#    define CAF_HAS_IO_URING
+#  endif
+#endif
+
+#ifdef CAF_HAS_IO_URING
+
+#  include <algorithm>
+#  include <cerrno>
+#  include <cstring>
+
+#  include <endian.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+
+namespace caf::io::network {
+
+namespace {
+
+// Maximum number of buffers per sendmsg request.
+constexpr size_t max_iov = 64;
+
+// We only register a single group of buffers.
+constexpr uint16_t buffer_group = 0;
+
+template <class T>
+T* offset(void* ptr, size_t x) {
+  return reinterpret_cast<T*>(reinterpret_cast<char*>(ptr) + x);
+}
+
+void* map_anonymous(size_t size) {
+  auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr != MAP_FAILED ? ptr : nullptr;
+}
+
+// Linux 6.0 added multishot receive requests together with the opcode for
+// zerocopy sends. Only the latter is visible to probes.
+bool supports_multishot_recv(int fd) {
+  constexpr unsigned num_ops = 256;
+  std::vector<char> storage(sizeof(io_uring_probe)
+                            + num_ops * sizeof(io_uring_probe_op));
+  auto probe = reinterpret_cast<io_uring_probe*>(storage.data());
+  if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe,
+              num_ops)
+      < 0)
+    return false;
+  return probe->ops_len > IORING_OP_SEND_ZC
+         && (probe->ops[IORING_OP_SEND_ZC].flags & IO_URING_OP_SUPPORTED) != 0;
+}
+
+} // namespace
+
+struct uring::message {
+  msghdr hdr;
+  iovec iov[max_iov];
+  sockaddr_storage addr;
+};
+
+uring::~uring() {
+  if (bufs_ != nullptr)
+    munmap(bufs_, bufs_size_);
+  if (buf_ring_ != nullptr)
+    munmap(buf_ring_, buf_ring_size_);
+  if (sqes_ != nullptr)
+    munmap(sqes_, sqes_size_);
+  if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_)
+    munmap(cq_ptr_, cq_size_);
+  if (sq_ptr_ != nullptr)
+    munmap(sq_ptr_, sq_size_);
+  if (fd_ != -1)
+    close(fd_);
+}
+
+std::unique_ptr<uring>
+uring::make(unsigned entries, unsigned num_buffers, size_t buffer_size) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  // The multiplexer enters the kernel after each round anyway, so there is no
+  // need to interrupt its thread for completing requests.
+  params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+  auto fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    CAF_LOG_DEBUG("io_uring_setup failed:" << strerror(errno));
+    return nullptr;
+  }
+  std::unique_ptr<uring> result{new uring};
+  result->fd_ = fd;
+  // We re-use message headers after submitting them, which requires the
+  // kernel to copy them right away.
+  if ((params.features & IORING_FEAT_NODROP) == 0
+      || (params.features & IORING_FEAT_SUBMIT_STABLE) == 0
+      || !supports_multishot_recv(fd)) {
+    CAF_LOG_DEBUG("kernel does not support multishot receive requests");
+    return nullptr;
+  }
+  auto& sq_off = params.sq_off;
+  auto& cq_off = params.cq_off;
+  result->sq_size_ = sq_off.array + params.sq_entries * sizeof(unsigned);
+  result->cq_size_ = cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    result->sq_size_ = result->cq_size_
+      = std::max(result->sq_size_, result->cq_size_);
+  auto map = [fd](size_t size, off_t off) -> void* {
+    auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, off);
+    return ptr != MAP_FAILED ? ptr : nullptr;
+  };
+  result->sq_ptr_ = map(result->sq_size_, IORING_OFF_SQ_RING);
+  if (result->sq_ptr_ == nullptr)
+    return nullptr;
+  result->cq_ptr_ = single_mmap ? result->sq_ptr_
+                                : map(result->cq_size_, IORING_OFF_CQ_RING);
+  if (result->cq_ptr_ == nullptr)
+    return nullptr;
+  result->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  result->sqes_ = map(result->sqes_size_, IORING_OFF_SQES);
+  if (result->sqes_ == nullptr)
+    return nullptr;
+  auto sq = result->sq_ptr_;
+  result->sq_head_ = offset<unsigned>(sq, sq_off.head);
+  result->sq_tail_ = offset<unsigned>(sq, sq_off.tail);
+  result->sq_mask_ = offset<unsigned>(sq, sq_off.ring_mask);
+  result->sq_entries_ = offset<unsigned>(sq, sq_off.ring_entries);
+  result->sq_array_ = offset<unsigned>(sq, sq_off.array);
+  auto cq = result->cq_ptr_;
+  result->cq_head_ = offset<unsigned>(cq, cq_off.head);
+  result->cq_tail_ = offset<unsigned>(cq, cq_off.tail);
+  result->cq_mask_ = offset<unsigned>(cq, cq_off.ring_mask);
+  result->cqes_ = offset<void>(cq, cq_off.cqes);
+  if (!result->init_buffers(num_buffers, buffer_size))
+    return nullptr;
+  return result;
+}
+
+// -- requests -----------------------------------------------------------------
+
+void uring::poll_add(native_socket fd, uint32_t mask, uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+#  if __BYTE_ORDER == __BIG_ENDIAN
+  mask = (mask << 16) | (mask >> 16);
+#  endif
+  sqe->poll32_events = mask;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::poll_remove(uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = user_data;
+  sqe->user_data = 0;
+  commit_sqe();
+}
+
+void uring::recv(native_socket fd, uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = buffer_group;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::recvmsg(native_socket fd, uint64_t user_data) {
+  // The kernel reserves room for the sender at the front of each buffer.
+  auto& msg = next_message();
+  msg.hdr.msg_namelen = sizeof(sockaddr_storage);
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&msg.hdr);
+  sqe->len = 1;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = buffer_group;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::accept(native_socket fd, uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_CLOEXEC;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::sendmsg(native_socket fd, const span<const byte>* bufs,
+                    size_t num_bufs, const ip_endpoint* addr,
+                    uint64_t user_data) {
+  auto& msg = next_message();
+  num_bufs = std::min(num_bufs, max_iov);
+  for (size_t i = 0; i < num_bufs; ++i) {
+    msg.iov[i].iov_base = const_cast<byte*>(bufs[i].data());
+    msg.iov[i].iov_len = bufs[i].size();
+  }
+  msg.hdr.msg_iov = msg.iov;
+  msg.hdr.msg_iovlen = num_bufs;
+  if (addr != nullptr) {
+    auto len = std::min(*addr->clength(), sizeof(sockaddr_storage));
+    memcpy(&msg.addr, addr->caddress(), len);
+    msg.hdr.msg_name = &msg.addr;
+    msg.hdr.msg_namelen = static_cast<socklen_t>(len);
+  }
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&msg.hdr);
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::nop(uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_NOP;
+  sqe->fd = -1;
+  sqe->user_data = user_data;
+  commit_sqe();
+}
+
+void uring::cancel(uint64_t user_data) {
+  auto sqe = static_cast<io_uring_sqe*>(acquire_sqe());
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = user_data;
+  sqe->user_data = 0;
+  commit_sqe();
+}
+
+// -- completions --------------------------------------------------------------
+
+bool uring::submit(unsigned min_complete) {
+  // Always pass IORING_ENTER_GETEVENTS to run deferred work for completing
+  // requests, because we set up the ring with IORING_SETUP_COOP_TASKRUN.
+  auto res = syscall(__NR_io_uring_enter, fd_, pending_, min_complete,
+                     IORING_ENTER_GETEVENTS, nullptr, 0);
+  if (res < 0) {
+    switch (errno) {
+      case EINTR:
+      case EAGAIN:
+      case EBUSY:
+        // Interrupted by a signal or the kernel asks us to reap completions
+        // first. Either way, the caller simply tries again later.
+        return true;
+      default:
+        CAF_LOG_ERROR("io_uring_enter failed:" << strerror(errno));
+        return false;
+    }
+  }
+  pending_ -= std::min(pending_, static_cast<unsigned>(res));
+  if (pending_ == 0)
+    used_messages_ = 0;
+  return true;
+}
+
+bool uring::next(completion& x) {
+  auto head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+    return false;
+  auto& cqe = static_cast<io_uring_cqe*>(cqes_)[head & *cq_mask_];
+  x.user_data = cqe.user_data;
+  x.res = cqe.res;
+  x.flags = cqe.flags;
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+const byte* uring::buffer(const completion& x) const noexcept {
+  if ((x.flags & IORING_CQE_F_BUFFER) == 0)
+    return nullptr;
+  return bufs_ + (x.flags >> IORING_CQE_BUFFER_SHIFT) * buf_size_;
+}
+
+void uring::recycle(const completion& x) noexcept {
+  if ((x.flags & IORING_CQE_F_BUFFER) != 0)
+    add_buffer(static_cast<uint16_t>(x.flags >> IORING_CQE_BUFFER_SHIFT));
+}
+
+bool uring::unpack_datagram(const completion& x, const byte* buf,
+                            ip_endpoint& sender,
+                            span<const byte>& payload) {
+  // Each buffer starts with a header, followed by the room for the sender
+  // that we have reserved in `recvmsg` and the payload.
+  io_uring_recvmsg_out out;
+  memcpy(&out, buf, sizeof(out));
+  auto prefix = sizeof(out) + sizeof(sockaddr_storage) + out.controllen;
+  auto name_len = std::min<size_t>(out.namelen, sizeof(sockaddr_storage));
+  memset(sender.address(), 0, sizeof(sockaddr_storage));
+  memcpy(sender.address(), buf + sizeof(out), name_len);
+  *sender.length() = name_len;
+  auto len = static_cast<size_t>(x.res);
+  payload = span<const byte>{buf + prefix, len > prefix ? len - prefix : 0};
+  return (out.flags & MSG_TRUNC) == 0;
+}
+
+// -- utility functions --------------------------------------------------------
+
+void* uring::acquire_sqe() {
+  auto tail = *sq_tail_;
+  auto full = [&] {
+    return tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= *sq_entries_;
+  };
+  if (full() && (!submit(0) || full()))
+    CAF_CRITICAL("unable to flush the io_uring submission queue");
+  auto index = tail & *sq_mask_;
+  auto sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+void uring::commit_sqe() {
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  ++pending_;
+}
+
+uring::message& uring::next_message() {
+  if (used_messages_ == messages_.size())
+    messages_.emplace_back(new message);
+  auto& result = *messages_[used_messages_++];
+  memset(&result, 0, sizeof(message));
+  return result;
+}
+
+bool uring::init_buffers(unsigned num_buffers, size_t buffer_size) {
+  // The kernel requires a power of two for the size of the ring.
+  CAF_ASSERT(num_buffers > 0 && num_buffers <= 32768);
+  CAF_ASSERT((num_buffers & (num_buffers - 1)) == 0);
+  buf_ring_size_ = num_buffers * sizeof(io_uring_buf);
+  buf_ring_ = map_anonymous(buf_ring_size_);
+  if (buf_ring_ == nullptr)
+    return false;
+  // The kernel only touches the pages of buffers that receive data.
+  bufs_size_ = num_buffers * buffer_size;
+  bufs_ = static_cast<byte*>(map_anonymous(bufs_size_));
+  if (bufs_ == nullptr)
+    return false;
+  io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+  reg.ring_entries = num_buffers;
+  reg.bgid = buffer_group;
+  if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1)
+      < 0) {
+    CAF_LOG_DEBUG("unable to register buffers:" << strerror(errno));
+    return false;
+  }
+  buf_size_ = buffer_size;
+  buf_mask_ = static_cast<uint16_t>(num_buffers - 1);
+  for (unsigned id = 0; id < num_buffers; ++id)
+    add_buffer(static_cast<uint16_t>(id));
+  return true;
+}
+
+void uring::add_buffer(uint16_t id) noexcept {
+  auto& buf = static_cast<io_uring_buf*>(buf_ring_)[buf_tail_ & buf_mask_];
+  buf.addr = reinterpret_cast<uint64_t>(bufs_ + id * buf_size_);
+  buf.len = static_cast<uint32_t>(buf_size_);
+  buf.bid = id;
+  // The tail of the ring overlays the reserved field of the first entry.
+  auto ring = static_cast<io_uring_buf_ring*>(buf_ring_);
+  __atomic_store_n(&ring->tail, ++buf_tail_, __ATOMIC_RELEASE);
+}
+
+} // namespace caf::io::network
+
+#else // CAF_HAS_IO_URING
+
+namespace caf::io::network {
+
+struct uring::message {};
+
+uring::~uring() {
+  // nop
+}
+
+std::unique_ptr<uring> uring::make(unsigned, unsigned, size_t) {
+  return nullptr;
+}
+
+void uring::poll_add(native_socket, uint32_t, uint64_t) {
+  // nop
+}
+
+void uring::poll_remove(uint64_t) {
+  // nop
+}
+
+void uring::recv(native_socket, uint64_t) {
+  // nop
+}
+
+void uring::recvmsg(native_socket, uint64_t) {
+  // nop
+}
+
+void uring::accept(native_socket, uint64_t) {
+  // nop
+}
+
+void uring::sendmsg(native_socket, const span<const byte>*, size_t,
+                    const ip_endpoint*, uint64_t) {
+  // nop
+}
+
+void uring::nop(uint64_t) {
+  // nop
+}
+
+void uring::cancel(uint64_t) {
+  // nop
+}
+
+bool uring::submit(unsigned) {
+  return false;
+}
+
+bool uring::next(completion&) {
+  return false;
+}
+
+const byte* uring::buffer(const completion&) const noexcept {
+  return nullptr;
+}
+
+void uring::recycle(const completion&) noexcept {
+  // nop
+}
+
+bool uring::unpack_datagram(const completion&, const byte*, ip_endpoint&,
+                            span<const byte>&) {
+  return false;
+}
+
+void* uring::acquire_sqe() {
+  return nullptr;
+}
+
+void uring::commit_sqe() {
+  // nop
+}
+
+uring::message& uring::next_message() {
+  if (used_messages_ == messages_.size())
+    messages_.emplace_back(new message);
+  return *messages_[used_messages_++];
+}
+
+bool uring::init_buffers(unsigned, size_t) {
+  return false;
+}
+
+void uring::add_buffer(uint16_t) noexcept {
+  // nop
+}
+
+} // namespace caf::io::network
+
+#endif // CAF_HAS_IO_URING
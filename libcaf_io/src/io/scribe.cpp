@@ -30,6 +30,18 @@ scribe::~scribe() {
   CAF_LOG_TRACE("");
 }
 
+void scribe::write(byte_buffer buf) {
+  auto& out = wr_buf();
+  out.insert(out.end(), buf.begin(), buf.end());
+}
+
+void scribe::write(shared_byte_buffer buf) {
+  if (buf == nullptr)
+    return;
+  auto& out = wr_buf();
+  out.insert(out.end(), buf->begin(), buf->end());
+}
+
 message scribe::detach_message() {
   return make_message(connection_closed_msg{hdl()});
 }
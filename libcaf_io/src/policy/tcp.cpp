@@ -18,6 +18,7 @@
 
 #include "caf/policy/tcp.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 #include "caf/io/network/native_socket.hpp"
@@ -26,8 +27,10 @@
 #ifdef CAF_WINDOWS
 #  include <winsock2.h>
 #else
+#  include <cerrno>
 #  include <sys/socket.h>
 #  include <sys/types.h>
+#  include <sys/uio.h>
 #endif
 
 using caf::io::network::is_error;
@@ -40,6 +43,44 @@ using caf::io::network::socket_size_type;
 
 namespace caf::policy {
 
+namespace {
+
+#ifndef CAF_WINDOWS
+
+// Writes up to 64 buffers with a single call to sendmsg.
+ssize_t sendmsg_some(native_socket fd, const span<const byte>* bufs,
+                     size_t num_bufs, int flags) {
+  // Stays well below IOV_MAX on all supported platforms.
+  static constexpr size_t max_bufs = 64;
+  iovec vec[max_bufs];
+  auto n = std::min(num_bufs, max_bufs);
+  for (size_t i = 0; i < n; ++i) {
+    vec[i].iov_base = const_cast<byte*>(bufs[i].data());
+    vec[i].iov_len = bufs[i].size();
+  }
+  msghdr msg;
+  std::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = vec;
+  msg.msg_iovlen = n;
+  return ::sendmsg(fd, &msg, no_sigpipe_io_flag | flags);
+}
+
+rw_state sendmsg_result(size_t& result, ssize_t sres) {
+  if (is_error(sres, true)) {
+    auto err = last_socket_error();
+    CAF_IGNORE_UNUSED(err);
+    CAF_LOG_ERROR("sendmsg failed:" << socket_error_as_string(err));
+    return rw_state::failure;
+  }
+  CAF_LOG_DEBUG(CAF_ARG(sres));
+  result = (sres > 0) ? static_cast<size_t>(sres) : 0;
+  return rw_state::success;
+}
+
+#endif // CAF_WINDOWS
+
+} // namespace
+
 rw_state
 tcp::read_some(size_t& result, native_socket fd, void* buf, size_t len) {
   CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(len));
@@ -78,6 +119,40 @@ tcp::write_some(size_t& result, native_socket fd, const void* buf, size_t len) {
   return rw_state::success;
 }
 
+rw_state tcp::write_some(size_t& result, native_socket fd,
+                         const span<const byte>* bufs, size_t num_bufs) {
+  CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(num_bufs));
+#ifdef CAF_WINDOWS
+  // Fall back to writing only the first buffer.
+  if (num_bufs == 0) {
+    result = 0;
+    return rw_state::success;
+  }
+  return write_some(result, fd, bufs[0].data(), bufs[0].size());
+#else
+  return sendmsg_result(result, sendmsg_some(fd, bufs, num_bufs, 0));
+#endif
+}
+
+rw_state tcp::write_some_zerocopy(size_t& result, native_socket fd,
+                                  const span<const byte>* bufs,
+                                  size_t num_bufs, bool& zerocopy) {
+  CAF_LOG_TRACE(CAF_ARG(fd) << CAF_ARG(num_bufs));
+#ifdef MSG_ZEROCOPY
+  auto sres = sendmsg_some(fd, bufs, num_bufs, MSG_ZEROCOPY);
+  // The kernel fails with ENOBUFS if the socket exceeds its limit for pinned
+  // pages.
+  if (sres >= 0 || last_socket_error() != ENOBUFS) {
+    // Only calls that succeed get a completion notification.
+    zerocopy = sres > 0;
+    return sendmsg_result(result, sres);
+  }
+  CAF_LOG_DEBUG("fall back to copying after ENOBUFS");
+#endif
+  zerocopy = false;
+  return write_some(result, fd, bufs, num_bufs);
+}
+
 bool tcp::try_accept(native_socket& result, native_socket fd) {
   using namespace io::network;
   CAF_LOG_TRACE(CAF_ARG(fd));
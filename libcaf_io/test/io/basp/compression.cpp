@@ -0,0 +1,161 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.basp.compression
+
+#include "caf/io/basp/compression.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <memory>
+#include <string>
+
+#include "caf/binary_serializer.hpp"
+#include "caf/io/basp/lz4_codec.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+byte_buffer to_buf(const std::string& str) {
+  auto first = reinterpret_cast<const byte*>(str.data());
+  return byte_buffer{first, first + str.size()};
+}
+
+std::string redundant_text(size_t reps) {
+  std::string result;
+  for (size_t i = 0; i < reps; ++i)
+    result += "the quick brown fox jumps over the lazy dog " + std::to_string(i);
+  return result;
+}
+
+struct fixture {
+  basp::lz4_codec lz4;
+
+  byte_buffer roundtrip(const byte_buffer& in) {
+    byte_buffer compressed;
+    if (!lz4.compress(in, compressed)) {
+      CAF_FAIL("compress failed");
+      return {};
+    }
+    CAF_CHECK_LESS(compressed.size(), in.size());
+    byte_buffer result;
+    if (!lz4.decompress(compressed, result, in.size()))
+      CAF_FAIL("decompress failed");
+    return result;
+  }
+
+  // Writes a BASP message with given payload to a fresh buffer.
+  byte_buffer make_message(basp::header& hdr, const byte_buffer& payload) {
+    byte_buffer buf;
+    buf.resize(basp::header_size);
+    buf.insert(buf.end(), payload.begin(), payload.end());
+    hdr.payload_len = static_cast<uint32_t>(payload.size());
+    return buf;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(compression_tests, fixture)
+
+CAF_TEST(lz4 restores redundant input) {
+  auto in = to_buf(redundant_text(100));
+  CAF_CHECK_EQUAL(roundtrip(in), in);
+}
+
+CAF_TEST(lz4 restores long runs of a single byte) {
+  byte_buffer in(10000, byte{42});
+  CAF_CHECK_EQUAL(roundtrip(in), in);
+}
+
+CAF_TEST(lz4 refuses to grow incompressible input) {
+  auto in = to_buf("abcdefghijklmnopqrstuvwxyz");
+  byte_buffer out{byte{1}, byte{2}};
+  CAF_CHECK(!lz4.compress(in, out));
+  CAF_CHECK_EQUAL(out, (byte_buffer{byte{1}, byte{2}}));
+}
+
+CAF_TEST(lz4 rejects malformed input) {
+  auto in = to_buf(redundant_text(10));
+  byte_buffer compressed;
+  CAF_REQUIRE(lz4.compress(in, compressed));
+  byte_buffer out;
+  CAF_MESSAGE("the decompressor checks the expected size");
+  CAF_CHECK(!lz4.decompress(compressed, out, in.size() - 1));
+  out.clear();
+  CAF_CHECK(!lz4.decompress(compressed, out, in.size() + 1));
+  CAF_MESSAGE("the decompressor rejects truncated input");
+  out.clear();
+  compressed.resize(compressed.size() / 2);
+  CAF_CHECK(!lz4.decompress(compressed, out, in.size()));
+  CAF_MESSAGE("the decompressor rejects offsets before the start");
+  out.clear();
+  byte_buffer bogus{byte{0x10}, byte{'a'}, byte{0x02}, byte{0x00}};
+  CAF_CHECK(!lz4.decompress(bogus, out, 5));
+}
+
+CAF_TEST(compression skips payloads below the threshold) {
+  basp::compression cmp{std::make_shared<basp::lz4_codec>(), 1024};
+  basp::header hdr{basp::message_type::direct_message, 0, 0, 0, 1, 2};
+  auto payload = to_buf(redundant_text(5));
+  CAF_REQUIRE_LESS(payload.size(), 1024u);
+  auto buf = make_message(hdr, payload);
+  auto orig_buf = buf;
+  cmp.compress(hdr, buf, 0);
+  CAF_CHECK(!hdr.has(basp::header::compressed_flag));
+  CAF_CHECK_EQUAL(buf, orig_buf);
+  CAF_CHECK_EQUAL(cmp.stats().compressed_payloads, 0u);
+}
+
+CAF_TEST(compression replaces payloads above the threshold) {
+  basp::compression cmp{std::make_shared<basp::lz4_codec>(), 64};
+  basp::header hdr{basp::message_type::direct_message, 0, 0, 0, 1, 2};
+  auto payload = to_buf(redundant_text(100));
+  auto buf = make_message(hdr, payload);
+  cmp.compress(hdr, buf, 0);
+  CAF_REQUIRE(hdr.has(basp::header::compressed_flag));
+  CAF_CHECK_EQUAL(buf.size(), basp::header_size + hdr.payload_len);
+  CAF_CHECK_LESS(hdr.payload_len, payload.size());
+  auto stats = cmp.stats();
+  CAF_CHECK_EQUAL(stats.compressed_payloads, 1u);
+  CAF_CHECK_EQUAL(stats.uncompressed_bytes, payload.size());
+  CAF_CHECK_EQUAL(stats.compressed_bytes, hdr.payload_len);
+  CAF_CHECK_GREATER(stats.ratio(), 1.);
+  CAF_MESSAGE("decompressing restores header and payload");
+  byte_buffer received{buf.begin() + basp::header_size, buf.end()};
+  CAF_REQUIRE(cmp.decompress(hdr, received));
+  CAF_CHECK(!hdr.has(basp::header::compressed_flag));
+  CAF_CHECK_EQUAL(hdr.payload_len, payload.size());
+  CAF_CHECK_EQUAL(received, payload);
+  CAF_CHECK_EQUAL(cmp.stats().decompressed_payloads, 1u);
+}
+
+CAF_TEST(compression keeps incompressible payloads) {
+  basp::compression cmp{std::make_shared<basp::lz4_codec>(), 8};
+  basp::header hdr{basp::message_type::direct_message, 0, 0, 0, 1, 2};
+  auto payload = to_buf("abcdefghijklmnopqrstuvwxyz");
+  auto buf = make_message(hdr, payload);
+  cmp.compress(hdr, buf, 0);
+  CAF_CHECK(!hdr.has(basp::header::compressed_flag));
+  CAF_CHECK_EQUAL(hdr.payload_len, payload.size());
+  CAF_CHECK_EQUAL(cmp.stats().incompressible_payloads, 1u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -26,6 +26,9 @@
 #include "caf/actor_system.hpp"
 #include "caf/behavior.hpp"
 
+#include <thread>
+#include <vector>
+
 using namespace caf;
 
 namespace {
@@ -64,7 +67,7 @@ CAF_TEST_FIXTURE_SCOPE(message_queue_tests, fixture)
 CAF_TEST(default construction) {
   CAF_CHECK_EQUAL(queue.next_id, 0u);
   CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
-  CAF_CHECK_EQUAL(queue.pending.size(), 0u);
+  CAF_CHECK_EQUAL(queue.num_pending(), 0u);
 }
 
 CAF_TEST(ascending IDs) {
@@ -152,4 +155,20 @@ CAF_TEST(dropping) {
   expect((ok_atom, int), from(self).to(testee).with(_, 2));
 }
 
+CAF_TEST(concurrent pushes deliver messages in order) {
+  acquire_ids(1000);
+  std::vector<std::thread> threads;
+  for (int offset = 0; offset < 4; ++offset)
+    threads.emplace_back([this, offset] {
+      for (int id = offset; id < 1000; id += 4)
+        push(id);
+    });
+  for (auto& t : threads)
+    t.join();
+  CAF_CHECK_EQUAL(queue.next_undelivered, 1000u);
+  CAF_CHECK_EQUAL(queue.num_pending(), 0u);
+  for (int id = 0; id < 1000; ++id)
+    expect((ok_atom, int), from(self).to(testee).with(_, id));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "caf/all.hpp"
 #include "caf/io/all.hpp"
@@ -179,4 +180,17 @@ CAF_TEST(test whether we can spawn typed broker) {
   expect_on(mars, (int), from(peer).to(mars.self).with(42));
 }
 
+CAF_TEST(batches to brokers run on the multiplexer) {
+  auto peer = mars.mm.spawn_broker(int_peer_fun);
+  run();
+  std::vector<int> xs{1, 2, 3};
+  mars.self->send_batch(peer, xs);
+  CAF_CHECK(mars.sched.jobs.empty());
+  CAF_CHECK(mars.mpx.try_exec_runnable());
+  run();
+  expect_on(mars, (int), from(peer).to(mars.self).with(1));
+  expect_on(mars, (int), from(peer).to(mars.self).with(2));
+  expect_on(mars, (int), from(peer).to(mars.self).with(3));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
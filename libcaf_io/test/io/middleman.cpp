@@ -0,0 +1,206 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2018 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE io.middleman
+
+#include "caf/io/middleman.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+struct config : actor_system_config {
+  config() {
+    load<middleman>();
+    set("middleman.multiplexers", 2);
+  }
+};
+
+behavior echo_server(broker* self) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->configure_read(msg.handle, receive_policy::exactly(1));
+    },
+    [=](const new_data_msg& msg) {
+      self->write(msg.handle, msg.buf.size(), msg.buf.data());
+      self->flush(msg.handle);
+    },
+    [=](const connection_closed_msg&) { self->quit(); },
+  };
+}
+
+behavior echo_client(broker* self, connection_handle hdl, actor listener) {
+  self->configure_read(hdl, receive_policy::exactly(1));
+  self->write(hdl, 1, "x");
+  self->flush(hdl);
+  return {
+    [=](const new_data_msg& msg) {
+      CAF_CHECK_EQUAL(msg.buf.size(), 1u);
+      self->send(listener, ok_atom_v);
+      self->quit();
+    },
+  };
+}
+
+constexpr const char mixed_writes_payload[] = "abcdefghijkl";
+
+behavior collecting_server(broker* self, actor listener) {
+  return {
+    [=](const new_connection_msg& msg) {
+      auto n = sizeof(mixed_writes_payload) - 1;
+      self->configure_read(msg.handle, receive_policy::exactly(n));
+    },
+    [=](const new_data_msg& msg) {
+      std::string str{reinterpret_cast<const char*>(msg.buf.data()),
+                      msg.buf.size()};
+      CAF_CHECK_EQUAL(str, mixed_writes_payload);
+      self->send(listener, ok_atom_v);
+      self->quit();
+    },
+  };
+}
+
+byte_buffer to_buf(const char* str) {
+  auto first = reinterpret_cast<const byte*>(str);
+  return byte_buffer{first, first + strlen(str)};
+}
+
+void mixed_writes_client(broker* self, connection_handle hdl) {
+  self->write(hdl, 3, "abc");
+  self->write(hdl, to_buf("def"));
+  self->write(hdl, std::make_shared<const byte_buffer>(to_buf("ghi")));
+  self->write(hdl, 3, "jkl");
+  self->flush(hdl);
+}
+
+network::multiplexer& other_backend(broker* self) {
+  auto& mm = self->system().middleman();
+  return &mm.backend(0) == &self->backend() ? mm.backend(1) : mm.backend(0);
+}
+
+// Receives the echo of "abcdefgh" with changing receive policies over a socket
+// that runs its I/O on another multiplexer.
+behavior relay_client(broker* self, uint16_t port, actor listener) {
+  auto& mpx = self->backend();
+  auto ptr = unbox(mpx.new_tcp_scribe("localhost", port, other_backend(self)));
+  auto hdl = ptr->hdl();
+  self->add_scribe(std::move(ptr));
+  self->configure_read(hdl, receive_policy::exactly(3));
+  self->write(hdl, 3, "abc");
+  self->write(hdl, to_buf("def"));
+  self->write(hdl, std::make_shared<const byte_buffer>(to_buf("gh")));
+  self->flush(hdl);
+  auto received = std::make_shared<std::string>();
+  return {
+    [=](const new_data_msg& msg) {
+      received->append(reinterpret_cast<const char*>(msg.buf.data()),
+                       msg.buf.size());
+      if (received->size() == 3) {
+        CAF_CHECK_EQUAL(*received, "abc");
+        self->configure_read(hdl, receive_policy::exactly(5));
+        return;
+      }
+      CAF_CHECK_EQUAL(*received, "abcdefgh");
+      self->send(listener, ok_atom_v);
+      self->quit();
+    },
+  };
+}
+
+network::multiplexer* backend_of(const actor& hdl) {
+  auto ptr = actor_cast<abstract_actor*>(hdl);
+  return &static_cast<abstract_broker*>(ptr)->backend();
+}
+
+struct fixture {
+  fixture() : sys(cfg), mm(sys.middleman()), self(sys) {
+    // nop
+  }
+
+  config cfg;
+  actor_system sys;
+  middleman& mm;
+  scoped_actor self;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(middleman_tests, fixture)
+
+CAF_TEST(the middleman runs one backend per configured multiplexer) {
+  CAF_REQUIRE_EQUAL(mm.num_backends(), 2u);
+  CAF_CHECK_EQUAL(&mm.backend(0), &mm.backend());
+  CAF_CHECK_NOT_EQUAL(&mm.backend(0), &mm.backend(1));
+}
+
+CAF_TEST(brokers get assigned to multiplexers in round robin order) {
+  uint16_t port = 0;
+  auto server = unbox(mm.spawn_server(echo_server, port));
+  auto client = unbox(mm.spawn_client(echo_client, "localhost", port,
+                                      actor{self}));
+  CAF_CHECK_NOT_EQUAL(backend_of(server), backend_of(client));
+  self->receive([](ok_atom) { CAF_MESSAGE("client received its echo"); });
+}
+
+CAF_TEST(brokers can mix copied owned and shared buffers when writing) {
+  uint16_t port = 0;
+  unbox(mm.spawn_server(collecting_server, port, actor{self}));
+  unbox(mm.spawn_client(mixed_writes_client, "localhost", port));
+  self->receive([](ok_atom) { CAF_MESSAGE("server received all bytes"); });
+}
+
+CAF_TEST(brokers can run the socket I/O of connections on other multiplexers) {
+  uint16_t port = 0;
+  unbox(mm.spawn_server(echo_server, port));
+  mm.spawn_broker(relay_client, port, actor{self});
+  self->receive([](ok_atom) { CAF_MESSAGE("client received its echo"); });
+}
+
+CAF_TEST(the BASP broker spreads connections across all multiplexers) {
+  auto echo = sys.spawn([]() -> behavior { return {[](int x) { return x; }}; });
+  auto port = unbox(mm.publish(echo, 0));
+  // The first connection of the server runs on the first multiplexer and the
+  // second connection on the other one. Skipping the first multiplexer of the
+  // second client makes sure that both sides of that connection use relay
+  // scribes.
+  for (int i = 0; i < 2; ++i) {
+    config client_cfg;
+    actor_system client_sys{client_cfg};
+    auto& client_mm = client_sys.middleman();
+    if (i == 1)
+      client_mm.next_backend();
+    auto proxy = unbox(client_mm.remote_actor("localhost", port));
+    scoped_actor client_self{client_sys};
+    client_self->request(proxy, infinite, i)
+      .receive([&](int x) { CAF_CHECK_EQUAL(x, i); },
+               [&](error& err) { CAF_FAIL("unexpected error: " << err); });
+  }
+  anon_send_exit(echo, exit_reason::user_shutdown);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
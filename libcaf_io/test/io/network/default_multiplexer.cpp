@@ -23,23 +23,51 @@
 #include "caf/test/io_dsl.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
 #include <vector>
 
 #include "caf/all.hpp"
 #include "caf/io/all.hpp"
+#include "caf/io/network/acceptor_impl.hpp"
+#include "caf/io/network/datagram_handler_impl.hpp"
 #include "caf/io/network/operation.hpp"
+#include "caf/io/network/stream_impl.hpp"
+#include "caf/policy/tcp.hpp"
+#include "caf/policy/udp.hpp"
+
+#ifndef CAF_WINDOWS
+#  include <arpa/inet.h>
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#  include <unistd.h>
+#endif
 
 using namespace caf;
 
 namespace {
 
-struct sub_fixture : test_coordinator_fixture<> {
+template <class Config = actor_system_config>
+struct sub_fixture : test_coordinator_fixture<Config> {
   io::network::default_multiplexer mpx;
 
-  sub_fixture() : mpx(&sys) {
+  sub_fixture() : mpx(&this->sys) {
+    // nop
+  }
+
+  explicit sub_fixture(const char* backend) : mpx(select_backend(backend)) {
     // nop
   }
 
+  // Overrides the 'testing' backend from test_coordinator_fixture before
+  // constructing the multiplexer.
+  actor_system* select_backend(const char* backend) {
+    this->cfg.set("middleman.network-backend", backend);
+    return &this->sys;
+  }
+
   bool exec_all() {
     size_t count = 0;
     while (mpx.poll_once(false)) {
@@ -47,12 +75,36 @@ struct sub_fixture : test_coordinator_fixture<> {
     }
     return count != 0;
   }
+
+  // Returns `false` if the kernel does not support io_uring. Otherwise,
+  // requires that the multiplexer did not fall back to epoll.
+  bool uring_active() {
+    if (io::network::uring::make(1, 1, 1) == nullptr) {
+      CAF_MESSAGE("skip test: kernel lacks io_uring with multishot receive");
+      return false;
+    }
+    CAF_REQUIRE(mpx.uses_io_uring());
+    return true;
+  }
+
+  // Runs the multiplexer until `predicate` holds. Sleeps between rounds to
+  // give the kernel time to complete pending requests.
+  template <class Predicate>
+  bool run_until(Predicate predicate) {
+    for (int i = 0; i < 1000; ++i) {
+      exec_all();
+      if (predicate())
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
 };
 
 struct fixture {
-  sub_fixture client;
+  sub_fixture<> client;
 
-  sub_fixture server;
+  sub_fixture<> server;
 
   void exec_all() {
     while (client.exec_all() || server.exec_all()) {
@@ -61,6 +113,476 @@ struct fixture {
   }
 };
 
+struct edge_triggered_config : actor_system_config {
+  edge_triggered_config() {
+    set("middleman.epoll-edge-triggered", true);
+  }
+};
+
+#ifndef CAF_WINDOWS
+
+// Reads one byte per event to force the multiplexer into multiple rounds.
+class dummy_handler : public io::network::event_handler {
+public:
+  using super = io::network::event_handler;
+
+  dummy_handler(io::network::default_multiplexer& mpx,
+                io::network::native_socket fd)
+    : super(mpx, fd) {
+    // nop
+  }
+
+  void handle_event(io::network::operation op) override {
+    if (op == io::network::operation::read) {
+      char x;
+      if (::read(fd(), &x, 1) == 1)
+        received.push_back(x);
+      else
+        state_.readable = false;
+    } else if (op == io::network::operation::write) {
+      ++writes;
+      backend().del(io::network::operation::write, fd(), this);
+    }
+  }
+
+  void removed_from_loop(io::network::operation) override {
+    // nop
+  }
+
+  void graceful_shutdown() override {
+    // nop
+  }
+
+  std::string received;
+
+  size_t writes = 0;
+};
+
+template <class Config>
+struct edge_triggered_fixture : sub_fixture<Config> {
+  using super = sub_fixture<Config>;
+
+  using super::exec_all;
+
+  using super::mpx;
+
+  template <class... Ts>
+  explicit edge_triggered_fixture(Ts&&... xs) : super(std::forward<Ts>(xs)...) {
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+      CAF_FAIL("socketpair failed");
+    handler.reset(new dummy_handler(mpx, fds[0]));
+    peer = fds[1];
+    mpx.add(io::network::operation::read, handler->fd(), handler.get());
+    mpx.handle_internal_events();
+  }
+
+  ~edge_triggered_fixture() {
+    mpx.del(io::network::operation::read, handler->fd(), handler.get());
+    mpx.del(io::network::operation::write, handler->fd(), handler.get());
+    mpx.handle_internal_events();
+    ::close(peer);
+  }
+
+  void handlers_receive_all_input() {
+    std::string data = "hello world";
+    CAF_REQUIRE_EQUAL(::write(peer, data.data(), data.size()),
+                      static_cast<ssize_t>(data.size()));
+    exec_all();
+    CAF_CHECK_EQUAL(handler->received, data);
+    CAF_CHECK(!mpx.poll_once(false));
+  }
+
+  void handlers_run_on_new_interest() {
+    exec_all();
+    CAF_CHECK_EQUAL(handler->writes, 0u);
+    mpx.add(io::network::operation::write, handler->fd(), handler.get());
+    mpx.handle_internal_events();
+    exec_all();
+    CAF_CHECK_EQUAL(handler->writes, 1u);
+  }
+
+  std::unique_ptr<dummy_handler> handler;
+
+  io::network::native_socket peer;
+};
+
+#endif // CAF_WINDOWS
+
+#ifdef CAF_LINUX
+
+class dummy_stream_manager : public io::network::stream_manager {
+public:
+  bool consume(execution_unit*, const void*, size_t) override {
+    return true;
+  }
+
+  void data_transferred(execution_unit*, size_t, size_t) override {
+    // nop
+  }
+
+  uint16_t port() const override {
+    return 0;
+  }
+
+  std::string addr() const override {
+    return {};
+  }
+
+  void graceful_shutdown() override {
+    // nop
+  }
+
+  void remove_from_loop() override {
+    // nop
+  }
+
+  void add_to_loop() override {
+    // nop
+  }
+
+protected:
+  message detach_message() override {
+    return {};
+  }
+
+  void detach_from(io::abstract_broker*) override {
+    // nop
+  }
+};
+
+struct zerocopy_config : actor_system_config {
+  zerocopy_config() {
+    set("middleman.zerocopy-threshold", size_t{1024});
+  }
+};
+
+struct zerocopy_fixture : sub_fixture<zerocopy_config> {
+  using stream_type = io::network::stream_impl<policy::tcp>;
+
+  zerocopy_fixture() {
+    using namespace io::network;
+    auto acceptor = unbox(new_tcp_acceptor_impl(0, "127.0.0.1", true));
+    auto port = unbox(local_port_of_fd(acceptor));
+    auto fd = unbox(new_tcp_connection("127.0.0.1", port));
+    peer = ::accept(acceptor, nullptr, nullptr);
+    close_socket(acceptor);
+    CAF_REQUIRE_NOT_EQUAL(peer, invalid_native_socket);
+    mgr = make_counted<dummy_stream_manager>();
+    uut.reset(new stream_type(mpx, fd));
+    uut->start(mgr.get());
+    mpx.handle_internal_events();
+  }
+
+  ~zerocopy_fixture() {
+    mpx.del(io::network::operation::read, uut->fd(), uut.get());
+    mpx.del(io::network::operation::write, uut->fd(), uut.get());
+    mpx.handle_internal_events();
+    ::close(peer);
+  }
+
+  // Reads `n` bytes from the peer.
+  byte_buffer receive(size_t n) {
+    byte_buffer result(n);
+    size_t received = 0;
+    while (received < n) {
+      auto res = ::recv(peer, result.data() + received, n - received, 0);
+      if (res <= 0)
+        CAF_FAIL("recv failed");
+      received += static_cast<size_t>(res);
+      exec_all();
+    }
+    return result;
+  }
+
+  intrusive_ptr<dummy_stream_manager> mgr;
+
+  std::unique_ptr<stream_type> uut;
+
+  io::network::native_socket peer;
+};
+
+// Records all input and stops reading after `max_chunks` calls to `consume`.
+class recording_stream_manager : public dummy_stream_manager {
+public:
+  bool consume(execution_unit*, const void* buf, size_t num_bytes) override {
+    auto first = static_cast<const char*>(buf);
+    chunks.emplace_back(first, first + num_bytes);
+    return chunks.size() < max_chunks;
+  }
+
+  void data_transferred(execution_unit*, size_t num_bytes, size_t) override {
+    transferred += num_bytes;
+  }
+
+  void io_failure(execution_unit*, io::network::operation op) override {
+    failures.emplace_back(op);
+  }
+
+  std::vector<std::string> chunks;
+
+  size_t max_chunks = std::numeric_limits<size_t>::max();
+
+  size_t transferred = 0;
+
+  std::vector<io::network::operation> failures;
+};
+
+struct uring_stream_fixture : sub_fixture<> {
+  using stream_type = io::network::stream_impl<policy::tcp>;
+
+  uring_stream_fixture() : sub_fixture("io_uring") {
+    using namespace io::network;
+    auto acceptor = unbox(new_tcp_acceptor_impl(0, "127.0.0.1", true));
+    auto port = unbox(local_port_of_fd(acceptor));
+    auto fd = unbox(new_tcp_connection("127.0.0.1", port));
+    peer = ::accept(acceptor, nullptr, nullptr);
+    close_socket(acceptor);
+    CAF_REQUIRE_NOT_EQUAL(peer, invalid_native_socket);
+    nonblocking(peer, true);
+    mgr = make_counted<recording_stream_manager>();
+    uut.reset(new stream_type(mpx, fd));
+  }
+
+  ~uring_stream_fixture() {
+    mpx.del(io::network::operation::read, uut->fd(), uut.get());
+    mpx.del(io::network::operation::write, uut->fd(), uut.get());
+    mpx.handle_internal_events();
+    exec_all();
+    if (peer != io::network::invalid_native_socket)
+      ::close(peer);
+  }
+
+  void start() {
+    uut->start(mgr.get());
+    mpx.handle_internal_events();
+    exec_all();
+  }
+
+  void send(const std::string& str) {
+    CAF_REQUIRE_EQUAL(::send(peer, str.data(), str.size(), 0),
+                      static_cast<ssize_t>(str.size()));
+  }
+
+  // Reads `n` bytes from the peer while running the multiplexer.
+  byte_buffer receive(size_t n) {
+    byte_buffer result(n);
+    size_t received = 0;
+    auto done = [&] {
+      auto res = ::recv(peer, result.data() + received, n - received, 0);
+      if (res > 0)
+        received += static_cast<size_t>(res);
+      return received == n;
+    };
+    if (!run_until(done))
+      CAF_FAIL("received only " << received << " of " << n << " bytes");
+    return result;
+  }
+
+  intrusive_ptr<recording_stream_manager> mgr;
+
+  std::unique_ptr<stream_type> uut;
+
+  io::network::native_socket peer;
+};
+
+// Counts and closes accepted connections.
+class counting_acceptor_manager : public io::network::acceptor_manager {
+public:
+  explicit counting_acceptor_manager(io::network::acceptor* ptr)
+    : acceptor(ptr) {
+    // nop
+  }
+
+  bool new_connection() override {
+    io::network::close_socket(acceptor->accepted_socket());
+    ++connections;
+    return true;
+  }
+
+  uint16_t port() const override {
+    return 0;
+  }
+
+  std::string addr() const override {
+    return {};
+  }
+
+  void graceful_shutdown() override {
+    // nop
+  }
+
+  void remove_from_loop() override {
+    // nop
+  }
+
+  void add_to_loop() override {
+    // nop
+  }
+
+  io::network::acceptor* acceptor;
+
+  size_t connections = 0;
+
+protected:
+  message detach_message() override {
+    return {};
+  }
+
+  void detach_from(io::abstract_broker*) override {
+    // nop
+  }
+};
+
+struct uring_acceptor_fixture : sub_fixture<> {
+  using acceptor_type = io::network::acceptor_impl<policy::tcp>;
+
+  uring_acceptor_fixture() : sub_fixture("io_uring") {
+    using namespace io::network;
+    auto fd = unbox(new_tcp_acceptor_impl(0, "127.0.0.1", true));
+    port = unbox(local_port_of_fd(fd));
+    uut.reset(new acceptor_type(mpx, fd));
+    mgr = make_counted<counting_acceptor_manager>(uut.get());
+    uut->start(mgr.get());
+    mpx.handle_internal_events();
+    exec_all();
+  }
+
+  ~uring_acceptor_fixture() {
+    mpx.del(io::network::operation::read, uut->fd(), uut.get());
+    mpx.handle_internal_events();
+    exec_all();
+    for (auto fd : clients)
+      io::network::close_socket(fd);
+  }
+
+  void connect(size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      clients.emplace_back(unbox(io::network::new_tcp_connection("127.0.0.1",
+                                                                 port)));
+  }
+
+  intrusive_ptr<counting_acceptor_manager> mgr;
+
+  std::unique_ptr<acceptor_type> uut;
+
+  uint16_t port;
+
+  std::vector<io::network::native_socket> clients;
+};
+
+// Records all datagrams and acknowledged writes.
+class recording_datagram_manager : public io::network::datagram_manager {
+public:
+  bool consume(execution_unit*, io::datagram_handle,
+               io::network::receive_buffer& buf) override {
+    received.emplace_back(reinterpret_cast<const char*>(buf.data()),
+                          buf.size());
+    return true;
+  }
+
+  void datagram_sent(execution_unit*, io::datagram_handle, size_t num_bytes,
+                     byte_buffer) override {
+    sent += num_bytes;
+  }
+
+  bool new_endpoint(io::network::receive_buffer& buf) override {
+    ++new_endpoints;
+    received.emplace_back(reinterpret_cast<const char*>(buf.data()),
+                          buf.size());
+    return true;
+  }
+
+  uint16_t port(io::datagram_handle) const override {
+    return 0;
+  }
+
+  std::string addr(io::datagram_handle) const override {
+    return {};
+  }
+
+  void graceful_shutdown() override {
+    // nop
+  }
+
+  void remove_from_loop() override {
+    // nop
+  }
+
+  void add_to_loop() override {
+    // nop
+  }
+
+  std::vector<std::string> received;
+
+  size_t new_endpoints = 0;
+
+  size_t sent = 0;
+
+protected:
+  message detach_message() override {
+    return {};
+  }
+
+  void detach_from(io::abstract_broker*) override {
+    // nop
+  }
+};
+
+// Opens a non-blocking UDP socket on a random port of the loopback device.
+io::network::native_socket new_udp_socket(sockaddr_in& addr) {
+  auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  CAF_REQUIRE_NOT_EQUAL(fd, io::network::invalid_native_socket);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  auto len = static_cast<socklen_t>(sizeof(addr));
+  CAF_REQUIRE_EQUAL(::bind(fd, reinterpret_cast<sockaddr*>(&addr), len), 0);
+  CAF_REQUIRE_EQUAL(
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len), 0);
+  return fd;
+}
+
+struct uring_datagram_fixture : sub_fixture<> {
+  using handler_type = io::network::datagram_handler_impl<policy::udp>;
+
+  uring_datagram_fixture() : sub_fixture("io_uring") {
+    uut.reset(new handler_type(mpx, new_udp_socket(uut_addr)));
+    peer = new_udp_socket(peer_addr);
+    mgr = make_counted<recording_datagram_manager>();
+    uut->start(mgr.get());
+    mpx.handle_internal_events();
+    exec_all();
+  }
+
+  ~uring_datagram_fixture() {
+    mpx.del(io::network::operation::read, uut->fd(), uut.get());
+    mpx.del(io::network::operation::write, uut->fd(), uut.get());
+    mpx.handle_internal_events();
+    exec_all();
+    ::close(peer);
+  }
+
+  void send(const std::string& str) {
+    auto res = ::sendto(peer, str.data(), str.size(), 0,
+                        reinterpret_cast<sockaddr*>(&uut_addr),
+                        sizeof(uut_addr));
+    CAF_REQUIRE_EQUAL(res, static_cast<ssize_t>(str.size()));
+  }
+
+  intrusive_ptr<recording_datagram_manager> mgr;
+
+  std::unique_ptr<handler_type> uut;
+
+  sockaddr_in uut_addr;
+
+  io::network::native_socket peer;
+
+  sockaddr_in peer_addr;
+};
+
+#endif // CAF_LINUX
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(default_multiplexer_tests, fixture)
@@ -80,3 +602,208 @@ CAF_TEST(doorman io_failure) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+#ifndef CAF_WINDOWS
+
+CAF_TEST_FIXTURE_SCOPE(edge_triggered_tests,
+                       edge_triggered_fixture<edge_triggered_config>)
+
+CAF_TEST(handlers receive all input with a single edge) {
+  handlers_receive_all_input();
+}
+
+CAF_TEST(handlers that become interested in ready events run immediately) {
+  handlers_run_on_new_interest();
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+struct uring_fixture : edge_triggered_fixture<actor_system_config> {
+  uring_fixture() : edge_triggered_fixture("io_uring") {
+    // nop
+  }
+};
+
+CAF_TEST_FIXTURE_SCOPE(uring_tests, uring_fixture)
+
+CAF_TEST(io_uring handlers receive all input with a single edge) {
+  if (!uring_active())
+    return;
+  handlers_receive_all_input();
+}
+
+CAF_TEST(io_uring handlers that become interested in ready events run) {
+  if (!uring_active())
+    return;
+  handlers_run_on_new_interest();
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+#endif // CAF_WINDOWS
+
+#ifdef CAF_LINUX
+
+CAF_TEST_FIXTURE_SCOPE(zerocopy_tests, zerocopy_fixture)
+
+CAF_TEST(streams keep zerocopy buffers alive until the kernel completes) {
+  byte_buffer small(16, byte{1});
+  byte_buffer large(64 * 1024, byte{2});
+  auto expected = small;
+  expected.insert(expected.end(), large.begin(), large.end());
+  uut->write(small);
+  uut->write(large);
+  uut->flush(mgr);
+  mpx.handle_internal_events();
+  exec_all();
+  CAF_CHECK_EQUAL(receive(expected.size()), expected);
+  int flag = 0;
+  socklen_t len = sizeof(flag);
+  if (::getsockopt(uut->fd(), SOL_SOCKET, SO_ZEROCOPY, &flag, &len) != 0
+      || flag == 0) {
+    CAF_MESSAGE("skip test: kernel lacks MSG_ZEROCOPY");
+    return;
+  }
+  for (int i = 0; i < 100 && uut->pending_zerocopy_buffers() > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    exec_all();
+  }
+  CAF_CHECK_EQUAL(uut->pending_zerocopy_buffers(), 0u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+#endif // CAF_LINUX
+
+#ifdef CAF_LINUX
+
+CAF_TEST_FIXTURE_SCOPE(uring_stream_tests, uring_stream_fixture)
+
+CAF_TEST(io_uring streams receive data via completions) {
+  if (!uring_active())
+    return;
+  uut->configure_read(io::receive_policy::exactly(4));
+  start();
+  send("hello world!");
+  CAF_CHECK(run_until([&] { return mgr->chunks.size() == 3; }));
+  CAF_CHECK_EQUAL(mgr->chunks,
+                  std::vector<std::string>({"hell", "o wo", "rld!"}));
+}
+
+CAF_TEST(io_uring streams keep input while passive) {
+  if (!uring_active())
+    return;
+  mgr->max_chunks = 1;
+  uut->configure_read(io::receive_policy::exactly(4));
+  start();
+  send("hello world!");
+  CAF_CHECK(run_until([&] { return mgr->chunks.size() == 1; }));
+  send("more");
+  run_until([] { return false; });
+  CAF_CHECK_EQUAL(mgr->chunks, std::vector<std::string>({"hell"}));
+  CAF_MESSAGE("activating the stream again delivers all pending input");
+  mgr->max_chunks = std::numeric_limits<size_t>::max();
+  uut->activate(mgr.get());
+  mpx.handle_internal_events();
+  CAF_CHECK(run_until([&] { return mgr->chunks.size() == 4; }));
+  CAF_CHECK_EQUAL(mgr->chunks,
+                  std::vector<std::string>({"hell", "o wo", "rld!", "more"}));
+}
+
+CAF_TEST(io_uring streams send data via completions) {
+  if (!uring_active())
+    return;
+  start();
+  byte_buffer data(1024 * 1024);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<byte>(i % 251);
+  uut->ack_writes(true);
+  uut->write(data);
+  uut->flush(mgr);
+  mpx.handle_internal_events();
+  CAF_CHECK_EQUAL(receive(data.size()), data);
+  CAF_CHECK(run_until([&] { return mgr->transferred == data.size(); }));
+}
+
+CAF_TEST(io_uring streams report closed connections) {
+  if (!uring_active())
+    return;
+  start();
+  send("bye");
+  ::close(peer);
+  peer = io::network::invalid_native_socket;
+  CAF_CHECK(run_until([&] { return !mgr->failures.empty(); }));
+  CAF_CHECK_EQUAL(mgr->chunks, std::vector<std::string>({"bye"}));
+  CAF_CHECK_EQUAL(mgr->failures,
+                  std::vector<io::network::operation>(
+                    {io::network::operation::read}));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(uring_acceptor_tests, uring_acceptor_fixture)
+
+CAF_TEST(io_uring acceptors accept connections via completions) {
+  if (!uring_active())
+    return;
+  connect(3);
+  CAF_CHECK(run_until([&] { return mgr->connections == 3; }));
+}
+
+CAF_TEST(io_uring acceptors keep connections while passive) {
+  if (!uring_active())
+    return;
+  uut->passivate();
+  mpx.handle_internal_events();
+  exec_all();
+  connect(2);
+  run_until([] { return false; });
+  CAF_CHECK_EQUAL(mgr->connections, 0u);
+  uut->activate(mgr.get());
+  mpx.handle_internal_events();
+  CAF_CHECK(run_until([&] { return mgr->connections == 2; }));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(uring_datagram_tests, uring_datagram_fixture)
+
+CAF_TEST(io_uring datagram handlers receive datagrams via completions) {
+  if (!uring_active())
+    return;
+  send("ping");
+  send("pong");
+  CAF_CHECK(run_until([&] { return mgr->received.size() == 2; }));
+  CAF_CHECK_EQUAL(mgr->received, std::vector<std::string>({"ping", "pong"}));
+  CAF_CHECK_EQUAL(mgr->new_endpoints, 2u);
+  CAF_CHECK_EQUAL(port(uut->sending_endpoint()), ntohs(peer_addr.sin_port));
+}
+
+CAF_TEST(io_uring datagram handlers send datagrams via completions) {
+  if (!uring_active())
+    return;
+  send("ping");
+  CAF_REQUIRE(run_until([&] { return mgr->received.size() == 1; }));
+  auto hdl = io::datagram_handle::from_int(1);
+  uut->add_endpoint(hdl, uut->sending_endpoint(), mgr);
+  send("pong");
+  CAF_CHECK(run_until([&] { return mgr->received.size() == 2; }));
+  CAF_CHECK_EQUAL(mgr->new_endpoints, 1u);
+  uut->ack_writes(true);
+  std::string reply = "hello";
+  uut->enqueue_datagram(hdl, byte_buffer{
+                               reinterpret_cast<const byte*>(reply.data()),
+                               reinterpret_cast<const byte*>(reply.data())
+                                 + reply.size()});
+  uut->flush(mgr);
+  mpx.handle_internal_events();
+  CAF_CHECK(run_until([&] { return mgr->sent == reply.size(); }));
+  char buf[16];
+  auto res = ::recv(peer, buf, sizeof(buf), 0);
+  CAF_REQUIRE_EQUAL(res, static_cast<ssize_t>(reply.size()));
+  CAF_CHECK_EQUAL(std::string(buf, reply.size()), reply);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+#endif // CAF_LINUX
@@ -27,6 +27,7 @@
 
 #include "caf/all.hpp"
 #include "caf/io/all.hpp"
+#include "caf/io/basp/serializing_proxy.hpp"
 
 using namespace caf;
 
@@ -99,6 +100,35 @@ behavior linking_actor(event_based_actor* self,
   };
 }
 
+behavior echo() {
+  return {
+    [](const std::string& str) { return str; },
+  };
+}
+
+void requester(event_based_actor* self, const actor& buddy, std::string str,
+               suite_state_ptr ssp) {
+  self->request(buddy, infinite, str).then([=](const std::string& reply) {
+    CAF_CHECK_EQUAL(reply, str);
+    ++ssp->pongs;
+  });
+}
+
+behavior collector(event_based_actor* self, suite_state_ptr ssp) {
+  return {
+    [=](int value) {
+      CAF_CHECK_EQUAL(value, ssp->pongs);
+      if (++ssp->pongs == 100)
+        self->quit();
+    },
+  };
+}
+
+void sequence_sender(event_based_actor* self, const actor& buddy) {
+  for (int i = 0; i < 100; ++i)
+    self->send(buddy, i);
+}
+
 struct fixture : point_to_point_fixture<> {
   fixture() {
     prepare_connection(mars, earth, "mars", 8080);
@@ -108,6 +138,70 @@ struct fixture : point_to_point_fixture<> {
   suite_state_ptr ssp;
 };
 
+struct serialize_on_send_config : test_node_fixture_config {
+  serialize_on_send_config() {
+    set("middleman.serialize-on-send", true);
+  }
+};
+
+using serialize_on_send_base
+  = test_coordinator_fixture<serialize_on_send_config>;
+
+struct serialize_on_send_fixture
+  : point_to_point_fixture<serialize_on_send_base> {
+  serialize_on_send_fixture() {
+    prepare_connection(mars, earth, "mars", 8080);
+    ssp = std::make_shared<suite_state>();
+  }
+
+  suite_state_ptr ssp;
+};
+
+struct compression_config : test_node_fixture_config {
+  compression_config() {
+    set("middleman.compression-codecs", std::vector<std::string>{"lz4"});
+    set("middleman.compression-threshold", 64);
+  }
+};
+
+using compression_base = test_coordinator_fixture<compression_config>;
+
+struct compression_fixture : point_to_point_fixture<compression_base> {
+  compression_fixture() {
+    prepare_connection(mars, earth, "mars", 8080);
+    ssp = std::make_shared<suite_state>();
+  }
+
+  suite_state_ptr ssp;
+};
+
+struct coalescing_config : test_node_fixture_config {
+  coalescing_config() {
+    set("middleman.coalesce-messages", true);
+    set("middleman.compression-codecs", std::vector<std::string>{"lz4"});
+    set("middleman.compression-threshold", 64);
+  }
+};
+
+using coalescing_base = test_coordinator_fixture<coalescing_config>;
+
+struct coalescing_fixture : point_to_point_fixture<coalescing_base> {
+  coalescing_fixture() {
+    prepare_connection(mars, earth, "mars", 8080);
+    ssp = std::make_shared<suite_state>();
+  }
+
+  static bool coalesces(const actor& hdl) {
+    auto bb = static_cast<io::basp_broker*>(actor_cast<abstract_actor*>(hdl));
+    for (auto& kvp : bb->ctx)
+      if (kvp.second.batch != nullptr)
+        return true;
+    return false;
+  }
+
+  suite_state_ptr ssp;
+};
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(dynamic_remote_actor_tests, fixture)
@@ -141,3 +235,81 @@ CAF_TEST(remote_link) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(serialize_on_send_tests, serialize_on_send_fixture)
+
+CAF_TEST(proxies serialize messages on the sending thread) {
+  auto port = mars.publish(mars.sys.spawn(pong, ssp), 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto remote_pong = earth.remote_actor("mars", 8080);
+  auto proxy = actor_cast<abstract_actor*>(remote_pong);
+  CAF_CHECK(dynamic_cast<io::basp::serializing_proxy*>(proxy) != nullptr);
+  anon_send(earth.sys.spawn(ping, ssp), ok_atom_v, remote_pong);
+  run();
+  CAF_CHECK_EQUAL(ssp->pings, 10);
+  CAF_CHECK_EQUAL(ssp->pongs, 10);
+}
+
+CAF_TEST(serializing proxies support remote links) {
+  auto port = mars.publish(mars.sys.spawn(fragile_mirror), 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto mirror = earth.remote_actor<fragile_mirror_actor>("mars", 8080);
+  earth.sys.spawn(linking_actor, mirror, ssp);
+  run();
+  CAF_CHECK_EQUAL(ssp->linking_result, exit_reason::user_shutdown);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(compression_tests, compression_fixture)
+
+CAF_TEST(nodes compress large payloads with the negotiated codec) {
+  auto server = mars.sys.spawn(echo);
+  auto port = mars.publish(server, 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto remote_echo = earth.remote_actor("mars", 8080);
+  std::string str;
+  for (int i = 0; i < 100; ++i)
+    str += "the quick brown fox jumps over the lazy dog ";
+  earth.sys.spawn(requester, remote_echo, str, ssp);
+  run();
+  CAF_CHECK_EQUAL(ssp->pongs, 1);
+  auto earth_stats = earth.mm.compression_stats(mars.sys.node());
+  auto mars_stats = mars.mm.compression_stats(earth.sys.node());
+  CAF_REQUIRE(earth_stats && mars_stats);
+  CAF_CHECK_GREATER(earth_stats->compressed_payloads, 0u);
+  CAF_CHECK_GREATER(earth_stats->ratio(), 2.);
+  CAF_CHECK_GREATER(mars_stats->compressed_payloads, 0u);
+  CAF_CHECK_GREATER(mars_stats->decompressed_payloads, 0u);
+  anon_send_exit(server, exit_reason::user_shutdown);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(coalescing_tests, coalescing_fixture)
+
+CAF_TEST(nodes coalesce messages without reordering them) {
+  auto port = mars.publish(mars.sys.spawn(collector, ssp), 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto remote_collector = earth.remote_actor("mars", 8080);
+  CAF_CHECK(coalesces(earth.bb));
+  CAF_CHECK(coalesces(mars.bb));
+  earth.sys.spawn(sequence_sender, remote_collector);
+  run();
+  CAF_CHECK_EQUAL(ssp->pongs, 100);
+  auto stats = earth.mm.compression_stats(mars.sys.node());
+  CAF_REQUIRE(stats);
+  CAF_CHECK_GREATER(stats->compressed_payloads, 0u);
+}
+
+CAF_TEST(coalescing nodes exchange requests and responses) {
+  auto port = mars.publish(mars.sys.spawn(pong, ssp), 8080);
+  CAF_CHECK_EQUAL(port, 8080u);
+  auto remote_pong = earth.remote_actor("mars", 8080);
+  anon_send(earth.sys.spawn(ping, ssp), ok_atom_v, remote_pong);
+  run();
+  CAF_CHECK_EQUAL(ssp->pings, 10);
+  CAF_CHECK_EQUAL(ssp->pongs, 10);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -101,7 +101,7 @@ CAF_TEST_FIXTURE_SCOPE(worker_tests, fixture)
 CAF_TEST(deliver serialized message) {
   CAF_MESSAGE("create the BASP worker");
   CAF_REQUIRE_EQUAL(hub.peek(), nullptr);
-  hub.add_new_worker(queue, proxies);
+  hub.add_new_worker(proxies);
   CAF_REQUIRE_NOT_EQUAL(hub.peek(), nullptr);
   auto w = hub.pop();
   CAF_MESSAGE("create a fake message + BASP header");
@@ -117,9 +117,34 @@ CAF_TEST(deliver serialized message) {
                        42,
                        testee.id()};
   CAF_MESSAGE("launch worker");
-  w->launch(last_hop, hdr, payload);
+  w->launch(last_hop, hdr, payload, nullptr, queue);
   sched.run_once();
   expect((ok_atom), from(_).to(testee));
 }
 
+CAF_TEST(workers take over payloads and remember message shapes) {
+  hub.add_new_worker(proxies);
+  auto shapes = make_counted<detail::message_shape_cache>();
+  for (int i = 0; i < 3; ++i) {
+    byte_buffer payload;
+    std::vector<strong_actor_ptr> stages;
+    binary_serializer sink{sys, payload};
+    if (auto err = sink(stages, make_message(ok_atom_v)))
+      CAF_FAIL("unable to serialize message: " << sys.render(err));
+    io::basp::header hdr{io::basp::message_type::direct_message,
+                         0,
+                         static_cast<uint32_t>(payload.size()),
+                         make_message_id().integer_value(),
+                         42,
+                         testee.id()};
+    auto w = hub.pop();
+    CAF_REQUIRE_NOT_EQUAL(w, nullptr);
+    w->launch(last_hop, hdr, payload, shapes.get(), queue);
+    CAF_CHECK(payload.empty());
+    sched.run_once();
+    expect((ok_atom), from(_).to(testee));
+  }
+  CAF_CHECK_EQUAL(shapes->size(), 1u);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()